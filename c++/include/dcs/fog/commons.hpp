@@ -87,7 +87,11 @@ enum vm_allocation_policy_category_t
 {
     optimal_vm_allocation_policy,
     bahreini2017_match_vm_allocation_policy,
-    bahreini2017_match_alt_vm_allocation_policy
+    bahreini2017_match_alt_vm_allocation_policy,
+    bahreini2017_match_flow_vm_allocation_policy,
+    aggregated_vm_allocation_policy,
+    ortools_vm_allocation_policy,
+    greedy_vm_allocation_policy
 }; // vm_allocation_policy_category_t
 
 
@@ -158,6 +162,18 @@ std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharT
         case bahreini2017_match_alt_vm_allocation_policy:
             os << "bahreini2017_match_alt";
             break;
+        case bahreini2017_match_flow_vm_allocation_policy:
+            os << "bahreini2017_match_flow";
+            break;
+        case aggregated_vm_allocation_policy:
+            os << "aggregated";
+            break;
+        case ortools_vm_allocation_policy:
+            os << "ortools";
+            break;
+        case greedy_vm_allocation_policy:
+            os << "greedy";
+            break;
     }
 
     return os;
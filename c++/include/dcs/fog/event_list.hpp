@@ -0,0 +1,36 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fog/event_list.hpp
+ *
+ * \brief Future event lists for the discrete-event simulator.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FOG_EVENT_LIST_HPP
+#define DCS_FOG_EVENT_LIST_HPP
+
+
+#include <dcs/fog/event_list/calendar_queue_event_list.hpp>
+#include <dcs/fog/event_list/commons.hpp>
+#include <dcs/fog/event_list/dary_heap_event_list.hpp>
+
+
+#endif // DCS_FOG_EVENT_LIST_HPP
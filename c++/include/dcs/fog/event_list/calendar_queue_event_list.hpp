@@ -0,0 +1,283 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fog/event_list/calendar_queue_event_list.hpp
+ *
+ * \brief Future event list based on a calendar queue.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FOG_EVENT_LIST_CALENDAR_QUEUE_EVENT_LIST_HPP
+#define DCS_FOG_EVENT_LIST_CALENDAR_QUEUE_EVENT_LIST_HPP
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <dcs/fog/event_list/commons.hpp>
+#include <vector>
+
+
+namespace dcs { namespace fog {
+
+/**
+ * \brief Future event list based on a calendar queue.
+ *
+ * The calendar queue (R. Brown, "Calendar Queues: A Fast O(1) Priority Queue
+ * Implementation for the Simulation Event Set Problem", Communications of the
+ * ACM 31(10), 1988) hashes entries by fire time into an array of buckets
+ * ("days"), each one covering a time interval of fixed width, and wraps around
+ * the array every "year".
+ * Provided that the bucket width matches the distribution of event times,
+ * insertion and removal take O(1) amortized time.
+ * The number of buckets is doubled (halved) when the number of entries grows
+ * above twice (falls below half) the number of buckets, and the bucket width
+ * is re-estimated from the earliest entries at every resize.
+ *
+ * Entries in a bucket are kept sorted in decreasing order, so that the
+ * earliest entry of a bucket is removed from the back.
+ */
+template <typename RealT>
+class calendar_queue_event_list_t
+{
+public:
+    typedef event_list_entry_t<RealT> entry_type;
+
+    static constexpr std::size_t min_num_buckets = 2;
+    static constexpr std::size_t width_sample_size = 25;
+
+
+public:
+    calendar_queue_event_list_t()
+    : buckets_(min_num_buckets),
+      size_(0),
+      width_(1),
+      cur_bucket_(0),
+      cur_vbucket_(0)
+    {
+    }
+
+    void push(const entry_type& entry)
+    {
+        // Move the calendar back if the new entry precedes its current position
+        if (size_ == 0 || virtual_bucket(entry.fire_time) < cur_vbucket_)
+        {
+            move_to(entry.fire_time);
+        }
+
+        insert(entry);
+        ++size_;
+
+        if (size_ > 2*buckets_.size())
+        {
+            resize(2*buckets_.size());
+        }
+    }
+
+    const entry_type& top() const
+    {
+        DCS_DEBUG_ASSERT( size_ > 0 );
+
+        locate_min();
+
+        return buckets_[cur_bucket_].back();
+    }
+
+    void pop()
+    {
+        DCS_DEBUG_ASSERT( size_ > 0 );
+
+        locate_min();
+
+        buckets_[cur_bucket_].pop_back();
+        --size_;
+
+        if (buckets_.size() > min_num_buckets && size_ < buckets_.size()/2)
+        {
+            resize(buckets_.size()/2);
+        }
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    void clear()
+    {
+        for (auto& bucket : buckets_)
+        {
+            bucket.clear();
+        }
+        size_ = 0;
+    }
+
+
+private:
+    /// Returns the (unbounded) virtual bucket the given time falls into
+    RealT virtual_bucket(RealT time) const
+    {
+        return std::floor(time/width_);
+    }
+
+    /// Maps a virtual bucket to the actual bucket
+    std::size_t bucket_index(RealT vbucket) const
+    {
+        RealT idx = std::fmod(vbucket, static_cast<RealT>(buckets_.size()));
+        if (idx < 0)
+        {
+            idx += buckets_.size();
+        }
+        return static_cast<std::size_t>(idx);
+    }
+
+    /// Moves the current position of the calendar to the bucket containing the given time
+    void move_to(RealT time) const
+    {
+        cur_vbucket_ = virtual_bucket(time);
+        cur_bucket_ = bucket_index(cur_vbucket_);
+    }
+
+    void insert(const entry_type& entry)
+    {
+        auto& bucket = buckets_[bucket_index(virtual_bucket(entry.fire_time))];
+
+        // Keep the bucket sorted in decreasing order
+        auto it = std::upper_bound(bucket.begin(),
+                                   bucket.end(),
+                                   entry,
+                                   [](const entry_type& e1, const entry_type& e2) { return e2 < e1; });
+        bucket.insert(it, entry);
+    }
+
+    /// Moves the current position of the calendar to the bucket containing the earliest entry
+    void locate_min() const
+    {
+        // Scan the buckets for at most one year, looking for an entry belonging to the current year.
+        // Since entries are hashed by virtual bucket, such entry (if any) is the earliest one.
+        const std::size_t nb = buckets_.size();
+        for (std::size_t n = 0; n < nb; ++n)
+        {
+            auto const& bucket = buckets_[cur_bucket_];
+
+            if (!bucket.empty() && virtual_bucket(bucket.back().fire_time) <= cur_vbucket_)
+            {
+                return;
+            }
+
+            cur_bucket_ = (cur_bucket_+1) % nb;
+            cur_vbucket_ += 1;
+        }
+
+        // No entry in the whole year: jump directly to the earliest entry
+        const entry_type* p_min = nullptr;
+        for (auto const& bucket : buckets_)
+        {
+            if (!bucket.empty() && (!p_min || bucket.back() < *p_min))
+            {
+                p_min = &bucket.back();
+            }
+        }
+
+        DCS_DEBUG_ASSERT( p_min );
+
+        move_to(p_min->fire_time);
+    }
+
+    void resize(std::size_t num_buckets)
+    {
+        scratch_.clear();
+        for (auto& bucket : buckets_)
+        {
+            scratch_.insert(scratch_.end(), bucket.begin(), bucket.end());
+            bucket.clear();
+        }
+
+        width_ = estimate_width();
+
+        buckets_.resize(num_buckets);
+        for (auto const& entry : scratch_)
+        {
+            insert(entry);
+        }
+
+        if (size_ > 0)
+        {
+            move_to(std::min_element(scratch_.begin(), scratch_.end())->fire_time);
+        }
+    }
+
+    /// Estimates the bucket width as three times the average separation of the earliest entries (see Brown, 1988)
+    RealT estimate_width()
+    {
+        const std::size_t n = std::min(width_sample_size, scratch_.size());
+
+        if (n < 2)
+        {
+            return width_;
+        }
+
+        std::partial_sort(scratch_.begin(), scratch_.begin()+n, scratch_.end());
+
+        const RealT avg_sep = (scratch_[n-1].fire_time-scratch_[0].fire_time)/(n-1);
+
+        // Recompute the average separation by discarding large separations
+        RealT sum_sep = 0;
+        std::size_t num_sep = 0;
+        for (std::size_t i = 1; i < n; ++i)
+        {
+            const RealT sep = scratch_[i].fire_time-scratch_[i-1].fire_time;
+            if (sep <= 2*avg_sep)
+            {
+                sum_sep += sep;
+                ++num_sep;
+            }
+        }
+
+        const RealT width = num_sep > 0 ? 3*sum_sep/num_sep : 0;
+
+        // Keep the old width if all the sampled entries have the same fire time
+        return width > 0 ? width : width_;
+    }
+
+
+private:
+    std::vector<std::vector<entry_type>> buckets_; ///< The buckets of the calendar
+    std::size_t size_; ///< The number of entries
+    RealT width_; ///< The time interval covered by each bucket
+    mutable std::size_t cur_bucket_; ///< The bucket at the current position of the calendar
+    mutable RealT cur_vbucket_; ///< The virtual bucket at the current position of the calendar
+    std::vector<entry_type> scratch_; ///< Buffer used to rehash entries when resizing
+}; // calendar_queue_event_list_t
+template <typename RealT>
+constexpr std::size_t calendar_queue_event_list_t<RealT>::min_num_buckets;
+template <typename RealT>
+constexpr std::size_t calendar_queue_event_list_t<RealT>::width_sample_size;
+
+}} // Namespace dcs::fog
+
+
+#endif // DCS_FOG_EVENT_LIST_CALENDAR_QUEUE_EVENT_LIST_HPP
@@ -0,0 +1,80 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fog/event_list/commons.hpp
+ *
+ * \brief Common definitions for future event lists.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FOG_EVENT_LIST_COMMONS_HPP
+#define DCS_FOG_EVENT_LIST_COMMONS_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace dcs { namespace fog {
+
+/**
+ * \brief An entry of the future event list.
+ *
+ * Entries only refer to the event they stand for (through the slot where the
+ * simulator stores it), so that event lists move small POD objects around.
+ * Entries with the same fire time are ordered by their insertion sequence
+ * number, which makes the order in which simultaneous events are fired
+ * deterministic and independent of the event list implementation.
+ */
+template <typename RealT>
+struct event_list_entry_t
+{
+    event_list_entry_t()
+    : fire_time(0),
+      seq(0),
+      slot(0)
+    {
+    }
+
+    event_list_entry_t(RealT fire_time, std::uint64_t seq, std::size_t slot)
+    : fire_time(fire_time),
+      seq(seq),
+      slot(slot)
+    {
+    }
+
+    RealT fire_time; ///< The time the event is fired
+    std::uint64_t seq; ///< The insertion sequence number (used to break ties)
+    std::size_t slot; ///< The slot of the event in the simulator's event pool
+}; // event_list_entry_t
+
+/// Tells if entry \a e1 must be fired before entry \a e2
+template <typename RealT>
+inline
+bool operator<(const event_list_entry_t<RealT>& e1, const event_list_entry_t<RealT>& e2)
+{
+    return e1.fire_time < e2.fire_time
+           || (e1.fire_time == e2.fire_time && e1.seq < e2.seq);
+}
+
+}} // Namespace dcs::fog
+
+
+#endif // DCS_FOG_EVENT_LIST_COMMONS_HPP
@@ -0,0 +1,174 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fog/event_list/dary_heap_event_list.hpp
+ *
+ * \brief Future event list based on an implicit d-ary heap.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FOG_EVENT_LIST_DARY_HEAP_EVENT_LIST_HPP
+#define DCS_FOG_EVENT_LIST_DARY_HEAP_EVENT_LIST_HPP
+
+
+#include <algorithm>
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <dcs/fog/event_list/commons.hpp>
+#include <utility>
+#include <vector>
+
+
+namespace dcs { namespace fog {
+
+/**
+ * \brief Future event list based on an implicit d-ary min-heap.
+ *
+ * Insertion and removal take O(log_D n) time. Compared to a binary heap, a
+ * larger arity makes the heap shallower and more cache friendly at the cost
+ * of more comparisons per level when sifting down.
+ *
+ * \tparam RealT The type of event fire times.
+ * \tparam D The arity of the heap (must be at least 2).
+ */
+template <typename RealT, std::size_t D = 4>
+class dary_heap_event_list_t
+{
+    static_assert(D >= 2, "The arity of the heap must be at least 2");
+
+
+public:
+    typedef event_list_entry_t<RealT> entry_type;
+
+
+public:
+    void push(const entry_type& entry)
+    {
+        heap_.push_back(entry);
+        sift_up(heap_.size()-1);
+    }
+
+    const entry_type& top() const
+    {
+        DCS_DEBUG_ASSERT( !heap_.empty() );
+
+        return heap_.front();
+    }
+
+    void pop()
+    {
+        DCS_DEBUG_ASSERT( !heap_.empty() );
+
+        heap_.front() = heap_.back();
+        heap_.pop_back();
+        if (!heap_.empty())
+        {
+            sift_down(0);
+        }
+    }
+
+    bool empty() const
+    {
+        return heap_.empty();
+    }
+
+    std::size_t size() const
+    {
+        return heap_.size();
+    }
+
+    void clear()
+    {
+        heap_.clear();
+    }
+
+
+private:
+    void sift_up(std::size_t i)
+    {
+        const entry_type entry = heap_[i];
+
+        while (i > 0)
+        {
+            const std::size_t parent = (i-1)/D;
+
+            if (!(entry < heap_[parent]))
+            {
+                break;
+            }
+
+            heap_[i] = heap_[parent];
+            i = parent;
+        }
+
+        heap_[i] = entry;
+    }
+
+    void sift_down(std::size_t i)
+    {
+        const std::size_t n = heap_.size();
+        const entry_type entry = heap_[i];
+
+        while (true)
+        {
+            const std::size_t first_child = i*D+1;
+
+            if (first_child >= n)
+            {
+                break;
+            }
+
+            // Find the smallest child
+            const std::size_t last_child = std::min(first_child+D, n);
+            std::size_t min_child = first_child;
+            for (std::size_t c = first_child+1; c < last_child; ++c)
+            {
+                if (heap_[c] < heap_[min_child])
+                {
+                    min_child = c;
+                }
+            }
+
+            if (!(heap_[min_child] < entry))
+            {
+                break;
+            }
+
+            heap_[i] = heap_[min_child];
+            i = min_child;
+        }
+
+        heap_[i] = entry;
+    }
+
+
+private:
+    std::vector<entry_type> heap_; ///< The heap, stored in level order
+}; // dary_heap_event_list_t
+
+
+/// Future event list based on an implicit binary min-heap
+template <typename RealT>
+using binary_heap_event_list_t = dary_heap_event_list_t<RealT, 2>;
+
+}} // Namespace dcs::fog
+
+
+#endif // DCS_FOG_EVENT_LIST_DARY_HEAP_EVENT_LIST_HPP
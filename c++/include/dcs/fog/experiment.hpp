@@ -31,7 +31,9 @@
 #include <algorithm>
 #include <array>
 #include <boost/smart_ptr.hpp>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <ctime>
 #include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
@@ -50,10 +52,10 @@
 #include <dcs/logging.hpp>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <initializer_list>
 #include <iostream>
 #include <limits>
-//#include <RndWalkPnt.hpp>
 #include <memory>
 #include <random>
 #include <sstream>
@@ -84,15 +86,126 @@ private:
 
     enum event_tag_t
     {
-        vm_allocation_trigger_event
+        vm_allocation_trigger_event,
+        request_arrival_event,
+        request_departure_event
     }; // event_tag_t
 
-    struct vm_allocation_trigger_event_state_t: public event_state_t
+    struct vm_allocation_trigger_event_state_t
     {
         RealT start_time = -1;
         RealT stop_time = -1;
     }; // vm_allocation_trigger_event_state_t
 
+    struct request_arrival_event_state_t
+    {
+        std::size_t svc = 0;
+        std::uint64_t epoch = 0; ///< The arrival process of the service the event belongs to
+    }; // request_arrival_event_state_t
+
+    struct request_departure_event_state_t
+    {
+        std::size_t svc = 0;
+        RealT arrival_time = 0;
+    }; // request_departure_event_state_t
+
+    /// Summary of the delays experienced by the requests of a service
+    struct request_delay_stats_t
+    {
+        RealT mean = std::numeric_limits<RealT>::quiet_NaN();
+        RealT p50 = std::numeric_limits<RealT>::quiet_NaN();
+        RealT p95 = std::numeric_limits<RealT>::quiet_NaN();
+        RealT p99 = std::numeric_limits<RealT>::quiet_NaN();
+        RealT rejection_ratio = std::numeric_limits<RealT>::quiet_NaN(); ///< The fraction of arrived requests rejected because the service had no VM
+    }; // request_delay_stats_t
+
+    /// Estimators of the delays experienced by the requests of a service
+    struct request_delay_estimators_t
+    {
+        request_delay_estimators_t()
+        : p50(0.50),
+          p95(0.95),
+          p99(0.99)
+        {
+        }
+
+        void collect(RealT delay)
+        {
+            mean.collect(delay);
+            p50.collect(delay);
+            p95.collect(delay);
+            p99.collect(delay);
+        }
+
+        void collect_arrival()
+        {
+            ++num_arrivals;
+        }
+
+        void collect_rejections(std::size_t n)
+        {
+            num_rejected += n;
+        }
+
+        void reset()
+        {
+            mean.reset();
+            p50.reset();
+            p95.reset();
+            p99.reset();
+            num_arrivals = 0;
+            num_rejected = 0;
+        }
+
+        request_delay_stats_t stats() const
+        {
+            request_delay_stats_t s;
+
+            if (mean.size() > 0)
+            {
+                s.mean = mean.estimate();
+                s.p50 = p50.estimate();
+                s.p95 = p95.estimate();
+                s.p99 = p99.estimate();
+            }
+            if (num_arrivals > 0)
+            {
+                s.rejection_ratio = static_cast<RealT>(num_rejected)/static_cast<RealT>(num_arrivals);
+            }
+
+            return s;
+        }
+
+        mean_estimator_t<RealT> mean;
+        p2_quantile_estimator_t<RealT> p50;
+        p2_quantile_estimator_t<RealT> p95;
+        p2_quantile_estimator_t<RealT> p99;
+        std::size_t num_arrivals = 0; ///< The number of arrived requests
+        std::size_t num_rejected = 0; ///< The number of arrived requests that have been rejected
+    }; // request_delay_estimators_t
+
+    /// State of a service in the request-level simulation
+    struct svc_request_state_t
+    {
+        void reset()
+        {
+            queue.num_servers(0);
+            queue.clear();
+            arrival_rate = 0;
+            service_rate = 0;
+            epoch = 0;
+            interval_delays.reset();
+            rep_delays.reset();
+        }
+
+        fcfs_multiserver_queue_t<RealT> queue; ///< The VMs allocated to the service and the requests waiting for them
+        RealT arrival_rate = 0; ///< The current request arrival rate
+        RealT service_rate = 0; ///< The service rate of every allocated VM
+        std::uint64_t epoch = 0; ///< Incremented every time the arrival process changes, to discard arrivals scheduled by the previous one
+        request_delay_estimators_t interval_delays; ///< Delays of the requests departed in the current interval
+        request_delay_estimators_t rep_delays; ///< Delays of the requests departed in the current replication
+    }; // svc_request_state_t
+
     static const char csv_field_quote_ch = '"';
     static const char csv_field_sep_ch = ',';
     static constexpr const char* csv_field_na_value = "NA";
@@ -115,10 +228,6 @@ private:
     static constexpr std::size_t default_num_fns = 0;
     static constexpr std::size_t default_num_svcs = 0;
 
-    //static constexpr std::size_t rwp_num_args = 3;
-    //static constexpr const char* rwp_py_module = "rndWayPoint";
-    //static constexpr const char* rwp_py_function = "nextPlease";
-
 public:
     experiment_t()
     : num_fn_categories_(default_num_fn_categories),
@@ -130,6 +239,7 @@ public:
       ci_level_(default_ci_level),
       ci_rel_precision_(default_ci_rel_precision),
       service_delay_tolerance_(default_service_delay_tolerance),
+      req_level_sim_(false),
       verbosity_(default_verbosity),
       svc_arr_rate_estimation_(default_svc_arr_rate_estimation),
       //fp_revenue_policy_(by_vm_revenue_policy),
@@ -137,94 +247,18 @@ public:
       //fp_penalty_model_(distance_penalty_model),
       fp_vm_allocation_interval_(default_fp_vm_allocation_interval),
       num_fns_(default_num_fns),
-      num_svcs_(default_num_svcs)
+      num_svcs_(default_num_svcs),
+      replica_(false),
+      rep_seed_base_(0)
     {
-////FIXME Uncomment and updates this below when all works
-//#if 1
-//        // Initialize Python script for the mobility model
-//        // - Prepare the arguments (i.e., module and file names)
-//# if 1 //FIXME: enable the code fragment below to use std:array instead of plain char**
-//        std::size_t sz = 0;
-//        // arg 0: not used
-//        rwp_args_[0] = 0;
-//        // arg 1: module name
-//        sz = std::strlen(rwp_py_module)+1;
-//        rwp_args_[1] = new char[sz];
-//        std::strncpy(rwp_args_[1], rwp_py_module, sz);
-//        // arg 2: function name
-//        sz = std::strlen(rwp_py_function)+1;
-//        rwp_args_[2] = new char[sz];
-//        std::strncpy(rwp_args_[2], rwp_py_function, sz);
-//        // sanity check
-//        DCS_DEBUG_ASSERT( rwp_num_args == rwp_args_.size() );
-//        // - Setup
-//        rwp_.setup(rwp_args_.size(), rwp_args_.data());
-//# else
-//        rwp_args_ = new char*[rwp_num_args];
-//        std::size_t sz = 0;
-//        // arg 0: not used
-//        rwp_args_[0] = 0;
-//        // arg 1: module name
-//        sz = std::strlen(rwp_py_module)+1;
-//        rwp_args_[1] = new char[sz];
-//        std::strncpy(rwp_args_[1], rwp_py_module, sz);
-//        // arg 2: function name
-//        sz = std::strlen(rwp_py_function)+1;
-//        rwp_args_[2] = new char[sz];
-//        std::strncpy(rwp_args_[2], rwp_py_function, sz);
-//        // - Setup
-//        rwp_.setup(rwp_num_args, rwp_args_);
-//# endif
-//#endif
-//#if 0//XXX: this below is just for testing
-//        char *argv[3];
-//        argv[0] = 0;  // What value?
-//        argv[1] = strdup("rndWayPoint"); //FIXME: memleak
-//        argv[2] = strdup("nextPlease"); //FIXME: memleak
-//        //char *argv[4];
-//        //argv[0] = 0; // What value?
-//        //argv[1] = strdup("rndWayPoint"); //FIXME: memleak
-//        //argv[2] = strdup("nextPlease"); //FIXME: memleak
-//        //argv[3] = strdup("/home/sguazt/Projects/src/fog-vmalloc/python/config.ini"); //FIXME: memleak
-//        //rwp_.setup(sizeof argv/sizeof argv[0], argv);
-//        //FIXME: mettere il file config.ini nella stessa dir da cui si lancia l'app
-//#endif
     }
 
-//    ~experiment_t()
-//    {
-////FIXME Uncomment and updates this below when all works
-//#if 1
-//        rwp_.dismiss();
-//# if 1 //FIXME: enable the code fragment below to use std:array instead of plain char**
-//        for (std::size_t i = 0; i < rwp_args_.size(); ++i)
-//        {
-//            if (rwp_args_[i])
-//            {
-//                delete[] rwp_args_[i];
-//                rwp_args_[i] = 0;
-//            }
-//        }
-//# else
-//        for (std::size_t i = 0; i < rwp_num_args; ++i)
-//        {
-//            if (rwp_args_[i])
-//            {
-//                delete[] rwp_args_[i];
-//                rwp_args_[i] = 0;
-//            }
-//        }
-//        delete[] rwp_args_;
-//# endif
-//#endif
-//    }
-
     void random_number_generator(random_number_engine_t& rng)
     {
         rng_ = rng;
     }
 
-    random_number_engine_t& random_number_generator() const
+    const random_number_engine_t& random_number_generator() const
     {
         return rng_;
     }
@@ -733,6 +767,27 @@ public:
         return service_delay_tolerance_;
     }
 
+    /**
+     * \brief Enables the request-level simulation of services.
+     *
+     * In addition to the delays given by the M/M/c performance model, every
+     * service is simulated as a FCFS queue served by the VMs allocated to it,
+     * where individual requests arrive (according to a Poisson process) and
+     * depart. The allocation computed at the end of an interval is applied in
+     * the next one, with the arrival rate observed in the last interval.
+     * Delays of requests (mean and percentiles) are then reported for every
+     * interval and replication.
+     */
+    void request_level_simulation(bool value)
+    {
+        req_level_sim_ = value;
+    }
+
+    bool request_level_simulation() const
+    {
+        return req_level_sim_;
+    }
+
     void verbosity_level(int value)
     {
         verbosity_ = value;
@@ -824,6 +879,26 @@ public:
         return p_mob_model_;
     }
 
+    /**
+     * \brief Sets the area where the users of each service are located.
+     *
+     * When set, the user mobility model is advanced once per interval and
+     * the number of users of a service is the number of users inside the
+     * area of that service. Otherwise, the user mobility model is advanced
+     * once per service and the number of users of a service is the one
+     * returned by the model for that step.
+     */
+    template <typename IterT>
+    void user_mobility_areas(IterT first, IterT last)
+    {
+        svc_user_mobility_areas_.assign(first, last);
+    }
+
+    std::vector<rectangular_area_t> user_mobility_areas() const
+    {
+        return svc_user_mobility_areas_;
+    }
+
     void vm_allocation_solver(const std::shared_ptr<base_vm_allocation_solver_t<RealT>>& p_solver)
     {
         p_vm_alloc_solver_ = p_solver;
@@ -846,6 +921,63 @@ public:
 
 
 private:
+    /// Makes a replica of the given experiment that runs the given replication with its own random number stream
+    experiment_t(const experiment_t& that, std::size_t replication)
+    : base_type(that),
+      num_fn_categories_(that.num_fn_categories_),
+      num_svc_categories_(that.num_svc_categories_),
+      num_vm_categories_(that.num_vm_categories_),
+      svc_arr_rates_(that.svc_arr_rates_),
+      svc_max_arr_rates_(that.svc_max_arr_rates_),
+      svc_max_delays_(that.svc_max_delays_),
+      svc_vm_service_rates_(that.svc_vm_service_rates_),
+      fp_num_svcs_(that.fp_num_svcs_),
+      fp_num_fns_(that.fp_num_fns_),
+      fp_electricity_costs_(that.fp_electricity_costs_),
+      fp_svc_revenues_(that.fp_svc_revenues_),
+      fp_svc_penalties_(that.fp_svc_penalties_),
+      fp_fn_asleep_costs_(that.fp_fn_asleep_costs_),
+      fp_fn_awake_costs_(that.fp_fn_awake_costs_),
+      fn_min_powers_(that.fn_min_powers_),
+      fn_max_powers_(that.fn_max_powers_),
+      vm_cpu_requirements_(that.vm_cpu_requirements_),
+      vm_ram_requirements_(that.vm_ram_requirements_),
+      vm_cat_alloc_costs_(that.vm_cat_alloc_costs_),
+      optim_relative_tolerance_(that.optim_relative_tolerance_),
+      optim_time_limit_(that.optim_time_limit_),
+      output_stats_data_file_(that.output_stats_data_file_),
+      output_trace_data_file_(that.output_trace_data_file_),
+      ci_level_(that.ci_level_),
+      ci_rel_precision_(that.ci_rel_precision_),
+      service_delay_tolerance_(that.service_delay_tolerance_),
+      req_level_sim_(that.req_level_sim_),
+      verbosity_(that.verbosity_),
+      svc_arr_rate_estimation_(that.svc_arr_rate_estimation_),
+      svc_arr_rate_estimation_params_(that.svc_arr_rate_estimation_params_),
+      fp_vm_allocation_interval_(that.fp_vm_allocation_interval_),
+      num_fns_(that.num_fns_),
+      num_svcs_(that.num_svcs_),
+      fn_categories_(that.fn_categories_),
+      svc_categories_(that.svc_categories_),
+      initial_fn_power_states_(that.initial_fn_power_states_),
+      initial_fn_vm_allocations_(that.initial_fn_vm_allocations_),
+      replica_(true),
+      rep_seed_base_(that.rep_seed_base_),
+      p_mob_model_(that.p_mob_model_),
+      svc_user_mobility_areas_(that.svc_user_mobility_areas_),
+      svc_perf_model_(that.svc_perf_model_),
+      p_vm_alloc_solver_(that.p_vm_alloc_solver_),
+      p_multislot_vm_alloc_solver_(that.p_multislot_vm_alloc_solver_)
+    {
+        // Derive an independent random number stream from the base seed and the replication number,
+        // so that results do not depend on the number of threads nor on the order replicas are run
+        std::seed_seq seq{rep_seed_base_, static_cast<random_number_engine_t::result_type>(replication)};
+        rng_.seed(seq);
+
+        // Estimators keep a reference to the random number generator, so they cannot be shared with the parent experiment
+        make_arrival_rate_estimators();
+    }
+
     template <typename IterT>
     static bool check_stats(IterT first, IterT last)
     {
@@ -862,52 +994,8 @@ private:
         return true;
     }
 
-    void do_initialize_simulation()
+    void make_arrival_rate_estimators()
     {
-        // Fills FN data structures and compute the total number of FNs
-        num_fns_ = 0;
-        fn_categories_.clear();
-        for (std::size_t fnc = 0; fnc < num_fn_categories_; ++fnc)
-        {
-            const std::size_t nfns = fp_num_fns_[fnc];
-
-            for (std::size_t i = 0; i < nfns; ++i)
-            {
-                fn_categories_.push_back(fnc);
-            }
-
-            num_fns_ += nfns;
-        }
-        initial_fn_power_states_.resize(num_fns_, false); //FIXME: currently the initial FN power status is always set to "powered-off"
-
-        // Fills service data structures and computes the total number of services
-        num_svcs_ = 0;
-        svc_categories_.clear();
-        for (std::size_t svc_cat = 0; svc_cat < num_svc_categories_; ++svc_cat)
-        {
-            const std::size_t nsvcs = fp_num_svcs_[svc_cat];
-
-            for (std::size_t i = 0; i < nsvcs; ++i)
-            {
-                svc_categories_.push_back(svc_cat);
-            }
-
-            num_svcs_ += nsvcs;
-        }
-        if (svc_arr_rates_.size() < num_svc_categories_)
-        {
-            svc_arr_rates_.resize(num_svc_categories_, std::numeric_limits<RealT>::infinity());
-        }
-        if (svc_max_arr_rates_.size() < num_svc_categories_)
-        {
-            svc_max_arr_rates_.resize(num_svc_categories_, std::numeric_limits<RealT>::infinity());
-        }
-        if (svc_max_delays_.size() < num_svc_categories_)
-        {
-            svc_max_delays_.resize(num_svc_categories_, std::numeric_limits<RealT>::infinity());
-        }
-
-        // Reset arrival rate estimators
         svc_arr_rate_estimators_.resize(num_svcs_);
         for (std::size_t svc = 0; svc < num_svcs_; ++svc)
         {
@@ -957,6 +1045,68 @@ private:
                     break;
             }
         }
+    }
+
+    void do_initialize_simulation()
+    {
+        // Fills FN data structures and compute the total number of FNs
+        num_fns_ = 0;
+        fn_categories_.clear();
+        for (std::size_t fnc = 0; fnc < num_fn_categories_; ++fnc)
+        {
+            const std::size_t nfns = fp_num_fns_[fnc];
+
+            for (std::size_t i = 0; i < nfns; ++i)
+            {
+                fn_categories_.push_back(fnc);
+            }
+
+            num_fns_ += nfns;
+        }
+        initial_fn_power_states_.resize(num_fns_, false); //FIXME: currently the initial FN power status is always set to "powered-off"
+
+        // Fills service data structures and computes the total number of services
+        num_svcs_ = 0;
+        svc_categories_.clear();
+        for (std::size_t svc_cat = 0; svc_cat < num_svc_categories_; ++svc_cat)
+        {
+            const std::size_t nsvcs = fp_num_svcs_[svc_cat];
+
+            for (std::size_t i = 0; i < nsvcs; ++i)
+            {
+                svc_categories_.push_back(svc_cat);
+            }
+
+            num_svcs_ += nsvcs;
+        }
+        if (svc_arr_rates_.size() < num_svc_categories_)
+        {
+            svc_arr_rates_.resize(num_svc_categories_, std::numeric_limits<RealT>::infinity());
+        }
+        if (svc_max_arr_rates_.size() < num_svc_categories_)
+        {
+            svc_max_arr_rates_.resize(num_svc_categories_, std::numeric_limits<RealT>::infinity());
+        }
+        if (svc_max_delays_.size() < num_svc_categories_)
+        {
+            svc_max_delays_.resize(num_svc_categories_, std::numeric_limits<RealT>::infinity());
+        }
+        if (!svc_user_mobility_areas_.empty() && svc_user_mobility_areas_.size() != num_svcs_)
+        {
+            DCS_EXCEPTION_THROW( std::invalid_argument, "The number of user mobility areas must be equal to the number of services" );
+        }
+
+        // Reset arrival rate estimators
+        make_arrival_rate_estimators();
+
+        // Draw the base seed of the random number streams used by replicas
+        // and by the user mobility model of each replication (only when
+        // needed, so that the sequential random number sequence stays
+        // untouched otherwise)
+        if (this->num_threads() > 1 || p_mob_model_)
+        {
+            rep_seed_base_ = rng_();
+        }
 
         initial_fn_vm_allocations_.resize(num_fns_); //FIXME: currently the initial VM allocation is always set to "no allocation"
 
@@ -1078,6 +1228,12 @@ private:
                             << csv_field_sep_ch << csv_field_quote_ch << "Simulation - Global VM Alloc - FP - S.D. Predicted #FNs" << csv_field_quote_ch;
             stats_dat_ofs_  << csv_field_sep_ch << csv_field_quote_ch << "Simulation - Global VM Alloc - FP - Mean Real #FNs" << csv_field_quote_ch
                             << csv_field_sep_ch << csv_field_quote_ch << "Simulation - Global VM Alloc - FP - S.D. Real #FNs" << csv_field_quote_ch;
+            if (req_level_sim_)
+            {
+                // Headers for request-level stats
+                output_request_delay_stats_headers(stats_dat_ofs_, "Interval");
+                output_request_delay_stats_headers(stats_dat_ofs_, "Replication");
+            }
             stats_dat_ofs_ << std::endl;
         }
 
@@ -1103,6 +1259,13 @@ private:
             }
             trace_dat_ofs_  << csv_field_sep_ch << csv_field_quote_ch << "FP - Predicted #FNs" << csv_field_quote_ch;
             trace_dat_ofs_  << csv_field_sep_ch << csv_field_quote_ch << "FP - Real #FNs" << csv_field_quote_ch;
+            trace_dat_ofs_  << csv_field_sep_ch << csv_field_quote_ch << "FP - Predicted Solve Time" << csv_field_quote_ch
+                            << csv_field_sep_ch << csv_field_quote_ch << "FP - Predicted Time to First Incumbent" << csv_field_quote_ch
+                            << csv_field_sep_ch << csv_field_quote_ch << "FP - Predicted Gap" << csv_field_quote_ch;
+            trace_dat_ofs_  << csv_field_sep_ch << csv_field_quote_ch << "FP - Real Solve Time" << csv_field_quote_ch
+                            << csv_field_sep_ch << csv_field_quote_ch << "FP - Real Time to First Incumbent" << csv_field_quote_ch
+                            << csv_field_sep_ch << csv_field_quote_ch << "FP - Real Gap" << csv_field_quote_ch;
+            trace_dat_ofs_  << csv_field_sep_ch << csv_field_quote_ch << "FP - Predicted+Real Solve Wall Time" << csv_field_quote_ch;
             trace_dat_ofs_ << std::endl;
          }
     }
@@ -1178,6 +1341,12 @@ private:
                             << csv_field_sep_ch << global_fp_pred_num_fns_ci_stats_->standard_deviation(); // Global predicted #FNs (s.d.)
             stats_dat_ofs_  << csv_field_sep_ch << global_fp_real_num_fns_ci_stats_->estimate() // Global predicted #FNs (mean)
                             << csv_field_sep_ch << global_fp_real_num_fns_ci_stats_->standard_deviation(); // Global predicted #FNs (s.d.)
+            if (req_level_sim_)
+            {
+                // Output request-level stats as NA since they are only available at interval and replication granularity
+                output_request_delay_stats(stats_dat_ofs_, std::vector<request_delay_stats_t>());
+                output_request_delay_stats(stats_dat_ofs_, std::vector<request_delay_stats_t>());
+            }
             stats_dat_ofs_ << std::endl;
         }
 
@@ -1226,6 +1395,16 @@ private:
         // Initialize VM allocation
         rep_fn_vm_allocations_.assign(initial_fn_vm_allocations_.begin(), initial_fn_vm_allocations_.end());
 
+        // Restart the user mobility model from a fresh copy with its own random number stream,
+        // so that each replication sees the same users whether replications run sequentially or in parallel
+        if (p_mob_model_)
+        {
+            p_rep_mob_model_.reset(p_mob_model_->clone());
+
+            std::seed_seq mob_seq{rep_seed_base_, static_cast<random_number_engine_t::result_type>(this->num_replications()), static_cast<random_number_engine_t::result_type>(1)}; // Use a stream other than the one of rng_
+            p_rep_mob_model_->seed(mob_seq);
+        }
+
         // Initialize members used for the global VM allocation
         rep_global_vm_alloc_duration_ = 0;
         rep_global_vm_alloc_interval_num_ = 0;
@@ -1267,20 +1446,82 @@ private:
         rep_global_fp_pred_num_fns_->name("GlobalPredNumFNs");
         rep_global_fp_real_num_fns_ = std::make_shared<mean_estimator_t<RealT>>();
         rep_global_fp_real_num_fns_->name("GlobalRealNumFNs");
+        // - Request-level simulation
+        if (req_level_sim_)
+        {
+            rep_svc_req_states_.resize(num_svcs_);
+            for (auto& svc_req : rep_svc_req_states_)
+            {
+                svc_req.reset();
+            }
+        }
+        rep_svc_req_delays_.clear();
 
 
         // Schedule initial events
 
-        auto p_state = std::make_shared<vm_allocation_trigger_event_state_t>();
-        p_state->start_time = this->simulated_time();
-        p_state->stop_time = this->simulated_time() + fp_vm_allocation_interval_;
-        this->schedule_event(p_state->stop_time, vm_allocation_trigger_event, p_state);
+        vm_allocation_trigger_event_state_t state;
+        state.start_time = this->simulated_time();
+        state.stop_time = this->simulated_time() + fp_vm_allocation_interval_;
+        this->schedule_event(state.stop_time, vm_allocation_trigger_event, state);
     }
 
     void do_finalize_replication()
     {
         global_allocate_vms();
 
+        if (req_level_sim_)
+        {
+            rep_svc_req_delays_.resize(num_svcs_);
+            for (std::size_t svc = 0; svc < num_svcs_; ++svc)
+            {
+                rep_svc_req_delays_[svc] = rep_svc_req_states_[svc].rep_delays.stats();
+            }
+        }
+
+        // Stats of replicas are collected by the parent experiment when the replica is merged
+        if (!replica_)
+        {
+            collect_replication_stats();
+        }
+    }
+
+    std::unique_ptr<base_type> do_make_replica(std::size_t replication) const
+    {
+        return std::unique_ptr<base_type>(new experiment_t<RealT>(*this, replication));
+    }
+
+    void do_merge_replica(base_type& replica)
+    {
+        experiment_t<RealT>& exp = dynamic_cast<experiment_t<RealT>&>(replica);
+
+        // Output the interval stats and trace buffered by the replica
+        if (stats_dat_ofs_.is_open())
+        {
+            stats_dat_ofs_ << exp.rep_stats_oss_.str();
+        }
+        if (trace_dat_ofs_.is_open())
+        {
+            trace_dat_ofs_ << exp.rep_trace_oss_.str();
+        }
+
+        rep_fp_pred_profits_ = exp.rep_fp_pred_profits_;
+        rep_fp_real_profits_ = exp.rep_fp_real_profits_;
+        rep_fp_pred_num_fns_ = exp.rep_fp_pred_num_fns_;
+        rep_fp_real_num_fns_ = exp.rep_fp_real_num_fns_;
+        rep_svc_pred_delays_ = exp.rep_svc_pred_delays_;
+        rep_svc_real_delays_ = exp.rep_svc_real_delays_;
+        rep_global_fp_pred_profits_ = exp.rep_global_fp_pred_profits_;
+        rep_global_fp_pred_num_fns_ = exp.rep_global_fp_pred_num_fns_;
+        rep_global_fp_real_profits_ = exp.rep_global_fp_real_profits_;
+        rep_global_fp_real_num_fns_ = exp.rep_global_fp_real_num_fns_;
+        rep_svc_req_delays_ = exp.rep_svc_req_delays_;
+
+        collect_replication_stats();
+    }
+
+    void collect_replication_stats()
+    {
         auto const cur_timestamp = std::time(nullptr);
 
         // Collect stats
@@ -1336,6 +1577,12 @@ private:
                     DCS_LOGGING_STREAM << rep_svc_real_delays_[svc]->estimate();
                 }
                 DCS_LOGGING_STREAM << "}" << std::endl;
+                if (req_level_sim_)
+                {
+                    DCS_LOGGING_STREAM << "   - Total Request-Level Delays (mean, p50, p95, p99, rejection ratio): ";
+                    output_request_delay_stats_summary(DCS_LOGGING_STREAM, rep_svc_req_delays_);
+                    DCS_LOGGING_STREAM << std::endl;
+                }
                 DCS_LOGGING_STREAM << "  - Global VM allocation: " << std::endl;
                 DCS_LOGGING_STREAM << "   - Total Predicted Profits: " << rep_global_fp_pred_profits_ << std::endl;
                 DCS_LOGGING_STREAM << "   - Total Real Profits: " << rep_global_fp_real_profits_ << std::endl;
@@ -1432,6 +1679,12 @@ private:
                             << csv_field_sep_ch << global_fp_pred_num_fns_ci_stats_->standard_deviation(); // Global predicted #FNs (s.d.)
             stats_dat_ofs_  << csv_field_sep_ch << global_fp_real_num_fns_ci_stats_->estimate() // Global real #FNs (mean)
                             << csv_field_sep_ch << global_fp_real_num_fns_ci_stats_->standard_deviation(); // Global real #FNs (s.d.)
+            if (req_level_sim_)
+            {
+                // Output request-level stats (interval stats are not available at this point)
+                output_request_delay_stats(stats_dat_ofs_, std::vector<request_delay_stats_t>());
+                output_request_delay_stats(stats_dat_ofs_, rep_svc_req_delays_);
+            }
             stats_dat_ofs_ << std::endl;
         }
     }
@@ -1450,43 +1703,233 @@ private:
     }
 
 
-    void do_process_event(const std::shared_ptr<event_t<RealT>>& p_event)
+    void do_process_event(const event_t<RealT>& event)
     {
-        switch (p_event->tag)
+        switch (event.tag)
         {
             case vm_allocation_trigger_event:
-                this->process_vm_allocation_trigger_event(p_event);
+                this->process_vm_allocation_trigger_event(event);
+                break;
+            case request_arrival_event:
+                this->process_request_arrival_event(event);
+                break;
+            case request_departure_event:
+                this->process_request_departure_event(event);
                 break;
             default:
-                dcs::log_warn(DCS_LOGGING_AT, "Unable to process events with tag " + stringify(p_event->tag));
+                dcs::log_warn(DCS_LOGGING_AT, "Unable to process events with tag " + stringify(event.tag));
                 break;
         }
     }
 
-    void process_vm_allocation_trigger_event(const std::shared_ptr<event_t<RealT>>& p_event)
+    void process_vm_allocation_trigger_event(const event_t<RealT>& event)
     {
-        // check: event is available
-        DCS_ASSERT(p_event,
-                   DCS_EXCEPTION_THROW(std::invalid_argument, "Event is not available"));
+        // check: event tag
+        DCS_DEBUG_ASSERT( event.tag == vm_allocation_trigger_event );
 
-        auto p_state = std::dynamic_pointer_cast<vm_allocation_trigger_event_state_t>(p_event->p_state);
-        // check: down-cast OK
-        DCS_DEBUG_ASSERT( p_state );
+        auto state = event.template state<vm_allocation_trigger_event_state_t>();
 
-        DCS_DEBUG_TRACE("Processing 'VM_ALLOCATION_TRIGGER' event - start: " << p_state->start_time << ", stop: " << p_state->stop_time << " (time: " << this->simulated_time() << ")");
+        DCS_DEBUG_TRACE("Processing 'VM_ALLOCATION_TRIGGER' event - start: " << state.start_time << ", stop: " << state.stop_time << " (time: " << this->simulated_time() << ")");
 
-        this->allocate_vms(*p_state);
+        this->allocate_vms(state);
 
         // Schedule a new VM allocation trigger event
 
-        p_state = std::make_shared<vm_allocation_trigger_event_state_t>();
-        p_state->start_time = this->simulated_time();
-        p_state->stop_time = this->simulated_time() + fp_vm_allocation_interval_;
-        this->schedule_event(p_state->stop_time, vm_allocation_trigger_event, p_state);
+        state.start_time = this->simulated_time();
+        state.stop_time = this->simulated_time() + fp_vm_allocation_interval_;
+        this->schedule_event(state.stop_time, vm_allocation_trigger_event, state);
 
         ++rep_global_vm_alloc_interval_num_;
     }
 
+    void process_request_arrival_event(const event_t<RealT>& event)
+    {
+        // check: event tag
+        DCS_DEBUG_ASSERT( event.tag == request_arrival_event );
+
+        auto const state = event.template state<request_arrival_event_state_t>();
+        auto& svc_req = rep_svc_req_states_[state.svc];
+
+        if (state.epoch != svc_req.epoch)
+        {
+            // This arrival has been scheduled by a previous arrival process
+            return;
+        }
+
+        svc_req.interval_delays.collect_arrival();
+        svc_req.rep_delays.collect_arrival();
+
+        if (svc_req.queue.num_servers() == 0)
+        {
+            // The service has no VM: the request is lost
+            svc_req.interval_delays.collect_rejections(1);
+            svc_req.rep_delays.collect_rejections(1);
+        }
+        else if (svc_req.queue.arrive(this->simulated_time()))
+        {
+            this->schedule_request_departure(state.svc, this->simulated_time());
+        }
+
+        this->schedule_request_arrival(state.svc);
+    }
+
+    void process_request_departure_event(const event_t<RealT>& event)
+    {
+        // check: event tag
+        DCS_DEBUG_ASSERT( event.tag == request_departure_event );
+
+        auto const state = event.template state<request_departure_event_state_t>();
+        auto& svc_req = rep_svc_req_states_[state.svc];
+
+        auto const delay = this->simulated_time() - state.arrival_time;
+        svc_req.interval_delays.collect(delay);
+        svc_req.rep_delays.collect(delay);
+
+        RealT arrival_time = 0;
+        if (svc_req.queue.depart(arrival_time))
+        {
+            this->schedule_request_departure(state.svc, arrival_time);
+        }
+    }
+
+    void schedule_request_arrival(std::size_t svc)
+    {
+        auto const& svc_req = rep_svc_req_states_[svc];
+
+        std::exponential_distribution<RealT> interarrival_time_rvg(svc_req.arrival_rate);
+
+        request_arrival_event_state_t state;
+        state.svc = svc;
+        state.epoch = svc_req.epoch;
+        this->schedule_event(this->simulated_time() + interarrival_time_rvg(rng_), request_arrival_event, state);
+    }
+
+    /// Schedules the departure of a request of the given service that enters service now
+    void schedule_request_departure(std::size_t svc, RealT arrival_time)
+    {
+        auto const& svc_req = rep_svc_req_states_[svc];
+
+        std::exponential_distribution<RealT> service_time_rvg(svc_req.service_rate);
+
+        request_departure_event_state_t state;
+        state.svc = svc;
+        state.arrival_time = arrival_time;
+        this->schedule_event(this->simulated_time() + service_time_rvg(rng_), request_departure_event, state);
+    }
+
+    /**
+     * \brief Starts a new interval of the request-level simulation.
+     *
+     * Returns the delays of the requests departed in the interval just ended
+     * and applies the VM allocation currently in force and the given arrival
+     * rates to the next interval.
+     */
+    std::vector<request_delay_stats_t> update_request_level_services(const std::vector<RealT>& svc_arr_rates)
+    {
+        std::vector<request_delay_stats_t> svc_delays(num_svcs_);
+
+        // Find out what VM category and how many VMs of that category are allocated to each service
+        std::vector<std::pair<std::size_t,std::size_t>> svc_allocs(num_svcs_, std::make_pair(0,0));
+        for (auto const& svc_map : rep_fn_vm_allocations_)
+        {
+            for (auto const& svc_vms : svc_map)
+            {
+                auto& svc_alloc = svc_allocs[svc_vms.first];
+
+                svc_alloc.first = svc_vms.second.first; // NOTE: all VMs allocated to the same service belong to the same category
+                svc_alloc.second += svc_vms.second.second;
+            }
+        }
+
+        for (std::size_t svc = 0; svc < num_svcs_; ++svc)
+        {
+            auto const svc_cat = svc_categories_[svc];
+            auto& svc_req = rep_svc_req_states_[svc];
+
+            svc_delays[svc] = svc_req.interval_delays.stats();
+            svc_req.interval_delays.reset();
+
+            svc_req.queue.num_servers(svc_allocs[svc].second);
+            svc_req.service_rate = svc_vm_service_rates_[svc_cat][svc_allocs[svc].first];
+            svc_req.arrival_rate = svc_arr_rates[svc];
+
+            if (svc_req.queue.num_servers() == 0)
+            {
+                // The service has lost all its VMs: waiting requests are lost too
+                auto const num_dropped = svc_req.queue.drop_waiting();
+                svc_req.interval_delays.collect_rejections(num_dropped);
+                svc_req.rep_delays.collect_rejections(num_dropped);
+            }
+
+            // Waiting requests enter service on newly allocated VMs, if any
+            RealT arrival_time = 0;
+            while (svc_req.queue.start_next(arrival_time))
+            {
+                this->schedule_request_departure(svc, arrival_time);
+            }
+
+            // Replace the arrival process (requests of services without VMs are generated too, and counted as rejected)
+            ++svc_req.epoch;
+            if (svc_req.arrival_rate > 0)
+            {
+                this->schedule_request_arrival(svc);
+            }
+        }
+
+        return svc_delays;
+    }
+
+    void output_request_delay_stats_headers(std::ostream& os, const std::string& scope) const
+    {
+        for (std::size_t svc = 0; svc < num_svcs_; ++svc)
+        {
+            os  << csv_field_sep_ch << csv_field_quote_ch << scope << " - Request-Level - Service " << svc << " - Mean Delay" << csv_field_quote_ch
+                << csv_field_sep_ch << csv_field_quote_ch << scope << " - Request-Level - Service " << svc << " - 50th Percentile Delay" << csv_field_quote_ch
+                << csv_field_sep_ch << csv_field_quote_ch << scope << " - Request-Level - Service " << svc << " - 95th Percentile Delay" << csv_field_quote_ch
+                << csv_field_sep_ch << csv_field_quote_ch << scope << " - Request-Level - Service " << svc << " - 99th Percentile Delay" << csv_field_quote_ch
+                << csv_field_sep_ch << csv_field_quote_ch << scope << " - Request-Level - Service " << svc << " - Rejection Ratio" << csv_field_quote_ch;
+        }
+    }
+
+    /// Outputs the given request-level delays as CSV fields (NA if not available)
+    void output_request_delay_stats(std::ostream& os, const std::vector<request_delay_stats_t>& svc_delays) const
+    {
+        for (std::size_t svc = 0; svc < num_svcs_; ++svc)
+        {
+            if (svc < svc_delays.size())
+            {
+                os  << csv_field_sep_ch << svc_delays[svc].mean
+                    << csv_field_sep_ch << svc_delays[svc].p50
+                    << csv_field_sep_ch << svc_delays[svc].p95
+                    << csv_field_sep_ch << svc_delays[svc].p99
+                    << csv_field_sep_ch << svc_delays[svc].rejection_ratio;
+            }
+            else
+            {
+                os  << csv_field_sep_ch << csv_field_na_value
+                    << csv_field_sep_ch << csv_field_na_value
+                    << csv_field_sep_ch << csv_field_na_value
+                    << csv_field_sep_ch << csv_field_na_value
+                    << csv_field_sep_ch << csv_field_na_value;
+            }
+        }
+    }
+
+    void output_request_delay_stats_summary(std::ostream& os, const std::vector<request_delay_stats_t>& svc_delays) const
+    {
+        os << "[" << svc_delays.size() << "]{";
+        for (std::size_t svc = 0; svc < svc_delays.size(); ++svc)
+        {
+            if (svc > 0)
+            {
+                os << ",";
+            }
+
+            os << "<" << svc_delays[svc].mean << "," << svc_delays[svc].p50 << "," << svc_delays[svc].p95 << "," << svc_delays[svc].p99 << "," << svc_delays[svc].rejection_ratio << ">";
+        }
+        os << "}";
+    }
+
     void allocate_vms(const vm_allocation_trigger_event_state_t& vm_alloc_state)
     {
         auto const cur_timestamp = std::time(nullptr);
@@ -1511,13 +1954,20 @@ private:
         rep_global_svc_vm_cat_predicted_min_num_vms_[rep_global_vm_alloc_interval_num_].resize(num_svcs_);
         rep_global_svc_vm_cat_real_min_num_vms_.resize(rep_global_svc_vm_cat_real_min_num_vms_.size()+1);
         rep_global_svc_vm_cat_real_min_num_vms_[rep_global_vm_alloc_interval_num_].resize(num_svcs_);
+        // Advance the user mobility model once for all services, if they have been assigned an area
+        std::vector<std::size_t> svc_num_users;
+        if (!svc_user_mobility_areas_.empty())
+        {
+            svc_num_users = p_rep_mob_model_->next(svc_user_mobility_areas_);
+        }
+
         for (std::size_t svc = 0; svc < num_svcs_; ++svc)
         {
             auto const svc_cat = svc_categories_[svc];
 
             std::size_t max_num_users = 0;
 
-            max_num_users = p_mob_model_->next();
+            max_num_users = svc_num_users.empty() ? p_rep_mob_model_->next() : svc_num_users[svc];
 DCS_DEBUG_TRACE("SVC: " << svc << " - Mobility model - max num users: " << max_num_users);//XXX
 
             //auto const pred_arr_rate = std::min(max_num_users*svc_arr_rates_[svc_cat], svc_max_arr_rates_[svc_cat]);
@@ -1544,21 +1994,10 @@ DCS_DEBUG_TRACE("SVC: " << svc << " - Real arrival rate: " << real_arr_rate << "
             for (std::size_t vm_cat = 0; vm_cat < num_vm_categories_; ++vm_cat)
             {
                 // Compute delays for this service according to real arrival rate
-DCS_DEBUG_TRACE("CHECK - SVC: " << svc << ", VM Category: " << vm_cat << " - Estimating the min number of VMs with Trivedi's MMc - real arrival rate: " << real_arr_rate << ", service rate: " << svc_vm_service_rates_[svc_cat][vm_cat] << ", delay: " << svc_max_delays_[svc_cat] << ", tol: " << service_delay_tolerance_);
+DCS_DEBUG_TRACE("CHECK - SVC: " << svc << ", VM Category: " << vm_cat << " - Estimating the min number of VMs with the M/M/c model - real arrival rate: " << real_arr_rate << ", service rate: " << svc_vm_service_rates_[svc_cat][vm_cat] << ", delay: " << svc_max_delays_[svc_cat] << ", tol: " << service_delay_tolerance_);
                 auto real_min_num_vms = svc_perf_model_.min_num_vms(real_arr_rate, svc_vm_service_rates_[svc_cat][vm_cat], svc_max_delays_[svc_cat], service_delay_tolerance_);
                 //auto svc_cat_real_delay = svc_perf_model_.average_response_time(real_arr_rate, svc_vm_service_rates_[svc_cat][vm_cat], real_min_num_vms);
-                svc_vm_cat_real_delays[svc][vm_cat].resize(real_min_num_vms+1, std::numeric_limits<RealT>::infinity());
-                if (real_min_num_vms > 0)
-                {
-                    for (std::size_t nvms = 1; nvms <= real_min_num_vms; ++nvms)
-                    {
-                        svc_vm_cat_real_delays[svc][vm_cat][nvms] = svc_perf_model_.average_response_time(real_arr_rate, svc_vm_service_rates_[svc_cat][vm_cat], nvms);
-                    }
-                }
-                else
-                {
-                    svc_vm_cat_real_delays[svc][vm_cat][0] = 0;
-                }
+                svc_vm_cat_real_delays[svc][vm_cat] = svc_perf_model_.average_response_times(real_arr_rate, svc_vm_service_rates_[svc_cat][vm_cat], real_min_num_vms);
                 svc_vm_cat_real_min_num_vms[svc][vm_cat] = real_min_num_vms;
                 rep_global_svc_vm_cat_real_min_num_vms_[rep_global_vm_alloc_interval_num_][svc][vm_cat] = real_min_num_vms;
 #if 0
@@ -1571,21 +2010,10 @@ DCS_DEBUG_TRACE("CHECK SVC: " << svc << ", VM Category: " << vm_cat << " - M/M/c
 #endif
 
                 // Predict delays for this service according to predicted arrival rate
-DCS_DEBUG_TRACE("CHECK: SVC: " << svc << ", VM Category: " << vm_cat << " - estimating the min number of VMs with Trivedi's MMc - predicted arrival rate: " << pred_arr_rate << ", service rate: " << svc_vm_service_rates_[svc_cat][vm_cat] << ", delay: " << svc_max_delays_[svc_cat] << ", tol: " << service_delay_tolerance_);
+DCS_DEBUG_TRACE("CHECK: SVC: " << svc << ", VM Category: " << vm_cat << " - estimating the min number of VMs with the M/M/c model - predicted arrival rate: " << pred_arr_rate << ", service rate: " << svc_vm_service_rates_[svc_cat][vm_cat] << ", delay: " << svc_max_delays_[svc_cat] << ", tol: " << service_delay_tolerance_);
                 auto pred_min_num_vms = svc_perf_model_.min_num_vms(pred_arr_rate, svc_vm_service_rates_[svc_cat][vm_cat], svc_max_delays_[svc_cat], service_delay_tolerance_);
                 //auto svc_cat_predicted_delay = svc_perf_model_.average_response_time(pred_arr_rate, svc_vm_service_rates_[svc_cat][vm_cat], pred_min_num_vms);
-                svc_vm_cat_predicted_delays[svc][vm_cat].resize(pred_min_num_vms+1, std::numeric_limits<RealT>::infinity());
-                if (pred_min_num_vms > 0)
-                {
-                    for (std::size_t nvms = 1; nvms <= pred_min_num_vms; ++nvms)
-                    {
-                        svc_vm_cat_predicted_delays[svc][vm_cat][nvms] = svc_perf_model_.average_response_time(pred_arr_rate, svc_vm_service_rates_[svc_cat][vm_cat], nvms);
-                    }
-                }
-                else
-                {
-                    svc_vm_cat_predicted_delays[svc][vm_cat][0] = 0;
-                }
+                svc_vm_cat_predicted_delays[svc][vm_cat] = svc_perf_model_.average_response_times(pred_arr_rate, svc_vm_service_rates_[svc_cat][vm_cat], pred_min_num_vms);
                 svc_vm_cat_predicted_min_num_vms[svc][vm_cat] = pred_min_num_vms;
                 rep_global_svc_vm_cat_predicted_min_num_vms_[rep_global_vm_alloc_interval_num_][svc][vm_cat] = pred_min_num_vms;
 #if 0
@@ -1610,6 +2038,13 @@ DCS_DEBUG_TRACE("CHECK SVC: " << svc << ", VM Category: " << vm_cat << " - M/M/c
         RealT fp_interval_real_num_fns = std::numeric_limits<RealT>::quiet_NaN();
         std::vector<RealT> svc_interval_pred_delays(num_svcs_, std::numeric_limits<RealT>::quiet_NaN());
         std::vector<RealT> svc_interval_real_delays(num_svcs_, std::numeric_limits<RealT>::quiet_NaN());
+        RealT fp_interval_pred_solve_time = std::numeric_limits<RealT>::quiet_NaN();
+        RealT fp_interval_pred_first_incumbent_time = std::numeric_limits<RealT>::quiet_NaN();
+        RealT fp_interval_pred_gap = std::numeric_limits<RealT>::quiet_NaN();
+        RealT fp_interval_real_solve_time = std::numeric_limits<RealT>::quiet_NaN();
+        RealT fp_interval_real_first_incumbent_time = std::numeric_limits<RealT>::quiet_NaN();
+        RealT fp_interval_real_gap = std::numeric_limits<RealT>::quiet_NaN();
+        RealT fp_interval_solve_wall_time = std::numeric_limits<RealT>::quiet_NaN();
 
         // Allocate VMs to the FP
 
@@ -1639,6 +2074,42 @@ DCS_DEBUG_TRACE("CHECK SVC: " << svc << ", VM Category: " << vm_cat << " - M/M/c
 //        p_vm_alloc_solver = std::make_unique<bahreini2017_mcappim_vm_allocation_solver_t<RealT>>();
 //#endif
 
+        // Wall-clock time spent in solving both the VM allocation problems
+        // (with ALLOCATE_ALL the two solves overlap, so their own solve times
+        // don't add up to this time)
+        auto const fp_solve_start_time = std::chrono::steady_clock::now();
+
+#if defined(DCS_FOG_VMALLOC_REAL_WORKLOAD_ALLOCATE_ALL)
+        // The VM allocation for the real workload doesn't depend on the one
+        // for the predicted workload, so solve the two problems concurrently.
+        // In debug builds the real-workload problem is solved only when its
+        // solution is needed, so that the trace messages of the two solves
+        // don't interleave.
+# ifdef DCS_DEBUG
+        const auto real_vm_alloc_launch_policy = std::launch::deferred;
+# else
+        const auto real_vm_alloc_launch_policy = std::launch::async;
+# endif // DCS_DEBUG
+        auto real_vm_alloc_future = std::async(real_vm_alloc_launch_policy,
+                                               [&]()
+                                               {
+                                                    return p_vm_alloc_solver_->solve(fn_categories_,
+                                                                                     fn_power_states,
+                                                                                     fn_vm_allocations,
+                                                                                     fn_min_powers_,
+                                                                                     fn_max_powers_,
+                                                                                     vm_cpu_requirements_,
+                                                                                     vm_cat_alloc_costs_,
+                                                                                     svc_categories_,
+                                                                                     svc_vm_cat_real_min_num_vms,
+                                                                                     fp_svc_revenues_,
+                                                                                     fp_svc_penalties_,
+                                                                                     fp_electricity_costs_,
+                                                                                     fp_fn_asleep_costs_,
+                                                                                     fp_fn_awake_costs_);
+                                               });
+#endif // DCS_FOG_VMALLOC_REAL_WORKLOAD_ALLOCATE_ALL
+
         // Compute VM allocation according to predicted workload
 
         vm_alloc = p_vm_alloc_solver_->solve(//fns,
@@ -1658,6 +2129,10 @@ DCS_DEBUG_TRACE("CHECK SVC: " << svc << ", VM Category: " << vm_cat << " - M/M/c
                                             fp_fn_asleep_costs_,
                                             fp_fn_awake_costs_);
 
+        fp_interval_pred_solve_time = vm_alloc.solve_time;
+        fp_interval_pred_first_incumbent_time = vm_alloc.first_incumbent_time;
+        fp_interval_pred_gap = vm_alloc.gap;
+
         if (vm_alloc.solved)
         {
 #ifdef DCS_DEBUG
@@ -1760,21 +2235,14 @@ DCS_DEBUG_TRACE("REP VM ALLOCATIONS: " << rep_fn_vm_allocations_);//XXX
 
 #if defined(DCS_FOG_VMALLOC_REAL_WORKLOAD_ALLOCATE_ALL)
 
-        // Solve again the optimization model by optimally reassigning VMs to FNs
-        vm_alloc = p_vm_alloc_solver_->solve(//fns,
-                                            fn_categories_,
-                                            fn_power_states,
-                                            fn_min_powers_,
-                                            fn_max_powers_,
-                                            vm_cpu_requirements_,
-                                            //vm_ram_requirements_,
-                                            svc_categories_,
-                                            svc_vm_cat_real_min_num_vms,
-                                            fp_svc_revenues_,
-                                            fp_svc_penalties_,
-                                            fp_electricity_costs_,
-                                            fp_fn_asleep_costs_,
-                                            fp_fn_awake_costs_);
+        // Solve again the optimization model by optimally reassigning VMs to FNs (the problem has been solved concurrently with the one for the predicted workload)
+        vm_alloc = real_vm_alloc_future.get();
+
+        fp_interval_solve_wall_time = std::chrono::duration<RealT>(std::chrono::steady_clock::now()-fp_solve_start_time).count();
+
+        fp_interval_real_solve_time = vm_alloc.solve_time;
+        fp_interval_real_first_incumbent_time = vm_alloc.first_incumbent_time;
+        fp_interval_real_gap = vm_alloc.gap;
 
         if (vm_alloc.solved)
         {
@@ -1884,22 +2352,29 @@ DCS_DEBUG_TRACE("REP VM ALLOCATIONS: " << rep_fn_vm_allocations_);//XXX
                 fixed_fns.insert(fn);
             }
         }
-        vm_alloc = p_vm_alloc_solver_->solve_with_fixed_fns(fixed_fns,
-                                                           fn_categories_,
-                                                           fn_power_states,
-                                                           fn_vm_allocations,
-                                                           fn_min_powers_,
-                                                           fn_max_powers_,
-                                                           vm_cpu_requirements_,
-                                                           //vm_ram_requirements_,
-                                                           vm_cat_alloc_costs_,
-                                                           svc_categories_,
-                                                           svc_vm_cat_real_min_num_vms,
-                                                           fp_svc_revenues_,
-                                                           fp_svc_penalties_,
-                                                           fp_electricity_costs_,
-                                                           fp_fn_asleep_costs_,
-                                                           fp_fn_awake_costs_);
+        // The solution for the predicted workload is usually a good starting point, since the two problems only differ in the min number of VMs
+        vm_alloc = p_vm_alloc_solver_->solve_with_fixed_fns_from(vm_alloc,
+                                                                fixed_fns,
+                                                                fn_categories_,
+                                                                fn_power_states,
+                                                                fn_vm_allocations,
+                                                                fn_min_powers_,
+                                                                fn_max_powers_,
+                                                                vm_cpu_requirements_,
+                                                                //vm_ram_requirements_,
+                                                                vm_cat_alloc_costs_,
+                                                                svc_categories_,
+                                                                svc_vm_cat_real_min_num_vms,
+                                                                fp_svc_revenues_,
+                                                                fp_svc_penalties_,
+                                                                fp_electricity_costs_,
+                                                                fp_fn_asleep_costs_,
+                                                                fp_fn_awake_costs_);
+
+        fp_interval_solve_wall_time = std::chrono::duration<RealT>(std::chrono::steady_clock::now()-fp_solve_start_time).count();
+        fp_interval_real_solve_time = vm_alloc.solve_time;
+        fp_interval_real_first_incumbent_time = vm_alloc.first_incumbent_time;
+        fp_interval_real_gap = vm_alloc.gap;
 
         if (vm_alloc.solved)
         {
@@ -1998,6 +2473,8 @@ DCS_DEBUG_TRACE("REP VM ALLOCATIONS: " << rep_fn_vm_allocations_);//XXX
 
 #elif defined(DCS_FOG_VMALLOC_REAL_WORKLOAD_ALLOCATE_NONE)
 
+        fp_interval_solve_wall_time = std::chrono::duration<RealT>(std::chrono::steady_clock::now()-fp_solve_start_time).count();
+
         DCS_DEBUG_TRACE("Real Workload:");
         DCS_DEBUG_TRACE("- FN Power States (resulting from predicted workload): " << vm_alloc.fn_power_states);
         DCS_DEBUG_TRACE("- FN - VM Allocations (resulting from predicted workload): " << vm_alloc.fn_vm_allocations);
@@ -2070,6 +2547,13 @@ DCS_DEBUG_TRACE("REAL WORKLOAD - SVC: " << svc << " - Subtracting revenue: " <<
 
 #endif // DCS_FOG_VMALLOC_REAL_WORKLOAD_ALLOCATE_...
 
+        // Apply the VM allocation to the request-level simulation of the next interval
+        std::vector<request_delay_stats_t> svc_interval_req_delays;
+        if (req_level_sim_)
+        {
+            svc_interval_req_delays = update_request_level_services(svc_real_arr_rates);
+        }
+
         // Collect replication stats
 
         rep_fp_pred_profits_ += fp_interval_pred_profits;
@@ -2113,6 +2597,12 @@ DCS_DEBUG_TRACE("REAL WORKLOAD - SVC: " << svc << " - Subtracting revenue: " <<
                 DCS_LOGGING_STREAM << svc_interval_real_delays[svc];
             }
             DCS_LOGGING_STREAM << "}" << std::endl;
+            if (req_level_sim_)
+            {
+                DCS_LOGGING_STREAM << " - Request-Level Delays in the Last Interval (mean, p50, p95, p99, rejection ratio): ";
+                output_request_delay_stats_summary(DCS_LOGGING_STREAM, svc_interval_req_delays);
+                DCS_LOGGING_STREAM << std::endl;
+            }
 
             if (verbosity_ >= high)
             {
@@ -2146,75 +2636,111 @@ DCS_DEBUG_TRACE("REAL WORKLOAD - SVC: " << svc << " - Subtracting revenue: " <<
             }
         }
 
-        // Output to file
-        if (stats_dat_ofs_.is_open())
+        // Output to file (replicas buffer their rows until they are merged by the parent experiment)
+        if (replica_ ? !output_stats_data_file_.empty() : stats_dat_ofs_.is_open())
         {
-            stats_dat_ofs_  << cur_timestamp // Timestamp
-                            << csv_field_sep_ch << csv_field_quote_ch << csv_field_interval_stats_tag << csv_field_quote_ch // Stats tag
-                            << csv_field_sep_ch << this->num_replications() // Replication number
-                            << csv_field_sep_ch << vm_alloc_start_time // VM allocation start time
-                            << csv_field_sep_ch << vm_alloc_duration; // VM allocation duration
+            std::ostream& stats_os = replica_ ? static_cast<std::ostream&>(rep_stats_oss_) : static_cast<std::ostream&>(stats_dat_ofs_);
+
+            stats_os  << cur_timestamp // Timestamp
+                      << csv_field_sep_ch << csv_field_quote_ch << csv_field_interval_stats_tag << csv_field_quote_ch // Stats tag
+                      << csv_field_sep_ch << this->num_replications() // Replication number
+                      << csv_field_sep_ch << vm_alloc_start_time // VM allocation start time
+                      << csv_field_sep_ch << vm_alloc_duration; // VM allocation duration
             // Output interval stats
-            stats_dat_ofs_  << csv_field_sep_ch << fp_interval_pred_profits; // Local predicted profit
-            stats_dat_ofs_  << csv_field_sep_ch << fp_interval_real_profits; // Local real profit
+            stats_os  << csv_field_sep_ch << fp_interval_pred_profits; // Local predicted profit
+            stats_os  << csv_field_sep_ch << fp_interval_real_profits; // Local real profit
             for (std::size_t svc = 0; svc < num_svcs_; ++svc)
             {
                 auto const svc_cat = svc_categories_[svc];
-                stats_dat_ofs_  << csv_field_sep_ch << svc_interval_pred_delays[svc] // Local predicted service delay
-                                << csv_field_sep_ch << relative_increment(svc_interval_pred_delays[svc], svc_max_delays_[svc_cat]); // Local predicted service delay vs. max delay
-                stats_dat_ofs_  << csv_field_sep_ch << svc_interval_real_delays[svc] // Local real service delay
-                                << csv_field_sep_ch << relative_increment(svc_interval_real_delays[svc], svc_max_delays_[svc_cat]); // Local real service delay vs. max delay
+                stats_os  << csv_field_sep_ch << svc_interval_pred_delays[svc] // Local predicted service delay
+                          << csv_field_sep_ch << relative_increment(svc_interval_pred_delays[svc], svc_max_delays_[svc_cat]); // Local predicted service delay vs. max delay
+                stats_os  << csv_field_sep_ch << svc_interval_real_delays[svc] // Local real service delay
+                          << csv_field_sep_ch << relative_increment(svc_interval_real_delays[svc], svc_max_delays_[svc_cat]); // Local real service delay vs. max delay
             }
-            stats_dat_ofs_  << csv_field_sep_ch << fp_interval_pred_num_fns; // Local predicted #FNs
-            stats_dat_ofs_  << csv_field_sep_ch << fp_interval_real_num_fns; // Local real #FNs
+            stats_os  << csv_field_sep_ch << fp_interval_pred_num_fns; // Local predicted #FNs
+            stats_os  << csv_field_sep_ch << fp_interval_real_num_fns; // Local real #FNs
             // Output replication stats: since current replication is not done yet we output incremental stats
             // - Local VM allocation
-            stats_dat_ofs_  << csv_field_sep_ch << rep_fp_pred_profits_; // Local predicted profit
-            stats_dat_ofs_  << csv_field_sep_ch << rep_fp_real_profits_; // Local real profit
+            stats_os  << csv_field_sep_ch << rep_fp_pred_profits_; // Local predicted profit
+            stats_os  << csv_field_sep_ch << rep_fp_real_profits_; // Local real profit
             for (std::size_t svc = 0; svc < num_svcs_; ++svc)
             {
                 auto const svc_cat = svc_categories_[svc];
-                stats_dat_ofs_  << csv_field_sep_ch << rep_svc_pred_delays_[svc]->estimate() // Local predicted service delay
-                                << csv_field_sep_ch << relative_increment(rep_svc_pred_delays_[svc]->estimate(), svc_max_delays_[svc_cat]); // Local predicted service delay vs. max delay
-                stats_dat_ofs_  << csv_field_sep_ch << rep_svc_real_delays_[svc]->estimate() // Local real service delay
-                                << csv_field_sep_ch << relative_increment(rep_svc_real_delays_[svc]->estimate(), svc_max_delays_[svc_cat]); // Local real service delay vs. max delay
+                stats_os  << csv_field_sep_ch << rep_svc_pred_delays_[svc]->estimate() // Local predicted service delay
+                          << csv_field_sep_ch << relative_increment(rep_svc_pred_delays_[svc]->estimate(), svc_max_delays_[svc_cat]); // Local predicted service delay vs. max delay
+                stats_os  << csv_field_sep_ch << rep_svc_real_delays_[svc]->estimate() // Local real service delay
+                          << csv_field_sep_ch << relative_increment(rep_svc_real_delays_[svc]->estimate(), svc_max_delays_[svc_cat]); // Local real service delay vs. max delay
             }
-            stats_dat_ofs_  << csv_field_sep_ch << rep_fp_pred_num_fns_->estimate(); // Local predicted #FNs
-            stats_dat_ofs_  << csv_field_sep_ch << rep_fp_real_num_fns_->estimate(); // Local real #FNs
+            stats_os  << csv_field_sep_ch << rep_fp_pred_num_fns_->estimate(); // Local predicted #FNs
+            stats_os  << csv_field_sep_ch << rep_fp_real_num_fns_->estimate(); // Local real #FNs
             // - Global VM allocation (not available at this point)
-            stats_dat_ofs_  << csv_field_sep_ch << csv_field_na_value; // Global predicted profit
-            stats_dat_ofs_  << csv_field_sep_ch << csv_field_na_value; // Global real profit
-            stats_dat_ofs_  << csv_field_sep_ch << csv_field_na_value; // Global predicted #FNs
-            stats_dat_ofs_  << csv_field_sep_ch << csv_field_na_value; // Global real #FNs
+            stats_os  << csv_field_sep_ch << csv_field_na_value; // Global predicted profit
+            stats_os  << csv_field_sep_ch << csv_field_na_value; // Global real profit
+            stats_os  << csv_field_sep_ch << csv_field_na_value; // Global predicted #FNs
+            stats_os  << csv_field_sep_ch << csv_field_na_value; // Global real #FNs
             // Output overall stats as NA since they are not available at interval granularity
             // - Local VM allocation
-            stats_dat_ofs_  << csv_field_sep_ch << csv_field_na_value // Local predicted profit (mean)
-                            << csv_field_sep_ch << csv_field_na_value; // Local predicted profit (s.d.)
-            stats_dat_ofs_  << csv_field_sep_ch << csv_field_na_value // Local real profit (mean)
-                            << csv_field_sep_ch << csv_field_na_value; // Local real profit (s.d.)
+            stats_os  << csv_field_sep_ch << csv_field_na_value // Local predicted profit (mean)
+                      << csv_field_sep_ch << csv_field_na_value; // Local predicted profit (s.d.)
+            stats_os  << csv_field_sep_ch << csv_field_na_value // Local real profit (mean)
+                      << csv_field_sep_ch << csv_field_na_value; // Local real profit (s.d.)
             for (std::size_t svc = 0; svc < num_svcs_; ++svc)
             {
-                stats_dat_ofs_  << csv_field_sep_ch << csv_field_na_value // Local predicted service delay (mean)
-                                << csv_field_sep_ch << csv_field_na_value // Local predicted service delay (s.d.)
-                                << csv_field_sep_ch << csv_field_na_value; // Local predicted service delay vs. max delay
-                stats_dat_ofs_  << csv_field_sep_ch << csv_field_na_value // Local real service delay (mean)
-                                << csv_field_sep_ch << csv_field_na_value // Local real service delay (s.d.)
-                                << csv_field_sep_ch << csv_field_na_value; // Local real service delay vs. max delay
-            }
-            stats_dat_ofs_  << csv_field_sep_ch << csv_field_na_value // Local predicted #FNs (mean)
-                            << csv_field_sep_ch << csv_field_na_value; // Local predicted #FNs (s.d.)
-            stats_dat_ofs_  << csv_field_sep_ch << csv_field_na_value // Local real #FNs (mean)
-                            << csv_field_sep_ch << csv_field_na_value; // Local real #FNs (s.d.)
+                stats_os  << csv_field_sep_ch << csv_field_na_value // Local predicted service delay (mean)
+                          << csv_field_sep_ch << csv_field_na_value // Local predicted service delay (s.d.)
+                          << csv_field_sep_ch << csv_field_na_value; // Local predicted service delay vs. max delay
+                stats_os  << csv_field_sep_ch << csv_field_na_value // Local real service delay (mean)
+                          << csv_field_sep_ch << csv_field_na_value // Local real service delay (s.d.)
+                          << csv_field_sep_ch << csv_field_na_value; // Local real service delay vs. max delay
+            }
+            stats_os  << csv_field_sep_ch << csv_field_na_value // Local predicted #FNs (mean)
+                      << csv_field_sep_ch << csv_field_na_value; // Local predicted #FNs (s.d.)
+            stats_os  << csv_field_sep_ch << csv_field_na_value // Local real #FNs (mean)
+                      << csv_field_sep_ch << csv_field_na_value; // Local real #FNs (s.d.)
             // - Global VM allocation
-            stats_dat_ofs_  << csv_field_sep_ch << csv_field_na_value // Global predicted profit (mean)
-                            << csv_field_sep_ch << csv_field_na_value; // Global predicted profit (s.d.)
-            stats_dat_ofs_  << csv_field_sep_ch << csv_field_na_value // Global real profit (mean)
-                            << csv_field_sep_ch << csv_field_na_value; // Global real profit (s.d.)
-            stats_dat_ofs_  << csv_field_sep_ch << csv_field_na_value // Global predicted #FNs (mean)
-                            << csv_field_sep_ch << csv_field_na_value; // Global predicted #FNs (s.d.)
-            stats_dat_ofs_  << csv_field_sep_ch << csv_field_na_value // Global real #FNs (mean)
-                            << csv_field_sep_ch << csv_field_na_value; // Global real #FNs (s.d.)
-            stats_dat_ofs_ << std::endl;
+            stats_os  << csv_field_sep_ch << csv_field_na_value // Global predicted profit (mean)
+                      << csv_field_sep_ch << csv_field_na_value; // Global predicted profit (s.d.)
+            stats_os  << csv_field_sep_ch << csv_field_na_value // Global real profit (mean)
+                      << csv_field_sep_ch << csv_field_na_value; // Global real profit (s.d.)
+            stats_os  << csv_field_sep_ch << csv_field_na_value // Global predicted #FNs (mean)
+                      << csv_field_sep_ch << csv_field_na_value; // Global predicted #FNs (s.d.)
+            stats_os  << csv_field_sep_ch << csv_field_na_value // Global real #FNs (mean)
+                      << csv_field_sep_ch << csv_field_na_value; // Global real #FNs (s.d.)
+            if (req_level_sim_)
+            {
+                // Output request-level stats (replication stats are not available at this point)
+                output_request_delay_stats(stats_os, svc_interval_req_delays);
+                output_request_delay_stats(stats_os, std::vector<request_delay_stats_t>());
+            }
+            stats_os << std::endl;
+        }
+        if (replica_ ? !output_trace_data_file_.empty() : trace_dat_ofs_.is_open())
+        {
+            std::ostream& trace_os = replica_ ? static_cast<std::ostream&>(rep_trace_oss_) : static_cast<std::ostream&>(trace_dat_ofs_);
+
+            trace_os  << cur_timestamp // Timestamp
+                      << csv_field_sep_ch << this->num_replications() // Replication number
+                      << csv_field_sep_ch << vm_alloc_start_time // VM allocation start time
+                      << csv_field_sep_ch << vm_alloc_duration; // VM allocation duration
+            trace_os  << csv_field_sep_ch << fp_interval_pred_profits; // Predicted profit
+            trace_os  << csv_field_sep_ch << fp_interval_real_profits; // Real profit
+            for (std::size_t svc = 0; svc < num_svcs_; ++svc)
+            {
+                trace_os  << csv_field_sep_ch << svc_predicted_arr_rates[svc] // Predicted arrival rate
+                          << csv_field_sep_ch << svc_interval_pred_delays[svc]; // Predicted service delay
+                trace_os  << csv_field_sep_ch << svc_real_arr_rates[svc] // Real arrival rate
+                          << csv_field_sep_ch << svc_interval_real_delays[svc]; // Real service delay
+            }
+            trace_os  << csv_field_sep_ch << fp_interval_pred_num_fns; // Predicted #FNs
+            trace_os  << csv_field_sep_ch << fp_interval_real_num_fns; // Real #FNs
+            trace_os  << csv_field_sep_ch << fp_interval_pred_solve_time // Solve time of the VM allocation for the predicted workload
+                      << csv_field_sep_ch << fp_interval_pred_first_incumbent_time // Time to the first incumbent of the VM allocation for the predicted workload
+                      << csv_field_sep_ch << fp_interval_pred_gap; // Relative gap of the VM allocation for the predicted workload
+            trace_os  << csv_field_sep_ch << fp_interval_real_solve_time // Solve time of the VM allocation for the real workload
+                      << csv_field_sep_ch << fp_interval_real_first_incumbent_time // Time to the first incumbent of the VM allocation for the real workload
+                      << csv_field_sep_ch << fp_interval_real_gap; // Relative gap of the VM allocation for the real workload
+            trace_os  << csv_field_sep_ch << fp_interval_solve_wall_time; // Wall-clock time to solve both the VM allocation problems
+            trace_os << std::endl;
         }
     }
 
@@ -2719,6 +3245,7 @@ private:
     RealT ci_level_; ///< Confidence level for confidence interval estimators
     RealT ci_rel_precision_; ///< Relative precision of the half-width of the confidence intervals used for stopping the simulation
     RealT service_delay_tolerance_; ///< The relative tolerance to set in the service performance model
+    bool req_level_sim_; ///< Tells if services are also simulated at the request level
     int verbosity_; ///< The verbosity level: 0 for 'minimum' and 9 for 'maximum' verbosity level
     arrival_rate_estimation_t svc_arr_rate_estimation_; ///< The way service arrival rates are estimated
     //RealT svc_arr_rate_estimation_perturb_max_sd_; ///< The standard deviation to use in the perturbed max arrival rate estimation
@@ -2738,6 +3265,10 @@ private:
     std::vector<std::map<std::size_t, std::pair<std::size_t, std::size_t>>> initial_fn_vm_allocations_; ///< The initial VMs allocation to FNs to use at the beginning of a replication (and in the global VM allocation), by FN and service
     std::ofstream stats_dat_ofs_;
     std::ofstream trace_dat_ofs_;
+    bool replica_; ///< Tells if this experiment runs a single replication on behalf of a parent experiment
+    random_number_engine_t::result_type rep_seed_base_; ///< The base seed from which the random number streams of replicas are derived
+    std::ostringstream rep_stats_oss_; ///< Interval stats buffered by a replica until it is merged by the parent experiment
+    std::ostringstream rep_trace_oss_; ///< Interval trace buffered by a replica until it is merged by the parent experiment
     // BEGIN of members related to local VM allocation
     RealT rep_fp_pred_profits_; ///< FP predicted profits in a single replication
     RealT rep_fp_real_profits_; ///< FP real profits in a single replication, by FP
@@ -2747,6 +3278,8 @@ private:
     std::vector<std::shared_ptr<mean_estimator_t<RealT>>> rep_svc_real_delays_; ///< Service real delays in a single replication, by service
     std::vector<bool> rep_fn_power_states_; ///< The FN power status along the replication (it is updated every time the local VM allocation problem is solved), by FN
     std::vector<std::map<std::size_t, std::pair<std::size_t, std::size_t>>> rep_fn_vm_allocations_; ///< The VM allocations along the replication (it is updated every time the local VM allocation problem is solved), by FN and service
+    std::vector<svc_request_state_t> rep_svc_req_states_; ///< The state of services in the request-level simulation, by service
+    std::vector<request_delay_stats_t> rep_svc_req_delays_; ///< Request-level service delays in a single replication, by service
     std::shared_ptr<ci_mean_estimator_t<RealT>> fp_pred_profit_ci_stats_; // FP predicted profits spanning the whole simulation
     std::shared_ptr<ci_mean_estimator_t<RealT>> fp_real_profit_ci_stats_; // FP real profits spanning the whole simulation
     std::shared_ptr<ci_mean_estimator_t<RealT>> fp_pred_num_fns_ci_stats_; // FP predicted number of powered-on FNs
@@ -2770,13 +3303,9 @@ private:
     std::shared_ptr<ci_mean_estimator_t<RealT>> global_fp_real_profit_ci_stats_; // FP real profits for the global VM allocation, spanning the whole simulation
     std::shared_ptr<ci_mean_estimator_t<RealT>> global_fp_real_num_fns_ci_stats_; // FP real number of powered-on FNs
     // END of members related to global VM allocation
-//#if 1 //FIXME: enable the code fragment below to use std:array instead of plain char**
-//    std::array<char*,rwp_num_args> rwp_args_; /// Arguments to pass to the Python script for the mobility model
-//#else
-//    char** rwp_args_; /// Arguments to pass to the Python script for the mobility model
-//#endif
-//    RndWalkPnt rwp_; ///< Interface to the Python script for the mobility model
     std::shared_ptr<user_mobility_model_t> p_mob_model_; ///< The user mobility model
+    std::shared_ptr<user_mobility_model_t> p_rep_mob_model_; ///< The user mobility model of the current replication (a copy of p_mob_model_)
+    std::vector<rectangular_area_t> svc_user_mobility_areas_; ///< The area where the users of each service are located (empty if the user mobility model is advanced once per service)
     mmc_service_performance_model_t<RealT> svc_perf_model_;
     std::shared_ptr<base_vm_allocation_solver_t<RealT>> p_vm_alloc_solver_;
     std::shared_ptr<base_multislot_vm_allocation_solver_t<RealT>> p_multislot_vm_alloc_solver_;
@@ -3036,8 +3565,23 @@ std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharT
     os << ", " << "sim-confidence-interval-level: " << exp.confidence_interval_level();
     os << ", " << "sim-confidence-interval-relative-precision: " << exp.confidence_interval_relative_precision();
     os << ", " << "sim-max-num-replications: " << exp.max_num_replications();
+    os << ", " << "sim-num-threads: " << exp.num_threads();
     os << ", " << "sim-max-replication-duration: " << exp.max_replication_duration();
     os << ", " << "service-delay-tolerance: " << exp.service_delay_tolerance();
+    os << ", " << "sim-request-level: " << exp.request_level_simulation();
+    os << ", " << "user_mobility_areas: [";
+    {
+        auto user_mobility_areas = exp.user_mobility_areas();
+        for (std::size_t i = 0; i < user_mobility_areas.size(); ++i)
+        {
+            if (i > 0)
+            {
+                os << ", ";
+            }
+            os << "<" << user_mobility_areas[i].min_x << "," << user_mobility_areas[i].max_x << "," << user_mobility_areas[i].min_y << "," << user_mobility_areas[i].max_y << ">";
+        }
+    }
+    os << "]";
     os << ", " << "service-arrival-rate-estimation: " << exp.service_arrival_rate_estimation();
     //os << ", " << "service-arrival-rate-estimation-perturb-max-stdev: " << exp.service_arrival_rate_estimation_perturbed_max_stdev();
     os << ", " << "service-arrival-rate-estimation-params: " << exp.service_arrival_rate_estimation_params();
@@ -64,6 +64,12 @@ public:
         eng_.seed(value);
     }
 
+    /// Initialize the random engine with the given seed sequence
+    void seed(std::seed_seq& seq)
+    {
+        eng_.seed(seq);
+    }
+
     /// Generate a new random number
     result_type operator()()
     {
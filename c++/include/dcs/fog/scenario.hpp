@@ -931,6 +931,22 @@ scenario_t<RealT> make_scenario(const std::string& fname)
             {
                 s.fp_vm_allocation_policy = fog::bahreini2017_match_alt_vm_allocation_policy;
             }
+            else if (str == "bahreini2017_match_flow")
+            {
+                s.fp_vm_allocation_policy = fog::bahreini2017_match_flow_vm_allocation_policy;
+            }
+            else if (str == "aggregated")
+            {
+                s.fp_vm_allocation_policy = fog::aggregated_vm_allocation_policy;
+            }
+            else if (str == "ortools")
+            {
+                s.fp_vm_allocation_policy = fog::ortools_vm_allocation_policy;
+            }
+            else if (str == "greedy")
+            {
+                s.fp_vm_allocation_policy = fog::greedy_vm_allocation_policy;
+            }
             else
             {
                 DCS_EXCEPTION_THROW(std::runtime_error, "Unknown VM allocation policy '" + str + "'");
@@ -28,6 +28,7 @@
 #define DCS_FOG_SERVICE_PERFORMANCE_HPP
 
 
+#include <dcs/fog/service_performance/fcfs_multiserver_queue.hpp>
 #include <dcs/fog/service_performance/mmc_service_performance_model.hpp>
 #include <dcs/fog/service_performance/service_performance_model.hpp>
 
@@ -0,0 +1,188 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fog/service_performance/fcfs_multiserver_queue.hpp
+ *
+ * \brief First-come first-served queue with a variable number of identical
+ *  servers.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FOG_SERVICE_PERFORMANCE_FCFS_MULTISERVER_QUEUE_HPP
+#define DCS_FOG_SERVICE_PERFORMANCE_FCFS_MULTISERVER_QUEUE_HPP
+
+
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <vector>
+
+
+namespace dcs { namespace fog {
+
+/**
+ * \brief State of a first-come first-served (FCFS) queue with a variable
+ *  number of identical servers.
+ *
+ * This class only keeps track of busy servers and waiting requests; it is up
+ * to the caller to schedule the departure of every request that enters
+ * service.
+ * Waiting requests are kept in a ring buffer (which only grows when the
+ * number of waiting requests exceeds its capacity), so that, in steady
+ * state, no memory is allocated per request.
+ * When the number of servers is reduced below the number of busy servers,
+ * requests in service are not preempted: no waiting request enters service
+ * until enough servers become idle.
+ */
+template <typename RealT>
+class fcfs_multiserver_queue_t
+{
+public:
+    fcfs_multiserver_queue_t()
+    : num_servers_(0),
+      num_busy_(0),
+      head_(0),
+      num_waiting_(0)
+    {
+    }
+
+    void num_servers(std::size_t value)
+    {
+        num_servers_ = value;
+    }
+
+    std::size_t num_servers() const
+    {
+        return num_servers_;
+    }
+
+    std::size_t num_busy_servers() const
+    {
+        return num_busy_;
+    }
+
+    std::size_t num_waiting() const
+    {
+        return num_waiting_;
+    }
+
+    /// Adds a request arrived at the given time; returns \c true if the request enters service immediately
+    bool arrive(RealT arrival_time)
+    {
+        if (num_waiting_ == 0 && num_busy_ < num_servers_)
+        {
+            ++num_busy_;
+            return true;
+        }
+
+        enqueue(arrival_time);
+        return false;
+    }
+
+    /**
+     * \brief Releases the server of a departing request.
+     *
+     * Returns \c true if a waiting request enters service, in which case its
+     * arrival time is stored in \a arrival_time.
+     */
+    bool depart(RealT& arrival_time)
+    {
+        DCS_DEBUG_ASSERT( num_busy_ > 0 );
+
+        --num_busy_;
+
+        return start_next(arrival_time);
+    }
+
+    /**
+     * \brief Moves the request at the head of the queue into service if a
+     *  server is idle.
+     *
+     * Returns \c true if a waiting request enters service, in which case its
+     * arrival time is stored in \a arrival_time.
+     * This is meant to be called repeatedly after the number of servers is
+     * increased.
+     */
+    bool start_next(RealT& arrival_time)
+    {
+        if (num_waiting_ == 0 || num_busy_ >= num_servers_)
+        {
+            return false;
+        }
+
+        arrival_time = waiting_[head_];
+        head_ = (head_+1) % waiting_.size();
+        --num_waiting_;
+        ++num_busy_;
+
+        return true;
+    }
+
+    /// Removes all waiting requests and returns their number (requests in service are left unchanged)
+    std::size_t drop_waiting()
+    {
+        auto const n = num_waiting_;
+
+        head_ = 0;
+        num_waiting_ = 0;
+
+        return n;
+    }
+
+    /// Removes all requests (the number of servers is left unchanged)
+    void clear()
+    {
+        num_busy_ = 0;
+        head_ = 0;
+        num_waiting_ = 0;
+    }
+
+
+private:
+    void enqueue(RealT arrival_time)
+    {
+        if (num_waiting_ == waiting_.size())
+        {
+            // Grow the ring buffer and unwrap its content
+            std::vector<RealT> waiting(waiting_.empty() ? 16 : 2*waiting_.size());
+            for (std::size_t i = 0; i < num_waiting_; ++i)
+            {
+                waiting[i] = waiting_[(head_+i) % waiting_.size()];
+            }
+            waiting_.swap(waiting);
+            head_ = 0;
+        }
+
+        waiting_[(head_+num_waiting_) % waiting_.size()] = arrival_time;
+        ++num_waiting_;
+    }
+
+
+private:
+    std::size_t num_servers_; ///< The number of servers
+    std::size_t num_busy_; ///< The number of busy servers
+    std::vector<RealT> waiting_; ///< Ring buffer with the arrival times of waiting requests
+    std::size_t head_; ///< Position of the oldest waiting request in the ring buffer
+    std::size_t num_waiting_; ///< The number of waiting requests
+}; // fcfs_multiserver_queue_t
+
+}} // Namespace dcs::fog
+
+
+#endif // DCS_FOG_SERVICE_PERFORMANCE_FCFS_MULTISERVER_QUEUE_HPP
@@ -28,433 +28,174 @@
 #define DCS_FOG_SERVICE_PERFORMANCE_MMC_SERVICE_PERFORMANCE_MODEL_HPP
 
 
-#include <array>
+#include <algorithm>
 #include <cstddef>
-#include <cstring>
 #include <dcs/debug.hpp>
 #include <dcs/logging.hpp>
-#if 0
-#include <dcs/fog/MMc.hpp>
-#elif 0
-//#include <trivedi/TrivediPerc.hpp>
-#include <trivedi/TrivediMMc.hpp>
-#else
 #include <dcs/math/traits/float.hpp>
-#endif
 #include <dcs/fog/service_performance/service_performance_model.hpp>
+#include <limits>
+#include <map>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 
 namespace dcs { namespace fog {
 
+namespace detail {
+
+/**
+ * \brief Floating-point type used to evaluate the Erlang recurrences of a
+ *  M/M/c queue whose parameters are of type \a RealT.
+ *
+ * The recurrences run over every number of servers up to the one being
+ * looked for, so rounding errors add up with large clusters: the evaluation
+ * is carried out with a type wider than \a RealT, whenever there is one.
+ */
 template <typename RealT>
-class mmc_service_performance_model_t: public service_performance_model_t<RealT>
+struct mmc_erlang_traits
 {
-#if 0
-private:
-    static constexpr const char* py_module = "percentileTrivedi";
-    static constexpr const char* py_function_min_num_vms = "main";
-    static constexpr const char* py_function_avg_rt = "avgRespTime";
+    typedef RealT value_type;
+}; // mmc_erlang_traits
 
+template <>
+struct mmc_erlang_traits<float>
+{
+    typedef double value_type;
+}; // mmc_erlang_traits<float>
 
-public:
-    mmc_service_performance_model_t()
-    {
-        initialize_py_script();
-    }
+template <>
+struct mmc_erlang_traits<double>
+{
+    typedef long double value_type;
+}; // mmc_erlang_traits<double>
+
+} // Namespace detail
 
-    ~mmc_service_performance_model_t()
-    {
-        finalize_py_script();
-    }
 
+template <typename RealT>
+class mmc_service_performance_model_t: public service_performance_model_t<RealT>
+{
 private:
-    std::size_t do_min_num_vms(RealT arrival_rate, RealT service_rate, RealT target_delay, RealT tol)
+    /// Average response times of a M/M/c queue for c=0,1,..., computed so far for a given pair of arrival and service rates
+    typedef typename detail::mmc_erlang_traits<RealT>::value_type erlang_value_type;
+
+    struct delay_table_t
     {
-        //MMc<RealT> mmc(arrival_rate, service_rate, target_delay, tol);
-        //return mmc.computeQueueParameters(true);
-        const std::size_t py_num_args = 8;
-
-        // Setup arguments to pass to Python script
-
-        std::array<char*,py_num_args> py_args_;
-        std::size_t sz = 0;
-        std::size_t arg = 0;
-        std::string str;
-
-        // arg 0: not used (however, we can't pass a null pointer because Python doesn't like it)
-        sz = 1;
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], "", 1);
-        // arg 1: module name
-        ++arg;
-        sz = std::strlen(py_module)+1;
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], py_module, sz);
-        // arg 2: function name
-        ++arg;
-        sz = std::strlen(py_function_min_num_vms)+1;
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], py_function_min_num_vms, sz);
-        // arg 3: arrival rate
-        ++arg;
-        {
-            std::ostringstream oss;
-            oss << arrival_rate;
-            str = oss.str();
-            sz = str.size()+1;
-        }
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], str.c_str(), sz);
-        // arg 4: service rate
-        ++arg;
-        {
-            std::ostringstream oss;
-            oss << service_rate;
-            str = oss.str();
-            sz = str.size()+1;
-        }
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], str.c_str(), sz);
-        // arg 5: delay
-        ++arg;
-        {
-            std::ostringstream oss;
-            oss << target_delay;
-            str = oss.str();
-            sz = str.size()+1;
-        }
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], str.c_str(), sz);
-        // arg 6: delay
-        ++arg;
-        {
-            std::ostringstream oss;
-            oss << tol;
-            str = oss.str();
-            sz = str.size()+1;
-        }
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], str.c_str(), sz);
-        // arg 7: debug?
-        ++arg;
-        {
-            std::ostringstream oss;
-#ifdef DCS_DEBUG
-            oss << true;
-#else
-            oss << false;
-#endif // DCS_DEBUG
-            str = oss.str();
-            sz = str.size()+1;
-        }
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], str.c_str(), sz);
+        erlang_value_type erlang_b = 1; ///< The Erlang-B blocking probability for the last computed number of servers
+        std::vector<RealT> delays; ///< The average response time by number of servers
+    }; // delay_table_t
 
-        // sanity check
-        DCS_DEBUG_ASSERT( py_num_args == py_args_.size() );
+    static const std::size_t max_delay_cache_size = 1024; ///< Maximum number of (arrival rate, service rate) pairs to keep in the cache
 
-        // - Call Python script
-DCS_DEBUG_TRACE("ARGS to NEXTPLEASE - arg[0]: " << py_args_[0] << ", arg[1]: " << py_args_[1] << ", arg[2]: " << py_args_[2] << ", arg[3]: " << py_args_[3] << ", arg[4]: " << py_args_[4] << ", arg[5]: " << py_args_[5] << ", arg[6]: " << py_args_[6] << ", arg[7]: " << py_args_[7]);//XXX
-        auto num_vms = py_wrap_.nextPlease(py_args_.size(), py_args_.data());
-        if (num_vms < 0)
-        {
-            throw std::runtime_error("Error while calling Python script for Trivedi's M/M/c service performance model");
-        }
 
-        // - Clean-up arguments for Python script
-        for (std::size_t i = 0; i < py_args_.size(); ++i)
+    std::size_t do_min_num_vms(RealT arrival_rate, RealT service_rate, RealT target_delay, RealT tol)
+    {
+        if (target_delay < (1/service_rate))
         {
-            if (py_args_[i])
-            {
-                delete[] py_args_[i];
-                py_args_[i] = 0;
-            }
+            //logging.warning("model NOT feasible: response time < service time")
+            return std::numeric_limits<std::size_t>::max();
         }
 
-        return static_cast<std::size_t>(num_vms);
+        return MMc_num_servers(arrival_rate, service_rate, target_delay, tol);
     }
 
     RealT do_average_response_time(RealT arrival_rate, RealT service_rate, std::size_t num_vms)
     {
-        // Setup arguments to pass to Python script
-
-        const std::size_t py_num_args = 7;
-        std::array<char*,py_num_args> py_args_;
-
-        std::size_t sz = 0;
-        std::size_t arg = 0;
-        std::string str;
-
-        // arg 0: not used (however, we can't pass a null pointer because Python doesn't like it)
-        sz = 1;
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], "", 1);
-        // arg 1: module name
-        ++arg;
-        sz = std::strlen(py_module)+1;
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], py_module, sz);
-        // arg 2: function name
-        ++arg;
-        sz = std::strlen(py_function_avg_rt)+1;
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], py_function_avg_rt, sz);
-        // arg 3: arrival rate
-        ++arg;
-        {
-            std::ostringstream oss;
-            oss << arrival_rate;
-            str = oss.str();
-            sz = str.size()+1;
-        }
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], str.c_str(), sz);
-        // arg 4: service rate
-        ++arg;
-        {
-            std::ostringstream oss;
-            oss << service_rate;
-            str = oss.str();
-            sz = str.size()+1;
-        }
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], str.c_str(), sz);
-        // arg 5: num VMs
-        ++arg;
-        {
-            std::ostringstream oss;
-            oss << num_vms;
-            str = oss.str();
-            sz = str.size()+1;
-        }
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], str.c_str(), sz);
-        // arg 6: debug?
-        ++arg;
-        {
-            std::ostringstream oss;
-#ifdef DCS_DEBUG
-            oss << true;
-#else
-            oss << false;
-#endif // DCS_DEBUG
-            str = oss.str();
-            sz = str.size()+1;
-        }
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], str.c_str(), sz);
-
-        // sanity check
-        DCS_DEBUG_ASSERT( py_num_args == py_args_.size() );
-
-        // - Call Python script
-DCS_DEBUG_TRACE("ARGS to AVGRESPTIME - arg[0]: " << py_args_[0] << ", arg[1]: " << py_args_[1] << ", arg[2]: " << py_args_[2] << ", arg[3]: " << py_args_[3] << ", arg[4]: " << py_args_[4] << ", arg[5]: " << py_args_[5] << ", arg[6]: " << py_args_[6]);//XXX
-        auto rt = py_wrap_.avgResponseTime(py_args_.size(), py_args_.data());
-
-        // - Clean-up arguments for Python script
-        for (std::size_t i = 0; i < py_args_.size(); ++i)
-        {
-            if (py_args_[i])
-            {
-                delete[] py_args_[i];
-                py_args_[i] = 0;
-            }
-        }
-
-        return static_cast<RealT>(rt);
+        return MMc_avg_response_time(arrival_rate, service_rate, num_vms);
     }
 
-    void initialize_py_script()
+    std::vector<RealT> do_average_response_times(RealT arrival_rate, RealT service_rate, std::size_t max_num_vms)
     {
-        const std::size_t py_num_args = 2;
-        std::array<char*,py_num_args> py_args_;
-
-        // Setup arguments to pass to Python script
-
-        std::size_t sz = 0;
-        std::size_t arg = 0;
-        std::string str;
-
-        // arg 0: not used (however, we can't pass a null pointer because Python doesn't like it)
-        sz = 1;
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], "", 1);
-        // arg 1: module name
-        ++arg;
-        sz = std::strlen(py_module)+1;
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], py_module, sz);
-#if 0
-        // arg 2: not used
-        ++arg;
-        sz = /*std::strlen(py_function)+*/1;
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], ""/*py_function*/, sz);
-        // arg 3: not used
-        ++arg;
-        sz = 1;
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], "", 1);
-        // arg 4: not used
-        ++arg;
-        sz = 1;
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], "", 1);
-        // arg 5: not used
-        ++arg;
-        sz = 1;
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], "", 1);
-        // arg 6: not used
-        ++arg;
-        sz = 1;
-        py_args_[arg] = new char[sz];
-        std::strncpy(py_args_[arg], "", 1);
-#endif
-
-        // sanity check
-        DCS_DEBUG_ASSERT( py_num_args == py_args_.size() );
-
-        // - Setup
-//DCS_DEBUG_TRACE("ARGS to SETUP - arg[0]: " << py_args_[0] << ", arg[1]: " << py_args_[1] << ", arg[2]: " << py_args_[2] << ", arg[3]: " << py_args_[3] << ", arg[4]: " << py_args_[4] << ", arg[5]: " << py_args_[5] << ", arg[6]: " << py_args_[6]);//XXX
-DCS_DEBUG_TRACE("ARGS to SETUP - arg[0]: " << py_args_[0] << ", arg[1]: " << py_args_[1]);//XXX
-        auto setup_ret = py_wrap_.setup(py_args_.size(), py_args_.data());
-        if (setup_ret < 0)
+        if (dcs::math::float_traits<RealT>::essentially_equal(arrival_rate, 0))
         {
-            throw std::runtime_error("Unable to initialize the Python script");
+            return std::vector<RealT>(max_num_vms+1, 0);
         }
 
-        // - Clean-up arguments for Python script
-        for (std::size_t i = 0; i < py_args_.size(); ++i)
-        {
-            if (py_args_[i])
-            {
-                delete[] py_args_[i];
-                py_args_[i] = 0;
-            }
-        }
+        auto const& tab = MMc_delay_table(arrival_rate, service_rate, max_num_vms);
+
+        return std::vector<RealT>(tab.delays.begin(), tab.delays.begin()+max_num_vms+1);
     }
 
-    void finalize_py_script()
+    std::size_t MMc_num_servers(RealT lambda, RealT mu, RealT max_rt, RealT tol)
     {
-        // - Clean-up
-        auto dismiss_ret = py_wrap_.dismiss();
-        if (dismiss_ret < 0)
+        if (dcs::math::float_traits<RealT>::essentially_equal(lambda, 0))
         {
-            dcs::log_warn(DCS_LOGGING_AT, "Problems when finalizing the Python script");
+            return 0;
         }
 
-        // - Clean-up arguments for Python script
-        //for (std::size_t i = 0; i < py_args_.size(); ++i)
-        //{
-        //    if (py_args_[i])
-        //    {
-        //        delete[] py_args_[i];
-        //        py_args_[i] = 0;
-        //    }
-        //}
-    }
+        auto& tab = MMc_delay_table(lambda, mu, 0);
 
-private:
-    TrivediPerc py_wrap_;
-    //std::array<char*,py_num_args> py_args_;
+        auto meets_target = [&](std::size_t c) -> bool
+                            {
+                                if (c >= tab.delays.size())
+                                {
+                                    MMc_extend_delay_table(lambda, mu, c, tab);
+                                }
 
-#elif 0
+                                // Check for stability
+                                if (MMc_unstable(lambda, mu, c))
+                                {
+                                    return false;
+                                }
 
-private:
-    std::size_t do_min_num_vms(RealT arrival_rate, RealT service_rate, RealT target_delay, RealT tol)
-    {
-        bool debug = false;
+                                auto rt = tab.delays[c];
 
-#ifdef DCS_DEBUG
-        debug = true;
-#endif //DCS_DEBUG
+                                DCS_DEBUG_TRACE("lambda: " << lambda << ", mu: " << mu << ", c: " << c << " -> rt: " << rt << " vs. max RT: " << max_rt << " (tol: " << tol << ")");
 
-        return py_wrap_.num_servers(arrival_rate, service_rate, target_delay, tol, debug);
-    }
-
-    RealT do_average_response_time(RealT arrival_rate, RealT service_rate, std::size_t num_vms)
-    {
-        bool debug = false;
-
-#ifdef DCS_DEBUG
-        debug = true;
-#endif //DCS_DEBUG
-
-        return 0;//py_wrap_.average_response_time(arrival_rate, service_rate, num_vms, debug);
-    }
-
-private:
-    TrivediMMc py_wrap_;
-#else
+                                // Check for target response time
+                                return dcs::math::float_traits<RealT>::essentially_less_equal(rt, max_rt, tol);
+                            };
 
-private:
-    std::size_t do_min_num_vms(RealT arrival_rate, RealT service_rate, RealT target_delay, RealT tol)
-    {
-        if (target_delay < (1/service_rate))
+        // No need to look below the stability bound ceil(lambda/mu), where the response time is infinite
+        std::size_t c_stab = std::max(static_cast<std::size_t>(lambda/mu), static_cast<std::size_t>(1));
+        while (MMc_unstable(lambda, mu, c_stab))
         {
-            //logging.warning("model NOT feasible: response time < service time")
-            return std::numeric_limits<std::size_t>::max();
+            ++c_stab;
         }
-
-        return MMc_num_servers(arrival_rate, service_rate, target_delay, tol);
-    }
-
-    RealT do_average_response_time(RealT arrival_rate, RealT service_rate, std::size_t num_vms)
-    {
-        return MMc_avg_response_time(arrival_rate, service_rate, num_vms);
-    }
-
-    static RealT factorial(std::size_t n)
-    {
-        RealT f = 1;
-        while (n >= 2)
+        while (c_stab > 1 && !MMc_unstable(lambda, mu, c_stab-1))
         {
-            f *= n--;
+            --c_stab;
         }
-        //for (std::size_t k = 2; k <= n; ++k)
-        //{
-        //    f *= k;
-        //}
-        return f;
-    }
 
-    static std::size_t MMc_num_servers(RealT lambda, RealT mu, RealT max_rt, RealT tol)
-    {
-        if (dcs::math::float_traits<RealT>::essentially_equal(lambda, 0))
+        // Above the stability bound the response time decreases with c, so
+        // gallop until the target response time is met and then bisect the
+        // last bracket (lo, hi] (lo never meets the target, while hi does)
+        std::size_t lo = c_stab-1;
+        std::size_t hi = c_stab;
+        std::size_t step = 1;
+        while (!meets_target(hi))
         {
-            return 0;
+            lo = hi;
+            hi += step;
+            step *= 2;
         }
-
-        std::size_t c = 0;
-        while (true)
+        while (hi-lo > 1)
         {
-            ++c;
-
-            // Check for stability
-            if (dcs::math::float_traits<RealT>::essentially_greater_equal(lambda/(c*mu), 1.0))
+            auto const mid = lo+(hi-lo)/2;
+            if (meets_target(mid))
             {
-                continue;
+                hi = mid;
             }
-
-            auto rt = MMc_avg_response_time(lambda, mu, c);
-
-            DCS_DEBUG_TRACE("lambda: " << lambda << ", mu: " << mu << ", c: " << c << " -> rt: " << rt << " vs. max RT: " << max_rt << " (tol: " << tol << ")");
-
-            // Check for target response time
-            if (dcs::math::float_traits<RealT>::essentially_less_equal(rt, max_rt, tol))
+            else
             {
-                // Found a value of c such that the achieved response time is <= max response time
-                DCS_DEBUG_TRACE("Found (lambda: " << lambda << ", mu: " << mu << ", c: " << c << " -> rt: " << rt << " vs. max RT: " << max_rt << " (tol: " << tol << "))");
-                break;
+                lo = mid;
             }
         }
 
-        return c;
+        // Found a value of c such that the achieved response time is <= max response time
+        DCS_DEBUG_TRACE("Found (lambda: " << lambda << ", mu: " << mu << ", c: " << hi << " -> rt: " << tab.delays[hi] << " vs. max RT: " << max_rt << " (tol: " << tol << "))");
+
+        return hi;
+    }
+
+    static bool MMc_unstable(RealT lambda, RealT mu, std::size_t c)
+    {
+        return dcs::math::float_traits<RealT>::essentially_greater_equal(lambda/(c*mu), 1.0);
     }
 
-    static RealT MMc_avg_response_time(RealT lambda, RealT mu, std::size_t c)
+    RealT MMc_avg_response_time(RealT lambda, RealT mu, std::size_t c)
     {
 DCS_DEBUG_TRACE("MMc avg response time - check for lambda " << lambda);
         if (dcs::math::float_traits<RealT>::essentially_equal(lambda, 0))
@@ -472,39 +213,74 @@ DCS_DEBUG_TRACE("MMc avg response time - check for lambda " << lambda);
             return std::numeric_limits<RealT>::infinity();
         }
 
-        if (c == 1)
+        return MMc_delay_table(lambda, mu, c).delays[c];
+    }
+
+    /// Returns the (cached) table of delays for the given arrival and service rates, with at least the delays for 0,...,c servers
+    delay_table_t& MMc_delay_table(RealT lambda, RealT mu, std::size_t c)
+    {
+        auto const key = std::make_pair(lambda, mu);
+
+        auto it = delay_cache_.find(key);
+        if (it == delay_cache_.end())
         {
-            return (1.0/mu)/(1.0-rho);
+            if (delay_cache_.size() >= max_delay_cache_size)
+            {
+                // Arrival rates change over time, so old entries are unlikely to be reused
+                delay_cache_.clear();
+            }
+
+            it = delay_cache_.emplace(key, delay_table_t()).first;
+            it->second.delays.push_back(std::numeric_limits<RealT>::infinity());
         }
 
-        auto pm = MMc_Pm(lambda, mu, c);
-        auto avgK = c*rho+(rho/(1-rho))*pm;
+        auto& tab = it->second;
+        if (c >= tab.delays.size())
+        {
+            MMc_extend_delay_table(lambda, mu, c, tab);
+        }
 
-        return avgK/lambda;
+        return tab;
     }
 
-    static RealT MMc_pi0(RealT lambda, RealT mu, std::size_t c)
+    /**
+     * \brief Extends the given table of delays up to \a c servers.
+     *
+     * Uses the Erlang-B recurrence B(k) = a*B(k-1)/(k+a*B(k-1)), with B(0)=1
+     * and a=lambda/mu, from which the Erlang-C probability of waiting is
+     * C(k) = B(k)/(1-rho*(1-B(k))), with rho=a/k, and the average response
+     * time is 1/mu+C(k)/(k*mu-lambda).
+     * Each step is O(1) and only involves numbers in [0,1], so that there is
+     * no need to compute powers and factorials, which overflow as soon as
+     * the number of servers is in the order of hundreds.
+     * Also, 1-rho is computed as (k-a)/k to avoid cancellation when the
+     * queue is close to saturation.
+     */
+    static void MMc_extend_delay_table(RealT lambda, RealT mu, std::size_t c, delay_table_t& tab)
     {
-        auto rho = lambda/(c*mu);
-        auto part1 = (std::pow(c*rho,c)/factorial(c))*(1.0/(1.0-rho));
-        RealT part2 = 0.0;
-        for (std::size_t k = 0; k < c; ++k)
+        auto const a = static_cast<erlang_value_type>(lambda)/mu;
+
+        tab.delays.reserve(c+1);
+        for (std::size_t k = tab.delays.size(); k <= c; ++k)
         {
-            part2 += std::pow(c*rho,k)/factorial(k);
-        }
+            tab.erlang_b = a*tab.erlang_b/(k+a*tab.erlang_b);
 
-        return 1/(part1+part2);
-    }
+            if (MMc_unstable(lambda, mu, k))
+            {
+                tab.delays.push_back(std::numeric_limits<RealT>::infinity());
+                continue;
+            }
 
-    static RealT MMc_Pm(RealT lambda, RealT mu, std::size_t c)
-    {
-        auto rho = lambda/(c*mu);
-        auto pi0 = MMc_pi0(lambda, mu, c);
+            auto const one_minus_rho = (k-a)/k;
+            auto const erlang_c = tab.erlang_b/(one_minus_rho+(a/k)*tab.erlang_b);
 
-        return (std::pow(c*rho, c)/(factorial(c)*(1-rho)))*pi0;
+            tab.delays.push_back(static_cast<RealT>(1/static_cast<erlang_value_type>(mu)+erlang_c/(mu*(k-a))));
+        }
     }
 
-#endif
+
+private:
+    std::map<std::pair<RealT,RealT>, delay_table_t> delay_cache_; ///< Tables of delays by (arrival rate, service rate)
 }; // mmc_service_performance_model_t
 
 }} // Namespace dcs::fog
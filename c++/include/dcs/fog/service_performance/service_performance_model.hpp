@@ -29,6 +29,8 @@
 
 
 #include <cstddef>
+#include <limits>
+#include <vector>
 
 
 namespace dcs { namespace fog {
@@ -41,6 +43,12 @@ struct service_performance_model_t
         return this->do_average_response_time(arrival_rate, service_rate, num_vms);
     }
 
+    /// Returns the average response times with 0,1,...,max_num_vms VMs
+    std::vector<RealT> average_response_times(RealT arrival_rate, RealT service_rate, std::size_t max_num_vms)
+    {
+        return this->do_average_response_times(arrival_rate, service_rate, max_num_vms);
+    }
+
     std::size_t min_num_vms(RealT arrival_rate, RealT service_rate, RealT target_delay, RealT tol)
     {
         return this->do_min_num_vms(arrival_rate, service_rate, target_delay, tol);
@@ -53,6 +61,19 @@ private:
     virtual std::size_t do_min_num_vms(RealT arrival_rate, RealT service_rate, RealT target_delay, RealT tol) = 0;
 
     virtual RealT do_average_response_time(RealT arrival_rate, RealT service_rate, std::size_t num_vms) = 0;
+
+    virtual std::vector<RealT> do_average_response_times(RealT arrival_rate, RealT service_rate, std::size_t max_num_vms)
+    {
+        std::vector<RealT> rts(max_num_vms+1);
+
+        rts[0] = (arrival_rate > 0) ? std::numeric_limits<RealT>::infinity() : 0;
+        for (std::size_t num_vms = 1; num_vms <= max_num_vms; ++num_vms)
+        {
+            rts[num_vms] = this->do_average_response_time(arrival_rate, service_rate, num_vms);
+        }
+
+        return rts;
+    }
 }; // service_performance_model_t
 
 }} // Namespace dcs::fog
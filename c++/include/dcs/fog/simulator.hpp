@@ -28,39 +28,74 @@
 #define DCS_FOG_SIMULATOR_HPP
 
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/fog/event_list.hpp>
+#include <dcs/macro.hpp>
+#include <exception>
+#include <limits>
 #include <memory>
-#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 
 namespace dcs { namespace fog {
 
-struct event_state_t
-{
-	virtual ~event_state_t() { }
-}; // event_state_t
-
+/**
+ * \brief A simulation event.
+ *
+ * The event state is stored inline (rather than on the heap) so that events
+ * can be recycled by the simulator without any dynamic memory allocation.
+ * For this reason, event states must be trivially copyable types whose size
+ * does not exceed \c max_state_size bytes.
+ */
 template <typename RealT>
 struct event_t
 {
+	static constexpr std::size_t max_state_size = 4*sizeof(RealT);
+
+	event_t()
+	: fire_time(0),
+	  tag(-1)
+	{
+	}
+
 	event_t(RealT fire_time, int tag)
 	: fire_time(fire_time),
 	  tag(tag)
 	{
 	}
 
-	event_t(RealT fire_time, int tag, const std::shared_ptr<event_state_t>& p_state)
-	: fire_time(fire_time),
-	  tag(tag),
-	  p_state(p_state)
+	template <typename StateT>
+	void state(const StateT& s)
 	{
+		static_assert(std::is_trivially_copyable<StateT>::value, "Event states must be trivially copyable");
+		static_assert(sizeof(StateT) <= max_state_size, "Event state is too large");
+		static_assert(alignof(StateT) <= alignof(std::max_align_t), "Event state is over-aligned");
+
+		std::memcpy(state_data, &s, sizeof(StateT));
+	}
+
+	template <typename StateT>
+	StateT state() const
+	{
+		static_assert(std::is_trivially_copyable<StateT>::value, "Event states must be trivially copyable");
+		static_assert(sizeof(StateT) <= max_state_size, "Event state is too large");
+
+		StateT s;
+		std::memcpy(&s, state_data, sizeof(StateT));
+		return s;
 	}
 
 	RealT fire_time;
 	int tag;
-	std::shared_ptr<event_state_t> p_state;
+	alignas(std::max_align_t) unsigned char state_data[max_state_size];
 }; // event_t
 
 
@@ -82,15 +117,29 @@ private:
 };
 */
 
-template <typename RealT>
+/**
+ * \brief Simple discrete-event simulator.
+ *
+ * \tparam RealT The type of simulated time.
+ * \tparam EventListT The future event list policy (e.g., dary_heap_event_list_t
+ *  or calendar_queue_event_list_t). It must store event_list_entry_t<RealT>
+ *  entries and provide the push, top, pop, empty, size and clear operations.
+ */
+template <typename RealT, typename EventListT = dary_heap_event_list_t<RealT>>
 class simulator_t
 {
+public:
+    typedef EventListT event_list_type;
+
+
 public:
     explicit simulator_t(RealT replication_duration = -1)
     : max_rep_len_(replication_duration),
       max_num_rep_(std::numeric_limits<std::size_t>::max()),
       sim_time_(0),
-      done_(false)
+      done_(false),
+      num_threads_(1),
+      evt_seq_(0)
     {
     }
 
@@ -104,28 +153,39 @@ public:
 //        evt_queue_.clear();
 //    }
 
-    void schedule_event(RealT time, int tag, const std::shared_ptr<event_state_t>& p_state = nullptr)
+    void schedule_event(RealT time, int tag)
     {
         DCS_DEBUG_TRACE("Scheduling event: <tag: " << tag << ", time: " << time << "> (time: " << sim_time_ << ")");
 
-        auto p_event = std::make_shared<event_t<RealT>>(time, tag, p_state);
-        evt_queue_.push(p_event);
+        auto const slot = acquire_event_slot();
+        evt_pool_[slot] = event_t<RealT>(time, tag);
+        evt_queue_.push(event_list_entry_t<RealT>(time, evt_seq_++, slot));
+    }
+
+    template <typename StateT>
+    void schedule_event(RealT time, int tag, const StateT& state)
+    {
+        DCS_DEBUG_TRACE("Scheduling event: <tag: " << tag << ", time: " << time << "> (time: " << sim_time_ << ")");
+
+        auto const slot = acquire_event_slot();
+        evt_pool_[slot] = event_t<RealT>(time, tag);
+        evt_pool_[slot].state(state);
+        evt_queue_.push(event_list_entry_t<RealT>(time, evt_seq_++, slot));
     }
 
     void run()
     {
+        if (num_threads_ > 1)
+        {
+            run_parallel();
+            return;
+        }
+
         initialize_simulation();
 
         while (!check_end_of_simulation())
         {
-            initialize_replication();
-
-            while (!check_end_of_replication())
-            {
-                fire_event();
-            }
-
-            finalize_replication();
+            run_replication();
 
             check_end_of_simulation();
         }
@@ -163,6 +223,17 @@ public:
         return num_rep_;
     }
 
+    /// Sets the number of replications to run concurrently (1 means sequential replications)
+    void num_threads(std::size_t value)
+    {
+        num_threads_ = std::max(value, static_cast<std::size_t>(1));
+    }
+
+    std::size_t num_threads() const
+    {
+        return num_threads_;
+    }
+
     bool done() const
     {
         return done_;
@@ -197,9 +268,103 @@ protected:
 
     virtual bool do_check_end_of_simulation() const = 0;
 
-    virtual void do_process_event(const std::shared_ptr<event_t<RealT>>& p_event) = 0;
+    virtual void do_process_event(const event_t<RealT>& event) = 0;
+
+    /**
+     * \brief Creates a private copy of this simulator to run the given replication.
+     *
+     * The returned simulator must not share any mutable state with this one,
+     * since it is run in a separate thread when more than one thread is used.
+     */
+    virtual std::unique_ptr<simulator_t> do_make_replica(std::size_t replication) const
+    {
+        DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( replication );
+
+        DCS_EXCEPTION_THROW( std::logic_error, "This simulator does not support parallel replications" );
+    }
+
+    /// Merges the outputs of a replication run by a replica into the simulation-wide state of this simulator
+    virtual void do_merge_replica(simulator_t& replica)
+    {
+        DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( replica );
+
+        DCS_EXCEPTION_THROW( std::logic_error, "This simulator does not support parallel replications" );
+    }
 
 private:
+    void run_replication()
+    {
+        initialize_replication();
+
+        while (!check_end_of_replication())
+        {
+            fire_event();
+        }
+
+        finalize_replication();
+    }
+
+    void run_parallel()
+    {
+        initialize_simulation();
+
+        while (!check_end_of_simulation())
+        {
+            // Run a batch of replications concurrently, each one on its own replica
+            std::size_t nreps = num_threads_;
+            if (max_num_rep_ > 0)
+            {
+                nreps = std::min(nreps, max_num_rep_-num_rep_);
+            }
+
+            std::vector<std::unique_ptr<simulator_t>> replicas(nreps);
+            std::vector<std::exception_ptr> errors(nreps);
+            std::vector<std::thread> workers;
+            for (std::size_t i = 0; i < nreps; ++i)
+            {
+                replicas[i] = do_make_replica(num_rep_+i+1);
+                replicas[i]->num_rep_ = num_rep_+i; // Incremented by initialize_replication()
+            }
+            for (std::size_t i = 0; i < nreps; ++i)
+            {
+                workers.emplace_back([&replicas, &errors, i]()
+                                     {
+                                        try
+                                        {
+                                            replicas[i]->run_replication();
+                                        }
+                                        catch (...)
+                                        {
+                                            errors[i] = std::current_exception();
+                                        }
+                                     });
+            }
+            for (auto& worker : workers)
+            {
+                worker.join();
+            }
+
+            // Merge results in replication order, so that outputs do not
+            // depend on thread scheduling. Replications exceeding the stopping
+            // criterion are discarded, as if they had never been run.
+            for (std::size_t i = 0; i < nreps && !check_end_of_simulation(); ++i)
+            {
+                if (errors[i])
+                {
+                    std::rethrow_exception(errors[i]);
+                }
+
+                ++num_rep_;
+
+                DCS_DEBUG_TRACE("Merging replication #" << num_rep_);
+
+                do_merge_replica(*replicas[i]);
+            }
+        }
+
+        finalize_simulation();
+    }
+
     void initialize_simulation()
     {
         DCS_DEBUG_TRACE("Initializing simulation (time: " << sim_time_ << ")");
@@ -227,10 +392,11 @@ private:
         ++num_rep_;
         sim_time_ = 0;
 
-        while (!evt_queue_.empty())
-        {
-            evt_queue_.pop();
-        }
+        // Pending events are dropped but the memory they used is kept for reuse
+        evt_queue_.clear();
+        evt_seq_ = 0;
+        evt_pool_.clear();
+        evt_free_slots_.clear();
 
         do_initialize_replication();
     }
@@ -256,25 +422,34 @@ private:
     {
         if (evt_queue_.size() > 0)
         {
-            auto p_event = evt_queue_.top();
+            auto const slot = evt_queue_.top().slot;
             evt_queue_.pop();
-            sim_time_ = p_event->fire_time;
 
-            DCS_DEBUG_TRACE("Firing event: <tag: " << p_event->tag << ", fire-time: " << p_event->fire_time << "> (time: " << sim_time_ << ")");
+            // Copy the event out of the pool since processing it may schedule new events (and thus grow the pool)
+            const event_t<RealT> event = evt_pool_[slot];
+            evt_free_slots_.push_back(slot);
+
+            sim_time_ = event.fire_time;
+
+            DCS_DEBUG_TRACE("Firing event: <tag: " << event.tag << ", fire-time: " << event.fire_time << "> (time: " << sim_time_ << ")");
 
-            do_process_event(p_event);
+            do_process_event(event);
         }
     }
 
-
-private:
-    struct event_comparator_t
+    std::size_t acquire_event_slot()
     {
-        constexpr bool operator()(const std::shared_ptr<event_t<double>>& e1, const std::shared_ptr<event_t<double>>& e2) const
+        if (evt_free_slots_.empty())
         {
-            return e1->fire_time > e2->fire_time;
+            evt_pool_.emplace_back();
+            return evt_pool_.size()-1;
         }
-    };
+
+        auto const slot = evt_free_slots_.back();
+        evt_free_slots_.pop_back();
+        return slot;
+    }
+
 
 private:
     RealT max_rep_len_;
@@ -282,7 +457,11 @@ private:
     std::size_t num_rep_;
     RealT sim_time_;
     bool done_;
-	std::priority_queue<std::shared_ptr<event_t<RealT>>, std::vector<std::shared_ptr<event_t<RealT>>>, event_comparator_t> evt_queue_;
+    std::size_t num_threads_;
+    std::vector<event_t<RealT>> evt_pool_; ///< Storage for scheduled events, recycled through the free-slot list
+    std::vector<std::size_t> evt_free_slots_; ///< Slots of the event pool that are available for reuse
+    std::uint64_t evt_seq_; ///< Sequence number to assign to the next scheduled event (used to break ties among simultaneous events)
+    event_list_type evt_queue_; ///< The future event list
 }; // simulator_t
 
 }} // Namespace dcs::fog
@@ -42,6 +42,9 @@
 #include <dcs/math/function/iszero.hpp>
 #include <dcs/math/function/sqr.hpp>
 #include <dcs/math/traits/float.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstddef>
 #include <limits>
 #include <stdexcept>
@@ -115,6 +118,162 @@ private:
 }; // mean_estimator_t
 
 
+/**
+ * \brief Estimator of a quantile based on the P-square algorithm.
+ *
+ * The P-square algorithm estimates a quantile on the fly with five markers,
+ * that is, without storing observations [1].
+ *
+ * References
+ * 1. R. Jain and I. Chlamtac,
+ *    "The P^2 Algorithm for Dynamic Calculation of Quantiles and Histograms Without Storing Observations,"
+ *    Communications of the ACM 28(10):1076-1085, 1985
+ */
+template <typename RealT>
+class p2_quantile_estimator_t
+{
+public:
+    explicit p2_quantile_estimator_t(RealT probability = 0.5)
+    : p_(probability),
+      name_("Unnamed")
+    {
+        // pre: probability in (0,1)
+        DCS_ASSERT(p_ > 0 && p_ < 1,
+                   DCS_EXCEPTION_THROW(std::invalid_argument,
+                                       "Quantile probability must be in (0,1)"));
+
+        this->reset();
+    }
+
+    void name(std::string const& s)
+    {
+        name_ = s;
+    }
+
+    std::string name() const
+    {
+        return name_;
+    }
+
+    RealT probability() const
+    {
+        return p_;
+    }
+
+    std::size_t size() const
+    {
+        return n_;
+    }
+
+    RealT estimate() const
+    {
+        if (n_ == 0)
+        {
+            return std::numeric_limits<RealT>::quiet_NaN();
+        }
+        if (n_ < q_.size())
+        {
+            // Not enough observations for the markers: use the sample quantile
+            std::array<RealT,5> q = q_;
+            std::sort(q.begin(), q.begin()+n_);
+            return q[static_cast<std::size_t>(p_*(n_-1)+0.5)];
+        }
+
+        return q_[2];
+    }
+
+    void collect(RealT obs)
+    {
+        if (n_ < q_.size())
+        {
+            q_[n_] = obs;
+            ++n_;
+            if (n_ == q_.size())
+            {
+                std::sort(q_.begin(), q_.end());
+            }
+            return;
+        }
+
+        // Find the cell the observation falls into and update the extreme markers
+        std::size_t k = 0;
+        if (obs < q_[0])
+        {
+            q_[0] = obs;
+            k = 0;
+        }
+        else if (obs >= q_[4])
+        {
+            q_[4] = obs;
+            k = 3;
+        }
+        else
+        {
+            k = 0;
+            while (k < 3 && obs >= q_[k+1])
+            {
+                ++k;
+            }
+        }
+
+        // Update the positions of markers
+        for (std::size_t i = k+1; i < pos_.size(); ++i)
+        {
+            pos_[i] += 1;
+        }
+        for (std::size_t i = 0; i < des_pos_.size(); ++i)
+        {
+            des_pos_[i] += des_pos_incs_[i];
+        }
+
+        // Adjust the heights of the middle markers
+        for (std::size_t i = 1; i < 4; ++i)
+        {
+            const RealT d = des_pos_[i]-pos_[i];
+
+            if ((d >= 1 && pos_[i+1]-pos_[i] > 1) || (d <= -1 && pos_[i-1]-pos_[i] < -1))
+            {
+                const RealT s = d >= 0 ? 1 : -1;
+
+                // Try the piecewise-parabolic formula and fall back to the linear one
+                const RealT qp = q_[i] + s/(pos_[i+1]-pos_[i-1])*((pos_[i]-pos_[i-1]+s)*(q_[i+1]-q_[i])/(pos_[i+1]-pos_[i])
+                                                                  + (pos_[i+1]-pos_[i]-s)*(q_[i]-q_[i-1])/(pos_[i]-pos_[i-1]));
+                if (q_[i-1] < qp && qp < q_[i+1])
+                {
+                    q_[i] = qp;
+                }
+                else
+                {
+                    const std::size_t j = s > 0 ? i+1 : i-1;
+                    q_[i] += s*(q_[j]-q_[i])/(pos_[j]-pos_[i]);
+                }
+                pos_[i] += s;
+            }
+        }
+
+        ++n_;
+    }
+
+    void reset()
+    {
+        n_ = 0;
+        q_.fill(0);
+        pos_ = {{0, 1, 2, 3, 4}};
+        des_pos_ = {{0, 2*p_, 4*p_, 2+2*p_, 4}};
+        des_pos_incs_ = {{0, p_/2, p_, (1+p_)/2, 1}};
+    }
+
+private:
+    RealT p_; ///< The probability of the quantile to estimate
+    std::string name_;
+    std::size_t n_; ///< The number of collected observations
+    std::array<RealT,5> q_; ///< Marker heights
+    std::array<RealT,5> pos_; ///< Actual marker positions
+    std::array<RealT,5> des_pos_; ///< Desired marker positions
+    std::array<RealT,5> des_pos_incs_; ///< Increments of desired marker positions
+}; // p2_quantile_estimator_t
+
+
 template <typename RealT>
 class ci_mean_estimator_t
 {
@@ -28,9 +28,11 @@
 #define DCS_FOG_USER_MOBILITY_HPP
 
 
+#include <dcs/fog/user_mobility/commons.hpp>
 #include <dcs/fog/user_mobility/fixed_user_mobility_model.hpp>
 #include <dcs/fog/user_mobility/random_waypoint_user_mobility_model.hpp>
 #include <dcs/fog/user_mobility/step_user_mobility_model.hpp>
+#include <dcs/fog/user_mobility/uniform_grid_spatial_index.hpp>
 #include <dcs/fog/user_mobility/user_mobility_model.hpp>
 
 
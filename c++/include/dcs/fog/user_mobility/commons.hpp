@@ -0,0 +1,233 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fog/user_mobility/commons.hpp
+ *
+ * \brief Common definitions for user mobility models.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FOG_USER_MOBILITY_COMMONS_HPP
+#define DCS_FOG_USER_MOBILITY_COMMONS_HPP
+
+
+#include <algorithm>
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <iterator>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+# define DCS_FOG_USER_MOBILITY_X86_SIMD 1
+# include <immintrin.h>
+#endif
+
+
+namespace dcs { namespace fog {
+
+/// An axis-aligned rectangular area (borders included)
+struct rectangular_area_t
+{
+    rectangular_area_t()
+    : min_x(0),
+      max_x(0),
+      min_y(0),
+      max_y(0)
+    {
+    }
+
+    rectangular_area_t(double min_x, double max_x, double min_y, double max_y)
+    : min_x(min_x),
+      max_x(max_x),
+      min_y(min_y),
+      max_y(max_y)
+    {
+    }
+
+    double min_x;
+    double max_x;
+    double min_y;
+    double max_y;
+}; // rectangular_area_t
+
+
+namespace detail {
+
+typedef std::size_t (*count_points_in_area_kernel_t)(const double*, const double*, std::size_t, const rectangular_area_t&);
+
+inline std::size_t count_points_in_area_scalar(const double* x, const double* y, std::size_t n, const rectangular_area_t& area)
+{
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        count += (x[i] >= area.min_x) & (x[i] <= area.max_x) & (y[i] >= area.min_y) & (y[i] <= area.max_y);
+    }
+
+    return count;
+}
+
+#ifdef DCS_FOG_USER_MOBILITY_X86_SIMD
+
+__attribute__((target("avx2")))
+inline std::size_t count_points_in_area_avx2(const double* x, const double* y, std::size_t n, const rectangular_area_t& area)
+{
+    auto const min_x = _mm256_set1_pd(area.min_x);
+    auto const max_x = _mm256_set1_pd(area.max_x);
+    auto const min_y = _mm256_set1_pd(area.min_y);
+    auto const max_y = _mm256_set1_pd(area.max_y);
+
+    // Each lane of the comparison mask is all ones (i.e., -1) for points inside the area
+    auto acc = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i+4 <= n; i += 4)
+    {
+        auto const px = _mm256_loadu_pd(x+i);
+        auto const py = _mm256_loadu_pd(y+i);
+        auto const in_x = _mm256_and_pd(_mm256_cmp_pd(px, min_x, _CMP_GE_OQ), _mm256_cmp_pd(px, max_x, _CMP_LE_OQ));
+        auto const in_y = _mm256_and_pd(_mm256_cmp_pd(py, min_y, _CMP_GE_OQ), _mm256_cmp_pd(py, max_y, _CMP_LE_OQ));
+        acc = _mm256_sub_epi64(acc, _mm256_castpd_si256(_mm256_and_pd(in_x, in_y)));
+    }
+
+    alignas(32) long long lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+
+    return static_cast<std::size_t>(lanes[0]+lanes[1]+lanes[2]+lanes[3])
+           + count_points_in_area_scalar(x+i, y+i, n-i, area);
+}
+
+__attribute__((target("avx512f")))
+inline std::size_t count_points_in_area_avx512(const double* x, const double* y, std::size_t n, const rectangular_area_t& area)
+{
+    auto const min_x = _mm512_set1_pd(area.min_x);
+    auto const max_x = _mm512_set1_pd(area.max_x);
+    auto const min_y = _mm512_set1_pd(area.min_y);
+    auto const max_y = _mm512_set1_pd(area.max_y);
+
+    std::size_t count = 0;
+    std::size_t i = 0;
+    for (; i+8 <= n; i += 8)
+    {
+        auto const px = _mm512_loadu_pd(x+i);
+        auto const py = _mm512_loadu_pd(y+i);
+        auto in = _mm512_cmp_pd_mask(px, min_x, _CMP_GE_OQ);
+        in = _mm512_mask_cmp_pd_mask(in, px, max_x, _CMP_LE_OQ);
+        in = _mm512_mask_cmp_pd_mask(in, py, min_y, _CMP_GE_OQ);
+        in = _mm512_mask_cmp_pd_mask(in, py, max_y, _CMP_LE_OQ);
+        count += __builtin_popcount(static_cast<unsigned int>(in));
+    }
+
+    return count + count_points_in_area_scalar(x+i, y+i, n-i, area);
+}
+
+#endif // DCS_FOG_USER_MOBILITY_X86_SIMD
+
+/// Selects the fastest kernel supported by the CPU the program is running on
+inline count_points_in_area_kernel_t select_count_points_in_area_kernel()
+{
+#ifdef DCS_FOG_USER_MOBILITY_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        DCS_DEBUG_TRACE("Counting points in areas with AVX-512");
+        return count_points_in_area_avx512;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        DCS_DEBUG_TRACE("Counting points in areas with AVX2");
+        return count_points_in_area_avx2;
+    }
+#endif // DCS_FOG_USER_MOBILITY_X86_SIMD
+
+    return count_points_in_area_scalar;
+}
+
+inline count_points_in_area_kernel_t count_points_in_area_kernel()
+{
+    static const count_points_in_area_kernel_t kernel = select_count_points_in_area_kernel();
+
+    return kernel;
+}
+
+} // Namespace detail
+
+
+/**
+ * \brief Counts the points inside the given area.
+ *
+ * Points are given as a structure of arrays, that is \a x[i] and \a y[i] are
+ * the coordinates of the i-th point.
+ * The count is carried out with the widest SIMD instruction set (AVX-512 or
+ * AVX2) supported by the CPU at run time, falling back to a scalar loop.
+ */
+inline std::size_t count_points_in_area(const double* x, const double* y, std::size_t n, const rectangular_area_t& area)
+{
+    return detail::count_points_in_area_kernel()(x, y, n, area);
+}
+
+inline std::size_t count_points_in_area(const std::vector<double>& x, const std::vector<double>& y, const rectangular_area_t& area)
+{
+    DCS_DEBUG_ASSERT( x.size() == y.size() );
+
+    return count_points_in_area(x.data(), y.data(), x.size(), area);
+}
+
+/**
+ * \brief Counts the points inside each of the given areas, in a single pass
+ *  over the points.
+ *
+ * Points are visited in blocks small enough to stay in cache while they are
+ * tested against every area, so that the coordinate arrays are read from
+ * memory only once whatever the number of areas.
+ * The count for the k-th area is written to the k-th element of the output
+ * range.
+ */
+template <typename AreaIterT, typename OutIterT>
+OutIterT count_points_in_areas(const double* x, const double* y, std::size_t n, AreaIterT areas_first, AreaIterT areas_last, OutIterT counts_first)
+{
+    const std::size_t block_size = 2048;
+
+    auto const kernel = detail::count_points_in_area_kernel();
+
+    std::vector<std::size_t> counts(std::distance(areas_first, areas_last), 0);
+    for (std::size_t i = 0; i < n; i += block_size)
+    {
+        auto const m = std::min(block_size, n-i);
+
+        std::size_t k = 0;
+        for (auto area_it = areas_first; area_it != areas_last; ++area_it)
+        {
+            counts[k++] += kernel(x+i, y+i, m, *area_it);
+        }
+    }
+
+    return std::copy(counts.begin(), counts.end(), counts_first);
+}
+
+template <typename AreaIterT, typename OutIterT>
+OutIterT count_points_in_areas(const std::vector<double>& x, const std::vector<double>& y, AreaIterT areas_first, AreaIterT areas_last, OutIterT counts_first)
+{
+    DCS_DEBUG_ASSERT( x.size() == y.size() );
+
+    return count_points_in_areas(x.data(), y.data(), x.size(), areas_first, areas_last, counts_first);
+}
+
+}} // Namespace dcs::fog
+
+#endif // DCS_FOG_USER_MOBILITY_COMMONS_HPP
@@ -60,6 +60,11 @@ private:
         return num_nodes_;
     }
 
+    fixed_user_mobility_model_t* do_clone() const
+    {
+        return new fixed_user_mobility_model_t(*this);
+    }
+
 
 private:
     std::size_t num_nodes_;
@@ -11,6 +11,7 @@
  * REFERENCES:
  * - Mao, Shiwen (2010). "Fundamentals of Communication Networks". Cognitive Radio Communications and Networks. pp. 201–234.
  *   [doi:10.1016/B978-0-12-374715-0.00008-3]
+ * - PyMobility, https://github.com/panisson/pymobility
  * .
  *
  * \author Marco Guazzone (marco.guazzone@gmail.com)
@@ -36,17 +37,15 @@
 #define DCS_FOG_USER_MOBILITY_RANDOM_WAYPOINT_USER_MOBILITY_MODEL_HPP
 
 
-#include <array>
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
-#include <cstdio>
-#include <cstring>
-#include <dcs/debug.hpp>
+#include <dcs/fog/random.hpp>
+#include <dcs/fog/user_mobility/uniform_grid_spatial_index.hpp>
 #include <dcs/fog/user_mobility/user_mobility_model.hpp>
-#include <dcs/logging.hpp>
-#include <fstream>
-#include <rndwaypoint/RndWalkPnt.hpp>
-#include <stdexcept>
+#include <random>
+#include <vector>
 
 
 namespace dcs { namespace fog {
@@ -62,18 +61,26 @@ namespace dcs { namespace fog {
  * - max_x: the max x dimension of the simulation area.
  * - max_y: the max y dimension of the simulation area.
  * - min_v: the min value for node velocity.
+ * - max_v: the max value for node velocity.
  * - max_wt: the max waiting time for node pauses (0 means no pause time).
  * - seed: the seed for initializing the random number generator
  * .
+ *
+ * Every call to \c next moves all the nodes by one time step, following the
+ * same kinematics as the \c random_waypoint model of PyMobility, and returns
+ * the number of nodes that are inside the area covered by the fog node, that
+ * is the rectangle centered in the simulation area whose sides are 10% of the
+ * ones of the simulation area.
+ *
+ * Node states are stored as a structure of arrays, so that the movement of
+ * nodes is a simple loop over contiguous arrays that the compiler can
+ * vectorize, and the nodes inside the fog node area are counted with the
+ * SIMD kernel of count_points_in_area.
+ * Users inside arbitrary areas (e.g., the ones covered by many fog nodes) are
+ * counted through a uniform-grid spatial index of node positions.
  */
 class random_waypoint_user_mobility_model_t: public user_mobility_model_t
 {
-private:
-    static constexpr std::size_t rwp_num_args = 4;
-    static constexpr const char* rwp_py_module = "rndWayPoint";
-    static constexpr const char* rwp_py_function = "nextPlease";
-
-
 public:
     //static constexpr std::size_t default_num_nodes = 300;
     //static constexpr std::size_t default_max_x = 100;
@@ -98,97 +105,165 @@ public:
       min_v_(min_v),
       max_v_(max_v),
       max_wt_(max_wt),
-      seed_(seed)
+      rng_(seed)
     {
-        initialize_py_script();
-    }
-
-    ~random_waypoint_user_mobility_model_t()
-    {
-        finalize_py_script();
+        init();
+        init_nodes();
     }
 
 
 private:
+    static constexpr std::size_t max_grid_cells = 2048; ///< Maximum number of cells per side of the spatial index
+    static constexpr std::size_t max_scanned_areas = 32; ///< Maximum number of areas counted by scanning all nodes rather than through the spatial index
+
+
     std::size_t do_next()
     {
-        auto ret = rwp_.nextPlease();
-        if (ret < 0)
+        move();
+
+        return count_points_in_area(pos_x_, pos_y_, fn_area_);
+    }
+
+    std::vector<std::size_t> do_next_in_areas(const std::vector<rectangular_area_t>& areas)
+    {
+        move();
+
+        std::vector<std::size_t> counts(areas.size());
+        if (areas.size() <= max_scanned_areas)
+        {
+            // With few areas a single blocked pass over the nodes is cheaper than building the index
+            count_points_in_areas(pos_x_, pos_y_, areas.begin(), areas.end(), counts.begin());
+        }
+        else
         {
-            throw std::runtime_error("Error while calling Python script for random waypoint user mobility model");
+            grid_.build(pos_x_, pos_y_);
+            grid_.count(areas.begin(), areas.end(), counts.begin());
         }
 
-        return static_cast<std::size_t>(ret);
+        return counts;
     }
 
-    void initialize_py_script()
+    random_waypoint_user_mobility_model_t* do_clone() const
     {
-        // Initialize Python script for the mobility model
-        // - Write model parameters to file
-//FIXME: std::tmpnam is not recommended, better use tempfile or mkstemp
-        std::string cfg_fname = std::tmpnam(nullptr);
-        std::ofstream ofs(cfg_fname);
-        ofs << "[WayPoint]" << std::endl
-            << "nr_nodes: " << num_nodes_ << std::endl
-            << "MAX_X: " << max_x_ << std::endl
-            << "MAX_Y: " << max_y_ << std::endl
-            << "MIN_V: " << min_v_ << std::endl
-            << "MAX_V: " << max_v_ << std::endl
-            << "MAX_WT: " << max_wt_ << std::endl
-            //<< "#seed: 0xffff" << std::endl; //FIXME: currently this param is not nused
-            << "seed: " << seed_ << std::endl;
-        ofs.close();
-
-        // - Prepare the arguments (i.e., module and file names)
-        std::size_t sz = 0;
-        std::size_t arg = 0;
-        // arg 0: not used (however, we can't pass a null pointer because Python doesn't like it)
-        sz = 1;
-        rwp_args_[arg] = new char[sz];
-        std::strncpy(rwp_args_[arg], "", 1);
-        // arg 1: module name
-        ++arg;
-        sz = std::strlen(rwp_py_module)+1;
-        rwp_args_[arg] = new char[sz];
-        std::strncpy(rwp_args_[arg], rwp_py_module, sz);
-        // arg 2: function name
-        ++arg;
-        sz = std::strlen(rwp_py_function)+1;
-        rwp_args_[arg] = new char[sz];
-        std::strncpy(rwp_args_[arg], rwp_py_function, sz);
-        // arg 3: config file name
-        ++arg;
-        sz = cfg_fname.size()+1;
-        rwp_args_[arg] = new char[sz];
-        std::strncpy(rwp_args_[arg], cfg_fname.c_str(), sz);
-        // sanity check
-        DCS_DEBUG_ASSERT( rwp_num_args == rwp_args_.size() );
-        // - Setup
-        auto ret = rwp_.setup(rwp_args_.size(), rwp_args_.data());
-        if (ret < 0)
+        return new random_waypoint_user_mobility_model_t(*this);
+    }
+
+    /// Reseeds the random number generator and restarts the nodes from the positions and waypoints it draws, as a newly built model would do
+    void do_seed(std::seed_seq& seq)
+    {
+        rng_.seed(seq);
+        init_nodes();
+    }
+
+    void init()
+    {
+        // The area covered by the fog node
+        auto const fn_len_x = 0.1*max_x_;
+        auto const fn_len_y = 0.1*max_y_;
+        auto const center_x = max_x_/2.0;
+        auto const center_y = max_y_/2.0;
+        fn_area_ = rectangular_area_t(center_x-fn_len_x/2.0,
+                                      center_x+fn_len_x/2.0,
+                                      center_y-fn_len_y/2.0,
+                                      center_y+fn_len_y/2.0);
+
+        // About 16 nodes per cell of the spatial index (border cells are scanned with SIMD, so cells need not be tiny)
+        // (max_grid_cells is cast to a temporary, since binding it to the reference parameters of std::min would ODR-use it)
+        auto const num_cells = std::min(static_cast<std::size_t>(std::sqrt(num_nodes_/16.0)), static_cast<std::size_t>(max_grid_cells));
+        grid_ = uniform_grid_spatial_index_t(max_x_, max_y_, num_cells, num_cells);
+    }
+
+    /// Draws the initial positions, waypoints and velocities of nodes
+    void init_nodes()
+    {
+        // Nodes start at uniformly random positions and move towards uniformly random waypoints
+        std::uniform_real_distribution<double> x_rvg(0, max_x_);
+        std::uniform_real_distribution<double> y_rvg(0, max_y_);
+
+        pos_x_.resize(num_nodes_);
+        pos_y_.resize(num_nodes_);
+        for (std::size_t i = 0; i < num_nodes_; ++i)
         {
-            throw std::runtime_error("Unable to initialize the Python script");
+            pos_x_[i] = x_rvg(rng_);
+            pos_y_[i] = y_rvg(rng_);
+        }
+        wp_x_.resize(num_nodes_);
+        wp_y_.resize(num_nodes_);
+        dir_x_.resize(num_nodes_);
+        dir_y_.resize(num_nodes_);
+        vel_.resize(num_nodes_);
+        wt_.assign(num_nodes_, 0);
+        for (std::size_t i = 0; i < num_nodes_; ++i)
+        {
+            next_waypoint(i);
         }
     }
 
-    void finalize_py_script()
+    /// Moves all the nodes by one time step
+    void move()
     {
-        auto ret = rwp_.dismiss();
-        if (ret < 0)
+        for (std::size_t i = 0; i < num_nodes_; ++i)
         {
-            dcs::log_warn(DCS_LOGGING_AT, "Problems when finalizing the Python script");
+            pos_x_[i] += dir_x_[i]*vel_[i];
+            pos_y_[i] += dir_y_[i]*vel_[i];
         }
 
-        for (std::size_t i = 0; i < rwp_args_.size(); ++i)
+        for (std::size_t i = 0; i < num_nodes_; ++i)
         {
-            if (rwp_args_[i])
+            bool restart = false;
+
+            // Nodes that are close enough to their waypoint reach it and, if pauses are enabled, pause there
+            auto const dx = wp_x_[i]-pos_x_[i];
+            auto const dy = wp_y_[i]-pos_y_[i];
+            if ((dx*dx+dy*dy) <= (vel_[i]*vel_[i]) && wt_[i] <= 0)
             {
-                delete[] rwp_args_[i];
-                rwp_args_[i] = 0;
+                pos_x_[i] = wp_x_[i];
+                pos_y_[i] = wp_y_[i];
+                if (max_wt_ > 0)
+                {
+                    std::uniform_real_distribution<double> wt_rvg(0, max_wt_);
+
+                    vel_[i] = 0;
+                    wt_[i] = wt_rvg(rng_);
+                }
+                else
+                {
+                    restart = true;
+                }
+            }
+
+            // Paused nodes restart when their waiting time is over
+            if (max_wt_ > 0 && vel_[i] == 0)
+            {
+                wt_[i] -= 1;
+                restart = wt_[i] < 0;
+            }
+
+            if (restart)
+            {
+                next_waypoint(i);
             }
         }
     }
 
+    /// Assigns a new waypoint and a new velocity to the given node
+    void next_waypoint(std::size_t i)
+    {
+        std::uniform_real_distribution<double> x_rvg(0, max_x_);
+        std::uniform_real_distribution<double> y_rvg(0, max_y_);
+        std::uniform_real_distribution<double> v_rvg(min_v_, max_v_);
+
+        wp_x_[i] = x_rvg(rng_);
+        wp_y_[i] = y_rvg(rng_);
+        vel_[i] = v_rvg(rng_);
+
+        auto const dx = wp_x_[i]-pos_x_[i];
+        auto const dy = wp_y_[i]-pos_y_[i];
+        auto const norm = std::sqrt(dx*dx+dy*dy);
+        dir_x_[i] = (norm > 0) ? dx/norm : 0;
+        dir_y_[i] = (norm > 0) ? dy/norm : 0;
+    }
+
 
 private:
     std::size_t num_nodes_;
@@ -197,13 +272,17 @@ private:
     std::size_t min_v_;
     std::size_t max_v_;
     std::size_t max_wt_;
-    std::uint32_t seed_;
-#if 1 //FIXME: enable the code fragment below to use std:array instead of plain char**
-    std::array<char*,rwp_num_args> rwp_args_; /// Arguments to pass to the Python script for the mobility model
-#else
-    char** rwp_args_; /// Arguments to pass to the Python script for the mobility model
-#endif
-    RndWalkPnt rwp_; ///< Interface to the Python script for the mobility model
+    random_number_engine_t rng_; ///< The random number generator that drives the movement of nodes
+    rectangular_area_t fn_area_; ///< The area covered by the fog node
+    std::vector<double> pos_x_; ///< The x coordinate of node positions
+    std::vector<double> pos_y_; ///< The y coordinate of node positions
+    std::vector<double> wp_x_; ///< The x coordinate of node waypoints
+    std::vector<double> wp_y_; ///< The y coordinate of node waypoints
+    std::vector<double> dir_x_; ///< The x component of the (unit) direction of nodes
+    std::vector<double> dir_y_; ///< The y component of the (unit) direction of nodes
+    std::vector<double> vel_; ///< The velocity of nodes (0 for paused nodes)
+    std::vector<double> wt_; ///< The residual waiting time of paused nodes
+    uniform_grid_spatial_index_t grid_; ///< Spatial index of node positions
 }; // random_waypoint_user_mobility_model_t
 
 }} // Namespace dcs::fog
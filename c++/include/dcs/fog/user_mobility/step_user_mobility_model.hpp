@@ -88,6 +88,11 @@ private:
         return num_nodes_seq_[next_idx_++ % num_nodes_seq_.size()];
     }
 
+    step_user_mobility_model_t* do_clone() const
+    {
+        return new step_user_mobility_model_t(*this);
+    }
+
 
 private:
     std::vector<std::size_t> num_nodes_seq_;
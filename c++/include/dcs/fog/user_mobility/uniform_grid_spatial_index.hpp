@@ -0,0 +1,237 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fog/user_mobility/uniform_grid_spatial_index.hpp
+ *
+ * \brief Uniform-grid spatial index to count users inside areas.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FOG_USER_MOBILITY_UNIFORM_GRID_SPATIAL_INDEX_HPP
+#define DCS_FOG_USER_MOBILITY_UNIFORM_GRID_SPATIAL_INDEX_HPP
+
+
+#include <algorithm>
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <dcs/fog/user_mobility/commons.hpp>
+#include <vector>
+
+
+namespace dcs { namespace fog {
+
+/**
+ * \brief Uniform-grid spatial index.
+ *
+ * Partitions the rectangle [0,max_x]x[0,max_y] into a grid of equally sized
+ * cells and sorts points by cell (points outside the rectangle go to the
+ * nearest border cell).
+ * The number of points inside an area is then the number of points in the
+ * cells that are fully covered by the area, which comes from a summed-area
+ * table of cell counts in O(1), plus the number of points inside the area
+ * among the ones in the cells along the area border, which are tested one by
+ * one.
+ * Thus, counting the users near thousands of fog nodes does not need a scan
+ * over all the users for each fog node.
+ */
+class uniform_grid_spatial_index_t
+{
+public:
+    uniform_grid_spatial_index_t()
+    : uniform_grid_spatial_index_t(1, 1, 1, 1)
+    {
+    }
+
+    uniform_grid_spatial_index_t(double max_x, double max_y, std::size_t num_cells_x, std::size_t num_cells_y)
+    : nx_(std::max(num_cells_x, static_cast<std::size_t>(1))),
+      ny_(std::max(num_cells_y, static_cast<std::size_t>(1))),
+      inv_cell_width_(nx_/max_x),
+      inv_cell_height_(ny_/max_y),
+      cell_starts_(nx_*ny_+1, 0),
+      cell_sums_((nx_+1)*(ny_+1), 0)
+    {
+    }
+
+    /// Indexes the given points (the i-th point is <x[i],y[i]>), replacing the ones previously indexed
+    void build(const double* x, const double* y, std::size_t n)
+    {
+        // Sort points by cell (counting sort)
+        point_cells_.resize(n);
+        std::fill(cell_starts_.begin(), cell_starts_.end(), 0);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto const cell = cell_y(y[i])*nx_+cell_x(x[i]);
+
+            point_cells_[i] = cell;
+            ++cell_starts_[cell+1];
+        }
+        for (std::size_t cell = 0; cell < nx_*ny_; ++cell)
+        {
+            cell_starts_[cell+1] += cell_starts_[cell];
+        }
+
+        sorted_x_.resize(n);
+        sorted_y_.resize(n);
+        cell_ends_.assign(cell_starts_.begin(), cell_starts_.end()-1);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto const pos = cell_ends_[point_cells_[i]]++;
+
+            sorted_x_[pos] = x[i];
+            sorted_y_[pos] = y[i];
+        }
+
+        // Summed-area table: cell_sums_[cy*(nx_+1)+cx] is the number of points in the cells <i,j> with i < cx and j < cy
+        for (std::size_t cy = 0; cy < ny_; ++cy)
+        {
+            std::size_t row_sum = 0;
+            for (std::size_t cx = 0; cx < nx_; ++cx)
+            {
+                auto const cell = cy*nx_+cx;
+
+                row_sum += cell_starts_[cell+1]-cell_starts_[cell];
+                cell_sums_[(cy+1)*(nx_+1)+cx+1] = cell_sums_[cy*(nx_+1)+cx+1]+row_sum;
+            }
+        }
+    }
+
+    void build(const std::vector<double>& x, const std::vector<double>& y)
+    {
+        DCS_DEBUG_ASSERT( x.size() == y.size() );
+
+        build(x.data(), y.data(), x.size());
+    }
+
+    /// Returns the number of indexed points inside the given area (borders included)
+    std::size_t count(const rectangular_area_t& area) const
+    {
+        if (area.max_x < area.min_x || area.max_y < area.min_y)
+        {
+            return 0;
+        }
+
+        // Since the mapping of coordinates to cells is monotone, points in
+        // cells strictly between the ones of the area corners are inside the
+        // area, while points in cells outside the range of cells of the area
+        // corners are outside of it
+        auto const bx0 = cell_x(area.min_x);
+        auto const bx1 = cell_x(area.max_x);
+        auto const by0 = cell_y(area.min_y);
+        auto const by1 = cell_y(area.max_y);
+
+        std::size_t count = 0;
+
+        // Interior cells
+        if (bx1 > bx0+1 && by1 > by0+1)
+        {
+            count += cell_sums_[by1*(nx_+1)+bx1]
+                   - cell_sums_[(by0+1)*(nx_+1)+bx1]
+                   - cell_sums_[by1*(nx_+1)+bx0+1]
+                   + cell_sums_[(by0+1)*(nx_+1)+bx0+1];
+        }
+
+        // Border cells: the bottom and top rows are contiguous in the sorted points, while the left and right columns are visited cell by cell
+        count += count_in_cells(by0*nx_+bx0, by0*nx_+bx1, area);
+        if (by1 != by0)
+        {
+            count += count_in_cells(by1*nx_+bx0, by1*nx_+bx1, area);
+        }
+        for (std::size_t cy = by0+1; cy < by1; ++cy)
+        {
+            count += count_in_cells(cy*nx_+bx0, cy*nx_+bx0, area);
+            if (bx1 != bx0)
+            {
+                count += count_in_cells(cy*nx_+bx1, cy*nx_+bx1, area);
+            }
+        }
+
+        return count;
+    }
+
+    /// Writes the number of indexed points inside each of the given areas to the output range
+    template <typename AreaIterT, typename OutIterT>
+    OutIterT count(AreaIterT areas_first, AreaIterT areas_last, OutIterT counts_first) const
+    {
+        while (areas_first != areas_last)
+        {
+            *counts_first = count(*areas_first);
+            ++counts_first;
+            ++areas_first;
+        }
+
+        return counts_first;
+    }
+
+    std::size_t num_points() const
+    {
+        return sorted_x_.size();
+    }
+
+
+private:
+    std::size_t cell_x(double x) const
+    {
+        return to_cell(x*inv_cell_width_, nx_);
+    }
+
+    std::size_t cell_y(double y) const
+    {
+        return to_cell(y*inv_cell_height_, ny_);
+    }
+
+    static std::size_t to_cell(double v, std::size_t n)
+    {
+        if (!(v > 0))
+        {
+            return 0;
+        }
+        if (v >= n)
+        {
+            return n-1;
+        }
+        return static_cast<std::size_t>(v);
+    }
+
+    /// Counts the points inside the given area among the ones in the cells first_cell,...,last_cell
+    std::size_t count_in_cells(std::size_t first_cell, std::size_t last_cell, const rectangular_area_t& area) const
+    {
+        auto const first = cell_starts_[first_cell];
+        auto const last = cell_starts_[last_cell+1];
+
+        return count_points_in_area(sorted_x_.data()+first, sorted_y_.data()+first, last-first, area);
+    }
+
+
+private:
+    std::size_t nx_; ///< The number of cells along the x axis
+    std::size_t ny_; ///< The number of cells along the y axis
+    double inv_cell_width_; ///< The inverse of the width of a cell
+    double inv_cell_height_; ///< The inverse of the height of a cell
+    std::vector<std::size_t> cell_starts_; ///< The position of the first point of each cell in the sorted points (plus the total number of points)
+    std::vector<std::size_t> cell_ends_; ///< Scratch space used while sorting points
+    std::vector<std::size_t> cell_sums_; ///< The summed-area table of the number of points by cell
+    std::vector<std::size_t> point_cells_; ///< Scratch space with the cell of each point, used while sorting points
+    std::vector<double> sorted_x_; ///< The x coordinate of points, sorted by cell
+    std::vector<double> sorted_y_; ///< The y coordinate of points, sorted by cell
+}; // uniform_grid_spatial_index_t
+
+}} // Namespace dcs::fog
+
+#endif // DCS_FOG_USER_MOBILITY_UNIFORM_GRID_SPATIAL_INDEX_HPP
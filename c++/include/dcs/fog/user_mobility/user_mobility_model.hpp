@@ -29,6 +29,10 @@
 
 
 #include <cstddef>
+#include <dcs/fog/user_mobility/commons.hpp>
+#include <dcs/macro.hpp>
+#include <random>
+#include <vector>
 
 
 namespace dcs { namespace fog {
@@ -40,11 +44,43 @@ struct user_mobility_model_t
         return do_next();
     }
 
+    /// Advances the model by one step and returns the number of users inside each of the given areas
+    std::vector<std::size_t> next(const std::vector<rectangular_area_t>& areas)
+    {
+        return do_next_in_areas(areas);
+    }
+
+    /// Returns a new independent copy of this model (the caller takes ownership of the returned object)
+    user_mobility_model_t* clone() const
+    {
+        return do_clone();
+    }
+
+    /// Reinitializes the random number generator of this model, if any, with the given seed sequence
+    void seed(std::seed_seq& seq)
+    {
+        do_seed(seq);
+    }
+
     virtual ~user_mobility_model_t() { }
 
 
 private:
     virtual std::size_t do_next() = 0;
+
+    virtual std::vector<std::size_t> do_next_in_areas(const std::vector<rectangular_area_t>& areas)
+    {
+        // Models without a notion of user position see the same users everywhere
+        return std::vector<std::size_t>(areas.size(), do_next());
+    }
+
+    virtual user_mobility_model_t* do_clone() const = 0;
+
+    virtual void do_seed(std::seed_seq& seq)
+    {
+        // Deterministic models have nothing to seed
+        DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( seq );
+    }
 }; // user_mobility_model_t
 
 }} // Namespace dcs::fog
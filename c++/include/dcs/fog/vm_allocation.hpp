@@ -28,9 +28,21 @@
 #define DCS_FOG_VM_ALLOCATION_HPP
 
 
+#ifdef DCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER
+# include <dcs/fog/vm_allocation/aggregated_solver.hpp>
+#endif // DCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER
 #include <dcs/fog/vm_allocation/bahreini2017_mcapp_solver.hpp>
+#include <dcs/fog/vm_allocation/caching_solver.hpp>
 #include <dcs/fog/vm_allocation/commons.hpp>
-#include <dcs/fog/vm_allocation/optimal_solver.hpp>
+#include <dcs/fog/vm_allocation/greedy_solver.hpp>
+#ifdef DCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER
+# include <dcs/fog/vm_allocation/optimal_solver.hpp>
+#endif // DCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER
+#ifdef DCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER
+# include <dcs/fog/vm_allocation/ortools_solver.hpp>
+#endif // DCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER
+#include <dcs/fog/vm_allocation/portfolio_solver.hpp>
+#include <dcs/fog/vm_allocation/rolling_horizon_solver.hpp>
 
 
 #endif // DCS_FOG_VM_ALLOCATION_HPP
@@ -0,0 +1,979 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fog/vm_allocation/aggregated_solver.hpp
+ *
+ * \brief Solver for the VM allocation problem based on a category-aggregated
+ *  MILP formulation.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FOG_VM_ALLOCATION_AGGREGATED_SOLVER_HPP
+#define DCS_FOG_VM_ALLOCATION_AGGREGATED_SOLVER_HPP
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/fog/io.hpp>
+#include <dcs/fog/vm_allocation/commons.hpp>
+#include <dcs/fog/vm_allocation/optimal_solver.hpp>
+#include <dcs/logging.hpp>
+#include <dcs/math/traits/float.hpp>
+#include <ilconcert/iloalg.h>
+#include <ilconcert/iloenv.h>
+#include <ilconcert/iloexpression.h>
+#include <ilconcert/ilomodel.h>
+#include <ilcplex/ilocplex.h>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+namespace dcs { namespace fog {
+
+namespace detail {
+
+/**
+ * \brief Partitions FNs into groups of FNs that are equivalent for the
+ *  category-aggregated VM allocation problem.
+ *
+ * FNs of the same group belong to the same FN category, are in the same power
+ * state and are all either in or out of \a fixed_fns, so that they only differ
+ * for the VMs they currently host.
+ */
+inline
+std::vector<std::vector<std::size_t>> make_fn_aggregated_groups(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                                const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                                const std::set<std::size_t>& fixed_fns) // The set of selected FNs to use in the VM allocation (if empty, any FN can be used)
+{
+    const std::size_t nfns = fn_categories.size();
+
+    std::map<std::tuple<std::size_t,bool,bool>,std::vector<std::size_t>> key_fns;
+    for (std::size_t i = 0; i < nfns; ++i)
+    {
+        key_fns[std::make_tuple(fn_categories[i], bool(fn_power_states[i]), fixed_fns.count(i) > 0)].push_back(i);
+    }
+
+    std::vector<std::vector<std::size_t>> fn_groups;
+    for (auto& key_fn : key_fns)
+    {
+        fn_groups.push_back(std::move(key_fn.second));
+    }
+
+    return fn_groups;
+}
+
+/**
+ * \brief Turns a VM allocation by FN group into a VM allocation by FN.
+ *
+ * For each group, the FNs that currently host the largest share of the VMs
+ * to allocate on the group are powered on first, and the VMs they already
+ * host are kept in place.
+ * The remaining VMs are then packed into the powered-on FNs of the group by
+ * first-fit decreasing on their CPU requirement.
+ * Since the aggregated capacity constraints are a relaxation of the per-FN
+ * ones, a VM that does not fit is allocated on a further FN of the group (if
+ * any), otherwise it is left unallocated.
+ * Services with VMs left unallocated cannot meet their QoS, so all their
+ * VMs are dropped: they are thus penalized as unserved services rather than
+ * earning revenues for a partial allocation.
+ */
+template <typename RealT>
+void disaggregate_vm_allocation(const std::vector<std::vector<std::size_t>>& fn_groups, // The FNs of each group
+                                const std::vector<std::size_t>& group_num_on_fns, // The number of FNs to power on, by group
+                                const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& group_vm_allocations, // The VM allocations, by group and service
+                                const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                vm_allocation_t<RealT>& solution)
+{
+    const std::size_t nfns = fn_categories.size();
+
+    solution.fn_vm_allocations.assign(nfns, std::map<std::size_t,std::pair<std::size_t,std::size_t>>());
+    solution.fn_power_states.assign(nfns, false);
+    solution.fn_cpu_allocations.assign(nfns, 0);
+
+    std::set<std::size_t> unserved_svcs; // Services with some VM left unallocated
+
+    for (std::size_t g = 0; g < fn_groups.size(); ++g)
+    {
+        auto const& group_vm_allocs = group_vm_allocations[g];
+
+        if (fn_groups[g].empty())
+        {
+            continue;
+        }
+
+        auto const fn_cat = fn_categories[fn_groups[g].front()];
+
+        // Rank FNs by the CPU share of the VMs they can keep
+        std::vector<std::pair<RealT,std::size_t>> fn_ranks;
+        for (auto const fn : fn_groups[g])
+        {
+            RealT share = 0;
+            for (auto const& svc_vms : fn_vm_allocations[fn])
+            {
+                auto const it = group_vm_allocs.find(svc_vms.first);
+                if (it != group_vm_allocs.end() && it->second.first == svc_vms.second.first)
+                {
+                    share += std::min(svc_vms.second.second, it->second.second)*vm_cat_fn_cat_cpu_specs[svc_vms.second.first][fn_cat];
+                }
+            }
+            fn_ranks.push_back(std::make_pair(share, fn));
+        }
+        std::stable_sort(fn_ranks.begin(),
+                         fn_ranks.end(),
+                         [](const std::pair<RealT,std::size_t>& a, const std::pair<RealT,std::size_t>& b)
+                         {
+                            return a.first > b.first;
+                         });
+
+        std::map<std::size_t,std::pair<std::size_t,std::size_t>> left_vm_allocs = group_vm_allocs; // VMs still to allocate, by service
+
+        // Power on the selected FNs and keep in place the VMs they already host
+        std::size_t num_on_fns = std::min(group_num_on_fns[g], fn_ranks.size());
+        for (std::size_t r = 0; r < num_on_fns; ++r)
+        {
+            auto const fn = fn_ranks[r].second;
+
+            solution.fn_power_states[fn] = true;
+
+            for (auto const& svc_vms : fn_vm_allocations[fn])
+            {
+                auto const svc = svc_vms.first;
+                auto const vm_cat = svc_vms.second.first;
+
+                auto it = left_vm_allocs.find(svc);
+                if (it == left_vm_allocs.end() || it->second.first != vm_cat || it->second.second == 0)
+                {
+                    continue;
+                }
+
+                auto const cpu_req = vm_cat_fn_cat_cpu_specs[vm_cat][fn_cat];
+                std::size_t num_vms = std::min(svc_vms.second.second, it->second.second);
+                while (num_vms > 0 && (solution.fn_cpu_allocations[fn]+num_vms*cpu_req) > 1)
+                {
+                    --num_vms;
+                }
+                if (num_vms > 0)
+                {
+                    solution.fn_vm_allocations[fn][svc] = std::make_pair(vm_cat, num_vms);
+                    solution.fn_cpu_allocations[fn] += num_vms*cpu_req;
+                    it->second.second -= num_vms;
+                }
+            }
+        }
+
+        // Pack the remaining VMs by first-fit decreasing
+        std::vector<std::tuple<RealT,std::size_t,std::size_t>> vms; // <CPU requirement, service, VM category> triple for each VM to allocate
+        for (auto const& svc_vms : left_vm_allocs)
+        {
+            vms.insert(vms.end(), svc_vms.second.second, std::make_tuple(vm_cat_fn_cat_cpu_specs[svc_vms.second.first][fn_cat], svc_vms.first, svc_vms.second.first));
+        }
+        std::stable_sort(vms.begin(),
+                         vms.end(),
+                         [](const std::tuple<RealT,std::size_t,std::size_t>& a, const std::tuple<RealT,std::size_t,std::size_t>& b)
+                         {
+                            return std::get<0>(a) > std::get<0>(b);
+                         });
+        for (auto const& vm : vms)
+        {
+            auto const cpu_req = std::get<0>(vm);
+            auto const svc = std::get<1>(vm);
+            auto const vm_cat = std::get<2>(vm);
+
+            std::size_t r = 0;
+            while (r < num_on_fns && (solution.fn_cpu_allocations[fn_ranks[r].second]+cpu_req) > 1)
+            {
+                ++r;
+            }
+            if (r == num_on_fns)
+            {
+                if (num_on_fns == fn_ranks.size() || cpu_req > 1)
+                {
+                    std::ostringstream oss;
+                    oss << "Unable to disaggregate a VM (group: " << g << ", service: " << svc << ", VM category: " << vm_cat << "): the service will be unserved";
+                    dcs::log_warn(DCS_LOGGING_AT, oss.str());
+
+                    unserved_svcs.insert(svc);
+                    continue;
+                }
+
+                // Power on a further FN of the group
+                solution.fn_power_states[fn_ranks[r].second] = true;
+                ++num_on_fns;
+            }
+
+            auto const fn = fn_ranks[r].second;
+
+            if (solution.fn_vm_allocations[fn].count(svc) > 0)
+            {
+                solution.fn_vm_allocations[fn][svc].second += 1;
+            }
+            else
+            {
+                solution.fn_vm_allocations[fn][svc] = std::make_pair(vm_cat, 1);
+            }
+            solution.fn_cpu_allocations[fn] += cpu_req;
+        }
+    }
+
+    // Drop the VMs of unserved services
+    if (!unserved_svcs.empty())
+    {
+        for (std::size_t fn = 0; fn < nfns; ++fn)
+        {
+            auto const fn_cat = fn_categories[fn];
+
+            for (auto it = solution.fn_vm_allocations[fn].begin(); it != solution.fn_vm_allocations[fn].end();)
+            {
+                if (unserved_svcs.count(it->first) > 0)
+                {
+                    solution.fn_cpu_allocations[fn] -= it->second.second*vm_cat_fn_cat_cpu_specs[it->second.first][fn_cat];
+                    it = solution.fn_vm_allocations[fn].erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            if (solution.fn_vm_allocations[fn].empty())
+            {
+                solution.fn_cpu_allocations[fn] = 0;
+            }
+        }
+    }
+}
+
+} // Namespace detail
+
+
+/**
+ * \brief Solver for the VM allocation problem based on a category-aggregated
+ *  MILP formulation.
+ *
+ * Rather than deciding the power state and the VM allocation of each FN, the
+ * model decides how many FNs of each group (i.e., FNs of the same category, in
+ * the same power state and either all selected or all not selected) are to be
+ * powered on and how many VMs of each service and VM category are to be
+ * allocated on each group. The size of the model thus depends on the number
+ * of FN categories rather than on the number of FNs.
+ * The resulting allocation is then turned into a per-FN VM allocation by means
+ * of a bin-packing pass (see \c detail::disaggregate_vm_allocation), and its
+ * revenue and cost are recomputed accordingly.
+ *
+ * Since the CPU capacity and the VM reallocation costs are aggregated by group,
+ * the objective value of the model is an upper bound to the one of the optimal
+ * VM allocation problem. The returned VM allocation is flagged as optimal only
+ * when this bound is attained.
+ */
+template <typename RealT>
+class aggregated_vm_allocation_solver_t: public base_vm_allocation_solver_t<RealT>
+{
+public:
+    explicit aggregated_vm_allocation_solver_t(RealT relative_tolerance = 0,
+                                               RealT time_limit = -1)
+    : rel_tol_(relative_tolerance),
+      time_lim_(time_limit)
+    {
+    }
+
+    vm_allocation_t<RealT> solve(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                 const std::vector<bool>& fn_power_states, // The power status of each FN
+                                 const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                 const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                 const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                 const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                 const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                 const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                 const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                 const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                 const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                 const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                 const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                 const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                 RealT deltat = 1 // Length of the time interval
+                            ) const
+    {
+        return by_native_cplex(fn_categories,
+                               fn_power_states,
+                               fn_vm_allocations,
+                               std::set<std::size_t>(), // Any FN can be selected
+                               std::vector<bool>(), // No starting point
+                               std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>(),
+                               fn_cat_min_powers,
+                               fn_cat_max_powers,
+                               vm_cat_fn_cat_cpu_specs,
+                               vm_cat_alloc_costs,
+                               svc_categories,
+                               svc_cat_vm_cat_min_num_vms,
+                               fp_svc_cat_revenues,
+                               fp_svc_cat_penalties,
+                               fp_electricity_cost,
+                               fp_fn_cat_asleep_costs,
+                               fp_fn_cat_awake_costs,
+                               deltat);
+    }
+
+    vm_allocation_t<RealT> solve_with_fixed_fns(const std::set<std::size_t>& fixed_fns,
+                                                const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                                const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                                const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                                const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                RealT deltat = 1 // Length of the time interval
+                            ) const
+    {
+        return by_native_cplex(fn_categories,
+                               fn_power_states,
+                               fn_vm_allocations,
+                               fixed_fns,
+                               std::vector<bool>(), // No starting point
+                               std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>(),
+                               fn_cat_min_powers,
+                               fn_cat_max_powers,
+                               vm_cat_fn_cat_cpu_specs,
+                               vm_cat_alloc_costs,
+                               svc_categories,
+                               svc_cat_vm_cat_min_num_vms,
+                               fp_svc_cat_revenues,
+                               fp_svc_cat_penalties,
+                               fp_electricity_cost,
+                               fp_fn_cat_asleep_costs,
+                               fp_fn_cat_awake_costs,
+                               deltat);
+    }
+
+
+    vm_allocation_t<RealT> solve_with_fixed_fns_from(const vm_allocation_t<RealT>& start_vm_alloc, // The VM allocation from which to start the search
+                                                     const std::set<std::size_t>& fixed_fns,
+                                                     const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                     const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                     const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                     const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                     const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                     const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                     const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                     const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                     const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                                     const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                                     const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                                     const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                     const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                     const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                     RealT deltat = 1 // Length of the time interval
+                            ) const
+    {
+        // The starting point is only used if it refers to the same FNs
+        const bool use_start = start_vm_alloc.fn_power_states.size() == fn_power_states.size()
+                               && start_vm_alloc.fn_vm_allocations.size() == fn_vm_allocations.size();
+
+        return by_native_cplex(fn_categories,
+                               fn_power_states,
+                               fn_vm_allocations,
+                               fixed_fns,
+                               use_start ? start_vm_alloc.fn_power_states : std::vector<bool>(),
+                               use_start ? start_vm_alloc.fn_vm_allocations : std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>(),
+                               fn_cat_min_powers,
+                               fn_cat_max_powers,
+                               vm_cat_fn_cat_cpu_specs,
+                               vm_cat_alloc_costs,
+                               svc_categories,
+                               svc_cat_vm_cat_min_num_vms,
+                               fp_svc_cat_revenues,
+                               fp_svc_cat_penalties,
+                               fp_electricity_cost,
+                               fp_fn_cat_asleep_costs,
+                               fp_fn_cat_awake_costs,
+                               deltat);
+    }
+
+
+private:
+    vm_allocation_t<RealT> by_native_cplex(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                           const std::vector<bool>& fn_power_states, // The power status of each FN
+                                           const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                           const std::set<std::size_t>& fixed_fns, // The set of selected FNs to use in the VM allocation (if empty, any FN may be used)
+                                           const std::vector<bool>& hint_fn_power_states, // The power status of each FN in the VM allocation from which to start the search (if empty, no MIP start is given)
+                                           const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& hint_fn_vm_allocations, // The VM allocations from which to start the search, by FN and service
+                                           const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                           const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                           const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                           const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                           const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                           const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                           const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service category
+                                           const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service category
+                                           const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                           const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                           const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                           RealT deltat) const // Length of the time interval
+    {
+        DCS_DEBUG_TRACE("Finding VM allocation by solving the category-aggregated optimization problem:");
+        DCS_DEBUG_TRACE("- Number of FNs: " << fn_categories.size());
+        DCS_DEBUG_TRACE("- FN Categories: " << fn_categories);
+        DCS_DEBUG_TRACE("- FN Power States: " << fn_power_states);
+        DCS_DEBUG_TRACE("- FN - VM Allocations: " << fn_vm_allocations);
+        DCS_DEBUG_TRACE("- FN Fixed: " << fixed_fns);
+        DCS_DEBUG_TRACE("- Relative Tolerance: " << rel_tol_);
+        DCS_DEBUG_TRACE("- Time Limit: " << time_lim_);
+
+        vm_allocation_t<RealT> solution;
+
+        const std::size_t nfns = fn_categories.size();
+        const std::size_t nsvcs = svc_categories.size();
+        const std::size_t nvmcats = vm_cat_fn_cat_cpu_specs.size();
+
+        DCS_ASSERT( nfns == fn_power_states.size(),
+                    DCS_EXCEPTION_THROW( std::logic_error,
+                                         "FN power states container has a wrong size" ) );
+
+        DCS_ASSERT( nfns == fn_vm_allocations.size(),
+                    DCS_EXCEPTION_THROW( std::logic_error,
+                                         "FN VM allocations container has a wrong size" ) );
+
+        auto const fn_groups = detail::make_fn_aggregated_groups(fn_categories, fn_power_states, fixed_fns);
+        const std::size_t ngrps = fn_groups.size();
+
+        // The number of class-k VMs currently allocated on the FNs of group g for service j
+        std::vector<std::vector<std::vector<IloInt>>> old_z(ngrps, std::vector<std::vector<IloInt>>(nsvcs, std::vector<IloInt>(nvmcats, 0)));
+        for (std::size_t g = 0; g < ngrps; ++g)
+        {
+            for (auto const fn : fn_groups[g])
+            {
+                for (auto const& svc_vms : fn_vm_allocations[fn])
+                {
+                    old_z[g][svc_vms.first][svc_vms.second.first] += svc_vms.second.second;
+                }
+            }
+        }
+
+        RealT model_objective_value = 0;
+        RealT check_tol = 0;
+        std::vector<std::size_t> group_num_on_fns(ngrps, 0);
+        std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>> group_vm_allocations(ngrps);
+
+        // Setting up the optimization model
+        try
+        {
+            // Initialize the Concert Technology app
+            IloEnv env;
+
+            IloModel model(env);
+
+            model.setName("Max-Profit Category-Aggregated Optimization");
+
+            // Decision Variables
+
+            // Variables n_{g} \in \{0,...,|G_g|\}: the number of FNs of group g to be powered on.
+            IloIntVarArray n(env, ngrps);
+            for (std::size_t g = 0; g < ngrps; ++g)
+            {
+                IloInt lb = 0;
+                IloInt ub = fn_groups[g].size();
+                if (fixed_fns.size() > 0)
+                {
+                    // Either all or none of the FNs in the group are selected
+                    lb = ub = (fixed_fns.count(fn_groups[g].front()) > 0) ? ub : 0;
+                }
+
+                std::ostringstream oss;
+                oss << "n[" << g << "]";
+                n[g] = IloIntVar(env, lb, ub, oss.str().c_str());
+                model.add(n[g]);
+            }
+
+            // Variables z_{g,j,k} \in \mathbb{N}: the number of class-k VMs allocated on the FNs of group g for service j.
+            IloArray<IloArray<IloIntVarArray>> z(env, ngrps);
+            for (std::size_t g = 0; g < ngrps; ++g)
+            {
+                z[g] = IloArray<IloIntVarArray>(env, nsvcs);
+
+                for (std::size_t j = 0; j < nsvcs; ++j)
+                {
+                    auto const svc_cat = svc_categories[j];
+
+                    z[g][j] = IloIntVarArray(env, nvmcats);
+
+                    for (std::size_t k = 0; k < nvmcats; ++k)
+                    {
+                        std::ostringstream oss;
+                        oss << "z[" << g << "][" << j << "][" << k << "]";
+                        z[g][j][k] = IloIntVar(env, 0, IloInt(svc_cat_vm_cat_min_num_vms[svc_cat][k]), oss.str().c_str());
+                        model.add(z[g][j][k]);
+                    }
+                }
+            }
+
+            // Variables v_{j,k} \in \{0,1\}: 1 if service j uses class-k VMs, 0 otherwise.
+            IloArray<IloBoolVarArray> v(env, nsvcs);
+            // Variables a_{j,k} \in \{0,1\}: 1 if service j gets all the class-k VMs it requires, 0 otherwise.
+            IloArray<IloBoolVarArray> a(env, nsvcs);
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                v[j] = IloBoolVarArray(env, nvmcats);
+                a[j] = IloBoolVarArray(env, nvmcats);
+
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    std::ostringstream oss;
+                    oss << "v[" << j << "][" << k << "]";
+                    v[j][k] = IloBoolVar(env, oss.str().c_str());
+                    model.add(v[j][k]);
+
+                    oss.str("");
+                    oss << "a[" << j << "][" << k << "]";
+                    a[j][k] = IloBoolVar(env, oss.str().c_str());
+                    model.add(a[j][k]);
+                }
+            }
+
+            // Variables r_{g,j,k} \ge 0: the number of class-k VMs newly allocated on the FNs of group g for service j.
+            IloArray<IloArray<IloNumVarArray>> r(env, ngrps);
+            for (std::size_t g = 0; g < ngrps; ++g)
+            {
+                r[g] = IloArray<IloNumVarArray>(env, nsvcs);
+
+                for (std::size_t j = 0; j < nsvcs; ++j)
+                {
+                    r[g][j] = IloNumVarArray(env, nvmcats);
+
+                    for (std::size_t k = 0; k < nvmcats; ++k)
+                    {
+                        std::ostringstream oss;
+                        oss << "r[" << g << "][" << j << "][" << k << "]";
+                        r[g][j][k] = IloNumVar(env, 0, IloInfinity, oss.str().c_str());
+                        model.add(r[g][j][k]);
+                    }
+                }
+            }
+
+            // Constraints
+
+            std::size_t cc = 0; // Constraint counter
+
+            // VMs allocated for a given service must belong to the same class
+            //  \forall j \in S: \sum_{k \in C} v_{j,k} \le 1
+            ++cc;
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                std::ostringstream oss;
+                oss << "C" << cc << "_{" << j << "}";
+
+                IloConstraint cons(IloSum(v[j]) <= 1);
+                cons.setName(oss.str().c_str());
+                model.add(cons);
+            }
+
+            // Don't allocate useless VMs and only allocate VMs of the selected class
+            //  \forall j \in S, k \in C: \sum_{g \in G} z_{g,j,k} \le N_{j,k} v_{j,k}
+            ++cc;
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                auto const svc_cat = svc_categories[j];
+
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    IloIntExpr lhs_expr(env);
+                    for (std::size_t g = 0; g < ngrps; ++g)
+                    {
+                        lhs_expr += z[g][j][k];
+                    }
+
+                    std::ostringstream oss;
+                    oss << "C" << cc << "_{" << j << "," << k << "}";
+
+                    IloConstraint cons(lhs_expr <= IloInt(svc_cat_vm_cat_min_num_vms[svc_cat][k])*v[j][k]);
+                    cons.setName(oss.str().c_str());
+                    model.add(cons);
+                }
+            }
+
+            // A service gets all the VMs it requires only if they are actually allocated
+            //  \forall j \in S, k \in C: \sum_{g \in G} z_{g,j,k} \ge N_{j,k} a_{j,k}
+            ++cc;
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                auto const svc_cat = svc_categories[j];
+
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    IloIntExpr lhs_expr(env);
+                    for (std::size_t g = 0; g < ngrps; ++g)
+                    {
+                        lhs_expr += z[g][j][k];
+                    }
+
+                    std::ostringstream oss;
+                    oss << "C" << cc << "_{" << j << "," << k << "}";
+
+                    IloConstraint cons(lhs_expr >= IloInt(svc_cat_vm_cat_min_num_vms[svc_cat][k])*a[j][k]);
+                    cons.setName(oss.str().c_str());
+                    model.add(cons);
+                }
+            }
+
+            // The total allocated capacity on the powered-on FNs of a group must not exceed their max capacity
+            //  \forall g \in G: \sum_{j \in S} \sum_{k \in C} z_{g,j,k} C_{g,k} \le n_{g}
+            ++cc;
+            for (std::size_t g = 0; g < ngrps; ++g)
+            {
+                auto const fn_cat = fn_categories[fn_groups[g].front()];
+
+                IloNumExpr lhs_expr(env);
+                for (std::size_t j = 0; j < nsvcs; ++j)
+                {
+                    for (std::size_t k = 0; k < nvmcats; ++k)
+                    {
+                        lhs_expr += z[g][j][k]*vm_cat_fn_cat_cpu_specs[k][fn_cat];
+                    }
+                }
+
+                std::ostringstream oss;
+                oss << "C" << cc << "_{" << g << "}";
+
+                IloConstraint cons(lhs_expr <= n[g]);
+                cons.setName(oss.str().c_str());
+                model.add(cons);
+            }
+
+            // Constraints the value of r_{g,j,k}:
+            //  \forall g \in G, j \in S, k \in C: r_{g,j,k} \ge z_{g,j,k} - \hat{z}_{g,j,k}
+            ++cc;
+            for (std::size_t g = 0; g < ngrps; ++g)
+            {
+                for (std::size_t j = 0; j < nsvcs; ++j)
+                {
+                    for (std::size_t k = 0; k < nvmcats; ++k)
+                    {
+                        std::ostringstream oss;
+                        oss << "C" << cc << "_{" << g << "," << j << "," << k << "}";
+
+                        IloConstraint cons(r[g][j][k] >= z[g][j][k] - old_z[g][j][k]);
+                        cons.setName(oss.str().c_str());
+                        model.add(cons);
+                    }
+                }
+            }
+
+            // Set objective
+
+            IloObjective obj;
+
+            // Revenues
+            IloNumExpr revenue_expr(env);
+            for (std::size_t g = 0; g < ngrps; ++g)
+            {
+                for (std::size_t j = 0; j < nsvcs; ++j)
+                {
+                    auto const svc_cat = svc_categories[j];
+
+                    revenue_expr += fp_svc_cat_revenues[svc_cat]*IloSum(z[g][j]);
+                }
+            }
+
+            // Costs
+            IloNumExpr cost_expr(env);
+            for (std::size_t g = 0; g < ngrps; ++g)
+            {
+                auto const fn = fn_groups[g].front();
+                auto const fn_cat = fn_categories[fn];
+                auto const fn_power_state = fn_power_states[fn];
+                auto const dC = fn_cat_max_powers[fn_cat]-fn_cat_min_powers[fn_cat];
+                auto const wcost = fp_electricity_cost;
+
+                // - Add elecricity consumption cost
+                cost_expr += n[g]*fn_cat_min_powers[fn_cat]*wcost;
+                for (std::size_t j = 0; j < nsvcs; ++j)
+                {
+                    for (std::size_t k = 0; k < nvmcats; ++k)
+                    {
+                        cost_expr += z[g][j][k]*vm_cat_fn_cat_cpu_specs[k][fn_cat]*dC*wcost;
+                    }
+                }
+
+                // - Add switch-on/off costs
+                if (fn_power_state)
+                {
+                    cost_expr += (IloInt(fn_groups[g].size())-n[g])*fp_fn_cat_asleep_costs[fn_cat]/deltat;
+                }
+                else
+                {
+                    cost_expr += n[g]*fp_fn_cat_awake_costs[fn_cat]/deltat;
+                }
+
+                // - Add VM (re)allocation costs
+                for (std::size_t j = 0; j < nsvcs; ++j)
+                {
+                    for (std::size_t k = 0; k < nvmcats; ++k)
+                    {
+                        cost_expr += r[g][j][k]*vm_cat_alloc_costs[k]/deltat;
+                    }
+                }
+            }
+            // - Add service penalties
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                auto const svc_cat = svc_categories[j];
+                auto const& min_num_vms = svc_cat_vm_cat_min_num_vms[svc_cat];
+
+                if (std::find(min_num_vms.begin(), min_num_vms.end(), 0) != min_num_vms.end())
+                {
+                    continue;
+                }
+
+                cost_expr += (1-IloSum(a[j]))*fp_svc_cat_penalties[svc_cat];
+            }
+
+            obj = IloMaximize(env, (revenue_expr-cost_expr)*deltat);
+            model.add(obj);
+
+
+            // Create the CPLEX solver and make 'model' the active ("extracted") model
+            IloCplex solver(model);
+
+            //write model
+#ifndef DCS_DEBUG
+            solver.setOut(env.getNullStream());
+            solver.setWarning(env.getNullStream());
+#else // DCS_DEBUG
+            solver.exportModel("agg_vm_alloc-cplex-model.lp");
+#endif // DCS_DEBUG
+
+            // Set Relative Optimality Tolerance to (rel_tol_*100)%
+            if (math::float_traits<RealT>::definitely_greater(rel_tol_, 0))
+            {
+                solver.setParam(IloCplex::Param::MIP::Tolerances::MIPGap, rel_tol_);
+            }
+            // Set Time Limit to limit the execution time of the search (capped by the time left before the deadline of the caller, if any)
+            auto const time_lim = detail::solve_time_limit(time_lim_);
+            if (math::float_traits<RealT>::definitely_greater(time_lim, 0))
+            {
+                solver.setParam(IloCplex::Param::TimeLimit, time_lim);
+            }
+
+            // Start the search from the given VM allocation, aggregated by group
+            // (CPLEX fixes the values of 'n' and 'z' and solves for the remaining variables)
+            if (!hint_fn_power_states.empty())
+            {
+                std::vector<bool> start_fn_power_states;
+                std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>> start_fn_vm_allocations;
+                detail::make_vm_allocation_start(hint_fn_power_states, hint_fn_vm_allocations, fixed_fns, svc_categories, svc_cat_vm_cat_min_num_vms, start_fn_power_states, start_fn_vm_allocations);
+
+                IloNumVarArray start_vars(env);
+                IloNumArray start_vals(env);
+                for (std::size_t g = 0; g < ngrps; ++g)
+                {
+                    IloInt start_n = 0;
+                    std::vector<std::vector<IloInt>> start_z(nsvcs, std::vector<IloInt>(nvmcats, 0));
+                    for (auto const fn : fn_groups[g])
+                    {
+                        if (start_fn_power_states[fn])
+                        {
+                            ++start_n;
+                        }
+                        for (auto const& svc_vms : start_fn_vm_allocations[fn])
+                        {
+                            start_z[svc_vms.first][svc_vms.second.first] += svc_vms.second.second;
+                        }
+                    }
+
+                    start_vars.add(n[g]);
+                    start_vals.add(start_n);
+                    for (std::size_t j = 0; j < nsvcs; ++j)
+                    {
+                        for (std::size_t k = 0; k < nvmcats; ++k)
+                        {
+                            start_vars.add(z[g][j][k]);
+                            start_vals.add(start_z[j][k]);
+                        }
+                    }
+                }
+
+                solver.addMIPStart(start_vars, start_vals, IloCplex::MIPStartSolveFixed, "warm_start");
+
+                start_vars.end();
+                start_vals.end();
+            }
+
+            detail::solve_timer_t<RealT> timer;
+            IloCplex::Callback timer_callback = solver.use(new (env) detail::cplex_incumbent_timer_callback_t<RealT>(env, timer));
+            IloCplex::Aborter aborter = solver.use(IloCplex::Aborter(env));
+            detail::cplex_mip_start_check_t mip_start_check(solver);
+
+            {
+                // Let the search be aborted from another thread (e.g., by the portfolio solver)
+                detail::solve_interrupt_guard_t interrupt_guard([&aborter]() { aborter.abort(); });
+
+                timer.start();
+                solution.solved = solver.solve();
+                timer.stop();
+            }
+            if (!aborter.isAborted() && !mip_start_check.accepted())
+            {
+                dcs::log_warn(DCS_LOGGING_AT, "CPLEX did not accept the warm start");
+            }
+            solution.optimal = false;
+            solution.solve_time = timer.solve_time();
+            solution.first_incumbent_time = timer.first_incumbent_time();
+            if (solution.solved && std::isnan(solution.first_incumbent_time))
+            {
+                // The informational callback is only invoked during branch-and-cut, so the problem has been solved before (e.g., by presolve)
+                solution.first_incumbent_time = solution.solve_time;
+            }
+
+            solver.remove(timer_callback);
+
+            DCS_DEBUG_TRACE("- Solve time: " << solution.solve_time << ", time to first incumbent: " << solution.first_incumbent_time);
+
+            IloAlgorithm::Status status = solver.getStatus();
+            switch (status)
+            {
+                case IloAlgorithm::Optimal: // The algorithm found an optimal solution.
+                    solution.optimal = true;
+                    solution.gap = static_cast<RealT>(solver.getMIPRelativeGap());
+                    break;
+                case IloAlgorithm::Feasible: // The algorithm found a feasible solution, though it may not necessarily be optimal.
+                    solution.gap = static_cast<RealT>(solver.getMIPRelativeGap());
+                    dcs::log_warn(DCS_LOGGING_AT, "Optimization problem solved but non-optimal");
+                    break;
+                case IloAlgorithm::Infeasible: // The algorithm proved the model infeasible (i.e., it is not possible to find an assignment of values to variables satisfying all the constraints in the model).
+                case IloAlgorithm::Unbounded: // The algorithm proved the model unbounded.
+                case IloAlgorithm::InfeasibleOrUnbounded: // The model is infeasible or unbounded.
+                case IloAlgorithm::Error: // An error occurred and, on platforms that support exceptions, that an exception has been thrown.
+                case IloAlgorithm::Unknown: // The algorithm has no information about the solution of the model.
+                {
+                    std::ostringstream oss;
+                    oss << "Optimization was stopped with status = " << status << " (CPLEX status = " << solver.getCplexStatus() << ", sub-status = " << solver.getCplexSubStatus() << ")";
+                    dcs::log_warn(DCS_LOGGING_AT, oss.str());
+
+                    solution.solved = false;
+                    return solution;
+                }
+            }
+
+            model_objective_value = static_cast<RealT>(solver.getObjValue());
+            check_tol = solver.getParam(IloCplex::Param::MIP::Tolerances::MIPGap);
+
+            DCS_DEBUG_TRACE( "- Objective value: " << model_objective_value << " (revenue: " << solver.getValue(revenue_expr) << ", cost: " << solver.getValue(cost_expr) << ", deltat: " << deltat << ")");
+
+            for (std::size_t g = 0; g < ngrps; ++g)
+            {
+                group_num_on_fns[g] = static_cast<std::size_t>(detail::to_IloInt(solver.getValue(n[g])));
+
+                for (std::size_t j = 0; j < nsvcs; ++j)
+                {
+                    for (std::size_t k = 0; k < nvmcats; ++k)
+                    {
+                        auto const num_vms = detail::to_IloInt(solver.getValue(z[g][j][k]));
+                        if (num_vms > 0)
+                        {
+                            group_vm_allocations[g][j] = std::make_pair(k, static_cast<std::size_t>(num_vms));
+                        }
+                    }
+                }
+            }
+
+            DCS_DEBUG_TRACE( "- Powered-on FNs by group: " << group_num_on_fns );
+
+            revenue_expr.end();
+            cost_expr.end();
+            obj.end();
+            r.end();
+            a.end();
+            v.end();
+            z.end();
+            n.end();
+
+            // Close the Concert Technology app
+            env.end();
+        }
+        catch (const IloException& e)
+        {
+            std::ostringstream oss;
+            oss << "Got exception from Cplex Optimizer: " << e.getMessage();
+            DCS_EXCEPTION_THROW(std::runtime_error, oss.str());
+        }
+        catch (...)
+        {
+            DCS_EXCEPTION_THROW(std::runtime_error,
+                                "Unexpected error during the optimization");
+        }
+
+        // Turn the aggregated VM allocation into a VM allocation by FN and evaluate it
+        detail::disaggregate_vm_allocation(fn_groups,
+                                           group_num_on_fns,
+                                           group_vm_allocations,
+                                           fn_categories,
+                                           fn_vm_allocations,
+                                           vm_cat_fn_cat_cpu_specs,
+                                           solution);
+        detail::eval_vm_allocation(fn_categories,
+                                   fn_power_states,
+                                   fn_vm_allocations,
+                                   fn_cat_min_powers,
+                                   fn_cat_max_powers,
+                                   vm_cat_alloc_costs,
+                                   svc_categories,
+                                   svc_cat_vm_cat_min_num_vms,
+                                   fp_svc_cat_revenues,
+                                   fp_svc_cat_penalties,
+                                   fp_electricity_cost,
+                                   fp_fn_cat_asleep_costs,
+                                   fp_fn_cat_awake_costs,
+                                   deltat,
+                                   solution);
+
+        // The model optimum is only an upper bound to the optimum of the VM allocation problem
+        solution.optimal = solution.optimal && !math::float_traits<RealT>::definitely_less(solution.objective_value, model_objective_value, check_tol);
+
+        DCS_DEBUG_TRACE( "- Disaggregated objective value: " << solution.objective_value << " (model objective value: " << model_objective_value << ", optimal: " << solution.optimal << ")");
+        DCS_DEBUG_TRACE( "- Final VM Allocation: " << solution.fn_vm_allocations );
+
+        return solution;
+    }
+
+
+private:
+    RealT rel_tol_; ///< Relative tolerance; the optimizer will stop as soon as it has found a feasible solution proved to be within (rel_tol_*100)% of optimal.
+    RealT time_lim_; ///< Time limit (in seconds) used to set the maximum time the optimizer can spend in search for the best solution.
+}; // aggregated_vm_allocation_solver_t
+
+}} // Namespace dcs::fog
+
+
+#endif // DCS_FOG_VM_ALLOCATION_AGGREGATED_SOLVER_HPP
@@ -34,8 +34,11 @@
 #define DCS_FOG_VM_ALLOCATION_BAHREINE2017_MCAPP_HPP
 
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
 #include <dcs/exception.hpp>
@@ -47,10 +50,16 @@
 #include <dcs/math/traits/float.hpp>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <ortools/algorithms/hungarian.h>
+#ifdef DCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER
+# include <ortools/graph/min_cost_flow.h>
+#endif // DCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER
 #include <set>
 #include <sstream>
 #include <stdexcept>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 
@@ -1366,6 +1375,724 @@ DCS_DEBUG_TRACE("Final VM Allocation: " << solution.fn_vm_allocations);//XXX
 }; // bahreini2017_mcappim_alt_vm_allocation_solver_t
 
 
+#ifdef DCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER
+
+/**
+ * \brief Solver for the VM allocation problem based on (Bahreini et al.,2017)
+ *  where the assignment step is solved as a sparse min-cost flow problem.
+ *
+ * Like \c bahreini2017_mcappim_alt_vm_allocation_solver_t, each service uses
+ * the VM category that requires less CPU capacity and VMs are charged the same
+ * costs, but:
+ * - more VMs can be allocated on the same FN, up to its CPU capacity;
+ * - no dense VM-by-FN cost matrix is built: FNs of the same category and in
+ *   the same power state are equivalent for a VM (unless they already host VMs
+ *   of the same service), so that each service is linked to one node per
+ *   group of equivalent FNs, and groups that are dominated by cheaper groups
+ *   with enough capacity are pruned.
+ * .
+ * VM categories are allocated in turn, from the one with the largest CPU
+ * requirements, by solving a min-cost flow problem where each service supplies
+ * its VMs, each FN has the capacity left by the previous VM categories, and
+ * VMs that are not allocated are charged the revenue and the penalty of the
+ * service.
+ * Since the penalty is charged once per service rather than per VM, the flow
+ * may serve a service only in part: the VMs of such services are then dropped
+ * and each of them is rerouted as a whole on the cheapest FNs with capacity
+ * left, provided that this pays off against its revenue and penalty, or is
+ * left unserved otherwise.
+ * The problem has O(S*G+F) arcs (with S services, G groups of FNs and F FNs)
+ * rather than the O(V*F) entries (with V VMs) of the assignment problem.
+ */
+template <typename RealT>
+class bahreini2017_mcappim_flow_vm_allocation_solver_t: public base_vm_allocation_solver_t<RealT>
+{
+private:
+    static constexpr double cost_scale = 1e6; ///< The factor used to turn monetary costs into the integer costs of the flow problem
+
+
+public:
+    vm_allocation_t<RealT> solve(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                 const std::vector<bool>& fn_power_states, // The power status of each FN
+                                 const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                 const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                 const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                 const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                 const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                 const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                 const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                 const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                 const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                 const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                 const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                 const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                 RealT deltat = 1 // Length of the time interval
+                            ) const
+    {
+        return do_solve(fn_categories,
+                        fn_power_states,
+                        fn_vm_allocations,
+                        std::set<std::size_t>(), // Any FN can be selected
+                        fn_cat_min_powers,
+                        fn_cat_max_powers,
+                        vm_cat_fn_cat_cpu_specs,
+                        vm_cat_alloc_costs,
+                        svc_categories,
+                        svc_cat_vm_cat_min_num_vms,
+                        fp_svc_cat_revenues,
+                        fp_svc_cat_penalties,
+                        fp_electricity_cost,
+                        fp_fn_cat_asleep_costs,
+                        fp_fn_cat_awake_costs,
+                        deltat);
+    }
+
+    vm_allocation_t<RealT> solve_with_fixed_fns(const std::set<std::size_t>& fixed_fns,
+                                                const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                                const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                                const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                                const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                RealT deltat = 1 // Length of the time interval
+                            ) const
+    {
+        return do_solve(fn_categories,
+                        fn_power_states,
+                        fn_vm_allocations,
+                        fixed_fns,
+                        fn_cat_min_powers,
+                        fn_cat_max_powers,
+                        vm_cat_fn_cat_cpu_specs,
+                        vm_cat_alloc_costs,
+                        svc_categories,
+                        svc_cat_vm_cat_min_num_vms,
+                        fp_svc_cat_revenues,
+                        fp_svc_cat_penalties,
+                        fp_electricity_cost,
+                        fp_fn_cat_asleep_costs,
+                        fp_fn_cat_awake_costs,
+                        deltat);
+    }
+
+
+private:
+    vm_allocation_t<RealT> do_solve(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                    const std::vector<bool>& fn_power_states, // The power status of each FN
+                                    const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                    const std::set<std::size_t>& fixed_fns, // The set of selected FNs to use for the VM allocation (if empty, any FN can be used)
+                                    const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                    const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                    const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                    const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                    const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                    const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                    const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                    const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                    const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                    const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                    const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                    RealT deltat = 1 // Length of the time interval
+                                ) const
+    {
+        namespace ort = operations_research;
+
+        DCS_DEBUG_TRACE("Finding VM allocation by solving the min-cost flow problem:");
+        DCS_DEBUG_TRACE("- Number of FNs: " << fn_categories.size());
+        DCS_DEBUG_TRACE("- FN Fixed: " << fixed_fns);
+        DCS_DEBUG_TRACE("- Number of Services: " << svc_categories.size());
+
+        auto const start_time = std::chrono::steady_clock::now();
+
+        const std::size_t nfns = fn_categories.size();
+        const std::size_t nsvcs = svc_categories.size();
+        const std::size_t nvmcats = vm_cat_fn_cat_cpu_specs.size();
+
+        DCS_ASSERT( nfns == fn_power_states.size(),
+                    DCS_EXCEPTION_THROW( std::logic_error,
+                                         "FN power states container has a wrong size" ) );
+
+        DCS_ASSERT( nfns == fn_vm_allocations.size(),
+                    DCS_EXCEPTION_THROW( std::logic_error,
+                                         "FN VM allocations container has a wrong size" ) );
+
+        // Group the usable FNs by FN category and power state
+        std::map<std::pair<std::size_t,bool>,std::vector<std::size_t>> key_fns;
+        std::set<std::size_t> fncat_set;
+        for (std::size_t fn = 0; fn < nfns; ++fn)
+        {
+            if (fixed_fns.size() > 0 && fixed_fns.count(fn) == 0)
+            {
+                continue;
+            }
+
+            key_fns[std::make_pair(fn_categories[fn], bool(fn_power_states[fn]))].push_back(fn);
+            fncat_set.insert(fn_categories[fn]);
+        }
+
+        // Collect the usable FNs where each service currently runs its VMs
+        std::vector<std::vector<std::size_t>> svc_old_fns(nsvcs);
+        for (auto const& key_fn : key_fns)
+        {
+            for (auto const fn : key_fn.second)
+            {
+                for (auto const& svc_vms : fn_vm_allocations[fn])
+                {
+                    if (svc_vms.first < nsvcs)
+                    {
+                        svc_old_fns[svc_vms.first].push_back(fn);
+                    }
+                }
+            }
+        }
+
+        // Choose the VM category of each service as the one that, to satisfy the service QoS, requires less CPU capacity
+        std::vector<std::vector<std::size_t>> vm_cat_svcs(nvmcats); // Services by VM category
+        for (std::size_t svc = 0; svc < nsvcs; ++svc)
+        {
+            auto const svc_cat = svc_categories[svc];
+
+            RealT best_tot_cpu_share = std::numeric_limits<RealT>::infinity();
+            std::size_t best_vm_cat = nvmcats;
+            for (auto const fn_cat : fncat_set)
+            {
+                for (std::size_t vm_cat = 0; vm_cat < svc_cat_vm_cat_min_num_vms[svc_cat].size(); ++vm_cat)
+                {
+                    auto const tot_cpu_share = vm_cat_fn_cat_cpu_specs[vm_cat][fn_cat]*svc_cat_vm_cat_min_num_vms[svc_cat][vm_cat];
+
+                    if (tot_cpu_share < best_tot_cpu_share)
+                    {
+                        best_tot_cpu_share = tot_cpu_share;
+                        best_vm_cat = vm_cat;
+                    }
+                }
+            }
+
+            if (best_vm_cat < nvmcats && svc_cat_vm_cat_min_num_vms[svc_cat][best_vm_cat] > 0)
+            {
+                vm_cat_svcs[best_vm_cat].push_back(svc);
+            }
+        }
+
+        // Allocate VM categories from the one with the largest CPU requirements
+        std::vector<std::pair<RealT,std::size_t>> vm_cat_ranks;
+        for (std::size_t vm_cat = 0; vm_cat < nvmcats; ++vm_cat)
+        {
+            if (vm_cat_svcs[vm_cat].empty())
+            {
+                continue;
+            }
+
+            RealT max_cpu_req = 0;
+            for (auto const fn_cat : fncat_set)
+            {
+                max_cpu_req = std::max(max_cpu_req, vm_cat_fn_cat_cpu_specs[vm_cat][fn_cat]);
+            }
+            vm_cat_ranks.push_back(std::make_pair(max_cpu_req, vm_cat));
+        }
+        std::stable_sort(vm_cat_ranks.begin(),
+                         vm_cat_ranks.end(),
+                         [](const std::pair<RealT,std::size_t>& a, const std::pair<RealT,std::size_t>& b)
+                         {
+                            return a.first > b.first;
+                         });
+
+        // Gets the cost of running a VM on a FN, as in the assignment problem
+        auto const vm_cost = [&](std::size_t fn_cat, bool fn_on, std::size_t vm_cat, bool realloc) -> RealT
+                             {
+                                auto const cpu_req = vm_cat_fn_cat_cpu_specs[vm_cat][fn_cat];
+                                RealT cost = (fn_cat_min_powers[fn_cat]*cpu_req + (fn_cat_max_powers[fn_cat]-fn_cat_min_powers[fn_cat])*cpu_req)*fp_electricity_cost;
+                                if (realloc)
+                                {
+                                    cost += vm_cat_alloc_costs[vm_cat]/deltat;
+                                }
+                                if (!fn_on)
+                                {
+                                    cost += cpu_req*fp_fn_cat_awake_costs[fn_cat]/deltat;
+                                }
+                                return cost;
+                             };
+        auto const int_cost = [](RealT cost) -> std::int64_t
+                              {
+                                return static_cast<std::int64_t>(std::llround(cost*cost_scale));
+                              };
+
+        vm_allocation_t<RealT> solution;
+
+        solution.fn_vm_allocations.resize(nfns);
+        solution.fn_cpu_allocations.resize(nfns, 0);
+        solution.fn_power_states.assign(nfns, false);
+
+        for (auto const& vm_cat_rank : vm_cat_ranks)
+        {
+            auto const vm_cat = vm_cat_rank.second;
+            auto const& svcs = vm_cat_svcs[vm_cat];
+
+            // Number of class-k VMs that still fit into each FN
+            auto const fn_capacity = [&](std::size_t fn) -> std::size_t
+                                     {
+                                        auto const cpu_req = vm_cat_fn_cat_cpu_specs[vm_cat][fn_categories[fn]];
+                                        if (cpu_req <= 0)
+                                        {
+                                            return std::numeric_limits<int>::max();
+                                        }
+                                        auto n = static_cast<std::size_t>(std::max(std::floor((1-solution.fn_cpu_allocations[fn])/cpu_req), RealT(0)));
+                                        while (n > 0 && solution.fn_cpu_allocations[fn]+n*cpu_req > 1)
+                                        {
+                                            --n;
+                                        }
+                                        return n;
+                                     };
+
+            // Number of VMs of this category that services can keep on each FN, through the arcs of their current allocation
+            std::map<std::size_t,std::int64_t> fn_old_num_vms;
+            for (auto const svc : svcs)
+            {
+                for (auto const fn : svc_old_fns[svc])
+                {
+                    auto const& svc_vms = fn_vm_allocations[fn].at(svc);
+                    if (svc_vms.first == vm_cat)
+                    {
+                        fn_old_num_vms[fn] += std::min(svc_vms.second, svc_cat_vm_cat_min_num_vms[svc_categories[svc]][vm_cat]);
+                    }
+                }
+            }
+
+            // Rank groups of FNs by cost and prune the ones that are dominated by cheaper groups with enough capacity
+            // (the capacity that the current allocations may use is not counted, since it is not available to the other VMs)
+            std::int64_t demand = 0;
+            for (auto const svc : svcs)
+            {
+                demand += svc_cat_vm_cat_min_num_vms[svc_categories[svc]][vm_cat];
+            }
+            std::vector<std::tuple<RealT,std::pair<std::size_t,bool>,std::int64_t>> group_ranks; // <cost, key, capacity> triple for each group of FNs
+            for (auto const& key_fn : key_fns)
+            {
+                std::int64_t capacity = 0;
+                for (auto const fn : key_fn.second)
+                {
+                    auto const fn_cap = static_cast<std::int64_t>(fn_capacity(fn));
+                    auto const it = fn_old_num_vms.find(fn);
+                    capacity += fn_cap - ((it != fn_old_num_vms.end()) ? std::min(fn_cap, it->second) : 0);
+                }
+                if (capacity > 0)
+                {
+                    group_ranks.push_back(std::make_tuple(vm_cost(key_fn.first.first, key_fn.first.second, vm_cat, true), key_fn.first, capacity));
+                }
+            }
+            std::stable_sort(group_ranks.begin(),
+                             group_ranks.end(),
+                             [](const std::tuple<RealT,std::pair<std::size_t,bool>,std::int64_t>& a, const std::tuple<RealT,std::pair<std::size_t,bool>,std::int64_t>& b)
+                             {
+                                return std::get<0>(a) < std::get<0>(b);
+                             });
+            std::size_t ngroups = 0;
+            for (std::int64_t capacity = 0; ngroups < group_ranks.size() && capacity < demand; ++ngroups)
+            {
+                capacity += std::get<2>(group_ranks[ngroups]);
+            }
+            group_ranks.resize(ngroups);
+
+            // Services of the same category that don't run VMs of this category on the usable FNs are equivalent too,
+            // so that they are merged in a single node whose flow is then split among them
+            std::vector<std::vector<std::size_t>> node_svcs; // Services by service node
+            std::vector<std::vector<std::pair<std::size_t,std::size_t>>> node_old_fns; // <FN, number of VMs> pairs of the current allocation, by service node
+            std::map<std::size_t,std::size_t> svc_cat_nodes;
+            for (auto const svc : svcs)
+            {
+                std::vector<std::pair<std::size_t,std::size_t>> old_fns;
+                for (auto const fn : svc_old_fns[svc])
+                {
+                    auto const& svc_vms = fn_vm_allocations[fn].at(svc);
+                    if (svc_vms.first == vm_cat && fn_capacity(fn) > 0)
+                    {
+                        old_fns.push_back(std::make_pair(fn, svc_vms.second));
+                    }
+                }
+
+                if (old_fns.empty())
+                {
+                    auto const svc_cat = svc_categories[svc];
+                    if (svc_cat_nodes.count(svc_cat) == 0)
+                    {
+                        svc_cat_nodes[svc_cat] = node_svcs.size();
+                        node_svcs.push_back(std::vector<std::size_t>());
+                        node_old_fns.push_back(old_fns);
+                    }
+                    node_svcs[svc_cat_nodes.at(svc_cat)].push_back(svc);
+                }
+                else
+                {
+                    node_svcs.push_back(std::vector<std::size_t>(1, svc));
+                    node_old_fns.push_back(old_fns);
+                }
+            }
+            const std::size_t nnodes = node_svcs.size();
+
+            // Build the flow network:
+            // - nodes: services, groups of FNs, FNs and a sink;
+            // - arcs: service -> sink (unallocated VMs), service -> group,
+            //   service -> FN (where the service already runs VMs of this
+            //   category), group -> FN and FN -> sink (FN capacity).
+            ort::SimpleMinCostFlow flow;
+
+            std::map<std::size_t,int> fn_nodes;
+            const int sink_node = static_cast<int>(nnodes+ngroups);
+            int next_node = sink_node+1;
+            auto const fn_node = [&](std::size_t fn) -> int
+                                 {
+                                    auto it = fn_nodes.find(fn);
+                                    if (it == fn_nodes.end())
+                                    {
+                                        it = fn_nodes.insert(std::make_pair(fn, next_node++)).first;
+                                        flow.AddArcWithCapacityAndUnitCost(it->second, sink_node, fn_capacity(fn), 0);
+                                    }
+                                    return it->second;
+                                 };
+
+            std::vector<std::vector<std::pair<std::size_t,int>>> group_fn_arcs(ngroups); // <FN, arc> pairs, by group
+            for (std::size_t g = 0; g < ngroups; ++g)
+            {
+                for (auto const fn : key_fns.at(std::get<1>(group_ranks[g])))
+                {
+                    auto const capacity = fn_capacity(fn);
+                    if (capacity > 0)
+                    {
+                        group_fn_arcs[g].push_back(std::make_pair(fn, flow.AddArcWithCapacityAndUnitCost(static_cast<int>(nnodes+g), fn_node(fn), capacity, 0)));
+                    }
+                }
+            }
+
+            std::vector<std::vector<int>> node_group_arcs(nnodes); // Arcs to groups, by service node
+            std::vector<std::vector<std::pair<std::size_t,int>>> node_fn_arcs(nnodes); // <FN, arc> pairs, by service node
+            for (std::size_t n = 0; n < nnodes; ++n)
+            {
+                auto const svc_cat = svc_categories[node_svcs[n].front()];
+                auto const nvms = svc_cat_vm_cat_min_num_vms[svc_cat][vm_cat];
+                auto const supply = static_cast<std::int64_t>(nvms*node_svcs[n].size());
+                auto const unalloc_cost = int_cost(fp_svc_cat_revenues[svc_cat]+fp_svc_cat_penalties[svc_cat]);
+
+                flow.SetNodeSupply(static_cast<int>(n), supply);
+                flow.AddArcWithCapacityAndUnitCost(static_cast<int>(n), sink_node, supply, unalloc_cost);
+                for (std::size_t g = 0; g < ngroups; ++g)
+                {
+                    // Groups that cost more than leaving the VMs unallocated get a zero-capacity arc (just to keep arcs aligned with groups)
+                    auto const cost = int_cost(std::get<0>(group_ranks[g]));
+                    node_group_arcs[n].push_back(flow.AddArcWithCapacityAndUnitCost(static_cast<int>(n), static_cast<int>(nnodes+g), cost < unalloc_cost ? supply : 0, cost));
+                }
+                for (auto const& old_fn : node_old_fns[n])
+                {
+                    auto const fn = old_fn.first;
+                    node_fn_arcs[n].push_back(std::make_pair(fn, flow.AddArcWithCapacityAndUnitCost(static_cast<int>(n), fn_node(fn), std::min(old_fn.second, nvms), int_cost(vm_cost(fn_categories[fn], fn_power_states[fn], vm_cat, false)))));
+                }
+            }
+            flow.SetNodeSupply(sink_node, -demand);
+
+            auto const status = flow.Solve();
+            if (status != ort::SimpleMinCostFlow::OPTIMAL)
+            {
+                std::ostringstream oss;
+                oss << "Unable to solve the min-cost flow problem for VM category " << vm_cat << " (status: " << status << ")";
+                dcs::log_warn(DCS_LOGGING_AT, oss.str());
+                continue;
+            }
+
+            // Split the flow leaving each service node among its services,
+            // filling one service at a time so that unallocated VMs are
+            // charged the penalty of as few services as possible
+            std::map<std::size_t,std::size_t> fn_num_vms; // Number of VMs of this category allocated to each FN
+            std::map<std::size_t,std::map<std::size_t,std::size_t>> svc_fn_num_vms; // Number of VMs allocated to each FN, by service
+            std::vector<std::vector<std::pair<std::size_t,std::size_t>>> group_svc_vms(ngroups); // <service, number of VMs> pairs, by group
+            auto const allocate = [&](std::size_t svc, std::size_t fn, std::size_t nvms)
+                                  {
+                                    auto& svc_vms = solution.fn_vm_allocations[fn][svc];
+                                    svc_vms.first = vm_cat;
+                                    svc_vms.second += nvms;
+                                    fn_num_vms[fn] += nvms;
+                                    svc_fn_num_vms[svc][fn] += nvms;
+                                  };
+            for (std::size_t n = 0; n < nnodes; ++n)
+            {
+                std::vector<std::pair<std::size_t,std::size_t>> fn_flows; // <FN, flow> pairs
+                std::vector<std::pair<std::size_t,std::size_t>> group_flows; // <group, flow> pairs
+                for (auto const& fn_arc : node_fn_arcs[n])
+                {
+                    fn_flows.push_back(std::make_pair(fn_arc.first, flow.Flow(fn_arc.second)));
+                }
+                for (std::size_t g = 0; g < ngroups; ++g)
+                {
+                    group_flows.push_back(std::make_pair(g, flow.Flow(node_group_arcs[n][g])));
+                }
+
+                std::size_t f = 0;
+                std::size_t g = 0;
+                for (auto const svc : node_svcs[n])
+                {
+                    std::size_t svc_left = svc_cat_vm_cat_min_num_vms[svc_categories[svc]][vm_cat];
+                    for (; svc_left > 0 && f < fn_flows.size(); ++f)
+                    {
+                        // Only one service per node can have a current allocation
+                        if (fn_flows[f].second > 0)
+                        {
+                            allocate(svc, fn_flows[f].first, fn_flows[f].second);
+                            svc_left -= fn_flows[f].second;
+                        }
+                    }
+                    for (; svc_left > 0 && g < group_flows.size(); )
+                    {
+                        auto const nvms = std::min(svc_left, group_flows[g].second);
+                        if (nvms > 0)
+                        {
+                            group_svc_vms[g].push_back(std::make_pair(svc, nvms));
+                            svc_left -= nvms;
+                            group_flows[g].second -= nvms;
+                        }
+                        if (group_flows[g].second == 0)
+                        {
+                            ++g;
+                        }
+                    }
+                }
+            }
+            // Split the flow through each group among its FNs (which are equivalent)
+            for (std::size_t g = 0; g < ngroups; ++g)
+            {
+                std::size_t a = 0;
+                std::size_t fn_left = 0;
+                for (auto const& svc_vms : group_svc_vms[g])
+                {
+                    std::size_t svc_left = svc_vms.second;
+                    while (svc_left > 0 && a < group_fn_arcs[g].size())
+                    {
+                        if (fn_left == 0)
+                        {
+                            fn_left = flow.Flow(group_fn_arcs[g][a].second);
+                        }
+                        auto const nvms = std::min(svc_left, fn_left);
+                        if (nvms > 0)
+                        {
+                            allocate(svc_vms.first, group_fn_arcs[g][a].first, nvms);
+                            svc_left -= nvms;
+                            fn_left -= nvms;
+                        }
+                        if (fn_left == 0)
+                        {
+                            ++a;
+                        }
+                    }
+                }
+            }
+
+            // Drop the VMs of the services that are only served in part
+            std::vector<std::pair<RealT,std::size_t>> left_svc_ranks; // <value of each VM, service> pairs of the services that are not fully served
+            for (auto const svc : svcs)
+            {
+                auto const svc_cat = svc_categories[svc];
+                auto const nvms = svc_cat_vm_cat_min_num_vms[svc_cat][vm_cat];
+
+                std::size_t svc_num_vms = 0;
+                for (auto const& fn_vms : svc_fn_num_vms[svc])
+                {
+                    svc_num_vms += fn_vms.second;
+                }
+                if (svc_num_vms >= nvms)
+                {
+                    continue;
+                }
+
+                for (auto const& fn_vms : svc_fn_num_vms[svc])
+                {
+                    auto const fn = fn_vms.first;
+
+                    solution.fn_vm_allocations[fn].erase(svc);
+                    fn_num_vms[fn] -= fn_vms.second;
+                    if (fn_num_vms[fn] == 0)
+                    {
+                        fn_num_vms.erase(fn);
+                    }
+                }
+                svc_fn_num_vms.erase(svc);
+
+                left_svc_ranks.push_back(std::make_pair(fp_svc_cat_revenues[svc_cat]+fp_svc_cat_penalties[svc_cat]/nvms, svc));
+            }
+
+            // Reroute the services that are not fully served, the most valuable first, on the cheapest FNs with capacity left
+            if (!left_svc_ranks.empty())
+            {
+                std::stable_sort(left_svc_ranks.begin(),
+                                 left_svc_ranks.end(),
+                                 [](const std::pair<RealT,std::size_t>& a, const std::pair<RealT,std::size_t>& b)
+                                 {
+                                    return a.first > b.first;
+                                 });
+
+                std::map<std::size_t,std::size_t> fn_left_num_vms; // Number of VMs of this category that still fit into each FN
+                std::size_t tot_left_num_vms = 0;
+                std::vector<std::pair<RealT,std::size_t>> fn_costs; // <cost of a VM, FN> pairs for VMs that are (re)allocated, cheapest first
+                for (auto const& key_fn : key_fns)
+                {
+                    auto const cost = vm_cost(key_fn.first.first, key_fn.first.second, vm_cat, true);
+                    for (auto const fn : key_fn.second)
+                    {
+                        auto const it = fn_num_vms.find(fn);
+                        std::size_t fn_left = fn_capacity(fn);
+                        fn_left -= std::min(fn_left, (it != fn_num_vms.end()) ? it->second : 0);
+                        if (fn_left > 0)
+                        {
+                            fn_left_num_vms[fn] = fn_left;
+                            tot_left_num_vms = std::min(tot_left_num_vms+fn_left, static_cast<std::size_t>(std::numeric_limits<int>::max()));
+                            fn_costs.push_back(std::make_pair(cost, fn));
+                        }
+                    }
+                }
+                std::stable_sort(fn_costs.begin(),
+                                 fn_costs.end(),
+                                 [](const std::pair<RealT,std::size_t>& a, const std::pair<RealT,std::size_t>& b)
+                                 {
+                                    return a.first < b.first;
+                                 });
+
+                for (auto const& svc_rank : left_svc_ranks)
+                {
+                    auto const svc = svc_rank.second;
+                    auto const svc_cat = svc_categories[svc];
+                    auto const nvms = svc_cat_vm_cat_min_num_vms[svc_cat][vm_cat];
+
+                    if (tot_left_num_vms < nvms)
+                    {
+                        continue;
+                    }
+
+                    // The FNs that host VMs of the service save the reallocation cost, up to the number of VMs they host
+                    std::vector<std::tuple<RealT,std::size_t,std::size_t>> old_options; // <cost of a VM, FN, max number of VMs> triple, cheapest first
+                    for (auto const fn : svc_old_fns[svc])
+                    {
+                        auto const& svc_vms = fn_vm_allocations[fn].at(svc);
+                        if (svc_vms.first == vm_cat && fn_left_num_vms.count(fn) > 0)
+                        {
+                            old_options.push_back(std::make_tuple(vm_cost(fn_categories[fn], fn_power_states[fn], vm_cat, false), fn, std::min(svc_vms.second, nvms)));
+                        }
+                    }
+                    std::stable_sort(old_options.begin(),
+                                     old_options.end(),
+                                     [](const std::tuple<RealT,std::size_t,std::size_t>& a, const std::tuple<RealT,std::size_t,std::size_t>& b)
+                                     {
+                                        return std::get<0>(a) < std::get<0>(b);
+                                     });
+
+                    // Fill the cheapest FNs first, by merging the FNs that host VMs of the service with the other ones
+                    std::map<std::size_t,std::size_t> fn_new_num_vms;
+                    std::size_t svc_left = nvms;
+                    RealT cost = 0;
+                    std::size_t o = 0;
+                    std::size_t c = 0;
+                    while (svc_left > 0 && (o < old_options.size() || c < fn_costs.size()))
+                    {
+                        std::size_t fn = 0;
+                        std::size_t max_num_vms = svc_left;
+                        RealT unit_cost = 0;
+                        if (o < old_options.size() && (c == fn_costs.size() || std::get<0>(old_options[o]) <= fn_costs[c].first))
+                        {
+                            std::tie(unit_cost, fn, max_num_vms) = old_options[o++];
+                        }
+                        else
+                        {
+                            std::tie(unit_cost, fn) = fn_costs[c++];
+                        }
+
+                        auto const n = std::min(std::min(svc_left, max_num_vms), fn_left_num_vms.at(fn)-fn_new_num_vms[fn]);
+                        if (n > 0)
+                        {
+                            fn_new_num_vms[fn] += n;
+                            svc_left -= n;
+                            cost += n*unit_cost;
+                        }
+                    }
+
+                    if (svc_left > 0 || cost >= nvms*fp_svc_cat_revenues[svc_cat]+fp_svc_cat_penalties[svc_cat])
+                    {
+                        continue;
+                    }
+
+                    for (auto const& fn_vms : fn_new_num_vms)
+                    {
+                        if (fn_vms.second > 0)
+                        {
+                            allocate(svc, fn_vms.first, fn_vms.second);
+                            fn_left_num_vms.at(fn_vms.first) -= fn_vms.second;
+                        }
+                    }
+                    tot_left_num_vms -= nvms;
+                    fn_costs.erase(std::remove_if(fn_costs.begin(),
+                                                  fn_costs.end(),
+                                                  [&](const std::pair<RealT,std::size_t>& fn_cost)
+                                                  {
+                                                    return fn_left_num_vms.at(fn_cost.second) == 0;
+                                                  }),
+                                   fn_costs.end());
+                }
+            }
+
+            // Update the residual FN capacities (once per FN, to be consistent with the capacities of the flow network)
+            for (auto const& fn_vms : fn_num_vms)
+            {
+                auto const fn = fn_vms.first;
+
+                solution.fn_cpu_allocations[fn] += fn_vms.second*vm_cat_fn_cat_cpu_specs[vm_cat][fn_categories[fn]];
+                solution.fn_power_states[fn] = true;
+            }
+        }
+
+        for (auto const fn : fixed_fns)
+        {
+            if (fn < nfns)
+            {
+                // Make sure the FN is powered on regardless its assignment
+                solution.fn_power_states[fn] = true;
+            }
+        }
+
+        detail::eval_vm_allocation(fn_categories,
+                                   fn_power_states,
+                                   fn_vm_allocations,
+                                   fn_cat_min_powers,
+                                   fn_cat_max_powers,
+                                   vm_cat_alloc_costs,
+                                   svc_categories,
+                                   svc_cat_vm_cat_min_num_vms,
+                                   fp_svc_cat_revenues,
+                                   fp_svc_cat_penalties,
+                                   fp_electricity_cost,
+                                   fp_fn_cat_asleep_costs,
+                                   fp_fn_cat_awake_costs,
+                                   deltat,
+                                   solution);
+
+        solution.solved = true;
+        solution.optimal = false;
+        solution.solve_time = std::chrono::duration_cast<std::chrono::duration<RealT>>(std::chrono::steady_clock::now()-start_time).count();
+
+        DCS_DEBUG_TRACE("- Solve time: " << solution.solve_time);
+        DCS_DEBUG_TRACE("Final VM Allocation: " << solution.fn_vm_allocations);
+
+        return solution;
+    }
+}; // bahreini2017_mcappim_flow_vm_allocation_solver_t
+
+template <typename RealT>
+constexpr double bahreini2017_mcappim_flow_vm_allocation_solver_t<RealT>::cost_scale;
+
+#endif // DCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER
+
+
 }} // Namespace dcs::fog
 
 
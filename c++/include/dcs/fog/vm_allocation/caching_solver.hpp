@@ -0,0 +1,530 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fog/vm_allocation/caching_solver.hpp
+ *
+ * \brief Solver for the VM allocation problem that caches the VM allocations
+ *  found by another solver.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FOG_VM_ALLOCATION_CACHING_SOLVER_HPP
+#define DCS_FOG_VM_ALLOCATION_CACHING_SOLVER_HPP
+
+
+#include <chrono>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/fog/vm_allocation/commons.hpp>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace dcs { namespace fog {
+
+/**
+ * \brief Solver for the VM allocation problem that caches the VM allocations
+ *  found by another solver.
+ *
+ * Consecutive intervals often give rise to the very same VM allocation
+ * problem (e.g., with a fixed or step user mobility model, or with coarse
+ * arrival rate estimators), which the decorated solver would otherwise solve
+ * again from scratch.
+ * Problem instances are identified by all the inputs of the solver (the
+ * starting point of \c solve_with_fixed_fns_from excluded, since it does not
+ * change the problem), and the VM allocations found for the most recently
+ * used ones are kept, up to the given capacity (LRU policy).
+ * Only solved VM allocations are cached.
+ *
+ * The decorated solver is not called on cache hits, so its internal state
+ * (e.g., the VM allocation used to warm start the next solve) is not updated.
+ */
+template <typename RealT>
+class caching_vm_allocation_solver_t: public base_vm_allocation_solver_t<RealT>
+{
+private:
+    /// An instance of the VM allocation problem
+    struct problem_t
+    {
+        bool operator==(const problem_t& that) const
+        {
+            return hash == that.hash
+                && fixed_fns == that.fixed_fns
+                && fn_categories == that.fn_categories
+                && fn_power_states == that.fn_power_states
+                && fn_vm_allocations == that.fn_vm_allocations
+                && fn_cat_min_powers == that.fn_cat_min_powers
+                && fn_cat_max_powers == that.fn_cat_max_powers
+                && vm_cat_fn_cat_cpu_specs == that.vm_cat_fn_cat_cpu_specs
+                && vm_cat_alloc_costs == that.vm_cat_alloc_costs
+                && svc_categories == that.svc_categories
+                && svc_cat_vm_cat_min_num_vms == that.svc_cat_vm_cat_min_num_vms
+                && fp_svc_cat_revenues == that.fp_svc_cat_revenues
+                && fp_svc_cat_penalties == that.fp_svc_cat_penalties
+                && fp_electricity_cost == that.fp_electricity_cost
+                && fp_fn_cat_asleep_costs == that.fp_fn_cat_asleep_costs
+                && fp_fn_cat_awake_costs == that.fp_fn_cat_awake_costs
+                && deltat == that.deltat;
+        }
+
+        std::size_t hash; ///< The hash value of this problem instance, computed once
+        std::set<std::size_t> fixed_fns;
+        std::vector<std::size_t> fn_categories;
+        std::vector<bool> fn_power_states;
+        std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>> fn_vm_allocations;
+        std::vector<RealT> fn_cat_min_powers;
+        std::vector<RealT> fn_cat_max_powers;
+        std::vector<std::vector<RealT>> vm_cat_fn_cat_cpu_specs;
+        std::vector<RealT> vm_cat_alloc_costs;
+        std::vector<std::size_t> svc_categories;
+        std::vector<std::vector<std::size_t>> svc_cat_vm_cat_min_num_vms;
+        std::vector<RealT> fp_svc_cat_revenues;
+        std::vector<RealT> fp_svc_cat_penalties;
+        RealT fp_electricity_cost;
+        std::vector<RealT> fp_fn_cat_asleep_costs;
+        std::vector<RealT> fp_fn_cat_awake_costs;
+        RealT deltat;
+    }; // problem_t
+
+    struct problem_hasher_t
+    {
+        std::size_t operator()(const problem_t& problem) const
+        {
+            return problem.hash;
+        }
+    }; // problem_hasher_t
+
+    struct cache_entry_t
+    {
+        vm_allocation_t<RealT> solution;
+        typename std::list<const problem_t*>::iterator lru_it; ///< The position of the problem in the LRU list
+    }; // cache_entry_t
+
+
+public:
+    static const std::size_t default_max_size = 128;
+
+
+    explicit caching_vm_allocation_solver_t(const std::shared_ptr<base_vm_allocation_solver_t<RealT>>& p_solver,
+                                            std::size_t max_size = default_max_size)
+    : p_solver_(p_solver),
+      max_size_(max_size),
+      num_hits_(0),
+      num_misses_(0)
+    {
+        // pre: solver is not null
+        DCS_ASSERT(p_solver_,
+                   DCS_EXCEPTION_THROW(std::invalid_argument,
+                                       "Invalid VM allocation solver"));
+        // pre: max size > 0
+        DCS_ASSERT(max_size_ > 0,
+                   DCS_EXCEPTION_THROW(std::invalid_argument,
+                                       "Cache size must be > 0"));
+    }
+
+    std::size_t max_size() const
+    {
+        return max_size_;
+    }
+
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        return cache_.size();
+    }
+
+    /// The number of solves whose VM allocation has been found in the cache
+    std::size_t num_hits() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        return num_hits_;
+    }
+
+    /// The number of solves whose VM allocation has been computed by the decorated solver
+    std::size_t num_misses() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        return num_misses_;
+    }
+
+    /// The fraction of solves whose VM allocation has been found in the cache
+    RealT hit_rate() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        return (num_hits_+num_misses_) > 0 ? static_cast<RealT>(num_hits_)/static_cast<RealT>(num_hits_+num_misses_) : 0;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        cache_.clear();
+        lru_.clear();
+        num_hits_ = num_misses_ = 0;
+    }
+
+    vm_allocation_t<RealT> solve(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                 const std::vector<bool>& fn_power_states, // The power status of each FN
+                                 const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                 const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                 const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                 const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                 const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                 const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                 const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                 const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                 const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                 const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                 const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                 const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                 RealT deltat = 1 // Length of the time interval
+                            ) const
+    {
+        return this->solve_cached(nullptr, // No starting point
+                                  std::set<std::size_t>(), // Any FN can be selected
+                                  fn_categories,
+                                  fn_power_states,
+                                  fn_vm_allocations,
+                                  fn_cat_min_powers,
+                                  fn_cat_max_powers,
+                                  vm_cat_fn_cat_cpu_specs,
+                                  vm_cat_alloc_costs,
+                                  svc_categories,
+                                  svc_cat_vm_cat_min_num_vms,
+                                  fp_svc_cat_revenues,
+                                  fp_svc_cat_penalties,
+                                  fp_electricity_cost,
+                                  fp_fn_cat_asleep_costs,
+                                  fp_fn_cat_awake_costs,
+                                  deltat);
+    }
+
+    vm_allocation_t<RealT> solve_with_fixed_fns(const std::set<std::size_t>& fixed_fns,
+                                                const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                                const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                                const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                                const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                RealT deltat = 1 // Length of the time interval
+                            ) const
+    {
+        return this->solve_cached(nullptr, // No starting point
+                                  fixed_fns,
+                                  fn_categories,
+                                  fn_power_states,
+                                  fn_vm_allocations,
+                                  fn_cat_min_powers,
+                                  fn_cat_max_powers,
+                                  vm_cat_fn_cat_cpu_specs,
+                                  vm_cat_alloc_costs,
+                                  svc_categories,
+                                  svc_cat_vm_cat_min_num_vms,
+                                  fp_svc_cat_revenues,
+                                  fp_svc_cat_penalties,
+                                  fp_electricity_cost,
+                                  fp_fn_cat_asleep_costs,
+                                  fp_fn_cat_awake_costs,
+                                  deltat);
+    }
+
+    vm_allocation_t<RealT> solve_with_fixed_fns_from(const vm_allocation_t<RealT>& start_vm_alloc, // The VM allocation from which to start the search
+                                                     const std::set<std::size_t>& fixed_fns,
+                                                     const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                     const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                     const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                     const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                     const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                     const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                     const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                     const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                     const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                                     const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                                     const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                                     const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                     const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                     const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                     RealT deltat = 1 // Length of the time interval
+                            ) const
+    {
+        return this->solve_cached(&start_vm_alloc,
+                                  fixed_fns,
+                                  fn_categories,
+                                  fn_power_states,
+                                  fn_vm_allocations,
+                                  fn_cat_min_powers,
+                                  fn_cat_max_powers,
+                                  vm_cat_fn_cat_cpu_specs,
+                                  vm_cat_alloc_costs,
+                                  svc_categories,
+                                  svc_cat_vm_cat_min_num_vms,
+                                  fp_svc_cat_revenues,
+                                  fp_svc_cat_penalties,
+                                  fp_electricity_cost,
+                                  fp_fn_cat_asleep_costs,
+                                  fp_fn_cat_awake_costs,
+                                  deltat);
+    }
+
+
+private:
+    template <typename T>
+    static void hash_combine(std::size_t& seed, const T& value)
+    {
+        seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    static std::size_t hash_problem(const problem_t& problem)
+    {
+        std::size_t seed = 0;
+
+        for (auto fn : problem.fixed_fns)
+        {
+            hash_combine(seed, fn);
+        }
+        for (auto fn_cat : problem.fn_categories)
+        {
+            hash_combine(seed, fn_cat);
+        }
+        hash_combine(seed, problem.fn_power_states);
+        for (std::size_t fn = 0; fn < problem.fn_vm_allocations.size(); ++fn)
+        {
+            for (auto const& svc_vms : problem.fn_vm_allocations[fn])
+            {
+                hash_combine(seed, fn);
+                hash_combine(seed, svc_vms.first);
+                hash_combine(seed, svc_vms.second.first);
+                hash_combine(seed, svc_vms.second.second);
+            }
+        }
+        for (auto power : problem.fn_cat_min_powers)
+        {
+            hash_combine(seed, power);
+        }
+        for (auto power : problem.fn_cat_max_powers)
+        {
+            hash_combine(seed, power);
+        }
+        for (auto const& fn_cat_cpu_specs : problem.vm_cat_fn_cat_cpu_specs)
+        {
+            for (auto cpu_spec : fn_cat_cpu_specs)
+            {
+                hash_combine(seed, cpu_spec);
+            }
+        }
+        for (auto cost : problem.vm_cat_alloc_costs)
+        {
+            hash_combine(seed, cost);
+        }
+        for (auto svc_cat : problem.svc_categories)
+        {
+            hash_combine(seed, svc_cat);
+        }
+        for (auto const& vm_cat_min_num_vms : problem.svc_cat_vm_cat_min_num_vms)
+        {
+            for (auto num_vms : vm_cat_min_num_vms)
+            {
+                hash_combine(seed, num_vms);
+            }
+        }
+        for (auto revenue : problem.fp_svc_cat_revenues)
+        {
+            hash_combine(seed, revenue);
+        }
+        for (auto penalty : problem.fp_svc_cat_penalties)
+        {
+            hash_combine(seed, penalty);
+        }
+        hash_combine(seed, problem.fp_electricity_cost);
+        for (auto cost : problem.fp_fn_cat_asleep_costs)
+        {
+            hash_combine(seed, cost);
+        }
+        for (auto cost : problem.fp_fn_cat_awake_costs)
+        {
+            hash_combine(seed, cost);
+        }
+        hash_combine(seed, problem.deltat);
+
+        return seed;
+    }
+
+    vm_allocation_t<RealT> solve_cached(const vm_allocation_t<RealT>* p_start_vm_alloc, // The VM allocation from which to start the search (if any)
+                                        const std::set<std::size_t>& fixed_fns,
+                                        const std::vector<std::size_t>& fn_categories,
+                                        const std::vector<bool>& fn_power_states,
+                                        const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations,
+                                        const std::vector<RealT>& fn_cat_min_powers,
+                                        const std::vector<RealT>& fn_cat_max_powers,
+                                        const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs,
+                                        const std::vector<RealT>& vm_cat_alloc_costs,
+                                        const std::vector<std::size_t>& svc_categories,
+                                        const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms,
+                                        const std::vector<RealT>& fp_svc_cat_revenues,
+                                        const std::vector<RealT>& fp_svc_cat_penalties,
+                                        const RealT fp_electricity_cost,
+                                        const std::vector<RealT>& fp_fn_cat_asleep_costs,
+                                        const std::vector<RealT>& fp_fn_cat_awake_costs,
+                                        RealT deltat) const
+    {
+        auto const start_time = std::chrono::steady_clock::now();
+
+        problem_t problem;
+        problem.fixed_fns = fixed_fns;
+        problem.fn_categories = fn_categories;
+        problem.fn_power_states = fn_power_states;
+        problem.fn_vm_allocations = fn_vm_allocations;
+        problem.fn_cat_min_powers = fn_cat_min_powers;
+        problem.fn_cat_max_powers = fn_cat_max_powers;
+        problem.vm_cat_fn_cat_cpu_specs = vm_cat_fn_cat_cpu_specs;
+        problem.vm_cat_alloc_costs = vm_cat_alloc_costs;
+        problem.svc_categories = svc_categories;
+        problem.svc_cat_vm_cat_min_num_vms = svc_cat_vm_cat_min_num_vms;
+        problem.fp_svc_cat_revenues = fp_svc_cat_revenues;
+        problem.fp_svc_cat_penalties = fp_svc_cat_penalties;
+        problem.fp_electricity_cost = fp_electricity_cost;
+        problem.fp_fn_cat_asleep_costs = fp_fn_cat_asleep_costs;
+        problem.fp_fn_cat_awake_costs = fp_fn_cat_awake_costs;
+        problem.deltat = deltat;
+        problem.hash = hash_problem(problem);
+
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+
+            auto it = cache_.find(problem);
+            if (it != cache_.end())
+            {
+                ++num_hits_;
+
+                // Move the problem to the front of the LRU list
+                lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+
+                auto solution = it->second.solution;
+
+                // The time is the one taken to look the VM allocation up
+                solution.solve_time = std::chrono::duration_cast<std::chrono::duration<RealT>>(std::chrono::steady_clock::now()-start_time).count();
+                solution.first_incumbent_time = solution.solve_time;
+
+                DCS_DEBUG_TRACE("VM allocation found in cache (hits: " << num_hits_ << ", misses: " << num_misses_ << ")");
+
+                return solution;
+            }
+
+            ++num_misses_;
+        }
+
+        // Solve the problem without holding the lock, so that concurrent solves are not serialized
+        auto solution = p_start_vm_alloc
+                        ? p_solver_->solve_with_fixed_fns_from(*p_start_vm_alloc,
+                                                               fixed_fns,
+                                                               fn_categories,
+                                                               fn_power_states,
+                                                               fn_vm_allocations,
+                                                               fn_cat_min_powers,
+                                                               fn_cat_max_powers,
+                                                               vm_cat_fn_cat_cpu_specs,
+                                                               vm_cat_alloc_costs,
+                                                               svc_categories,
+                                                               svc_cat_vm_cat_min_num_vms,
+                                                               fp_svc_cat_revenues,
+                                                               fp_svc_cat_penalties,
+                                                               fp_electricity_cost,
+                                                               fp_fn_cat_asleep_costs,
+                                                               fp_fn_cat_awake_costs,
+                                                               deltat)
+                        : p_solver_->solve_with_fixed_fns(fixed_fns,
+                                                          fn_categories,
+                                                          fn_power_states,
+                                                          fn_vm_allocations,
+                                                          fn_cat_min_powers,
+                                                          fn_cat_max_powers,
+                                                          vm_cat_fn_cat_cpu_specs,
+                                                          vm_cat_alloc_costs,
+                                                          svc_categories,
+                                                          svc_cat_vm_cat_min_num_vms,
+                                                          fp_svc_cat_revenues,
+                                                          fp_svc_cat_penalties,
+                                                          fp_electricity_cost,
+                                                          fp_fn_cat_asleep_costs,
+                                                          fp_fn_cat_awake_costs,
+                                                          deltat);
+
+        if (solution.solved)
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+
+            // The same problem may have been cached in the meantime by a concurrent solve
+            if (cache_.count(problem) == 0)
+            {
+                if (cache_.size() >= max_size_)
+                {
+                    // Evict the least recently used problem
+                    cache_.erase(*lru_.back());
+                    lru_.pop_back();
+                }
+
+                lru_.push_front(nullptr);
+                auto ins = cache_.emplace(std::move(problem), cache_entry_t{solution, lru_.begin()});
+                lru_.front() = &ins.first->first;
+            }
+        }
+
+        return solution;
+    }
+
+
+    std::shared_ptr<base_vm_allocation_solver_t<RealT>> p_solver_; ///< The decorated solver
+    std::size_t max_size_; ///< The max number of VM allocations to keep in the cache
+    mutable std::mutex mtx_; ///< Guards the cache, which can be used by concurrent solves
+    mutable std::unordered_map<problem_t,cache_entry_t,problem_hasher_t> cache_; ///< The cached VM allocations, by problem instance
+    mutable std::list<const problem_t*> lru_; ///< The cached problem instances, from the most to the least recently used
+    mutable std::size_t num_hits_; ///< The number of solves whose VM allocation has been found in the cache
+    mutable std::size_t num_misses_; ///< The number of solves whose VM allocation has been computed by the decorated solver
+}; // caching_vm_allocation_solver_t
+
+template <typename RealT>
+const std::size_t caching_vm_allocation_solver_t<RealT>::default_max_size;
+
+}} // Namespace dcs::fog
+
+
+#endif // DCS_FOG_VM_ALLOCATION_CACHING_SOLVER_HPP
@@ -28,9 +28,15 @@
 #define DCS_FOG_VM_ALLOCATION_COMMONS_HPP
 
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <dcs/macro.hpp>
+#include <functional>
 #include <limits>
 #include <map>
+#include <mutex>
+#include <set>
 #include <vector>
 #include <utility>
 
@@ -45,7 +51,10 @@ struct vm_allocation_t
 	  optimal(false),
 	  objective_value(std::numeric_limits<RealT>::quiet_NaN()),
 	  revenue(std::numeric_limits<RealT>::quiet_NaN()),
-	  cost(std::numeric_limits<RealT>::quiet_NaN())
+	  cost(std::numeric_limits<RealT>::quiet_NaN()),
+	  solve_time(std::numeric_limits<RealT>::quiet_NaN()),
+	  first_incumbent_time(std::numeric_limits<RealT>::quiet_NaN()),
+	  gap(std::numeric_limits<RealT>::quiet_NaN())
 	{
 	}
 
@@ -56,6 +65,9 @@ struct vm_allocation_t
 	RealT profit;
 	RealT revenue;
 	RealT cost;
+	RealT solve_time; // Wall-clock time (in seconds) taken by the solver to solve the problem (NaN if not measured)
+	RealT first_incumbent_time; // Wall-clock time (in seconds) taken by the solver to find its first feasible solution (NaN if not measured)
+	RealT gap; // Relative gap between the objective value and the best bound proved by the solver (NaN if the solver gives no bound)
 	std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>> fn_vm_allocations; // For each FN, there is a collection of <service => <VM category,number>> mappings
 	std::vector<bool> fn_power_states;
     std::vector<RealT> fn_cpu_allocations;
@@ -71,7 +83,9 @@ struct multislot_vm_allocation_t
 	  optimal(false),
 	  objective_value(std::numeric_limits<RealT>::quiet_NaN()),
 	  revenue(std::numeric_limits<RealT>::quiet_NaN()),
-	  cost(std::numeric_limits<RealT>::quiet_NaN())
+	  cost(std::numeric_limits<RealT>::quiet_NaN()),
+	  solve_time(std::numeric_limits<RealT>::quiet_NaN()),
+	  gap(std::numeric_limits<RealT>::quiet_NaN())
 	{
 	}
 
@@ -82,6 +96,8 @@ struct multislot_vm_allocation_t
 	RealT profit;
 	RealT revenue;
 	RealT cost;
+	RealT solve_time; // Wall-clock time (in seconds) taken by the solver to solve the problem (NaN if not measured)
+	RealT gap; // Relative gap between the objective value and the best bound proved by the solver (NaN if the solver gives no bound)
 	std::vector<std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>> fn_vm_allocations; // For each time slot and FN, there is a collection of <service => <VM category,number>> mappings
 	std::vector<std::vector<bool>> fn_power_states; // For each time slot and FN, tells whether a given FN is to be powered on or not
     std::vector<std::vector<RealT>> fn_cpu_allocations; // For each time slot and FN, gives the amount of used CPU for a given FN
@@ -129,6 +145,51 @@ struct base_vm_allocation_solver_t
                                          const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
                                          RealT deltat = 1 // Length of the time interval
                                     ) const = 0;
+
+    /**
+     * \brief Same as \c solve_with_fixed_fns but gives the solver the chance
+     *  to start its search from the given VM allocation.
+     *
+     * By default, the starting point is ignored.
+     */
+    virtual vm_allocation_t<RealT> solve_with_fixed_fns_from(const vm_allocation_t<RealT>& start_vm_alloc, // The VM allocation from which to start the search
+                                         const std::set<std::size_t>& fixed_fns,
+                                         const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                         const std::vector<bool>& fn_power_states, // The power status of each FN
+                                         const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                         const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                         const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                         const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                         const std::vector<RealT>& vm_cat_alloc_costs, // // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                         const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                         const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                         const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                         const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                         const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                         const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                         const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                         RealT deltat = 1 // Length of the time interval
+                                    ) const
+    {
+        DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( start_vm_alloc );
+
+        return this->solve_with_fixed_fns(fixed_fns,
+                                          fn_categories,
+                                          fn_power_states,
+                                          fn_vm_allocations,
+                                          fn_cat_min_powers,
+                                          fn_cat_max_powers,
+                                          vm_cat_fn_cat_cpu_specs,
+                                          vm_cat_alloc_costs,
+                                          svc_categories,
+                                          svc_cat_vm_cat_min_num_vms,
+                                          fp_svc_cat_revenues,
+                                          fp_svc_cat_penalties,
+                                          fp_electricity_cost,
+                                          fp_fn_cat_asleep_costs,
+                                          fp_fn_cat_awake_costs,
+                                          deltat);
+    }
 }; // base_vm_allocation_solver_t
 
 
@@ -175,6 +236,514 @@ struct base_multislot_vm_allocation_solver_t
 }; // base_multislot_vm_allocation_solver_t
 
 
+namespace detail {
+
+/**
+ * \brief Computes the revenue and the cost of the given VM allocation.
+ *
+ * Revenues and costs are the same as the ones used in the objective function
+ * of the optimal VM allocation problem.
+ */
+template <typename RealT>
+void eval_vm_allocation(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                        const std::vector<bool>& fn_power_states, // The power status of each FN
+                        const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                        const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                        const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                        const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                        const std::vector<std::size_t>& svc_categories, // Service categories by service
+                        const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                        const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service category
+                        const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service category
+                        const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                        const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                        const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                        RealT deltat, // Length of the time interval
+                        vm_allocation_t<RealT>& solution) // The VM allocation to evaluate
+{
+    const std::size_t nfns = fn_categories.size();
+    const std::size_t nsvcs = svc_categories.size();
+
+    std::vector<std::vector<std::size_t>> svc_vm_cat_num_vms(nsvcs); // Total number of allocated VMs, by service and VM category
+
+    solution.revenue = 0;
+    solution.cost = 0;
+    for (std::size_t i = 0; i < nfns; ++i)
+    {
+        auto const fn_cat = fn_categories[i];
+        const bool on = solution.fn_power_states[i];
+        const bool was_on = fn_power_states[i];
+        auto const dC = fn_cat_max_powers[fn_cat]-fn_cat_min_powers[fn_cat];
+
+        // Revenues
+        for (auto const& svc_vms : solution.fn_vm_allocations[i])
+        {
+            auto const svc_cat = svc_categories[svc_vms.first];
+
+            solution.revenue += fp_svc_cat_revenues[svc_cat]*svc_vms.second.second;
+        }
+
+        // Costs
+        // - Add elecricity consumption cost
+        solution.cost += (on*fn_cat_min_powers[fn_cat]+dC*solution.fn_cpu_allocations[i])*fp_electricity_cost;
+
+        // - Add switch-on/off costs
+        solution.cost += on*(1-was_on)*fp_fn_cat_awake_costs[fn_cat]/deltat
+                      +  (1-on)*was_on*fp_fn_cat_asleep_costs[fn_cat]/deltat;
+
+        // - Add VM (re)allocation costs
+        for (auto const& svc_vms : solution.fn_vm_allocations[i])
+        {
+            auto const j = svc_vms.first;
+            auto const k = svc_vms.second.first;
+            auto const it = fn_vm_allocations[i].find(j);
+            auto const old_y = (it != fn_vm_allocations[i].end() && it->second.first == k) ? it->second.second : 0;
+
+            if (svc_vms.second.second > old_y)
+            {
+                solution.cost += (svc_vms.second.second-old_y)*vm_cat_alloc_costs[k]/deltat;
+            }
+
+            if (svc_vm_cat_num_vms[j].size() <= k)
+            {
+                svc_vm_cat_num_vms[j].resize(k+1, 0);
+            }
+            svc_vm_cat_num_vms[j][k] += svc_vms.second.second;
+        }
+    }
+    // - Add service penalties
+    for (std::size_t j = 0; j < nsvcs; ++j)
+    {
+        auto const svc_cat = svc_categories[j];
+        auto const& min_num_vms = svc_cat_vm_cat_min_num_vms[svc_cat];
+
+        if (std::find(min_num_vms.begin(), min_num_vms.end(), 0) != min_num_vms.end())
+        {
+            continue;
+        }
+
+        std::size_t tot_num_vms = 0;
+        std::size_t left_term = 0;
+        for (std::size_t k = 0; k < svc_vm_cat_num_vms[j].size(); ++k)
+        {
+            auto const ysum_term = svc_vm_cat_num_vms[j][k];
+
+            tot_num_vms += ysum_term;
+            left_term += (ysum_term > 0 && ysum_term != min_num_vms[k]) ? 1 : 0;
+        }
+
+        solution.cost += ((tot_num_vms == 0) + left_term)*fp_svc_cat_penalties[svc_cat];
+    }
+    solution.revenue *= deltat;
+    solution.cost *= deltat;
+    solution.profit = solution.objective_value = solution.revenue-solution.cost;
+}
+
+/**
+ * \brief Computes the revenue and the cost of the given multi-slot VM
+ *  allocation.
+ *
+ * Revenues and costs are the same as the ones used in the objective function
+ * of the optimal multi-slot VM allocation problem.
+ */
+template <typename RealT>
+void eval_multislot_vm_allocation(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                  const std::vector<bool>& fn_power_states, // The power status of each FN before the first time slot
+                                  const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // VM allocations before the first time slot, by FN and service
+                                  const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                  const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                  const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                  const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                  const std::vector<std::vector<std::vector<std::size_t>>>& slot_svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by time slot, service category and VM category
+                                  const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service category
+                                  const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service category
+                                  const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                  const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                  const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                  RealT deltat, // Length of the time interval
+                                  multislot_vm_allocation_t<RealT>& solution) // The VM allocation to evaluate
+{
+    const std::size_t nslots = solution.fn_power_states.size();
+    const std::size_t nfns = fn_categories.size();
+    const std::size_t nsvcs = svc_categories.size();
+
+    // Gets the number of class-k VMs allocated on a FN for service j
+    auto const num_vms = [](const std::map<std::size_t,std::pair<std::size_t,std::size_t>>& vm_allocs, std::size_t j, std::size_t k) -> std::size_t
+                         {
+                            auto const it = vm_allocs.find(j);
+                            return (it != vm_allocs.end() && it->second.first == k) ? it->second.second : 0;
+                         };
+
+    solution.revenue = 0;
+    solution.cost = 0;
+    for (std::size_t t = 0; t < nslots; ++t)
+    {
+        auto const& prev_fn_power_states = (t > 0) ? solution.fn_power_states[t-1] : fn_power_states;
+        auto const& prev_fn_vm_allocations = (t > 0) ? solution.fn_vm_allocations[t-1] : fn_vm_allocations;
+
+        std::vector<std::vector<std::size_t>> svc_vm_cat_num_vms(nsvcs); // Total number of allocated VMs, by service and VM category
+
+        // Revenues
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            for (auto const& svc_vms : solution.fn_vm_allocations[t][i])
+            {
+                auto const svc_cat = svc_categories[svc_vms.first];
+
+                solution.revenue += fp_svc_cat_revenues[svc_cat]*svc_vms.second.second;
+            }
+        }
+
+        // Costs
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            auto const fn_cat = fn_categories[i];
+            const bool on = solution.fn_power_states[t][i];
+            const bool was_on = prev_fn_power_states[i];
+            auto const dC = fn_cat_max_powers[fn_cat]-fn_cat_min_powers[fn_cat];
+
+            // - Add elecricity consumption cost
+            solution.cost += (on*fn_cat_min_powers[fn_cat]+dC*solution.fn_cpu_allocations[t][i])*fp_electricity_cost;
+
+            // - Add switch-on/off costs
+            solution.cost += on*(1-was_on)*fp_fn_cat_awake_costs[fn_cat]/deltat
+                          +  (1-on)*was_on*fp_fn_cat_asleep_costs[fn_cat]/deltat;
+
+            // - Add VM (re)allocation costs
+            for (auto const& svc_vms : solution.fn_vm_allocations[t][i])
+            {
+                auto const j = svc_vms.first;
+                auto const k = svc_vms.second.first;
+                auto const old_y = num_vms(prev_fn_vm_allocations[i], j, k);
+
+                if (svc_vms.second.second > old_y)
+                {
+                    solution.cost += (svc_vms.second.second-old_y)*vm_cat_alloc_costs[k]/deltat;
+                }
+
+                if (svc_vm_cat_num_vms[j].size() <= k)
+                {
+                    svc_vm_cat_num_vms[j].resize(k+1, 0);
+                }
+                svc_vm_cat_num_vms[j][k] += svc_vms.second.second;
+            }
+        }
+        // - Add service penalties
+        for (std::size_t j = 0; j < nsvcs; ++j)
+        {
+            auto const svc_cat = svc_categories[j];
+            auto const& min_num_vms = slot_svc_cat_vm_cat_min_num_vms[t][svc_cat];
+
+            if (std::find(min_num_vms.begin(), min_num_vms.end(), 0) != min_num_vms.end())
+            {
+                continue;
+            }
+
+            std::size_t tot_num_vms = 0;
+            std::size_t left_term = 0;
+            for (std::size_t k = 0; k < svc_vm_cat_num_vms[j].size(); ++k)
+            {
+                auto const ysum_term = svc_vm_cat_num_vms[j][k];
+
+                tot_num_vms += ysum_term;
+                left_term += (ysum_term > 0 && ysum_term != min_num_vms[k]) ? 1 : 0;
+            }
+
+            solution.cost += ((tot_num_vms == 0) + left_term)*fp_svc_cat_penalties[svc_cat];
+        }
+    }
+    solution.revenue *= deltat;
+    solution.cost *= deltat;
+    solution.profit = solution.objective_value = solution.revenue-solution.cost;
+}
+
+
+/**
+ * \brief Builds a starting point for the VM allocation problem out of the
+ *  current VM allocation.
+ *
+ * FNs that are not in \a fixed_fns (if not empty) are powered off, and VMs
+ * that are no longer needed (i.e., that exceed the min number of VMs of their
+ * service) are dropped, so that the returned allocation is a feasible solution
+ * of the new problem.
+ */
+inline void make_vm_allocation_start(const std::vector<bool>& fn_power_states, // The power status of each FN
+                                     const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                     const std::set<std::size_t>& fixed_fns, // The set of selected FNs to use in the VM allocation (if empty, any FN can be used)
+                                     const std::vector<std::size_t>& svc_categories, // Maps every service to its service category
+                                     const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                     std::vector<bool>& start_fn_power_states, // The power status of each FN in the starting point
+                                     std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& start_fn_vm_allocations) // The VM allocations of the starting point, by FN and service
+{
+    const std::size_t nfns = fn_power_states.size();
+
+    start_fn_power_states.assign(nfns, false);
+    start_fn_vm_allocations.assign(nfns, std::map<std::size_t,std::pair<std::size_t,std::size_t>>());
+
+    std::map<std::size_t,std::size_t> svc_num_left_vms; // Number of VMs that can still be allocated, by service
+    for (std::size_t i = 0; i < nfns; ++i)
+    {
+        start_fn_power_states[i] = fixed_fns.empty() ? fn_power_states[i] : (fixed_fns.count(i) > 0);
+
+        if (!start_fn_power_states[i] || i >= fn_vm_allocations.size())
+        {
+            continue;
+        }
+
+        for (auto const& svc_vms : fn_vm_allocations[i])
+        {
+            auto const svc = svc_vms.first;
+            auto const vm_cat = svc_vms.second.first;
+
+            if (svc >= svc_categories.size())
+            {
+                continue;
+            }
+
+            if (svc_num_left_vms.count(svc) == 0)
+            {
+                // NOTE: all VMs allocated to the same service belong to the same category
+                svc_num_left_vms[svc] = svc_cat_vm_cat_min_num_vms[svc_categories[svc]][vm_cat];
+            }
+
+            auto const nvms = std::min(svc_vms.second.second, svc_num_left_vms[svc]);
+            if (nvms > 0)
+            {
+                start_fn_vm_allocations[i][svc] = std::make_pair(vm_cat, nvms);
+                svc_num_left_vms[svc] -= nvms;
+            }
+        }
+    }
+}
+
+/**
+ * \brief Lets the solve calls run by a thread be interrupted from another
+ *  thread.
+ *
+ * Solvers that can stop their search early register the function that
+ * aborts it (e.g., by means of \c IloCplex::Aborter) for as long as the
+ * search runs (see \c solve_interrupt_guard_t).
+ * Since solver objects are shared by threads (e.g., by the simulation
+ * replicas), the interrupter is bound to the thread running the solve call
+ * rather than to the solver (see \c solve_interrupter_scope_t).
+ * Once interrupted, an interrupter stays so: the searches started later on
+ * the same thread are aborted as soon as they are registered.
+ */
+class solve_interrupter_t
+{
+public:
+    solve_interrupter_t()
+    : interrupted_(false),
+      next_id_(0)
+    {
+    }
+
+    /// Aborts the searches that are running and the ones that will be started
+    void interrupt()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        interrupted_ = true;
+        for (auto const& id_abort : aborts_)
+        {
+            id_abort.second();
+        }
+    }
+
+    bool interrupted() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        return interrupted_;
+    }
+
+    /// Registers the function that aborts a running search and returns its identifier
+    std::size_t attach(const std::function<void()>& abort)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        if (interrupted_)
+        {
+            abort();
+        }
+        aborts_[next_id_] = abort;
+
+        return next_id_++;
+    }
+
+    /// Unregisters the function with the given identifier (once this returns, the function is no longer called)
+    void detach(std::size_t id)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        aborts_.erase(id);
+    }
+
+    /// Returns the interrupter of the calling thread (null if its solve calls cannot be interrupted)
+    static solve_interrupter_t*& current()
+    {
+        static thread_local solve_interrupter_t* p_interrupter = nullptr;
+
+        return p_interrupter;
+    }
+
+
+private:
+    mutable std::mutex mtx_;
+    bool interrupted_;
+    std::size_t next_id_;
+    std::map<std::size_t,std::function<void()>> aborts_; ///< The functions that abort the running searches, by identifier
+}; // solve_interrupter_t
+
+
+/// Makes the given interrupter the one of the calling thread for the lifetime of this object
+class solve_interrupter_scope_t
+{
+public:
+    explicit solve_interrupter_scope_t(solve_interrupter_t* p_interrupter)
+    : p_old_interrupter_(solve_interrupter_t::current())
+    {
+        solve_interrupter_t::current() = p_interrupter;
+    }
+
+    solve_interrupter_scope_t(const solve_interrupter_scope_t&) = delete;
+
+    solve_interrupter_scope_t& operator=(const solve_interrupter_scope_t&) = delete;
+
+    ~solve_interrupter_scope_t()
+    {
+        solve_interrupter_t::current() = p_old_interrupter_;
+    }
+
+
+private:
+    solve_interrupter_t* p_old_interrupter_;
+}; // solve_interrupter_scope_t
+
+
+/**
+ * \brief Registers the function that aborts a search with the interrupter of
+ *  the calling thread, if any, for the lifetime of this object.
+ *
+ * The guard must be destroyed before the objects used by the function (e.g.,
+ * the solver) are.
+ */
+class solve_interrupt_guard_t
+{
+public:
+    explicit solve_interrupt_guard_t(const std::function<void()>& abort)
+    : p_interrupter_(solve_interrupter_t::current()),
+      id_(0)
+    {
+        if (p_interrupter_)
+        {
+            id_ = p_interrupter_->attach(abort);
+        }
+    }
+
+    solve_interrupt_guard_t(const solve_interrupt_guard_t&) = delete;
+
+    solve_interrupt_guard_t& operator=(const solve_interrupt_guard_t&) = delete;
+
+    ~solve_interrupt_guard_t()
+    {
+        if (p_interrupter_)
+        {
+            p_interrupter_->detach(id_);
+        }
+    }
+
+
+private:
+    solve_interrupter_t* p_interrupter_;
+    std::size_t id_;
+}; // solve_interrupt_guard_t
+
+
+/// Tells whether the solve calls of the calling thread have been interrupted
+inline bool solve_interrupted()
+{
+    auto const p_interrupter = solve_interrupter_t::current();
+
+    return p_interrupter && p_interrupter->interrupted();
+}
+
+
+/**
+ * \brief Sets the deadline of the solve calls of the calling thread for the
+ *  lifetime of this object.
+ *
+ * Like the interrupter, the deadline is bound to the thread rather than to
+ * the solver, so that callers (e.g., the portfolio solver) can give a solver
+ * the time left to them without changing its options.
+ * An earlier deadline set by an enclosing scope is kept.
+ */
+class solve_deadline_scope_t
+{
+public:
+    typedef std::chrono::steady_clock::time_point time_point;
+
+
+    explicit solve_deadline_scope_t(time_point deadline)
+    : old_deadline_(current())
+    {
+        current() = std::min(old_deadline_, deadline);
+    }
+
+    solve_deadline_scope_t(const solve_deadline_scope_t&) = delete;
+
+    solve_deadline_scope_t& operator=(const solve_deadline_scope_t&) = delete;
+
+    ~solve_deadline_scope_t()
+    {
+        current() = old_deadline_;
+    }
+
+    /// Returns the deadline of the calling thread (\c time_point::max() if there is none)
+    static time_point& current()
+    {
+        static thread_local time_point deadline = time_point::max();
+
+        return deadline;
+    }
+
+
+private:
+    time_point old_deadline_;
+}; // solve_deadline_scope_t
+
+
+/**
+ * \brief Returns the time limit (in seconds) of a search that starts now,
+ *  that is \a time_limit capped by the time left before the deadline of the
+ *  calling thread, if any.
+ *
+ * A non-positive value means no limit. Solvers should call this right before
+ * the search starts, so that the time spent to build the model is accounted
+ * for.
+ */
+template <typename RealT>
+RealT solve_time_limit(RealT time_limit)
+{
+    // The limit given when the deadline has expired, since some solvers take a zero limit as no limit
+    constexpr RealT min_time_limit = 1e-3;
+
+    auto const deadline = solve_deadline_scope_t::current();
+
+    if (deadline == solve_deadline_scope_t::time_point::max())
+    {
+        return time_limit;
+    }
+
+    auto const time_left = std::max(std::chrono::duration_cast<std::chrono::duration<RealT>>(deadline-std::chrono::steady_clock::now()).count(),
+                                    min_time_limit);
+
+    return (time_limit > 0) ? std::min(time_limit, time_left) : time_left;
+}
+
+} // Namespace detail
+
+
 template <typename RealT>
 bool check_vm_allocation_solution(const vm_allocation_t<RealT>& vm_alloc)
 {
@@ -0,0 +1,1298 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fog/vm_allocation/greedy_solver.hpp
+ *
+ * \brief Solvers for the VM allocation problem based on first-fit decreasing
+ *  packing and local search.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FOG_VM_ALLOCATION_GREEDY_SOLVER_HPP
+#define DCS_FOG_VM_ALLOCATION_GREEDY_SOLVER_HPP
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/fog/io.hpp>
+#include <dcs/fog/vm_allocation/commons.hpp>
+#include <dcs/math/traits/float.hpp>
+#include <limits>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+namespace dcs { namespace fog {
+
+namespace detail {
+
+/**
+ * \brief Incremental packing of VMs into FNs.
+ *
+ * Keeps track of the VMs allocated on each FN, of the CPU share they use and
+ * of the power state of FNs, and gives the change in cost (as accounted by
+ * \c eval_vm_allocation) caused by each elementary move, so that moves can be
+ * evaluated and undone in constant time.
+ *
+ * The cost of powering on a FN is the idle power consumption plus either the
+ * switch-on cost (if the FN is currently powered off) or minus the switch-off
+ * cost (if the FN is currently powered on).
+ * FNs whose cost is not positive, as well as the FNs in \a fixed_fns, are
+ * never powered off.
+ */
+template <typename RealT>
+class vm_packing_t
+{
+public:
+    typedef std::map<std::size_t,std::pair<std::size_t,std::size_t>> svc_vm_allocation_container;
+
+
+    vm_packing_t(const std::set<std::size_t>& fixed_fns, // The set of selected FNs to use for the VM allocation (if empty, any FN can be used)
+                 const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                 const std::vector<bool>& fn_power_states, // The power status of each FN
+                 const std::vector<svc_vm_allocation_container>& fn_vm_allocations, // Current VM allocations, by FN and service
+                 const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                 const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                 const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                 const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN, by VM category
+                 const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                 const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                 const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                 RealT deltat) // Length of the time interval
+    : fn_categories_(fn_categories),
+      fn_vm_allocations_(fn_vm_allocations),
+      vm_cat_fn_cat_cpu_specs_(vm_cat_fn_cat_cpu_specs),
+      vm_cat_alloc_costs_(vm_cat_alloc_costs),
+      allowed_(fn_categories.size(), false),
+      keep_on_(fn_categories.size(), false),
+      on_(fn_categories.size(), false),
+      loads_(fn_categories.size(), 0),
+      open_costs_(fn_categories.size(), 0),
+      share_costs_(fn_categories.size(), 0),
+      allocs_(fn_categories.size())
+    {
+        const std::size_t nfns = fn_categories.size();
+
+        DCS_ASSERT( nfns == fn_power_states.size(),
+                    DCS_EXCEPTION_THROW( std::logic_error,
+                                         "FN power states container has a wrong size" ) );
+
+        DCS_ASSERT( nfns == fn_vm_allocations.size(),
+                    DCS_EXCEPTION_THROW( std::logic_error,
+                                         "FN VM allocations container has a wrong size" ) );
+
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            auto const fn_cat = fn_categories[i];
+
+            allowed_[i] = fixed_fns.empty() || fixed_fns.count(i) > 0;
+            share_costs_[i] = (fn_cat_max_powers[fn_cat]-fn_cat_min_powers[fn_cat])*fp_electricity_cost*deltat;
+            open_costs_[i] = fn_cat_min_powers[fn_cat]*fp_electricity_cost*deltat
+                           + (fn_power_states[i] ? -fp_fn_cat_asleep_costs[fn_cat] : fp_fn_cat_awake_costs[fn_cat]);
+            keep_on_[i] = allowed_[i] && (!fixed_fns.empty() || !math::float_traits<RealT>::definitely_greater(open_costs_[i], 0));
+            on_[i] = keep_on_[i];
+            if (allowed_[i])
+            {
+                order_.push_back(i);
+            }
+        }
+
+        // Cheapest FNs come first: FNs that are powered on for free, ordered by
+        // the cost of their CPU share, and then FNs ordered by their power-on
+        // cost
+        std::stable_sort(order_.begin(),
+                         order_.end(),
+                         [this](std::size_t a, std::size_t b)
+                         {
+                            auto const open_a = on_[a] ? 0 : open_costs_[a];
+                            auto const open_b = on_[b] ? 0 : open_costs_[b];
+                            return std::make_tuple(open_a, share_costs_[a]) < std::make_tuple(open_b, share_costs_[b]);
+                         });
+    }
+
+    std::size_t num_fns() const
+    {
+        return fn_categories_.size();
+    }
+
+    std::size_t num_vm_categories() const
+    {
+        return vm_cat_fn_cat_cpu_specs_.size();
+    }
+
+    std::size_t fn_category(std::size_t i) const
+    {
+        return fn_categories_[i];
+    }
+
+    const std::vector<std::size_t>& fn_order() const
+    {
+        return order_;
+    }
+
+    bool allowed(std::size_t i) const
+    {
+        return allowed_[i];
+    }
+
+    bool keep_on(std::size_t i) const
+    {
+        return keep_on_[i];
+    }
+
+    bool on(std::size_t i) const
+    {
+        return on_[i];
+    }
+
+    RealT load(std::size_t i) const
+    {
+        return loads_[i];
+    }
+
+    RealT open_cost(std::size_t i) const
+    {
+        return open_costs_[i];
+    }
+
+    const svc_vm_allocation_container& allocations(std::size_t i) const
+    {
+        return allocs_[i];
+    }
+
+    /// Gets the CPU share taken by a class-k VM on FN i.
+    RealT cpu_share(std::size_t i, std::size_t k) const
+    {
+        return vm_cat_fn_cat_cpu_specs_[k][fn_categories_[i]];
+    }
+
+    /// Gets the energy cost of a class-k VM on FN i (idle power excluded).
+    RealT energy_cost(std::size_t i, std::size_t k) const
+    {
+        return cpu_share(i, k)*share_costs_[i];
+    }
+
+    /// Gets the number of class-k VMs of service j currently allocated on FN i.
+    std::size_t old_num_vms(std::size_t i, std::size_t j, std::size_t k) const
+    {
+        auto const it = fn_vm_allocations_[i].find(j);
+        return (it != fn_vm_allocations_[i].end() && it->second.first == k) ? it->second.second : 0;
+    }
+
+    /// Gets the number of VMs of service j allocated on FN i.
+    std::size_t num_vms(std::size_t i, std::size_t j) const
+    {
+        auto const it = allocs_[i].find(j);
+        return (it != allocs_[i].end()) ? it->second.second : 0;
+    }
+
+    /// Tells if a further class-k VM fits into FN i.
+    bool fits(std::size_t i, std::size_t k) const
+    {
+        // Capacity is checked exactly so that the CPU share never exceeds 1
+        return allowed_[i] && loads_[i]+cpu_share(i, k) <= 1;
+    }
+
+    /// Gets the change in cost caused by allocating a further class-k VM for service j on FN i.
+    RealT add_cost(std::size_t i, std::size_t j, std::size_t k) const
+    {
+        RealT cost = energy_cost(i, k);
+        if (num_vms(i, j) >= old_num_vms(i, j, k))
+        {
+            cost += vm_cat_alloc_costs_[k];
+        }
+        if (!on_[i])
+        {
+            cost += open_costs_[i];
+        }
+        return cost;
+    }
+
+    /// Allocates a further class-k VM for service j on FN i (powering it on if needed) and returns the change in cost.
+    RealT add(std::size_t i, std::size_t j, std::size_t k)
+    {
+        // pre: VMs of a service allocated on the same FN belong to the same class
+        DCS_ASSERT( allocs_[i].count(j) == 0 || allocs_[i].at(j).first == k,
+                    DCS_EXCEPTION_THROW( std::logic_error,
+                                         "VMs of the same service must belong to the same class" ) );
+
+        auto const cost = add_cost(i, j, k);
+
+        auto& vms = allocs_[i][j];
+        vms.first = k;
+        vms.second += 1;
+        loads_[i] += cpu_share(i, k);
+        on_[i] = true;
+
+        return cost;
+    }
+
+    /// Gets the change in cost caused by deallocating a VM of service j from FN i.
+    RealT remove_cost(std::size_t i, std::size_t j) const
+    {
+        auto const& vms = allocs_[i].at(j);
+        RealT cost = -energy_cost(i, vms.first);
+        if (vms.second > old_num_vms(i, j, vms.first))
+        {
+            cost -= vm_cat_alloc_costs_[vms.first];
+        }
+        return cost;
+    }
+
+    /// Deallocates a VM of service j from FN i (leaving the FN powered on) and returns the change in cost.
+    RealT remove(std::size_t i, std::size_t j)
+    {
+        auto const cost = remove_cost(i, j);
+
+        auto it = allocs_[i].find(j);
+        loads_[i] -= cpu_share(i, it->second.first);
+        if (--(it->second.second) == 0)
+        {
+            allocs_[i].erase(it);
+        }
+        if (allocs_[i].empty())
+        {
+            // Avoid round-off drifts
+            loads_[i] = 0;
+        }
+
+        return cost;
+    }
+
+    /// Powers off FN i if it hosts no VM and can be powered off, and returns the change in cost.
+    RealT close(std::size_t i)
+    {
+        if (!on_[i] || keep_on_[i] || !allocs_[i].empty())
+        {
+            return 0;
+        }
+
+        on_[i] = false;
+
+        return -open_costs_[i];
+    }
+
+    /// Fills the FN part of the given VM allocation.
+    void export_to(vm_allocation_t<RealT>& solution) const
+    {
+        const std::size_t nfns = fn_categories_.size();
+
+        solution.fn_vm_allocations = allocs_;
+        solution.fn_power_states.assign(nfns, false);
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            solution.fn_power_states[i] = on_[i];
+        }
+        solution.fn_cpu_allocations = loads_;
+    }
+
+
+private:
+    const std::vector<std::size_t>& fn_categories_;
+    const std::vector<svc_vm_allocation_container>& fn_vm_allocations_;
+    const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs_;
+    const std::vector<RealT>& vm_cat_alloc_costs_;
+    std::vector<bool> allowed_; ///< Tells whether a FN can be used
+    std::vector<bool> keep_on_; ///< Tells whether a FN must stay powered on
+    std::vector<bool> on_; ///< The power state of FNs
+    std::vector<RealT> loads_; ///< The CPU share used on FNs
+    std::vector<RealT> open_costs_; ///< The cost to keep FNs powered on
+    std::vector<RealT> share_costs_; ///< The energy cost of the whole CPU of FNs
+    std::vector<svc_vm_allocation_container> allocs_; ///< The VM allocations, by FN and service
+    std::vector<std::size_t> order_; ///< The usable FNs, from the cheapest to the most expensive one
+}; // vm_packing_t
+
+
+/**
+ * \brief Allocates the VMs of services by first-fit decreasing.
+ *
+ * Every service gets either all the VMs of a class it requires or nothing,
+ * since a partial allocation is charged the same penalty as no allocation.
+ * Services are taken by decreasing CPU share and, for each of them, VM
+ * classes are tried by increasing CPU share: each VM is first put back on the
+ * FNs where the service already runs VMs of the same class (so as to avoid
+ * reallocation costs), and then on the first FN (from the cheapest one) with
+ * enough spare capacity.
+ * The first class whose allocation increases the profit is kept.
+ */
+template <typename RealT>
+void pack_vm_allocation(const std::vector<std::size_t>& svc_categories, // Service categories by service
+                        const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                        const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service category
+                        const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service category
+                        RealT deltat, // Length of the time interval
+                        const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                        vm_packing_t<RealT>& packing)
+{
+    const std::size_t nfns = packing.num_fns();
+    const std::size_t nsvcs = svc_categories.size();
+    auto const& order = packing.fn_order();
+
+    // FNs that currently host VMs, by service
+    std::vector<std::vector<std::size_t>> svc_old_fns(nsvcs);
+    for (std::size_t i = 0; i < nfns; ++i)
+    {
+        for (auto const& svc_vms : fn_vm_allocations[i])
+        {
+            if (svc_vms.first < nsvcs && packing.allowed(i))
+            {
+                svc_old_fns[svc_vms.first].push_back(i);
+            }
+        }
+    }
+
+    // The min CPU share of VMs by VM category and overall, used to skip the FNs that are full
+    std::vector<RealT> vm_cat_min_shares(packing.num_vm_categories(), std::numeric_limits<RealT>::infinity());
+    for (auto const i : order)
+    {
+        for (std::size_t k = 0; k < vm_cat_min_shares.size(); ++k)
+        {
+            vm_cat_min_shares[k] = std::min(vm_cat_min_shares[k], packing.cpu_share(i, k));
+        }
+    }
+    const RealT min_share = vm_cat_min_shares.empty() ? 0 : *std::min_element(vm_cat_min_shares.begin(), vm_cat_min_shares.end());
+
+    // Rank services and VM classes by CPU share
+    std::vector<std::pair<RealT,std::size_t>> svc_ranks; // <CPU share, service> pair for each service
+    std::vector<std::vector<std::pair<RealT,std::size_t>>> svc_vm_cats(nsvcs); // <CPU share, VM category> pair for each candidate VM category, by service
+    for (std::size_t j = 0; j < nsvcs; ++j)
+    {
+        auto const& min_num_vms = svc_cat_vm_cat_min_num_vms[svc_categories[j]];
+
+        for (std::size_t k = 0; k < min_num_vms.size(); ++k)
+        {
+            if (min_num_vms[k] == 0)
+            {
+                continue;
+            }
+
+            if (k >= vm_cat_min_shares.size() || vm_cat_min_shares[k] > 1)
+            {
+                continue;
+            }
+            svc_vm_cats[j].push_back(std::make_pair(min_num_vms[k]*vm_cat_min_shares[k], k));
+        }
+        if (svc_vm_cats[j].empty())
+        {
+            continue;
+        }
+        std::stable_sort(svc_vm_cats[j].begin(), svc_vm_cats[j].end());
+        svc_ranks.push_back(std::make_pair(svc_vm_cats[j].front().first, j));
+    }
+    std::stable_sort(svc_ranks.begin(),
+                     svc_ranks.end(),
+                     [](const std::pair<RealT,std::size_t>& a, const std::pair<RealT,std::size_t>& b)
+                     {
+                        return a.first > b.first;
+                     });
+
+    std::size_t first_free = 0; // Position in the FN order of the first FN that is not full
+    std::vector<std::size_t> placed_fns;
+    std::vector<std::size_t> opened_fns;
+    for (auto const& svc_rank : svc_ranks)
+    {
+        auto const j = svc_rank.second;
+        auto const svc_cat = svc_categories[j];
+        auto const& min_num_vms = svc_cat_vm_cat_min_num_vms[svc_cat];
+        const bool with_penalty = std::find(min_num_vms.begin(), min_num_vms.end(), 0) == min_num_vms.end();
+
+        for (auto const& vm_cat_share : svc_vm_cats[j])
+        {
+            auto const k = vm_cat_share.second;
+            auto const nvms = min_num_vms[k];
+
+            RealT cost = 0;
+            placed_fns.clear();
+            opened_fns.clear();
+
+            // Keep VMs in place first
+            for (auto const i : svc_old_fns[j])
+            {
+                for (std::size_t n = packing.old_num_vms(i, j, k); n > 0 && placed_fns.size() < nvms && packing.fits(i, k); --n)
+                {
+                    if (!packing.on(i))
+                    {
+                        opened_fns.push_back(i);
+                    }
+                    cost += packing.add(i, j, k);
+                    placed_fns.push_back(i);
+                }
+            }
+
+            // Then go first-fit
+            while (first_free < order.size() && math::float_traits<RealT>::definitely_greater(packing.load(order[first_free])+min_share, 1))
+            {
+                ++first_free;
+            }
+            for (std::size_t p = first_free; p < order.size() && placed_fns.size() < nvms; ++p)
+            {
+                auto const i = order[p];
+
+                while (placed_fns.size() < nvms && packing.fits(i, k))
+                {
+                    if (!packing.on(i))
+                    {
+                        opened_fns.push_back(i);
+                    }
+                    cost += packing.add(i, j, k);
+                    placed_fns.push_back(i);
+                }
+            }
+
+            auto const gain = (fp_svc_cat_revenues[svc_cat]*nvms + (with_penalty ? fp_svc_cat_penalties[svc_cat] : 0))*deltat - cost;
+            if (placed_fns.size() == nvms && math::float_traits<RealT>::definitely_greater(gain, 0))
+            {
+                break;
+            }
+
+            // Undo
+            for (auto it = placed_fns.rbegin(); it != placed_fns.rend(); ++it)
+            {
+                packing.remove(*it, j);
+            }
+            for (auto const i : opened_fns)
+            {
+                packing.close(i);
+            }
+            first_free = 0;
+        }
+    }
+}
+
+/**
+ * \brief Moves the VMs of FN \a from to other FNs and powers it off.
+ *
+ * If \a to is a valid FN, all the VMs are moved there (which is powered on if
+ * needed); otherwise, they are moved by first-fit to the powered-on FNs in
+ * \a to_fns.
+ * The move is undone unless it succeeds and it decreases the cost.
+ *
+ * \return \c true if the move has been made.
+ */
+template <typename RealT>
+bool evacuate_fn(std::size_t from, std::size_t to, const std::vector<std::size_t>& to_fns, vm_packing_t<RealT>& packing)
+{
+    const bool to_was_on = to < packing.num_fns() && packing.on(to);
+
+    RealT cost = 0;
+    std::vector<std::tuple<std::size_t,std::size_t,std::size_t>> moves; // <service, VM category, target FN> triple for each moved VM
+    bool ok = true;
+
+    auto const svc_vm_allocs = packing.allocations(from);
+    for (auto const& svc_vms : svc_vm_allocs)
+    {
+        auto const j = svc_vms.first;
+        auto const k = svc_vms.second.first;
+
+        std::size_t p = 0; // Position in to_fns of the first FN where the VM may fit
+        for (std::size_t n = 0; n < svc_vms.second.second && ok; ++n)
+        {
+            std::size_t i = to;
+            if (i >= packing.num_fns())
+            {
+                while (p < to_fns.size() && (to_fns[p] == from || !packing.on(to_fns[p]) || !packing.fits(to_fns[p], k)))
+                {
+                    ++p;
+                }
+                i = (p < to_fns.size()) ? to_fns[p] : packing.num_fns();
+            }
+            if (i >= packing.num_fns() || !packing.fits(i, k))
+            {
+                ok = false;
+                break;
+            }
+            cost += packing.remove(from, j);
+            cost += packing.add(i, j, k);
+            moves.push_back(std::make_tuple(j, k, i));
+        }
+    }
+    if (ok)
+    {
+        cost += packing.close(from);
+    }
+
+    if (ok && math::float_traits<RealT>::definitely_less(cost, 0))
+    {
+        return true;
+    }
+
+    // Undo
+    for (auto it = moves.rbegin(); it != moves.rend(); ++it)
+    {
+        packing.remove(std::get<2>(*it), std::get<0>(*it));
+        packing.add(from, std::get<0>(*it), std::get<1>(*it));
+    }
+    if (to < packing.num_fns() && !to_was_on)
+    {
+        packing.close(to);
+    }
+
+    return false;
+}
+
+/**
+ * \brief Improves the given VM allocation by local search.
+ *
+ * Each pass applies, by first improvement, the following moves:
+ * - \e move: the VMs of a powered-on FN are moved to the other powered-on
+ *   FNs so that the FN can be powered off (FNs are taken from the least
+ *   loaded one);
+ * - \e swap: a powered-on FN is swapped with a powered-off one, by moving all
+ *   its VMs there (only one powered-off FN is tried for each FN category and
+ *   power-on cost, since the others are equivalent);
+ * - \e relocate: a single VM is moved to another powered-on FN where it costs
+ *   less (that is, either a FN where the service already ran VMs of that class
+ *   or the first FN with enough spare capacity of each FN category that
+ *   consumes less energy for that class).
+ * .
+ * Passes are repeated until no move improves the profit or the given number
+ * of passes is reached.
+ */
+template <typename RealT>
+void improve_vm_allocation(std::size_t max_num_passes,
+                           const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                           vm_packing_t<RealT>& packing)
+{
+    const std::size_t nfns = packing.num_fns();
+    auto const& order = packing.fn_order();
+
+    // FNs that currently host VMs, by service
+    std::map<std::size_t,std::vector<std::size_t>> svc_old_fns;
+    for (std::size_t i = 0; i < nfns; ++i)
+    {
+        for (auto const& svc_vms : fn_vm_allocations[i])
+        {
+            if (packing.allowed(i))
+            {
+                svc_old_fns[svc_vms.first].push_back(i);
+            }
+        }
+    }
+
+    bool improved = true;
+    for (std::size_t pass = 0; pass < max_num_passes && improved; ++pass)
+    {
+        improved = false;
+
+        // The powered-on FNs (from the cheapest one), the ones that can be
+        // powered off (from the least loaded one) and the powered-on FNs by
+        // FN category
+        std::vector<std::size_t> on_fns;
+        std::vector<std::size_t> off_cand_fns;
+        std::map<std::size_t,std::vector<std::size_t>> fn_cat_on_fns;
+        for (auto const i : order)
+        {
+            if (packing.on(i))
+            {
+                on_fns.push_back(i);
+                fn_cat_on_fns[packing.fn_category(i)].push_back(i);
+                if (!packing.keep_on(i))
+                {
+                    off_cand_fns.push_back(i);
+                }
+            }
+        }
+        std::stable_sort(off_cand_fns.begin(),
+                         off_cand_fns.end(),
+                         [&packing](std::size_t a, std::size_t b)
+                         {
+                            return packing.load(a) < packing.load(b);
+                         });
+
+        // Move
+        for (auto const i : off_cand_fns)
+        {
+            if (packing.on(i) && evacuate_fn(i, nfns, on_fns, packing))
+            {
+                improved = true;
+            }
+        }
+
+        // Swap
+        std::map<std::pair<std::size_t,RealT>,std::size_t> key_swap_fns; // The first powered-off FN, by <FN category, power-on cost> pair
+        for (auto const i : order)
+        {
+            if (!packing.on(i))
+            {
+                key_swap_fns.insert(std::make_pair(std::make_pair(packing.fn_category(i), packing.open_cost(i)), i));
+            }
+        }
+        for (auto const i : off_cand_fns)
+        {
+            if (!packing.on(i))
+            {
+                continue;
+            }
+
+            for (auto& key_fn : key_swap_fns)
+            {
+                auto const i2 = key_fn.second;
+
+                if (i2 >= nfns || !evacuate_fn(i, i2, on_fns, packing))
+                {
+                    continue;
+                }
+
+                improved = true;
+
+                // Replace the swapped FN with the next equivalent one
+                key_fn.second = nfns;
+                for (auto const i3 : order)
+                {
+                    if (!packing.on(i3) && packing.fn_category(i3) == key_fn.first.first && packing.open_cost(i3) == key_fn.first.second)
+                    {
+                        key_fn.second = i3;
+                        break;
+                    }
+                }
+                break;
+            }
+        }
+
+        // Relocate
+        for (auto const i : on_fns)
+        {
+            if (!packing.on(i))
+            {
+                continue;
+            }
+
+            auto const svc_vm_allocs = packing.allocations(i);
+            for (auto const& svc_vms : svc_vm_allocs)
+            {
+                auto const j = svc_vms.first;
+                auto const k = svc_vms.second.first;
+
+                bool moved = true;
+                for (std::size_t n = 0; n < svc_vms.second.second && moved; ++n)
+                {
+                    // Candidate FNs: the ones where the service already ran and the first one with enough capacity of each cheaper category
+                    std::vector<std::size_t> cand_fns;
+                    if (svc_old_fns.count(j) > 0)
+                    {
+                        cand_fns = svc_old_fns.at(j);
+                    }
+                    for (auto const& fn_cat_fns : fn_cat_on_fns)
+                    {
+                        auto const& cat_fns = fn_cat_fns.second;
+
+                        if (!math::float_traits<RealT>::definitely_less(packing.energy_cost(cat_fns.front(), k), packing.energy_cost(i, k)))
+                        {
+                            continue;
+                        }
+                        auto const it = std::find_if(cat_fns.begin(),
+                                                     cat_fns.end(),
+                                                     [&packing,k](std::size_t fn)
+                                                     {
+                                                        return packing.on(fn) && packing.fits(fn, k);
+                                                     });
+                        if (it != cat_fns.end())
+                        {
+                            cand_fns.push_back(*it);
+                        }
+                    }
+
+                    moved = false;
+                    for (auto const i2 : cand_fns)
+                    {
+                        if (i2 == i
+                            || !packing.on(i2)
+                            || !packing.fits(i2, k)
+                            || (packing.num_vms(i2, j) > 0 && packing.allocations(i2).at(j).first != k))
+                        {
+                            continue;
+                        }
+
+                        auto const cost = packing.remove_cost(i, j)+packing.add_cost(i2, j, k);
+                        if (math::float_traits<RealT>::definitely_less(cost, 0))
+                        {
+                            packing.remove(i, j);
+                            packing.add(i2, j, k);
+                            moved = improved = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Power off the FNs left empty by relocations
+    for (auto const i : order)
+    {
+        packing.close(i);
+    }
+}
+
+/**
+ * \brief Solves the VM allocation problem by first-fit decreasing packing
+ *  followed by local search.
+ */
+template <typename RealT>
+vm_allocation_t<RealT> solve_greedy_vm_allocation(std::size_t max_num_passes, // Max number of local search passes
+                                                  const std::set<std::size_t>& fixed_fns, // The set of selected FNs to use for the VM allocation (if empty, any FN can be used)
+                                                  const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                  const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                  const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                  const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                  const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                  const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                  const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                  const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                  const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                                  const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service category
+                                                  const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service category
+                                                  const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                  const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                  const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                  RealT deltat) // Length of the time interval
+{
+    auto const start_time = std::chrono::steady_clock::now();
+
+    vm_allocation_t<RealT> solution;
+
+    vm_packing_t<RealT> packing(fixed_fns,
+                                fn_categories,
+                                fn_power_states,
+                                fn_vm_allocations,
+                                fn_cat_min_powers,
+                                fn_cat_max_powers,
+                                vm_cat_fn_cat_cpu_specs,
+                                vm_cat_alloc_costs,
+                                fp_electricity_cost,
+                                fp_fn_cat_asleep_costs,
+                                fp_fn_cat_awake_costs,
+                                deltat);
+
+    if (!svc_categories.empty() && !svc_cat_vm_cat_min_num_vms.empty())
+    {
+        pack_vm_allocation(svc_categories,
+                           svc_cat_vm_cat_min_num_vms,
+                           fp_svc_cat_revenues,
+                           fp_svc_cat_penalties,
+                           deltat,
+                           fn_vm_allocations,
+                           packing);
+
+        improve_vm_allocation(max_num_passes,
+                              fn_vm_allocations,
+                              packing);
+    }
+
+    packing.export_to(solution);
+
+    eval_vm_allocation(fn_categories,
+                       fn_power_states,
+                       fn_vm_allocations,
+                       fn_cat_min_powers,
+                       fn_cat_max_powers,
+                       vm_cat_alloc_costs,
+                       svc_categories,
+                       svc_cat_vm_cat_min_num_vms,
+                       fp_svc_cat_revenues,
+                       fp_svc_cat_penalties,
+                       fp_electricity_cost,
+                       fp_fn_cat_asleep_costs,
+                       fp_fn_cat_awake_costs,
+                       deltat,
+                       solution);
+
+    solution.solved = true;
+    solution.optimal = false;
+    solution.solve_time = std::chrono::duration_cast<std::chrono::duration<RealT>>(std::chrono::steady_clock::now()-start_time).count();
+    solution.first_incumbent_time = solution.solve_time;
+
+    return solution;
+}
+
+/**
+ * \brief Plans the power state of FNs over the given time slots, taking into
+ *  account the costs to power them on and off.
+ *
+ * For each FN category, the number of FNs that must be powered on in each
+ * time slot (e.g., the ones used by a per-slot VM allocation) is seen as a
+ * stack of FN units, where the k-th unit is needed in the slots that require
+ * at least k FNs and is not allowed in the slots that allow less than k FNs.
+ * Units are independent of each other, so that each one is kept powered on
+ * during the gaps between the slots where it is needed if its idle cost over
+ * the gap doesn't exceed the cost of powering it off and on again (or, after
+ * the last needed slot, the cost of powering it off).
+ * Actual FNs are then assigned to units slot by slot, preferring the FNs that
+ * are already powered on.
+ *
+ * The running time is linear in the number of time slots (and in the number
+ * of FNs).
+ */
+template <typename RealT>
+std::vector<std::vector<bool>> plan_fn_power_states(const std::vector<std::set<std::size_t>>& fixed_fns, // For each time slot, the set of selected FNs to use for the VM allocation (if in a given time slot the set is empty, any FN can be used)
+                                                    const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                    const std::vector<bool>& fn_power_states, // The power status of each FN before the first time slot
+                                                    const std::vector<std::vector<bool>>& slot_fn_power_states, // The power state of each FN needed in each time slot, by time slot
+                                                    const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                    const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                    const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                    const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                    RealT deltat) // Length of the time interval
+{
+    const std::size_t nslots = slot_fn_power_states.size();
+    const std::size_t nfns = fn_categories.size();
+    const std::size_t nfncats = fn_cat_min_powers.size();
+
+    // Count the needed, the allowed and the initially powered-on FNs, by FN category
+    std::vector<std::size_t> fn_cat_num_fns(nfncats, 0);
+    std::vector<std::size_t> fn_cat_num_on_fns(nfncats, 0);
+    std::vector<std::vector<std::size_t>> slot_fn_cat_num_needed(nslots, std::vector<std::size_t>(nfncats, 0));
+    std::vector<std::vector<std::size_t>> slot_fn_cat_num_allowed(nslots, std::vector<std::size_t>(nfncats, 0));
+    for (std::size_t fn = 0; fn < nfns; ++fn)
+    {
+        auto const fn_cat = fn_categories[fn];
+
+        fn_cat_num_fns[fn_cat] += 1;
+        fn_cat_num_on_fns[fn_cat] += fn_power_states[fn] ? 1 : 0;
+        for (std::size_t t = 0; t < nslots; ++t)
+        {
+            slot_fn_cat_num_needed[t][fn_cat] += slot_fn_power_states[t][fn] ? 1 : 0;
+            slot_fn_cat_num_allowed[t][fn_cat] += (fixed_fns.empty() || fixed_fns[t].empty() || fixed_fns[t].count(fn) > 0) ? 1 : 0;
+        }
+    }
+
+    // Decide the number of powered-on FNs, by time slot and FN category
+    std::vector<std::vector<std::size_t>> slot_fn_cat_num_on(nslots, std::vector<std::size_t>(nfncats, 0));
+    for (std::size_t fn_cat = 0; fn_cat < nfncats; ++fn_cat)
+    {
+        auto const idle_cost = fn_cat_min_powers[fn_cat]*fp_electricity_cost*deltat;
+        auto const cycle_cost = fp_fn_cat_asleep_costs[fn_cat]+fp_fn_cat_awake_costs[fn_cat];
+
+        for (std::size_t k = 0; k < fn_cat_num_fns[fn_cat]; ++k)
+        {
+            bool on = k < fn_cat_num_on_fns[fn_cat];
+            std::size_t gap_start = 0;
+            for (std::size_t t = 0; t <= nslots; ++t)
+            {
+                const bool last = (t == nslots);
+                const bool needed = !last && k < slot_fn_cat_num_needed[t][fn_cat];
+                const bool allowed = !last && k < slot_fn_cat_num_allowed[t][fn_cat];
+
+                if (!last && !needed && allowed)
+                {
+                    // The unit is free in this slot: decide at the end of the gap
+                    continue;
+                }
+
+                // Keep the unit on across the gap if powering it off doesn't pay off
+                if (on && t > gap_start && (needed || last))
+                {
+                    auto const gap_cost = (t-gap_start)*idle_cost;
+                    if (gap_cost <= (last ? fp_fn_cat_asleep_costs[fn_cat] : cycle_cost))
+                    {
+                        for (std::size_t tt = gap_start; tt < t; ++tt)
+                        {
+                            slot_fn_cat_num_on[tt][fn_cat] += 1;
+                        }
+                    }
+                }
+                if (!last)
+                {
+                    on = needed;
+                    slot_fn_cat_num_on[t][fn_cat] += on ? 1 : 0;
+                    gap_start = t+1;
+                }
+            }
+        }
+    }
+
+    // Map units to FNs, preferring the ones that are already powered on, then the needed ones
+    std::vector<std::vector<bool>> plan(nslots, std::vector<bool>(nfns, false));
+    for (std::size_t t = 0; t < nslots; ++t)
+    {
+        auto const& prev_fn_power_states = (t > 0) ? plan[t-1] : fn_power_states;
+
+        std::vector<std::size_t> fns;
+        for (std::size_t fn = 0; fn < nfns; ++fn)
+        {
+            if (fixed_fns.empty() || fixed_fns[t].empty() || fixed_fns[t].count(fn) > 0)
+            {
+                fns.push_back(fn);
+            }
+        }
+        std::stable_sort(fns.begin(),
+                         fns.end(),
+                         [&](std::size_t a, std::size_t b)
+                         {
+                            return std::make_pair(!prev_fn_power_states[a], !slot_fn_power_states[t][a])
+                                 < std::make_pair(!prev_fn_power_states[b], !slot_fn_power_states[t][b]);
+                         });
+
+        std::vector<std::size_t> fn_cat_num_left = slot_fn_cat_num_on[t];
+        for (auto const fn : fns)
+        {
+            auto const fn_cat = fn_categories[fn];
+
+            if (fn_cat_num_left[fn_cat] > 0)
+            {
+                plan[t][fn] = true;
+                fn_cat_num_left[fn_cat] -= 1;
+            }
+        }
+    }
+
+    return plan;
+}
+
+} // Namespace detail
+
+
+/**
+ * \brief Heuristic solver for the VM allocation problem based on first-fit
+ *  decreasing packing and local search.
+ *
+ * Unlike the solvers based on (Bahreini et al., 2017), more VMs can be
+ * allocated on the same FN and no dense VM-by-FN cost matrix is built, so
+ * that the solver scales to thousands of FNs and VMs.
+ * Services are packed by first-fit decreasing on their CPU share into the
+ * cheapest FNs (starting from the ones that are already powered on), and the
+ * resulting allocation is then improved by move/swap local search on the
+ * profit (see \c detail::improve_vm_allocation).
+ *
+ * Since the solution is always feasible, it can also be used as a starting
+ * point for the exact solvers.
+ */
+template <typename RealT>
+class greedy_vm_allocation_solver_t: public base_vm_allocation_solver_t<RealT>
+{
+public:
+    explicit greedy_vm_allocation_solver_t(std::size_t max_num_passes = 10)
+    : max_num_passes_(max_num_passes)
+    {
+    }
+
+    vm_allocation_t<RealT> solve(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                 const std::vector<bool>& fn_power_states, // The power status of each FN
+                                 const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                 const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                 const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                 const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                 const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                 const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                 const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                 const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                 const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                 const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                 const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                 const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                 RealT deltat = 1 // Length of the time interval
+                            ) const
+    {
+        return this->solve_with_fixed_fns(std::set<std::size_t>(), // Any FN can be selected
+                                          fn_categories,
+                                          fn_power_states,
+                                          fn_vm_allocations,
+                                          fn_cat_min_powers,
+                                          fn_cat_max_powers,
+                                          vm_cat_fn_cat_cpu_specs,
+                                          vm_cat_alloc_costs,
+                                          svc_categories,
+                                          svc_cat_vm_cat_min_num_vms,
+                                          fp_svc_cat_revenues,
+                                          fp_svc_cat_penalties,
+                                          fp_electricity_cost,
+                                          fp_fn_cat_asleep_costs,
+                                          fp_fn_cat_awake_costs,
+                                          deltat);
+    }
+
+    vm_allocation_t<RealT> solve_with_fixed_fns(const std::set<std::size_t>& fixed_fns,
+                                                const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                                const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                                const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                                const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                RealT deltat = 1 // Length of the time interval
+                            ) const
+    {
+        DCS_DEBUG_TRACE("Finding VM allocation by first-fit decreasing and local search:");
+        DCS_DEBUG_TRACE("- Number of FNs: " << fn_categories.size());
+        DCS_DEBUG_TRACE("- FN Fixed: " << fixed_fns);
+        DCS_DEBUG_TRACE("- Max Number of Local Search Passes: " << max_num_passes_);
+
+        auto const solution = detail::solve_greedy_vm_allocation(max_num_passes_,
+                                                                 fixed_fns,
+                                                                 fn_categories,
+                                                                 fn_power_states,
+                                                                 fn_vm_allocations,
+                                                                 fn_cat_min_powers,
+                                                                 fn_cat_max_powers,
+                                                                 vm_cat_fn_cat_cpu_specs,
+                                                                 vm_cat_alloc_costs,
+                                                                 svc_categories,
+                                                                 svc_cat_vm_cat_min_num_vms,
+                                                                 fp_svc_cat_revenues,
+                                                                 fp_svc_cat_penalties,
+                                                                 fp_electricity_cost,
+                                                                 fp_fn_cat_asleep_costs,
+                                                                 fp_fn_cat_awake_costs,
+                                                                 deltat);
+
+        DCS_DEBUG_TRACE("- Solve time: " << solution.solve_time);
+        DCS_DEBUG_TRACE("- Objective value: " << solution.objective_value);
+
+        return solution;
+    }
+
+
+private:
+    std::size_t max_num_passes_; ///< Max number of local search passes (0 means no local search).
+}; // greedy_vm_allocation_solver_t
+
+
+/**
+ * \brief Heuristic solver for the multi-slot VM allocation problem based on
+ *  first-fit decreasing packing and local search.
+ *
+ * Time slots are first solved in order by \c greedy_vm_allocation_solver_t,
+ * each one starting from the VM allocation found for the previous time slot.
+ * Then, the power state of FNs is planned over all time slots so that FNs
+ * that are needed again shortly are kept powered on when this costs less
+ * than switching them off and on (see \c detail::plan_fn_power_states), VMs
+ * are packed again into the planned FNs, and the most profitable of the two
+ * allocations is returned.
+ * The running time is linear in the number of time slots, so that the solver
+ * can replace the optimal multi-slot solver where CPLEX is not available or
+ * too slow.
+ */
+template <typename RealT>
+class greedy_multislot_vm_allocation_solver_t: public base_multislot_vm_allocation_solver_t<RealT>
+{
+public:
+    explicit greedy_multislot_vm_allocation_solver_t(std::size_t max_num_passes = 10)
+    : max_num_passes_(max_num_passes)
+    {
+    }
+
+    multislot_vm_allocation_t<RealT> solve(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                           const std::vector<bool>& fn_power_states, // The power status of each FN
+                                           const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                           const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                           const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                           const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                           const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                           const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                           const std::vector<std::vector<std::vector<std::size_t>>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by time slot, service category and VM category
+                                           const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                           const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                           const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                           const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                           const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                           RealT deltat = 1 // Length of the time interval
+                                    ) const
+    {
+        return this->solve_with_fixed_fns(std::vector<std::set<std::size_t>>(svc_cat_vm_cat_min_num_vms.size()), // Any FN can be selected
+                                          fn_categories,
+                                          fn_power_states,
+                                          fn_vm_allocations,
+                                          fn_cat_min_powers,
+                                          fn_cat_max_powers,
+                                          vm_cat_fn_cat_cpu_specs,
+                                          vm_cat_alloc_costs,
+                                          svc_categories,
+                                          svc_cat_vm_cat_min_num_vms,
+                                          fp_svc_cat_revenues,
+                                          fp_svc_cat_penalties,
+                                          fp_electricity_cost,
+                                          fp_fn_cat_asleep_costs,
+                                          fp_fn_cat_awake_costs,
+                                          deltat);
+    }
+
+    multislot_vm_allocation_t<RealT> solve_with_fixed_fns(const std::vector<std::set<std::size_t>>& fixed_fns, // For each time slot, the set of selected FNs to use for the VM allocation (if in a given time slot the set is empty, any FN can be used)
+                                                          const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                          const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                          const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                          const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                          const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                          const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                          const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                          const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                          const std::vector<std::vector<std::vector<std::size_t>>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by time slot, service category and VM category
+                                                          const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                                          const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                                          const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                          const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                          const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                          RealT deltat = 1 // Length of the time interval
+                                                    ) const
+    {
+        const std::size_t nslots = svc_cat_vm_cat_min_num_vms.size();
+
+        DCS_DEBUG_TRACE("Finding multi-slot VM allocation by first-fit decreasing and local search:");
+        DCS_DEBUG_TRACE("- Number of FNs: " << fn_categories.size());
+        DCS_DEBUG_TRACE("- Number of Time Slots: " << nslots);
+        DCS_DEBUG_TRACE("- FN Fixed: " << fixed_fns);
+        DCS_DEBUG_TRACE("- Max Number of Local Search Passes: " << max_num_passes_);
+
+        DCS_ASSERT( fixed_fns.empty() || nslots == fixed_fns.size(),
+                    DCS_EXCEPTION_THROW( std::logic_error,
+                                         "Fixed FNs container has a wrong size" ) );
+
+        auto const start_time = std::chrono::steady_clock::now();
+
+        // Solves time slots in order, each one starting from the VM allocation of the previous time slot and using the given FNs
+        auto const solve_slots = [&](const std::vector<std::set<std::size_t>>& slot_fns, // For each time slot, the set of FNs to use for the VM allocation
+                                     const std::vector<bool>& slot_any_fns) // For each time slot, tells if any FN can be used when the set of FNs is empty
+                                 {
+                                    multislot_vm_allocation_t<RealT> sol;
+
+                                    sol.fn_vm_allocations.resize(nslots);
+                                    sol.fn_power_states.resize(nslots);
+                                    sol.fn_cpu_allocations.resize(nslots);
+                                    for (std::size_t t = 0; t < nslots; ++t)
+                                    {
+                                        if (slot_fns[t].empty() && !slot_any_fns[t])
+                                        {
+                                            // No FN is used
+                                            sol.fn_vm_allocations[t].resize(fn_categories.size());
+                                            sol.fn_power_states[t].assign(fn_categories.size(), false);
+                                            sol.fn_cpu_allocations[t].assign(fn_categories.size(), 0);
+                                            continue;
+                                        }
+
+                                        auto const& prev_fn_power_states = (t > 0) ? sol.fn_power_states[t-1] : fn_power_states;
+                                        auto const& prev_fn_vm_allocations = (t > 0) ? sol.fn_vm_allocations[t-1] : fn_vm_allocations;
+
+                                        auto const slot_solution = detail::solve_greedy_vm_allocation(max_num_passes_,
+                                                                                                      slot_fns[t],
+                                                                                                      fn_categories,
+                                                                                                      prev_fn_power_states,
+                                                                                                      prev_fn_vm_allocations,
+                                                                                                      fn_cat_min_powers,
+                                                                                                      fn_cat_max_powers,
+                                                                                                      vm_cat_fn_cat_cpu_specs,
+                                                                                                      vm_cat_alloc_costs,
+                                                                                                      svc_categories,
+                                                                                                      svc_cat_vm_cat_min_num_vms[t],
+                                                                                                      fp_svc_cat_revenues,
+                                                                                                      fp_svc_cat_penalties,
+                                                                                                      fp_electricity_cost,
+                                                                                                      fp_fn_cat_asleep_costs,
+                                                                                                      fp_fn_cat_awake_costs,
+                                                                                                      deltat);
+
+                                        sol.fn_vm_allocations[t] = slot_solution.fn_vm_allocations;
+                                        sol.fn_power_states[t] = slot_solution.fn_power_states;
+                                        sol.fn_cpu_allocations[t] = slot_solution.fn_cpu_allocations;
+                                    }
+
+                                    detail::eval_multislot_vm_allocation(fn_categories,
+                                                                         fn_power_states,
+                                                                         fn_vm_allocations,
+                                                                         fn_cat_min_powers,
+                                                                         fn_cat_max_powers,
+                                                                         vm_cat_alloc_costs,
+                                                                         svc_categories,
+                                                                         svc_cat_vm_cat_min_num_vms,
+                                                                         fp_svc_cat_revenues,
+                                                                         fp_svc_cat_penalties,
+                                                                         fp_electricity_cost,
+                                                                         fp_fn_cat_asleep_costs,
+                                                                         fp_fn_cat_awake_costs,
+                                                                         deltat,
+                                                                         sol);
+
+                                    return sol;
+                                 };
+
+        // First, solve each time slot on its own
+        auto solution = solve_slots(fixed_fns.empty() ? std::vector<std::set<std::size_t>>(nslots) : fixed_fns,
+                                    std::vector<bool>(nslots, true));
+
+        DCS_DEBUG_TRACE("- Objective value (per-slot allocation): " << solution.objective_value);
+
+        if (nslots > 1)
+        {
+            // Then, plan FN power states over the time slots to avoid costly switches, and pack VMs again into the planned FNs
+            auto const plan = detail::plan_fn_power_states(fixed_fns,
+                                                           fn_categories,
+                                                           fn_power_states,
+                                                           solution.fn_power_states,
+                                                           fn_cat_min_powers,
+                                                           fp_electricity_cost,
+                                                           fp_fn_cat_asleep_costs,
+                                                           fp_fn_cat_awake_costs,
+                                                           deltat);
+
+            std::vector<std::set<std::size_t>> planned_fns(nslots);
+            for (std::size_t t = 0; t < nslots; ++t)
+            {
+                for (std::size_t fn = 0; fn < plan[t].size(); ++fn)
+                {
+                    if (plan[t][fn])
+                    {
+                        planned_fns[t].insert(fn);
+                    }
+                }
+            }
+
+            auto planned_solution = solve_slots(planned_fns,
+                                                std::vector<bool>(nslots, false));
+
+            DCS_DEBUG_TRACE("- Objective value (planned allocation): " << planned_solution.objective_value);
+
+            if (planned_solution.objective_value > solution.objective_value)
+            {
+                solution = std::move(planned_solution);
+            }
+        }
+
+        solution.solved = true;
+        solution.optimal = false;
+        solution.solve_time = std::chrono::duration_cast<std::chrono::duration<RealT>>(std::chrono::steady_clock::now()-start_time).count();
+
+        DCS_DEBUG_TRACE("- Objective value: " << solution.objective_value);
+        DCS_DEBUG_TRACE("- Solve time: " << solution.solve_time);
+
+        return solution;
+    }
+
+
+private:
+    std::size_t max_num_passes_; ///< Max number of local search passes (0 means no local search).
+}; // greedy_multislot_vm_allocation_solver_t
+
+}} // Namespace dcs::fog
+
+
+#endif // DCS_FOG_VM_ALLOCATION_GREEDY_SOLVER_HPP
@@ -28,6 +28,8 @@
 #define DCS_FOG_VM_ALLOCATION_OPTIMAL_SOLVER_HPP
 
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <dcs/assert.hpp>
@@ -48,9 +50,14 @@
 #include <ilcplex/ilocplex.h>
 #include <iostream>
 #include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <sstream>
 #include <stdexcept>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 
@@ -180,6 +187,887 @@ IloInt to_IloInt(const IloNum& x)
     return static_cast<IloInt>(std::round(x));
 }
 
+/**
+ * \brief Partitions FNs into classes of interchangeable FNs.
+ *
+ * Two FNs are interchangeable if they belong to the same FN category, are in
+ * the same power state, currently host the same VMs, and are both either in or
+ * out of \a fixed_fns: swapping their VM allocations changes neither the
+ * feasibility nor the objective value of a solution.
+ * Only classes with at least two FNs are returned, each one sorted by
+ * increasing FN index.
+ */
+inline
+std::vector<std::vector<std::size_t>> make_fn_symmetry_classes(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                               const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                               const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                               const std::set<std::size_t>& fixed_fns) // The set of selected FNs to use in the VM allocation (if empty, any FN can be used)
+{
+    typedef std::tuple<std::size_t, bool, bool, std::map<std::size_t,std::pair<std::size_t,std::size_t>>> fn_key_type;
+
+    const std::size_t nfns = fn_categories.size();
+
+    std::map<fn_key_type,std::vector<std::size_t>> key_fns;
+    for (std::size_t i = 0; i < nfns; ++i)
+    {
+        key_fns[std::make_tuple(fn_categories[i], bool(fn_power_states[i]), fixed_fns.count(i) > 0, fn_vm_allocations[i])].push_back(i);
+    }
+
+    std::vector<std::vector<std::size_t>> fn_classes;
+    for (auto& key_fn : key_fns)
+    {
+        if (key_fn.second.size() > 1)
+        {
+            fn_classes.push_back(std::move(key_fn.second));
+        }
+    }
+
+    return fn_classes;
+}
+
+/**
+ * \brief Reorders a starting point so that it satisfies the symmetry-breaking
+ *  constraints.
+ *
+ * Within each class of interchangeable FNs, powered-on FNs come first and are
+ * sorted by decreasing CPU allocation (see
+ * \c add_fn_symmetry_breaking_constraints).
+ * Since only the VM allocations of interchangeable FNs are swapped, the
+ * objective value of the starting point does not change.
+ */
+template <typename RealT>
+void order_vm_allocation_start(const std::vector<std::vector<std::size_t>>& fn_classes, // Classes of interchangeable FNs
+                               const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                               const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                               std::vector<bool>& start_fn_power_states, // The power status of each FN in the starting point
+                               std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& start_fn_vm_allocations) // The VM allocations of the starting point, by FN and service
+{
+    for (auto const& fn_class : fn_classes)
+    {
+        std::vector<std::tuple<bool,RealT,std::size_t>> fn_ranks; // <power state, CPU allocation, FN> triple for each FN of the class
+        for (auto const fn : fn_class)
+        {
+            RealT cpu = 0;
+            for (auto const& svc_vms : start_fn_vm_allocations[fn])
+            {
+                cpu += svc_vms.second.second*vm_cat_fn_cat_cpu_specs[svc_vms.second.first][fn_categories[fn]];
+            }
+            fn_ranks.push_back(std::make_tuple(bool(start_fn_power_states[fn]), cpu, fn));
+        }
+        std::stable_sort(fn_ranks.begin(),
+                         fn_ranks.end(),
+                         [](const std::tuple<bool,RealT,std::size_t>& a, const std::tuple<bool,RealT,std::size_t>& b)
+                         {
+                            return std::get<0>(a) != std::get<0>(b) ? std::get<0>(a) : std::get<1>(a) > std::get<1>(b);
+                         });
+
+        std::vector<bool> power_states;
+        std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>> vm_allocations;
+        for (auto const& fn_rank : fn_ranks)
+        {
+            power_states.push_back(start_fn_power_states[std::get<2>(fn_rank)]);
+            vm_allocations.push_back(start_fn_vm_allocations[std::get<2>(fn_rank)]);
+        }
+        for (std::size_t r = 0; r < fn_class.size(); ++r)
+        {
+            start_fn_power_states[fn_class[r]] = power_states[r];
+            start_fn_vm_allocations[fn_class[r]] = std::move(vm_allocations[r]);
+        }
+    }
+}
+
+/**
+ * \brief Adds the constraints to break the symmetries among interchangeable
+ *  FNs.
+ *
+ * For every pair of consecutive FNs a, b of each class of interchangeable FNs,
+ * adds the constraints x_{a} \ge x_{b} and u_{a} \ge u_{b}, that is powered-on
+ * FNs come first and are sorted by decreasing CPU allocation.
+ * Any solution can be turned into an equivalent one that satisfies these
+ * constraints by swapping the VM allocations of interchangeable FNs.
+ *
+ * \return The added constraints.
+ */
+template <typename UArrayT>
+IloConstraintArray add_fn_symmetry_breaking_constraints(IloModel& model,
+                                                        const IloBoolVarArray& x,
+                                                        const UArrayT& u, // CPU utilization of FNs (either variables or expressions)
+                                                        const std::vector<std::vector<std::size_t>>& fn_classes, // Classes of interchangeable FNs
+                                                        std::size_t cc) // Constraint counter
+{
+    IloConstraintArray conss(model.getEnv());
+
+    for (auto const& fn_class : fn_classes)
+    {
+        for (std::size_t r = 1; r < fn_class.size(); ++r)
+        {
+            auto const a = fn_class[r-1];
+            auto const b = fn_class[r];
+
+            std::ostringstream oss;
+            oss << "C" << cc << "_x_{" << a << "," << b << "}";
+
+            IloConstraint cons(x[a] >= x[b]);
+            cons.setName(oss.str().c_str());
+            conss.add(cons);
+
+            oss.str("");
+            oss << "C" << cc << "_u_{" << a << "," << b << "}";
+
+            cons = (u[a] >= u[b]);
+            cons.setName(oss.str().c_str());
+            conss.add(cons);
+        }
+    }
+
+    model.add(conss);
+
+    return conss;
+}
+
+/**
+ * \brief Measures the wall-clock time taken by a solver to find its first
+ *  feasible solution and to complete its search.
+ *
+ * The time of the first incumbent may be recorded concurrently by the threads
+ * of the solver.
+ */
+template <typename RealT>
+class solve_timer_t
+{
+private:
+    typedef std::chrono::steady_clock clock_type;
+
+
+public:
+    solve_timer_t()
+    : solve_time_(std::numeric_limits<RealT>::quiet_NaN()),
+      first_incumbent_time_(std::numeric_limits<RealT>::quiet_NaN())
+    {
+    }
+
+    void start()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        start_time_ = clock_type::now();
+        solve_time_ = first_incumbent_time_ = std::numeric_limits<RealT>::quiet_NaN();
+    }
+
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        solve_time_ = elapsed();
+    }
+
+    /// Records the current time as the time of the first incumbent, unless one has already been found
+    void incumbent_found()
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        if (std::isnan(first_incumbent_time_))
+        {
+            first_incumbent_time_ = elapsed();
+        }
+    }
+
+    RealT solve_time() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        return solve_time_;
+    }
+
+    RealT first_incumbent_time() const
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        return first_incumbent_time_;
+    }
+
+
+private:
+    RealT elapsed() const
+    {
+        return std::chrono::duration_cast<std::chrono::duration<RealT>>(clock_type::now()-start_time_).count();
+    }
+
+
+private:
+    mutable std::mutex mtx_;
+    clock_type::time_point start_time_;
+    RealT solve_time_;
+    RealT first_incumbent_time_;
+}; // solve_timer_t
+
+/// Informational CPLEX callback that notifies a solve timer as soon as an incumbent is available
+template <typename RealT>
+class cplex_incumbent_timer_callback_t: public IloCplex::MIPInfoCallbackI
+{
+public:
+    cplex_incumbent_timer_callback_t(IloEnv env, solve_timer_t<RealT>& timer)
+    : IloCplex::MIPInfoCallbackI(env),
+      p_timer_(&timer)
+    {
+    }
+
+
+protected:
+    void main()
+    {
+        if (hasIncumbent())
+        {
+            p_timer_->incumbent_found();
+        }
+    }
+
+    IloCplex::CallbackI* duplicateCallback() const
+    {
+        return new (getEnv()) cplex_incumbent_timer_callback_t(*this);
+    }
+
+
+private:
+    solve_timer_t<RealT>* p_timer_;
+}; // cplex_incumbent_timer_callback_t
+
+/**
+ * \brief Checks whether CPLEX turns the MIP starts given to it into an initial
+ *  solution.
+ *
+ * While this object is alive, the log of CPLEX is captured and then looked up
+ * for the message CPLEX emits when a MIP start defines an initial solution.
+ * In debug mode the log is shown as usual and is not checked.
+ */
+class cplex_mip_start_check_t
+{
+public:
+    explicit cplex_mip_start_check_t(IloCplex solver)
+    : solver_(solver),
+      enabled_(solver.getNMIPStarts() > 0)
+    {
+#ifndef DCS_DEBUG
+        if (enabled_)
+        {
+            solver_.setOut(log_);
+            solver_.setWarning(log_);
+        }
+#endif // DCS_DEBUG
+    }
+
+    ~cplex_mip_start_check_t()
+    {
+#ifndef DCS_DEBUG
+        if (enabled_)
+        {
+            solver_.setOut(solver_.getEnv().getNullStream());
+            solver_.setWarning(solver_.getEnv().getNullStream());
+        }
+#endif // DCS_DEBUG
+    }
+
+    /// Tells whether CPLEX has not been given any MIP start or has accepted one of them
+    bool accepted() const
+    {
+#ifndef DCS_DEBUG
+        return !enabled_ || log_.str().find("defined initial solution") != std::string::npos;
+#else // DCS_DEBUG
+        return true;
+#endif // DCS_DEBUG
+    }
+
+
+private:
+    IloCplex solver_;
+    bool enabled_;
+    std::ostringstream log_;
+}; // cplex_mip_start_check_t
+
+#if defined(CPX_VERSION) && CPX_VERSION >= 12100000
+/// CP Optimizer callback (available since version 12.10) that notifies a solve timer as soon as a solution is found
+template <typename RealT>
+class cp_incumbent_timer_callback_t: public IloCP::Callback
+{
+public:
+    explicit cp_incumbent_timer_callback_t(solve_timer_t<RealT>& timer)
+    : p_timer_(&timer)
+    {
+    }
+
+    void invoke(IloCP cp, IloCP::Callback::Reason reason)
+    {
+        DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( cp );
+
+        if (reason == IloCP::Callback::Solution)
+        {
+            p_timer_->incumbent_found();
+        }
+    }
+
+
+private:
+    solve_timer_t<RealT>* p_timer_;
+}; // cp_incumbent_timer_callback_t
+# define DCS_FOG_VM_ALLOC_CP_HAS_CALLBACKS true
+#endif // CPX_VERSION
+
+/**
+ * \brief CPLEX model of the VM allocation problem that is kept alive across
+ *  solves.
+ *
+ * Variables and constraints only depend on the structure of the problem (i.e.,
+ * on the categories of FNs and services and on the CPU requirements of VMs),
+ * so they are created once and reused every time the problem is solved again.
+ * The data that change from one solve to the next (i.e., the min number of
+ * VMs, the FN power states, the current VM allocations and the set of fixed
+ * FNs) are set by only changing bounds and coefficients of the model, and by
+ * replacing the expression of the objective function.
+ *
+ * To this end, service penalties and VM (re)allocation costs are linearized by
+ * means of the following auxiliary variables:
+ * - o_{j,k} \in \{0,1\}: 1 if class-k VMs are allocated to service j, that is
+ *   \sum_{i \in F} y_{i,j,k} \le N_{j,k} o_{j,k};
+ * - f_{j,k} \in \{0,1\}: 1 if service j gets all the N_{j,k} class-k VMs it
+ *   needs, that is \sum_{i \in F} y_{i,j,k} \ge N_{j,k} f_{j,k} and
+ *   f_{j,k} \le o_{j,k};
+ * - r_{i,j,k} \ge 0: number of class-k VMs newly allocated on FN i for
+ *   service j, that is r_{i,j,k} \ge y_{i,j,k} - \hat{y}_{i,j,k}, where
+ *   \hat{y}_{i,j,k} is the current number of VMs.
+ * .
+ * So, the penalty term ((\sum_{i \in F} y_{i,j,k}) > 0)((\sum_{i \in F} y_{i,j,k}) < N_{j,k})
+ * becomes o_{j,k}-f_{j,k}, and \max(0, y_{i,j,k}-\hat{y}_{i,j,k}) becomes
+ * r_{i,j,k}.
+ */
+template <typename RealT>
+class cplex_vm_allocation_model_t
+{
+public:
+    cplex_vm_allocation_model_t(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                const std::vector<std::size_t>& svc_categories) // Maps every service to its service category
+    : fn_categories_(fn_categories),
+      vm_cat_fn_cat_cpu_specs_(vm_cat_fn_cat_cpu_specs),
+      svc_categories_(svc_categories)
+    {
+        try
+        {
+            build();
+        }
+        catch (...)
+        {
+            env_.end();
+            throw;
+        }
+    }
+
+    cplex_vm_allocation_model_t(const cplex_vm_allocation_model_t&) = delete;
+
+    cplex_vm_allocation_model_t& operator=(const cplex_vm_allocation_model_t&) = delete;
+
+    ~cplex_vm_allocation_model_t()
+    {
+        env_.end();
+    }
+
+    /// Tells if this model can be used to solve a problem with the given structure
+    bool matches(const std::vector<std::size_t>& fn_categories,
+                 const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs,
+                 const std::vector<std::size_t>& svc_categories) const
+    {
+        return fn_categories == fn_categories_
+               && svc_categories == svc_categories_
+               && vm_cat_fn_cat_cpu_specs == vm_cat_fn_cat_cpu_specs_;
+    }
+
+    /// Sets the data of the problem to solve next
+    void update(const std::vector<bool>& fn_power_states, // The power status of each FN
+                const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                const std::set<std::size_t>& fixed_fns, // The set of selected FNs to use in the VM allocation (if empty, any FN can be used)
+                const std::vector<std::vector<std::size_t>>& fn_sym_classes, // Classes of interchangeable FNs whose symmetries must be broken
+                const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service category
+                const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service category
+                const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                RealT deltat) // Length of the time interval
+    {
+        const std::size_t nfns = fn_categories_.size();
+        const std::size_t nsvcs = svc_categories_.size();
+        const std::size_t nvmcats = vm_cat_fn_cat_cpu_specs_.size();
+
+        // Fix the power status of FNs
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            if (fixed_fns.size() > 0)
+            {
+                auto const on = (fixed_fns.count(i) > 0) ? 1 : 0;
+                x_[i].setBounds(on, on);
+            }
+            else
+            {
+                x_[i].setBounds(0, 1);
+            }
+        }
+
+        // Set the min number of VMs
+        for (std::size_t j = 0; j < nsvcs; ++j)
+        {
+            auto const svc_cat = svc_categories_[j];
+
+            for (std::size_t k = 0; k < nvmcats; ++k)
+            {
+                auto const min_num_vms = IloInt(svc_cat_vm_cat_min_num_vms[svc_cat][k]);
+
+                o_cons_[j][k].setLinearCoef(o_[j][k], -min_num_vms);
+                f_cons_[j][k].setLinearCoef(f_[j][k], -min_num_vms);
+            }
+        }
+
+        // Set the current VM allocations
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    IloInt old_y = 0;
+                    if (fn_vm_allocations[i].count(j) > 0 && fn_vm_allocations[i].at(j).first == k)
+                    {
+                        // This FN already hosted some VMs for service j
+                        old_y = fn_vm_allocations[i].at(j).second;
+                    }
+                    r_cons_[i][j][k].setLB(-old_y);
+                }
+            }
+        }
+
+        // Replace the symmetry-breaking constraints (classes of interchangeable FNs depend on power states and VM allocations)
+        if (sym_cons_.getImpl())
+        {
+            model_.remove(sym_cons_);
+            sym_cons_.endElements();
+            sym_cons_.end();
+        }
+        sym_cons_ = add_fn_symmetry_breaking_constraints(model_, x_, u_, fn_sym_classes, sym_cc_);
+
+        // Replace the objective function
+
+        if (revenue_expr_.getImpl())
+        {
+            revenue_expr_.end();
+        }
+        if (cost_expr_.getImpl())
+        {
+            cost_expr_.end();
+        }
+
+        // Revenues
+        revenue_expr_ = IloNumExpr(env_);
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                auto const svc_cat = svc_categories_[j];
+
+                revenue_expr_ += fp_svc_cat_revenues[svc_cat]*IloSum(y_[i][j]);
+            }
+        }
+
+        // Costs
+        cost_expr_ = IloNumExpr(env_);
+        // - Add elecricity costs
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            auto const fn_cat = fn_categories_[i];
+            auto const fn_power_state = fn_power_states[i];
+            auto const dC = fn_cat_max_powers[fn_cat]-fn_cat_min_powers[fn_cat];
+            auto const wcost = fp_electricity_cost;
+
+            // Add elecricity consumption cost
+            cost_expr_ += (x_[i]*fn_cat_min_powers[fn_cat]+dC*u_[i])*wcost;
+
+            // Add switch-on/off costs
+            cost_expr_ += x_[i]*IloInt(1-fn_power_state)*fp_fn_cat_awake_costs[fn_cat]/deltat
+                       +  (1-x_[i])*IloInt(fn_power_state)*fp_fn_cat_asleep_costs[fn_cat]/deltat;
+        }
+        // - Add VM (re)allocation costs
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    cost_expr_ += r_[i][j][k]*vm_cat_alloc_costs[k]/deltat;
+                }
+            }
+        }
+        // - Add service penalties
+        for (std::size_t j = 0; j < nsvcs; ++j)
+        {
+            auto const svc_cat = svc_categories_[j];
+
+            bool need_vms = true;
+            for (std::size_t k = 0; k < nvmcats && need_vms; ++k)
+            {
+                if (svc_cat_vm_cat_min_num_vms[svc_cat][k] == 0)
+                {
+                    need_vms = false;
+                }
+            }
+            if (!need_vms)
+            {
+                continue;
+            }
+
+            cost_expr_ += ((1-s_[j]) + IloSum(o_[j]) - IloSum(f_[j]))*fp_svc_cat_penalties[svc_cat];
+        }
+
+        obj_.setExpr((revenue_expr_-cost_expr_)*deltat);
+
+        // Discard the MIP starts of previous solves (including the solution retained by CPLEX)
+        if (cplex_.getNMIPStarts() > 0)
+        {
+            cplex_.deleteMIPStarts(0, cplex_.getNMIPStarts());
+        }
+    }
+
+    IloCplex& cplex()
+    {
+        return cplex_;
+    }
+
+    const IloBoolVarArray& x() const
+    {
+        return x_;
+    }
+
+    const IloArray<IloArray<IloIntVarArray>>& y() const
+    {
+        return y_;
+    }
+
+    const IloBoolVarArray& s() const
+    {
+        return s_;
+    }
+
+    const IloNumVarArray& u() const
+    {
+        return u_;
+    }
+
+    const IloNumExpr& revenue_expr() const
+    {
+        return revenue_expr_;
+    }
+
+    const IloNumExpr& cost_expr() const
+    {
+        return cost_expr_;
+    }
+
+
+private:
+    void build()
+    {
+        const std::size_t nfns = fn_categories_.size();
+        const std::size_t nsvcs = svc_categories_.size();
+        const std::size_t nvmcats = vm_cat_fn_cat_cpu_specs_.size();
+
+        model_ = IloModel(env_);
+        model_.setName("Max-Profit Optimization");
+
+        // Decision Variables
+
+        // Variables x_{i} \in \{0,1\}: 1 if FN i is to be powered on, 0 otherwise.
+        x_ = IloBoolVarArray(env_, nfns);
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            std::ostringstream oss;
+            oss << "x[" << i << "]";
+            x_[i] = IloBoolVar(env_, oss.str().c_str());
+            model_.add(x_[i]);
+        }
+
+        // Variables y_{i,j,k} \in \mathbb{N}: denotes the number of class-k VMs are allocated on FN i for service j.
+        y_ = IloArray<IloArray<IloIntVarArray>>(env_, nfns);
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            y_[i] = IloArray<IloIntVarArray>(env_, nsvcs);
+
+            for (std::size_t j = 0 ; j < nsvcs ; ++j)
+            {
+                y_[i][j] = IloIntVarArray(env_, nvmcats);
+
+                for (std::size_t k = 0 ; k < nvmcats ; ++k)
+                {
+                    std::ostringstream oss;
+                    oss << "y[" << i << "][" << j << "][" << k << "]";
+                    y_[i][j][k] = IloIntVar(env_, oss.str().c_str());
+                    model_.add(y_[i][j][k]);
+                }
+            }
+        }
+
+        // Auxiliary variables s_{j} \in \{0,1\}: 1 if service j is offered, 0 otherwise.
+        s_ = IloBoolVarArray(env_, nsvcs);
+        for (std::size_t j = 0; j < nsvcs; ++j)
+        {
+            std::ostringstream oss;
+            oss << "s[" << j << "]";
+            s_[j] = IloBoolVar(env_, oss.str().c_str());
+            model_.add(s_[j]);
+        }
+
+        // Variable u_{i} \in [0,1]: total fraction of CPU of FN i allocated to VMs
+        u_ = IloNumVarArray(env_, nfns);
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            std::ostringstream oss;
+            oss << "u[" << i << "]";
+            u_[i] = IloNumVar(env_, oss.str().c_str());
+            model_.add(u_[i]);
+        }
+
+        // Auxiliary variables o_{j,k} \in \{0,1\} and f_{j,k} \in \{0,1\} (see the class documentation)
+        o_ = IloArray<IloBoolVarArray>(env_, nsvcs);
+        f_ = IloArray<IloBoolVarArray>(env_, nsvcs);
+        for (std::size_t j = 0; j < nsvcs; ++j)
+        {
+            o_[j] = IloBoolVarArray(env_, nvmcats);
+            f_[j] = IloBoolVarArray(env_, nvmcats);
+
+            for (std::size_t k = 0; k < nvmcats; ++k)
+            {
+                std::ostringstream oss;
+                oss << "o[" << j << "][" << k << "]";
+                o_[j][k] = IloBoolVar(env_, oss.str().c_str());
+                model_.add(o_[j][k]);
+
+                oss.str("");
+                oss << "f[" << j << "][" << k << "]";
+                f_[j][k] = IloBoolVar(env_, oss.str().c_str());
+                model_.add(f_[j][k]);
+            }
+        }
+
+        // Auxiliary variables r_{i,j,k} \ge 0 (see the class documentation)
+        r_ = IloArray<IloArray<IloNumVarArray>>(env_, nfns);
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            r_[i] = IloArray<IloNumVarArray>(env_, nsvcs);
+
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                r_[i][j] = IloNumVarArray(env_, nvmcats);
+
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    std::ostringstream oss;
+                    oss << "r[" << i << "][" << j << "][" << k << "]";
+                    r_[i][j][k] = IloNumVar(env_, 0, IloInfinity, oss.str().c_str());
+                    model_.add(r_[i][j][k]);
+                }
+            }
+        }
+
+        // Constraints
+
+        std::size_t cc = 0; // Constraint counter
+
+        // Constraints the values of s_{j}:
+        //   \forall j \in S: s_{j} = ( \sum_{i \in F} \sum_{k \in C} y_{i,j,k} ) > 0)
+        ++cc;
+        for (std::size_t j = 0; j < nsvcs; ++j)
+        {
+            IloIntExpr rhs_expr(env_);
+            for (std::size_t i = 0; i < nfns; ++i)
+            {
+                rhs_expr += IloSum(y_[i][j]);
+            }
+
+            std::ostringstream oss;
+            oss << "C" << cc << "_{" << j << "}";
+
+            IloConstraint cons(s_[j] == (rhs_expr > 0));
+            cons.setName(oss.str().c_str());
+            model_.add(cons);
+        }
+
+        // Constraints the value of u_{i}:
+        //   u_{i} = \sum_{j \in S} \sum_{k \in C} y_{i,j,k}*C_{i,k}, \forall i \in FN'
+        ++cc;
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            auto const fn_cat = fn_categories_[i];
+
+            IloNumExpr rhs_expr(env_);
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    rhs_expr += y_[i][j][k]*vm_cat_fn_cat_cpu_specs_[k][fn_cat];
+                }
+            }
+
+            std::ostringstream oss;
+            oss << "C" << cc << "_{" << i << "}";
+
+            IloConstraint cons(u_[i] == rhs_expr);
+            cons.setName(oss.str().c_str());
+            model_.add(cons);
+        }
+
+        // VMs allocated for a given service must belong to the same class
+        //  \forall j \in S: \sum_{i \in F} \sum_{k \in C} y_{i,j,k} = max_{k \in C} \sum_{i \in F} y_{i,j,k}
+        ++cc;
+        for (std::size_t j = 0; j < nsvcs; ++j)
+        {
+            IloIntExpr lhs_expr(env_);
+            for (std::size_t i = 0; i < nfns; ++i)
+            {
+                lhs_expr += IloSum(y_[i][j]);
+            }
+
+            IloIntExprArray max_op_expr(env_, nvmcats);
+            for (std::size_t k = 0; k < nvmcats; ++k)
+            {
+                max_op_expr[k] = IloIntExpr(env_);
+                for (std::size_t i = 0; i < nfns; ++i)
+                {
+                    max_op_expr[k] += y_[i][j][k];
+                }
+            }
+
+            std::ostringstream oss;
+            oss << "C" << cc << "_{" << j << "}";
+
+            IloConstraint cons(lhs_expr == IloMax(max_op_expr));
+            cons.setName(oss.str().c_str());
+            model_.add(cons);
+        }
+
+        // The total allocated capacity on a powered-on FN must not exceed the max capacity
+        //  \forall i \in F: u_{i} \le x_{i}
+        ++cc;
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            std::ostringstream oss;
+            oss << "C" << cc << "_{" << i << "}";
+
+            IloConstraint cons(u_[i] <= x_[i]);
+            cons.setName(oss.str().c_str());
+            model_.add(cons);
+        }
+
+        // Don't allocate useless VMs, and tell which VM classes are used
+        //  \forall j \in S, k \in C: \sum_{i \in F} y_{i,j,k} - N_{j,k} o_{j,k} \le 0
+        // Tell which services get all the VMs they need
+        //  \forall j \in S, k \in C: \sum_{i \in F} y_{i,j,k} - N_{j,k} f_{j,k} \ge 0
+        // NOTE: the coefficients N_{j,k} are set by update()
+        ++cc;
+        o_cons_ = IloArray<IloRangeArray>(env_, nsvcs);
+        f_cons_ = IloArray<IloRangeArray>(env_, nsvcs);
+        for (std::size_t j = 0; j < nsvcs; ++j)
+        {
+            o_cons_[j] = IloRangeArray(env_, nvmcats);
+            f_cons_[j] = IloRangeArray(env_, nvmcats);
+
+            for (std::size_t k = 0; k < nvmcats; ++k)
+            {
+                IloIntExpr ysum_expr(env_);
+                for (std::size_t i = 0; i < nfns; ++i)
+                {
+                    ysum_expr += y_[i][j][k];
+                }
+
+                std::ostringstream oss;
+                oss << "C" << cc << "_o_{" << j << "," << k << "}";
+                o_cons_[j][k] = IloRange(env_, -IloInfinity, ysum_expr - o_[j][k], 0, oss.str().c_str());
+                model_.add(o_cons_[j][k]);
+
+                oss.str("");
+                oss << "C" << cc << "_f_{" << j << "," << k << "}";
+                f_cons_[j][k] = IloRange(env_, 0, ysum_expr - f_[j][k], IloInfinity, oss.str().c_str());
+                model_.add(f_cons_[j][k]);
+
+                oss.str("");
+                oss << "C" << cc << "_{" << j << "," << k << "}";
+                IloConstraint cons(f_[j][k] <= o_[j][k]);
+                cons.setName(oss.str().c_str());
+                model_.add(cons);
+            }
+        }
+
+        // Number of newly allocated VMs
+        //  \forall i \in F, j \in S, k \in C: r_{i,j,k} - y_{i,j,k} \ge -\hat{y}_{i,j,k}
+        // NOTE: the lower bounds are set by update()
+        ++cc;
+        r_cons_ = IloArray<IloArray<IloRangeArray>>(env_, nfns);
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            r_cons_[i] = IloArray<IloRangeArray>(env_, nsvcs);
+
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                r_cons_[i][j] = IloRangeArray(env_, nvmcats);
+
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    std::ostringstream oss;
+                    oss << "C" << cc << "_{" << i << "," << j << "," << k << "}";
+                    r_cons_[i][j][k] = IloRange(env_, 0, r_[i][j][k] - y_[i][j][k], IloInfinity, oss.str().c_str());
+                    model_.add(r_cons_[i][j][k]);
+                }
+            }
+        }
+
+        // Symmetry-breaking constraints are set by update()
+        sym_cc_ = ++cc;
+
+        // Set objective (the actual expression is set by update())
+        obj_ = IloMaximize(env_);
+        model_.add(obj_);
+
+        // Create the CPLEX solver and make 'model' the active ("extracted") model
+        cplex_ = IloCplex(model_);
+
+#ifndef DCS_DEBUG
+        cplex_.setOut(env_.getNullStream());
+        cplex_.setWarning(env_.getNullStream());
+#endif // DCS_DEBUG
+    }
+
+
+private:
+    std::vector<std::size_t> fn_categories_; ///< Maps every FN to its FN category
+    std::vector<std::vector<RealT>> vm_cat_fn_cat_cpu_specs_; ///< The CPU requirement of VMs by VM category and FN category
+    std::vector<std::size_t> svc_categories_; ///< Maps every service to its service category
+    IloEnv env_; ///< The Concert Technology environment owning all the objects below
+    IloModel model_;
+    IloBoolVarArray x_; ///< x_{i}: 1 if FN i is powered on
+    IloArray<IloArray<IloIntVarArray>> y_; ///< y_{i,j,k}: number of class-k VMs allocated on FN i for service j
+    IloBoolVarArray s_; ///< s_{j}: 1 if service j is offered
+    IloNumVarArray u_; ///< u_{i}: fraction of CPU of FN i allocated to VMs
+    IloArray<IloBoolVarArray> o_; ///< o_{j,k}: 1 if class-k VMs are allocated to service j
+    IloArray<IloBoolVarArray> f_; ///< f_{j,k}: 1 if service j gets all the class-k VMs it needs
+    IloArray<IloArray<IloNumVarArray>> r_; ///< r_{i,j,k}: number of class-k VMs newly allocated on FN i for service j
+    IloArray<IloRangeArray> o_cons_; ///< Constraints defining o_{j,k}
+    IloArray<IloRangeArray> f_cons_; ///< Constraints defining f_{j,k}
+    IloArray<IloArray<IloRangeArray>> r_cons_; ///< Constraints defining r_{i,j,k}
+    IloConstraintArray sym_cons_; ///< Symmetry-breaking constraints
+    std::size_t sym_cc_; ///< Number of the symmetry-breaking constraints (used to name them)
+    IloObjective obj_;
+    IloNumExpr revenue_expr_;
+    IloNumExpr cost_expr_;
+    IloCplex cplex_;
+}; // cplex_vm_allocation_model_t
+
 //bool cplex_int_eq(const IloCplex& cplex, const IloNum& x, const IloNum& y)
 //{
 //    return dcs::math::float_traits<IloNum>::approximately_equal(x, y, cplex.getParam(IloCplex::Param::MIP::Tolerances::Integrality));
@@ -194,11 +1082,23 @@ IloInt to_IloInt(const IloNum& x)
 template <typename RealT>
 class optimal_vm_allocation_solver_t: public base_vm_allocation_solver_t<RealT>
 {
+private:
+    static constexpr std::size_t max_num_cplex_models = 16; ///< Max number of persistent CPLEX models kept in the pool
+
+
 public:
     explicit optimal_vm_allocation_solver_t(RealT relative_tolerance = 0,
-                                            RealT time_limit = -1)
+                                            RealT time_limit = -1,
+                                            bool warm_start = true,
+                                            bool persistent_model = false,
+                                            bool symmetry_breaking = false)
     : rel_tol_(relative_tolerance),
-      time_lim_(time_limit)
+      time_lim_(time_limit),
+      warm_start_(warm_start),
+      persistent_model_(persistent_model),
+      sym_break_(symmetry_breaking),
+      num_workers_(0),
+      deterministic_(false)
     {
     }
 
@@ -222,6 +1122,88 @@ public:
         return time_lim_;
     }
 
+    /// Tells whether the search must start from the current VM allocation
+    void warm_start(bool value)
+    {
+        warm_start_ = value;
+    }
+
+    bool warm_start() const
+    {
+        return warm_start_;
+    }
+
+    /**
+     * \brief Tells whether the optimization model must be kept alive across
+     *  calls to \c solve.
+     *
+     * When set, the model is built only the first time a problem with a given
+     * structure (i.e., FN categories, service categories and VM CPU
+     * requirements) is solved; the following calls only update its bounds,
+     * coefficients and objective function.
+     * This option is only supported by the CPLEX solver.
+     */
+    void persistent_model(bool value)
+    {
+        persistent_model_ = value;
+    }
+
+    bool persistent_model() const
+    {
+        return persistent_model_;
+    }
+
+    /**
+     * \brief Tells whether the symmetries among interchangeable FNs must be
+     *  broken.
+     *
+     * FNs of the same category that are in the same power state and host the
+     * same VMs are interchangeable, so the search would otherwise explore all
+     * their permutations. When set, such FNs are ordered by power state and CPU
+     * allocation by means of additional constraints.
+     */
+    void symmetry_breaking(bool value)
+    {
+        sym_break_ = value;
+    }
+
+    bool symmetry_breaking() const
+    {
+        return sym_break_;
+    }
+
+    /**
+     * \brief Sets the number of parallel workers used by the solver (0 means
+     *  the solver default, that is usually one per core).
+     */
+    void num_workers(std::size_t value)
+    {
+        num_workers_ = value;
+    }
+
+    std::size_t num_workers() const
+    {
+        return num_workers_;
+    }
+
+    /**
+     * \brief Tells whether the parallel search must be deterministic, that is
+     *  whether repeated runs must give the same result regardless of thread
+     *  scheduling.
+     *
+     * This option is only meaningful for the CPLEX solver (CP Optimizer only
+     * supports the number of workers).
+     */
+    void deterministic(bool value)
+    {
+        deterministic_ = value;
+    }
+
+    bool deterministic() const
+    {
+        return deterministic_;
+    }
+
     vm_allocation_t<RealT> solve(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
                                  const std::vector<bool>& fn_power_states, // The power status of each FN
                                  const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
@@ -260,12 +1242,40 @@ public:
         DCS_DEBUG_TRACE("- Length of the time interval: " << deltat);
         DCS_DEBUG_TRACE("- Relative Tolerance: " << rel_tol_);
         DCS_DEBUG_TRACE("- Time Limit: " << time_lim_);
+        DCS_DEBUG_TRACE("- Warm Start: " << warm_start_);
+        DCS_DEBUG_TRACE("- Persistent Model: " << persistent_model_);
+        DCS_DEBUG_TRACE("- Symmetry Breaking: " << sym_break_);
+        DCS_DEBUG_TRACE("- Number of Workers: " << num_workers_);
+        DCS_DEBUG_TRACE("- Deterministic: " << deterministic_);
 
 #if defined(DCS_FOG_VM_ALLOC_USE_CPLEX_SOLVER)
+        if (persistent_model_)
+        {
+            return by_persistent_cplex(fn_categories,
+                                       fn_power_states,
+                                       fn_vm_allocations,
+                                       std::set<std::size_t>(), // Use any FN
+                                       fn_power_states,
+                                       fn_vm_allocations,
+                                       fn_cat_min_powers,
+                                       fn_cat_max_powers,
+                                       vm_cat_fn_cat_cpu_specs,
+                                       vm_cat_alloc_costs,
+                                       svc_categories,
+                                       svc_cat_vm_cat_min_num_vms,
+                                       fp_svc_cat_revenues,
+                                       fp_svc_cat_penalties,
+                                       fp_electricity_cost,
+                                       fp_fn_cat_asleep_costs,
+                                       fp_fn_cat_awake_costs,
+                                       deltat);
+        }
         return by_native_cplex(fn_categories,
                                fn_power_states,
                                fn_vm_allocations,
                                std::set<std::size_t>(), // Use any FN
+                               fn_power_states,
+                               fn_vm_allocations,
                                fn_cat_min_powers,
                                fn_cat_max_powers,
                                vm_cat_fn_cat_cpu_specs,
@@ -284,6 +1294,8 @@ public:
                             fn_power_states,
                             fn_vm_allocations,
                             std::set<std::size_t>(), // Use any FN
+                            fn_power_states,
+                            fn_vm_allocations,
                             fn_cat_min_powers,
                             fn_cat_max_powers,
                             vm_cat_fn_cat_cpu_specs,
@@ -341,12 +1353,169 @@ public:
         DCS_DEBUG_TRACE("- Length of the time interval: " << deltat);
         DCS_DEBUG_TRACE("- Relative Tolerance: " << rel_tol_);
         DCS_DEBUG_TRACE("- Time Limit: " << time_lim_);
+        DCS_DEBUG_TRACE("- Warm Start: " << warm_start_);
+        DCS_DEBUG_TRACE("- Persistent Model: " << persistent_model_);
+        DCS_DEBUG_TRACE("- Symmetry Breaking: " << sym_break_);
+        DCS_DEBUG_TRACE("- Number of Workers: " << num_workers_);
+        DCS_DEBUG_TRACE("- Deterministic: " << deterministic_);
+
+#if defined(DCS_FOG_VM_ALLOC_USE_CPLEX_SOLVER)
+        if (persistent_model_)
+        {
+            return by_persistent_cplex(fn_categories,
+                                       fn_power_states,
+                                       fn_vm_allocations,
+                                       fixed_fns,
+                                       fn_power_states,
+                                       fn_vm_allocations,
+                                       fn_cat_min_powers,
+                                       fn_cat_max_powers,
+                                       vm_cat_fn_cat_cpu_specs,
+                                       vm_cat_alloc_costs,
+                                       svc_categories,
+                                       svc_cat_vm_cat_min_num_vms,
+                                       fp_svc_cat_revenues,
+                                       fp_svc_cat_penalties,
+                                       fp_electricity_cost,
+                                       fp_fn_cat_asleep_costs,
+                                       fp_fn_cat_awake_costs,
+                                       deltat);
+        }
+        return by_native_cplex(fn_categories,
+                               fn_power_states,
+                               fn_vm_allocations,
+                               fixed_fns,
+                               fn_power_states,
+                               fn_vm_allocations,
+                               fn_cat_min_powers,
+                               fn_cat_max_powers,
+                               vm_cat_fn_cat_cpu_specs,
+                               //vm_cat_fn_cat_ram_specs,
+                               vm_cat_alloc_costs,
+                               svc_categories,
+                               svc_cat_vm_cat_min_num_vms,
+                               fp_svc_cat_revenues,
+                               fp_svc_cat_penalties,
+                               fp_electricity_cost,
+                               fp_fn_cat_asleep_costs,
+                               fp_fn_cat_awake_costs,
+                               deltat);
+#elif defined(DCS_FOG_VM_ALLOC_USE_CP_SOLVER)
+        return by_native_cp(fn_categories,
+                            fn_power_states,
+                            fn_vm_allocations,
+                            fixed_fns,
+                            fn_power_states,
+                            fn_vm_allocations,
+                            fn_cat_min_powers,
+                            fn_cat_max_powers,
+                            vm_cat_fn_cat_cpu_specs,
+                            //vm_cat_fn_cat_ram_specs,
+                            vm_cat_alloc_costs,
+                            svc_categories,
+                            svc_cat_vm_cat_min_num_vms,
+                            fp_svc_cat_revenues,
+                            fp_svc_cat_penalties,
+                            fp_electricity_cost,
+                            fp_fn_cat_asleep_costs,
+                            fp_fn_cat_awake_costs,
+                            deltat);
+#else
+# error Unable to find a suitable solver for the VM allocation problem
+#endif // DCS_FOG_VM_ALLOC_USE_..._SOLVER
+    }
+
+    /**
+     * \brief Solves the VM allocation problem by only using the given FNs and
+     *  by starting the search from the given VM allocation.
+     *
+     * This is useful when a closely related problem has just been solved
+     * (e.g., the one for the predicted workload), since its solution is
+     * usually a good incumbent for the new problem.
+     * The starting point is only used when the warm start is enabled.
+     */
+    vm_allocation_t<RealT> solve_with_fixed_fns_from(const vm_allocation_t<RealT>& start_vm_alloc, // The VM allocation from which to start the search
+                                                     const std::set<std::size_t>& fixed_fns,
+                                                     const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                     const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                     const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                     const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                     const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                     const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                     //const std::vector<std::vector<RealT>>& vm_cat_fn_cat_ram_specs, // The RAM requirement of VMs by VM category and FN category
+                                                     const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                     const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                     const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                                     const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                                     const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                                     const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                     const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                     const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                     RealT deltat = 1) const // Length of the time interval
+    {
+        DCS_DEBUG_TRACE("Finding optimal VM allocation from a given starting point:");
+        DCS_DEBUG_TRACE("- Number of FNs: " << fn_categories.size());
+        DCS_DEBUG_TRACE("- FN Categories: " << fn_categories);
+        DCS_DEBUG_TRACE("- FN Power States: " << fn_power_states);
+        DCS_DEBUG_TRACE("- FN - VM Allocations: " << fn_vm_allocations);
+        DCS_DEBUG_TRACE("- FN Mininimum Power Consumption by FN Category: " << fn_cat_min_powers);
+        DCS_DEBUG_TRACE("- FN Maximum Power Consumption by FN Category: " << fn_cat_max_powers);
+        DCS_DEBUG_TRACE("- VM CPU requirements by VM Category and FN Category: " << vm_cat_fn_cat_cpu_specs);
+        //DCS_DEBUG_TRACE("- VM RAM requirements by VM Category and FN Category: " << vm_cat_fn_cat_ram_specs);
+        DCS_DEBUG_TRACE("- VM Allocation Costs by VM Category: " << vm_cat_alloc_costs);
+        DCS_DEBUG_TRACE("- Number of Services: " << svc_categories.size());
+        DCS_DEBUG_TRACE("- Service Categories: " << svc_categories);
+        DCS_DEBUG_TRACE("- Service Minimum Number of VMs by Service Category and VM Category: " << svc_cat_vm_cat_min_num_vms);
+        DCS_DEBUG_TRACE("- FP Service Revenues by Service Category: " << fp_svc_cat_revenues);
+        DCS_DEBUG_TRACE("- FP Service Penalties by Service Category: " << fp_svc_cat_penalties);
+        DCS_DEBUG_TRACE("- FP Energy Cost: " << fp_electricity_cost);
+        DCS_DEBUG_TRACE("- FN On->Off Cost by FN Category: " << fp_fn_cat_asleep_costs);
+        DCS_DEBUG_TRACE("- FN Off->On Cost by FN Category: " << fp_fn_cat_awake_costs);
+        DCS_DEBUG_TRACE("- Length of the time interval: " << deltat);
+        DCS_DEBUG_TRACE("- Relative Tolerance: " << rel_tol_);
+        DCS_DEBUG_TRACE("- Time Limit: " << time_lim_);
+        DCS_DEBUG_TRACE("- Warm Start: " << warm_start_);
+        DCS_DEBUG_TRACE("- Persistent Model: " << persistent_model_);
+        DCS_DEBUG_TRACE("- Symmetry Breaking: " << sym_break_);
+        DCS_DEBUG_TRACE("- Number of Workers: " << num_workers_);
+        DCS_DEBUG_TRACE("- Deterministic: " << deterministic_);
+        DCS_DEBUG_TRACE("- Start FN Power States: " << start_vm_alloc.fn_power_states);
+        DCS_DEBUG_TRACE("- Start FN - VM Allocations: " << start_vm_alloc.fn_vm_allocations);
+
+        // Fall back to the current VM allocation if the starting point is not a complete VM allocation (e.g., because it comes from an unsolved problem)
+        const bool use_start = start_vm_alloc.fn_power_states.size() == fn_power_states.size()
+                               && start_vm_alloc.fn_vm_allocations.size() == fn_vm_allocations.size();
+        auto const& hint_fn_power_states = use_start ? start_vm_alloc.fn_power_states : fn_power_states;
+        auto const& hint_fn_vm_allocations = use_start ? start_vm_alloc.fn_vm_allocations : fn_vm_allocations;
 
 #if defined(DCS_FOG_VM_ALLOC_USE_CPLEX_SOLVER)
+        if (persistent_model_)
+        {
+            return by_persistent_cplex(fn_categories,
+                                       fn_power_states,
+                                       fn_vm_allocations,
+                                       fixed_fns,
+                                       hint_fn_power_states,
+                                       hint_fn_vm_allocations,
+                                       fn_cat_min_powers,
+                                       fn_cat_max_powers,
+                                       vm_cat_fn_cat_cpu_specs,
+                                       vm_cat_alloc_costs,
+                                       svc_categories,
+                                       svc_cat_vm_cat_min_num_vms,
+                                       fp_svc_cat_revenues,
+                                       fp_svc_cat_penalties,
+                                       fp_electricity_cost,
+                                       fp_fn_cat_asleep_costs,
+                                       fp_fn_cat_awake_costs,
+                                       deltat);
+        }
         return by_native_cplex(fn_categories,
                                fn_power_states,
                                fn_vm_allocations,
                                fixed_fns,
+                               hint_fn_power_states,
+                               hint_fn_vm_allocations,
                                fn_cat_min_powers,
                                fn_cat_max_powers,
                                vm_cat_fn_cat_cpu_specs,
@@ -365,6 +1534,8 @@ public:
                             fn_power_states,
                             fn_vm_allocations,
                             fixed_fns,
+                            hint_fn_power_states,
+                            hint_fn_vm_allocations,
                             fn_cat_min_powers,
                             fn_cat_max_powers,
                             vm_cat_fn_cat_cpu_specs,
@@ -389,6 +1560,8 @@ private:
                                         const std::vector<bool>& fn_power_states, // The power status of each FN
                                         const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
                                         const std::set<std::size_t>& fixed_fns, // The set of selected FNs to use in the VM allocation (if empty, any FN may be used)
+                                        const std::vector<bool>& hint_fn_power_states, // The power status of each FN in the VM allocation from which to start the search
+                                        const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& hint_fn_vm_allocations, // The VM allocations, by FN and service, from which to start the search
                                         const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
                                         const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
                                         const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
@@ -405,6 +1578,13 @@ private:
     {
         vm_allocation_t<RealT> solution;
 
+        // Classes of interchangeable FNs (if symmetries are to be broken)
+        std::vector<std::vector<std::size_t>> fn_sym_classes;
+        if (sym_break_)
+        {
+            fn_sym_classes = detail::make_fn_symmetry_classes(fn_categories, fn_power_states, fn_vm_allocations, fixed_fns);
+        }
+
         const std::size_t nfns = fn_categories.size();
         const std::size_t nsvcs = svc_categories.size();
         const std::size_t nvmcats = vm_cat_fn_cat_cpu_specs.size();
@@ -708,6 +1888,14 @@ private:
             }
 */
 
+            // Break the symmetries among interchangeable FNs:
+            //  \forall a, b \in F, a and b consecutive interchangeable FNs: x_{a} \ge x_{b}, u_{a} \ge u_{b}
+            if (fn_sym_classes.size() > 0)
+            {
+                ++cc;
+                detail::add_fn_symmetry_breaking_constraints(model, x, u, fn_sym_classes, cc);
+            }
+
             // Constraints the value of x_{i} to force using a selected set of FNs:
             //   x_{i} = 1 if fixed_fns.count(i) > 0
             //   x_{i} = 0 if fixed_fns.count(i) == 0
@@ -766,8 +1954,6 @@ private:
             {
                 for (std::size_t j = 0; j < nsvcs; ++j)
                 {
-                    auto const svc_cat = svc_categories[j];
-
                     for (std::size_t k = 0; k < nvmcats; ++k)
                     {
                         IloInt old_y = 0;
@@ -848,16 +2034,22 @@ private:
                 //solver.setParam(IloCplex::Param::MIP::Tolerances::MIPGap, rel_tol_);
                 solver.setParameter(IloCP::RelativeOptimalityTolerance, rel_tol_);
             }
-            // Set Time Limit to limit the execution time of the search
-            if (math::float_traits<RealT>::definitely_greater(time_lim_, 0))
+            // Set Time Limit to limit the execution time of the search (capped by the time left before the deadline of the caller, if any)
+            auto const time_lim = detail::solve_time_limit(time_lim_);
+            if (math::float_traits<RealT>::definitely_greater(time_lim, 0))
             {
                 //solver.setParam(IloCplex::Param::TimeLimit, time_lim_);
-                solver.setParameter(IloCP::TimeLimit, time_lim_);
+                solver.setParameter(IloCP::TimeLimit, time_lim);
             }
             // Set the search log verbosity to 'terse' (default is 'normal') to
             // limit the amount of data written into the log file in case the
             // search takes very long
             solver.setParameter(IloCP::LogVerbosity, IloCP::Terse);
+            // Set the number of parallel workers (default is one per core)
+            if (num_workers_ > 0)
+            {
+                solver.setParameter(IloCP::Workers, static_cast<IloInt>(num_workers_));
+            }
 
 #ifdef DCS_DEBUG
             detail::dump_cp_settings(solver);
@@ -874,20 +2066,75 @@ private:
             //solver.setParameter(IloCP::SearchType, IloCP::MultiPoint);
             //solver.setParameter(IloCP::BranchLimit, 10000);
 
+            // Start the search from the current VM allocation
+            IloSolution start(env);
+            if (warm_start_)
+            {
+                std::vector<bool> start_fn_power_states;
+                std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>> start_fn_vm_allocations;
+                detail::make_vm_allocation_start(hint_fn_power_states, hint_fn_vm_allocations, fixed_fns, svc_categories, svc_cat_vm_cat_min_num_vms, start_fn_power_states, start_fn_vm_allocations);
+                detail::order_vm_allocation_start(fn_sym_classes, fn_categories, vm_cat_fn_cat_cpu_specs, start_fn_power_states, start_fn_vm_allocations);
+
+                for (std::size_t i = 0; i < nfns; ++i)
+                {
+                    start.add(x[i]);
+                    start.setValue(x[i], IloInt(start_fn_power_states[i]));
+
+                    for (std::size_t j = 0; j < nsvcs; ++j)
+                    {
+                        for (std::size_t k = 0; k < nvmcats; ++k)
+                        {
+                            IloInt start_y = 0;
+                            if (start_fn_vm_allocations[i].count(j) > 0 && start_fn_vm_allocations[i].at(j).first == k)
+                            {
+                                start_y = start_fn_vm_allocations[i].at(j).second;
+                            }
+                            start.add(y[i][j][k]);
+                            start.setValue(y[i][j][k], start_y);
+                        }
+                    }
+                }
+
+                solver.setStartingPoint(start);
+            }
+
+            detail::solve_timer_t<RealT> timer;
+#ifdef DCS_FOG_VM_ALLOC_CP_HAS_CALLBACKS
+            detail::cp_incumbent_timer_callback_t<RealT> timer_callback(timer);
+            solver.addCallback(&timer_callback);
+#endif // DCS_FOG_VM_ALLOC_CP_HAS_CALLBACKS
+
             solver.propagate();
-            solution.solved = solver.solve();
+            {
+                // Let the search be aborted from another thread (e.g., by the portfolio solver)
+                detail::solve_interrupt_guard_t interrupt_guard([&solver]() { solver.abortSearch(); });
+
+                timer.start();
+                solution.solved = !detail::solve_interrupted() && solver.solve();
+                timer.stop();
+            }
             solution.optimal = false;
+            solution.solve_time = timer.solve_time();
+            solution.first_incumbent_time = timer.first_incumbent_time();
+
+#ifdef DCS_FOG_VM_ALLOC_CP_HAS_CALLBACKS
+            solver.removeCallback(&timer_callback);
+#endif // DCS_FOG_VM_ALLOC_CP_HAS_CALLBACKS
+
+            DCS_DEBUG_TRACE("- Solve time: " << solution.solve_time << ", time to first incumbent: " << solution.first_incumbent_time);
 
             IloAlgorithm::Status status = solver.getStatus();
             switch (status)
             {
                 case IloAlgorithm::Optimal: // The algorithm found an optimal solution.
                     solution.objective_value = static_cast<RealT>(solver.getObjValue());
+                    solution.gap = static_cast<RealT>(solver.getObjGap());
                     solution.optimal = true;
                     break;
                 case IloAlgorithm::Feasible: // The algorithm found a feasible solution, though it may not necessarily be optimal.
 
                     solution.objective_value = static_cast<RealT>(solver.getObjValue());
+                    solution.gap = static_cast<RealT>(solver.getObjGap());
                     dcs::log_warn(DCS_LOGGING_AT, "Optimization problem solved but non-optimal");
                     break;
                 case IloAlgorithm::Infeasible: // The algorithm proved the model infeasible (i.e., it is not possible to find an assignment of values to variables satisfying all the constraints in the model).
@@ -910,7 +2157,7 @@ private:
 
                     // If the problem was shown to be infeasible, find a minimal
                     // explanation for infeasibility
-                    if (solver.refineConflict())
+                    if (!detail::solve_interrupted() && solver.refineConflict())
                     {
                         dcs::log_warn(DCS_LOGGING_AT, "Conflict refinement:");
                         solver.writeConflict(DCS_LOGGING_STREAM);
@@ -1108,6 +2355,8 @@ private:
                                            const std::vector<bool>& fn_power_states, // The power status of each FN
                                            const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
                                            const std::set<std::size_t>& fixed_fns, // The set of selected FNs to use in the VM allocation (if empty, any FN can be used)
+                                           const std::vector<bool>& hint_fn_power_states, // The power status of each FN in the VM allocation from which to start the search
+                                           const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& hint_fn_vm_allocations, // The VM allocations, by FN and service, from which to start the search
                                            const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
                                            const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
                                            const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
@@ -1124,6 +2373,13 @@ private:
     {
         vm_allocation_t<RealT> solution;
 
+        // Classes of interchangeable FNs (if symmetries are to be broken)
+        std::vector<std::vector<std::size_t>> fn_sym_classes;
+        if (sym_break_)
+        {
+            fn_sym_classes = detail::make_fn_symmetry_classes(fn_categories, fn_power_states, fn_vm_allocations, fixed_fns);
+        }
+
         const std::size_t nfns = fn_categories.size();
         const std::size_t nsvcs = svc_categories.size();
         const std::size_t nvmcats = vm_cat_fn_cat_cpu_specs.size();
@@ -1400,6 +2656,14 @@ private:
             }
 */
 
+            // Break the symmetries among interchangeable FNs:
+            //  \forall a, b \in F, a and b consecutive interchangeable FNs: x_{a} \ge x_{b}, u_{a} \ge u_{b}
+            if (fn_sym_classes.size() > 0)
+            {
+                ++cc;
+                detail::add_fn_symmetry_breaking_constraints(model, x, u, fn_sym_classes, cc);
+            }
+
             // Constraints the value of x_{i} to force using a selected set of FNs:
             //   x_{i} = 1 if fixed_fns.count(i) > 0
             //   x_{i} = 0 if fixed_fns.count(i) == 0
@@ -1523,288 +2787,434 @@ private:
             solver.exportModel("opt_vm_alloc-cplex-model.lp");
 #endif // DCS_DEBUG
 
-            // Set Relative Optimality Tolerance to (rel_tol_*100)%: CP will stop as soon as it has found a feasible solution proved to be within (rel_tol_*100)% of optimal.
-            if (math::float_traits<RealT>::definitely_greater(rel_tol_, 0))
+            configure_cplex(solver);
+
+            // Start the search from the current VM allocation
+            if (warm_start_)
             {
-                //solver.setParam(IloCplex::EpGap, relative_gap);
-                solver.setParam(IloCplex::Param::MIP::Tolerances::MIPGap, rel_tol_);
+                add_cplex_warm_start(solver, x, y, hint_fn_power_states, hint_fn_vm_allocations, fixed_fns, fn_sym_classes, fn_categories, vm_cat_fn_cat_cpu_specs, svc_categories, svc_cat_vm_cat_min_num_vms);
             }
-            // Set Time Limit to limit the execution time of the search
-            if (math::float_traits<RealT>::definitely_greater(time_lim_, 0))
+
+            solve_cplex(solver, solution);
+
+            if (!extract_cplex_solution(solver, x, y, s, u, revenue_expr, cost_expr,
+                                        fn_categories,
+                                        fn_power_states,
+                                        fn_vm_allocations,
+                                        fn_cat_min_powers,
+                                        fn_cat_max_powers,
+                                        vm_cat_fn_cat_cpu_specs,
+                                        vm_cat_alloc_costs,
+                                        svc_categories,
+                                        svc_cat_vm_cat_min_num_vms,
+                                        fp_svc_cat_revenues,
+                                        fp_svc_cat_penalties,
+                                        fp_electricity_cost,
+                                        fp_fn_cat_asleep_costs,
+                                        fp_fn_cat_awake_costs,
+                                        deltat,
+                                        solution))
             {
-                solver.setParam(IloCplex::Param::TimeLimit, time_lim_);
+                return solution;
             }
-//            // Set the search log verbosity to 'terse' (default is 'normal') to
-//            // limit the amount of data written into the log file in case the
-//            // search takes very long
-//            solver.setParameter(IloCplex::Param::WriteLevel, IloCP::Terse);
+
+            revenue_expr.end();
+            cost_expr.end();
+            obj.end();
+            s.end();
+            u.end();
+            y.end();
+            x.end();
+
+            // Close the Concert Technology app
+            env.end();
+        }
+        catch (const IloException& e)
+        {
+            std::ostringstream oss;
+            oss << "Got exception from Cplex Optimizer: " << e.getMessage();
+            DCS_EXCEPTION_THROW(std::runtime_error, oss.str());
+        }
+        catch (...)
+        {
+            DCS_EXCEPTION_THROW(std::runtime_error,
+                                "Unexpected error during the optimization");
+        }
+
+        return solution;
+    }
+
+    vm_allocation_t<RealT> by_persistent_cplex(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                               const std::vector<bool>& fn_power_states, // The power status of each FN
+                                               const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                               const std::set<std::size_t>& fixed_fns, // The set of selected FNs to use in the VM allocation (if empty, any FN may be used)
+                                               const std::vector<bool>& hint_fn_power_states, // The power status of each FN in the VM allocation from which to start the search
+                                               const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& hint_fn_vm_allocations, // The VM allocations, by FN and service, from which to start the search
+                                               const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                               const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                               const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                               const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                               const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                               const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                               const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service category
+                                               const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service category
+                                               const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                               const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                               const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                               RealT deltat) const // Length of the time interval
+    {
+        vm_allocation_t<RealT> solution;
+
+        // Classes of interchangeable FNs (if symmetries are to be broken)
+        std::vector<std::vector<std::size_t>> fn_sym_classes;
+        if (sym_break_)
+        {
+            fn_sym_classes = detail::make_fn_symmetry_classes(fn_categories, fn_power_states, fn_vm_allocations, fixed_fns);
+        }
+
+        std::unique_ptr<detail::cplex_vm_allocation_model_t<RealT>> p_model;
+
+        try
+        {
+            p_model = acquire_cplex_model(fn_categories, vm_cat_fn_cat_cpu_specs, svc_categories);
+
+            p_model->update(fn_power_states,
+                            fn_vm_allocations,
+                            fixed_fns,
+                            fn_sym_classes,
+                            fn_cat_min_powers,
+                            fn_cat_max_powers,
+                            vm_cat_alloc_costs,
+                            svc_cat_vm_cat_min_num_vms,
+                            fp_svc_cat_revenues,
+                            fp_svc_cat_penalties,
+                            fp_electricity_cost,
+                            fp_fn_cat_asleep_costs,
+                            fp_fn_cat_awake_costs,
+                            deltat);
+
+            IloCplex& solver = p_model->cplex();
 
 #ifdef DCS_DEBUG
-            detail::dump_cplex_settings(solver);
+            solver.exportModel("opt_vm_alloc-cplex-persistent-model.lp");
 #endif // DCS_DEBUG
 
-#ifdef DCS_FOG_VM_ALLOC_CPLEX_MEMORY_EMPHASIS
-            solver.setParam(IloCplex::Param::Emphasis::Memory, 1);
-#endif // DCS_FOG_VM_ALLOC_CPLEX_MEMORY_EMPHASIS
-
-            solution.solved = solver.solve();
-            solution.optimal = false;
+            configure_cplex(solver);
 
-            IloAlgorithm::Status status = solver.getStatus();
-            switch (status)
+            // Start the search from the current VM allocation
+            if (warm_start_)
             {
-                case IloAlgorithm::Optimal: // The algorithm found an optimal solution.
-                    solution.objective_value = static_cast<RealT>(solver.getObjValue());
-                    solution.optimal = true;
-                    break;
-                case IloAlgorithm::Feasible: // The algorithm found a feasible solution, though it may not necessarily be optimal.
-
-                    solution.objective_value = static_cast<RealT>(solver.getObjValue());
-                    dcs::log_warn(DCS_LOGGING_AT, "Optimization problem solved but non-optimal");
-                    break;
-                case IloAlgorithm::Infeasible: // The algorithm proved the model infeasible (i.e., it is not possible to find an assignment of values to variables satisfying all the constraints in the model).
-                case IloAlgorithm::Unbounded: // The algorithm proved the model unbounded.
-                case IloAlgorithm::InfeasibleOrUnbounded: // The model is infeasible or unbounded.
-                case IloAlgorithm::Error: // An error occurred and, on platforms that support exceptions, that an exception has been thrown.
-                case IloAlgorithm::Unknown: // The algorithm has no information about the solution of the model.
-                {
-                    std::ostringstream oss;
-                    oss << "Optimization was stopped with status = " << status << " (CPLEX status = " << solver.getCplexStatus() << ", sub-status = " << solver.getCplexSubStatus() << ")";
-                    dcs::log_warn(DCS_LOGGING_AT, oss.str());
-
-                    return solution;
-                }
+                add_cplex_warm_start(solver, p_model->x(), p_model->y(), hint_fn_power_states, hint_fn_vm_allocations, fixed_fns, fn_sym_classes, fn_categories, vm_cat_fn_cat_cpu_specs, svc_categories, svc_cat_vm_cat_min_num_vms);
             }
 
-#ifdef DCS_DEBUG
-            DCS_DEBUG_TRACE( "-------------------------------------------------------------------------------[" );
-            DCS_DEBUG_TRACE( "- Objective value: " << solution.objective_value << " (revenue: " << solver.getValue(revenue_expr) << ", cost: " << solver.getValue(cost_expr) << ", deltat: " << deltat << ")");
+            solve_cplex(solver, solution);
+
+            extract_cplex_solution(solver, p_model->x(), p_model->y(), p_model->s(), p_model->u(), p_model->revenue_expr(), p_model->cost_expr(),
+                                   fn_categories,
+                                   fn_power_states,
+                                   fn_vm_allocations,
+                                   fn_cat_min_powers,
+                                   fn_cat_max_powers,
+                                   vm_cat_fn_cat_cpu_specs,
+                                   vm_cat_alloc_costs,
+                                   svc_categories,
+                                   svc_cat_vm_cat_min_num_vms,
+                                   fp_svc_cat_revenues,
+                                   fp_svc_cat_penalties,
+                                   fp_electricity_cost,
+                                   fp_fn_cat_asleep_costs,
+                                   fp_fn_cat_awake_costs,
+                                   deltat,
+                                   solution);
+
+            release_cplex_model(std::move(p_model));
+        }
+        catch (const IloException& e)
+        {
+            // The model may be left in an inconsistent state, so don't reuse it
+            std::ostringstream oss;
+            oss << "Got exception from Cplex Optimizer: " << e.getMessage();
+            DCS_EXCEPTION_THROW(std::runtime_error, oss.str());
+        }
+        catch (...)
+        {
+            DCS_EXCEPTION_THROW(std::runtime_error,
+                                "Unexpected error during the optimization");
+        }
 
-            DCS_DEBUG_TRACE( "- Decision variables: " );
+        return solution;
+    }
 
-            // Output x_{i}
-            for (std::size_t i = 0; i < nfns; ++i)
-            {
-                DCS_DEBUG_STREAM << x[i].getName() << " = " << solver.getValue(x[i]) << " (" << detail::to_IloBool(solver.getValue(x[i])) << ")" << std::endl;
-            }
+    /// Gets a CPLEX model for the given problem structure, either from the pool of persistent models or by building a new one
+    std::unique_ptr<detail::cplex_vm_allocation_model_t<RealT>> acquire_cplex_model(const std::vector<std::size_t>& fn_categories,
+                                                                                    const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs,
+                                                                                    const std::vector<std::size_t>& svc_categories) const
+    {
+        {
+            std::lock_guard<std::mutex> lock(cplex_models_mtx_);
 
-            // Output y_{i,j,k}
-            for (std::size_t i = 0; i < nfns; ++i)
+            for (auto it = cplex_models_.begin(); it != cplex_models_.end(); ++it)
             {
-                for (std::size_t j = 0; j < nsvcs; ++j)
+                if ((*it)->matches(fn_categories, vm_cat_fn_cat_cpu_specs, svc_categories))
                 {
-                    for (std::size_t k = 0; k < nvmcats; ++k)
-                    {
-                        DCS_DEBUG_STREAM << y[i][j][k].getName() << " = " << solver.getValue(y[i][j][k]) << " (" << detail::to_IloInt(solver.getValue(y[i][j][k])) << ")" << std::endl;
-                    }
+                    auto p_model = std::move(*it);
+                    cplex_models_.erase(it);
+                    return p_model;
                 }
             }
+        }
 
-            DCS_DEBUG_TRACE( "- Derived variables: " );
+        DCS_DEBUG_TRACE("Building a new persistent CPLEX model");
 
-            // Output u_{i}
-            for (std::size_t i = 0; i < nfns; ++i)
-            {
-                DCS_DEBUG_STREAM << u[i].getName() << " = " << solver.getValue(u[i]) << std::endl;
-            }
+        return std::unique_ptr<detail::cplex_vm_allocation_model_t<RealT>>(new detail::cplex_vm_allocation_model_t<RealT>(fn_categories, vm_cat_fn_cat_cpu_specs, svc_categories));
+    }
 
-            // Output s_{j}
-            for (std::size_t j = 0; j < nsvcs; ++j)
-            {
-                DCS_DEBUG_STREAM << s[j].getName() << " = " << solver.getValue(s[j]) << " (" << detail::to_IloBool(solver.getValue(s[j])) << ")" << std::endl;
-            }
+    /// Puts back a CPLEX model into the pool of persistent models (evicting the least recently used one if the pool is full)
+    void release_cplex_model(std::unique_ptr<detail::cplex_vm_allocation_model_t<RealT>> p_model) const
+    {
+        std::lock_guard<std::mutex> lock(cplex_models_mtx_);
 
-            // Output revenue
-            //DCS_DEBUG_STREAM << revenue_expr.getName() << " = " << solver.getValue(revenue_expr) << std::endl;
-            DCS_DEBUG_STREAM << "revenue = " << solver.getValue(revenue_expr) << std::endl;
+        if (cplex_models_.size() >= max_num_cplex_models)
+        {
+            cplex_models_.erase(cplex_models_.begin());
+        }
+        cplex_models_.push_back(std::move(p_model));
+    }
 
-            // Output cost
-            //DCS_DEBUG_STREAM << cost_expr.getName() << " = " << solver.getValue(cost_expr) << std::endl;
-            DCS_DEBUG_STREAM << "cost = " << solver.getValue(cost_expr) << std::endl;
+    /// Sets the parameters of CPLEX according to the options of this solver
+    void configure_cplex(IloCplex& solver) const
+    {
+        // Set Relative Optimality Tolerance to (rel_tol_*100)%: CP will stop as soon as it has found a feasible solution proved to be within (rel_tol_*100)% of optimal.
+        if (math::float_traits<RealT>::definitely_greater(rel_tol_, 0))
+        {
+            //solver.setParam(IloCplex::EpGap, relative_gap);
+            solver.setParam(IloCplex::Param::MIP::Tolerances::MIPGap, rel_tol_);
+        }
+        // Set Time Limit to limit the execution time of the search (capped by the time left before the deadline of the caller, if any)
+        auto const time_lim = detail::solve_time_limit(time_lim_);
+        if (math::float_traits<RealT>::definitely_greater(time_lim, 0))
+        {
+            solver.setParam(IloCplex::Param::TimeLimit, time_lim);
+        }
+        // Set the number of threads and the parallel mode
+        if (num_workers_ > 0)
+        {
+            solver.setParam(IloCplex::Param::Threads, static_cast<IloInt>(num_workers_));
+        }
+        if (deterministic_)
+        {
+            solver.setParam(IloCplex::Param::Parallel, IloCplex::Deterministic);
+        }
+//            // Set the search log verbosity to 'terse' (default is 'normal') to
+//            // limit the amount of data written into the log file in case the
+//            // search takes very long
+//            solver.setParameter(IloCplex::Param::WriteLevel, IloCP::Terse);
 
-            DCS_DEBUG_TRACE( "- Computed values: " );
+#ifdef DCS_DEBUG
+        detail::dump_cplex_settings(solver);
+#endif // DCS_DEBUG
 
-            {
-                // Output computed revenue (compare it with the value of the variable 'revenue')
-                RealT comp_revenue = 0;
-                for (std::size_t i = 0; i < nfns; ++i)
-                {
-                    for (std::size_t j = 0; j < nsvcs; ++j)
-                    {
-                        auto const svc_cat = svc_categories[j];
+#ifdef DCS_FOG_VM_ALLOC_CPLEX_MEMORY_EMPHASIS
+        solver.setParam(IloCplex::Param::Emphasis::Memory, 1);
+#endif // DCS_FOG_VM_ALLOC_CPLEX_MEMORY_EMPHASIS
+    }
 
-                        for (std::size_t k = 0; k < nvmcats; ++k)
-                        {
-                            comp_revenue += fp_svc_cat_revenues[svc_cat]*detail::to_IloInt(solver.getValue(y[i][j][k]));
-                        }
-                    }
-                }
-                DCS_DEBUG_STREAM << "Computed revenue = " << comp_revenue << std::endl;
+    /// Adds the current VM allocation as a MIP start (CPLEX fixes the values of 'x' and 'y' and solves for the remaining variables)
+    void add_cplex_warm_start(IloCplex& solver,
+                              const IloBoolVarArray& x,
+                              const IloArray<IloArray<IloIntVarArray>>& y,
+                              const std::vector<bool>& fn_power_states, // The power status of each FN
+                              const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                              const std::set<std::size_t>& fixed_fns, // The set of selected FNs to use in the VM allocation (if empty, any FN can be used)
+                              const std::vector<std::vector<std::size_t>>& fn_sym_classes, // Classes of interchangeable FNs whose symmetries are broken
+                              const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                              const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                              const std::vector<std::size_t>& svc_categories, // Maps every service to its service category
+                              const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms) const // The min number of VMs required to achieve QoS, by service category and VM category
+    {
+        const std::size_t nfns = fn_power_states.size();
+        const std::size_t nsvcs = svc_categories.size();
 
-                // Output computed cost (compare it with the value of the variable 'cost')
-                RealT comp_cost = 0;
-                // - Add elecricity costs
-                for (std::size_t i = 0; i < nfns; ++i)
-                {
-                    auto const fn_cat = fn_categories[i];
-                    auto const fn_power_state = fn_power_states[i];
-                    auto const dC = fn_cat_max_powers[fn_cat]-fn_cat_min_powers[fn_cat];
-                    auto const wcost = fp_electricity_cost;
+        std::vector<bool> start_fn_power_states;
+        std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>> start_fn_vm_allocations;
+        detail::make_vm_allocation_start(fn_power_states, fn_vm_allocations, fixed_fns, svc_categories, svc_cat_vm_cat_min_num_vms, start_fn_power_states, start_fn_vm_allocations);
+        detail::order_vm_allocation_start(fn_sym_classes, fn_categories, vm_cat_fn_cat_cpu_specs, start_fn_power_states, start_fn_vm_allocations);
 
-                    // Add elecricity consumption cost
-                    comp_cost += (detail::to_IloBool(solver.getValue(x[i]))*fn_cat_min_powers[fn_cat]+dC*solver.getValue(u[i]))*wcost;
+        IloEnv env = solver.getEnv();
+        IloNumVarArray start_vars(env);
+        IloNumArray start_vals(env);
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            start_vars.add(x[i]);
+            start_vals.add(IloInt(start_fn_power_states[i]));
 
-                    // Add switch-on/off costs
-                    comp_cost += detail::to_IloBool(solver.getValue(x[i]))*(1-fn_power_state)*fp_fn_cat_awake_costs[fn_cat]/deltat
-                              +  (1-detail::to_IloBool(solver.getValue(x[i])))*fn_power_state*fp_fn_cat_asleep_costs[fn_cat]/deltat;
-                }
-                // - Add VM (re)allocation costs
-                for (std::size_t i = 0; i < nfns; ++i)
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                const std::size_t nvmcats = y[i][j].getSize();
+
+                for (std::size_t k = 0; k < nvmcats; ++k)
                 {
-                    for (std::size_t j = 0; j < nsvcs; ++j)
+                    IloInt start_y = 0;
+                    if (start_fn_vm_allocations[i].count(j) > 0 && start_fn_vm_allocations[i].at(j).first == k)
                     {
-                        for (std::size_t k = 0; k < nvmcats; ++k)
-                        {
-                            IloInt old_y = 0;
-                            if (fn_vm_allocations[i].count(j) > 0 && fn_vm_allocations[i].at(j).first == k)
-                            {
-                                // This FN already hosted some VMs for service j
-                                old_y = fn_vm_allocations[i].at(j).second;
-                            }
-                            comp_cost += std::max(IloInt(0), detail::to_IloInt(solver.getValue(y[i][j][k])) - old_y)*vm_cat_alloc_costs[k]/deltat;
-                        }
+                        start_y = start_fn_vm_allocations[i].at(j).second;
                     }
+                    start_vars.add(y[i][j][k]);
+                    start_vals.add(start_y);
                 }
-                // - Add service penalties
-                for (std::size_t j = 0; j < nsvcs; ++j)
-                {
-                    auto const svc_cat = svc_categories[j];
+            }
+        }
 
-                    bool need_vms = true;
-                    for (std::size_t k = 0; k < nvmcats && need_vms; ++k)
-                    {
-                        if (svc_cat_vm_cat_min_num_vms[svc_cat][k] == 0)
-                        {
-                            need_vms = false;
-                        }
-                    }
-                    if (!need_vms)
-                    {
-                        continue;
-                    }
+        solver.addMIPStart(start_vars, start_vals, IloCplex::MIPStartSolveFixed, "warm_start");
 
-                    std::size_t left_term = 0;
+        start_vars.end();
+        start_vals.end();
+    }
 
-                    for (std::size_t k = 0; k < nvmcats; ++k)
-                    {
-                        std::size_t ysum_term = 0;
+    /// Runs CPLEX and records in the solution whether the problem has been solved and how long it took
+    void solve_cplex(IloCplex& solver, vm_allocation_t<RealT>& solution) const
+    {
+        detail::solve_timer_t<RealT> timer;
+        IloCplex::Callback timer_callback = solver.use(new (solver.getEnv()) detail::cplex_incumbent_timer_callback_t<RealT>(solver.getEnv(), timer));
+        IloCplex::Aborter aborter = solver.use(IloCplex::Aborter(solver.getEnv()));
+        detail::cplex_mip_start_check_t mip_start_check(solver);
 
-                        for (std::size_t i = 0; i < nfns; ++i)
-                        {
-                            ysum_term += detail::to_IloInt(solver.getValue(y[i][j][k]));
-                        }
+        {
+            // Let the search be aborted from another thread (e.g., by the portfolio solver)
+            detail::solve_interrupt_guard_t interrupt_guard([&aborter]() { aborter.abort(); });
 
-                        //left_term += (ysum_term > 0)*(ysum_term < svc_cat_vm_cat_min_num_vms[svc_cat][k]);
-                        left_term += ((ysum_term == 0) + (ysum_term == svc_cat_vm_cat_min_num_vms[svc_cat][k])) == 0;
-                    }
+            timer.start();
+            solution.solved = solver.solve();
+            timer.stop();
+        }
+        if (!aborter.isAborted() && !mip_start_check.accepted())
+        {
+            dcs::log_warn(DCS_LOGGING_AT, "CPLEX did not accept the warm start");
+        }
+        solution.optimal = false;
+        solution.solve_time = timer.solve_time();
+        solution.first_incumbent_time = timer.first_incumbent_time();
+        if (solution.solved && std::isnan(solution.first_incumbent_time))
+        {
+            // The informational callback is only invoked during branch-and-cut, so the problem has been solved before (e.g., by presolve)
+            solution.first_incumbent_time = solution.solve_time;
+        }
 
+        solver.remove(timer_callback);
+        solver.remove(aborter);
+        aborter.end();
 
-                    //cost_cost += ((s[t][j] == 0) || left_term)*fp_svc_cat_penalties[svc_cat]; // Don't work
-                    comp_cost += ((detail::to_IloBool(solver.getValue(s[j])) == 0) + left_term)*fp_svc_cat_penalties[svc_cat];
-                }
-                DCS_DEBUG_STREAM << "Computed cost = " << comp_cost << std::endl;
-                DCS_DEBUG_STREAM << "Computed objective value = " << (comp_revenue-comp_cost)*deltat << std::endl;
+        DCS_DEBUG_TRACE("- Solve time: " << solution.solve_time << ", time to first incumbent: " << solution.first_incumbent_time);
+    }
+
+    /// Reads the solution found by CPLEX (returns false if CPLEX has not found any solution)
+    bool extract_cplex_solution(IloCplex& solver,
+                                const IloBoolVarArray& x,
+                                const IloArray<IloArray<IloIntVarArray>>& y,
+                                const IloBoolVarArray& s,
+                                const IloNumVarArray& u,
+                                const IloNumExpr& revenue_expr,
+                                const IloNumExpr& cost_expr,
+                                const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                const std::vector<bool>& fn_power_states, // The power status of each FN
+                                const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                const std::vector<std::size_t>& svc_categories, // Maps every service to its service category
+                                const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service category
+                                const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service category
+                                const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                RealT deltat, // Length of the time interval
+                                vm_allocation_t<RealT>& solution) const
+    {
+        const std::size_t nfns = fn_categories.size();
+        const std::size_t nsvcs = svc_categories.size();
+        const std::size_t nvmcats = vm_cat_fn_cat_cpu_specs.size();
+
+        IloAlgorithm::Status status = solver.getStatus();
+        switch (status)
+        {
+            case IloAlgorithm::Optimal: // The algorithm found an optimal solution.
+                solution.objective_value = static_cast<RealT>(solver.getObjValue());
+                solution.gap = static_cast<RealT>(solver.getMIPRelativeGap());
+                solution.optimal = true;
+                break;
+            case IloAlgorithm::Feasible: // The algorithm found a feasible solution, though it may not necessarily be optimal.
+
+                solution.objective_value = static_cast<RealT>(solver.getObjValue());
+                solution.gap = static_cast<RealT>(solver.getMIPRelativeGap());
+                dcs::log_warn(DCS_LOGGING_AT, "Optimization problem solved but non-optimal");
+                break;
+            case IloAlgorithm::Infeasible: // The algorithm proved the model infeasible (i.e., it is not possible to find an assignment of values to variables satisfying all the constraints in the model).
+            case IloAlgorithm::Unbounded: // The algorithm proved the model unbounded.
+            case IloAlgorithm::InfeasibleOrUnbounded: // The model is infeasible or unbounded.
+            case IloAlgorithm::Error: // An error occurred and, on platforms that support exceptions, that an exception has been thrown.
+            case IloAlgorithm::Unknown: // The algorithm has no information about the solution of the model.
+            {
+                std::ostringstream oss;
+                oss << "Optimization was stopped with status = " << status << " (CPLEX status = " << solver.getCplexStatus() << ", sub-status = " << solver.getCplexSubStatus() << ")";
+                dcs::log_warn(DCS_LOGGING_AT, oss.str());
+
+                return false;
             }
+        }
 
-            DCS_DEBUG_TRACE( "]-------------------------------------------------------------------------------" );
-#endif // DCS_DEBUG
+#ifdef DCS_DEBUG
+        DCS_DEBUG_TRACE( "-------------------------------------------------------------------------------[" );
+        DCS_DEBUG_TRACE( "- Objective value: " << solution.objective_value << " (revenue: " << solver.getValue(revenue_expr) << ", cost: " << solver.getValue(cost_expr) << ", deltat: " << deltat << ")");
 
-            // Perform consistency checks
+        DCS_DEBUG_TRACE( "- Decision variables: " );
 
-            auto const check_tol = solver.getParam(IloCplex::Param::MIP::Tolerances::MIPGap);
-            auto const check_int_tol = solver.getParam(IloCplex::Param::MIP::Tolerances::Integrality);
+        // Output x_{i}
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            DCS_DEBUG_STREAM << x[i].getName() << " = " << solver.getValue(x[i]) << " (" << detail::to_IloBool(solver.getValue(x[i])) << ")" << std::endl;
+        }
 
-            // - Check 'x' variable consistency
-            for (std::size_t i = 0; i < nfns; ++i)
-            {
-DCS_DEBUG_TRACE( "x[" << i << "] - Value: " << solver.getValue(x[i]) << ", Converted: " << detail::to_IloBool(solver.getValue(x[i])) << ", tol: " << check_int_tol );
-#ifdef DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
-                DCS_ASSERT( dcs::math::float_traits<IloNum>::approximately_equal(solver.getValue(x[i]), detail::to_IloBool(solver.getValue(x[i])), check_int_tol),
-                            DCS_EXCEPTION_THROW( std::logic_error,
-                                                 "Anomaly in the CPLEX 'x' variable" ) );
-#else // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
-                if (!dcs::math::float_traits<IloNum>::approximately_equal(solver.getValue(x[i]), detail::to_IloBool(solver.getValue(x[i])), check_int_tol))
-                {
-                    std::ostringstream oss;
-                    oss << "Anomaly in the CPLEX 'x[" << i << "]' variable - value: " << solver.getValue(x[i]) << ", converted-value: " << detail::to_IloBool(solver.getValue(x[i])) << " (tol: " << check_int_tol << ")";
-                    dcs::log_warn(DCS_LOGGING_AT, oss.str());
-                }
-#endif // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
-            }
-            // - Check 'y' variable consistency
-            for (std::size_t i = 0; i < nfns; ++i)
-            {
-                for (std::size_t j = 0; j < nsvcs; ++j)
-                {
-                    for (std::size_t k = 0; k < nvmcats; ++k)
-                    {
-#ifdef DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
-                        DCS_ASSERT( dcs::math::float_traits<IloNum>::approximately_equal(solver.getValue(y[i][j][k]), detail::to_IloInt(solver.getValue(y[i][j][k])), check_int_tol),
-                                    DCS_EXCEPTION_THROW( std::logic_error,
-                                                         "Anomaly in the CPLEX 'y' variable" ) );
-#else // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
-                        if (!dcs::math::float_traits<IloNum>::approximately_equal(solver.getValue(y[i][j][k]), detail::to_IloInt(solver.getValue(y[i][j][k])), check_int_tol))
-                        {
-                            std::ostringstream oss;
-                            oss << "Anomaly in the CPLEX 'y[" << i << "][" << j << "][" << k << "]' variable - value: " << solver.getValue(y[i][j][k]) << ", converted-value: " << detail::to_IloBool(solver.getValue(y[i][j][k])) << " (tol: " << check_int_tol << ")";
-                            dcs::log_warn(DCS_LOGGING_AT, oss.str());
-                        }
-#endif // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
-                    }
-                }
-            }
-            // - Check 's' variable consistency
+        // Output y_{i,j,k}
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
             for (std::size_t j = 0; j < nsvcs; ++j)
             {
-#ifdef DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
-                DCS_ASSERT( dcs::math::float_traits<IloNum>::approximately_equal(solver.getValue(s[j]), detail::to_IloBool(solver.getValue(s[j])), check_int_tol),
-                            DCS_EXCEPTION_THROW( std::logic_error,
-                                                 "Anomaly in the CPLEX 's' variable" ) );
-#else // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
-                if (!dcs::math::float_traits<IloNum>::approximately_equal(solver.getValue(s[j]), detail::to_IloBool(solver.getValue(s[j])), check_int_tol))
-                {
-                    std::ostringstream oss;
-                    oss << "Anomaly in the CPLEX 's[" << j << "]' variable - value: " << solver.getValue(s[j]) << ", converted-value: " << detail::to_IloBool(solver.getValue(s[j])) << " (tol: " << check_int_tol << ")";
-                    dcs::log_warn(DCS_LOGGING_AT, oss.str());
-                }
-#endif // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
-            }
-            // - Check objective value consistency
-#ifdef DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
-            DCS_ASSERT( dcs::math::float_traits<IloNum>::approximately_equal(solver.getObjValue(), (solver.getValue(revenue_expr)-solver.getValue(cost_expr))*deltat, check_tol),
-                        DCS_EXCEPTION_THROW( std::logic_error,
-                                             "Anomaly in th CPLEX solution: objective value does not match with the difference of revenues and costs" ) );
-#else // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
-            if (!dcs::math::float_traits<IloNum>::approximately_equal(solver.getObjValue(), (solver.getValue(revenue_expr)-solver.getValue(cost_expr))*deltat, check_tol))
-            {
-                std::ostringstream oss;
-                oss << "Anomaly in the CPLEX solution - objective value and the difference between revenue and costs do not match - objective value: " << solver.getObjValue() << ", difference: " << (solver.getValue(revenue_expr)-solver.getValue(cost_expr))*deltat << " (tol: " << check_tol << ")";
-                dcs::log_warn(DCS_LOGGING_AT, oss.str());
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    DCS_DEBUG_STREAM << y[i][j][k].getName() << " = " << solver.getValue(y[i][j][k]) << " (" << detail::to_IloInt(solver.getValue(y[i][j][k])) << ")" << std::endl;
+                }
             }
-#endif // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
+        }
 
-            // Fill the solution object
+        DCS_DEBUG_TRACE( "- Derived variables: " );
 
-            solution.fn_vm_allocations.resize(nfns);
-            solution.fn_cpu_allocations.resize(nfns);
-            solution.fn_power_states.resize(nfns, 0);
-            solution.profit = solution.objective_value;
-#if 1
-            solution.cost = solver.getValue(cost_expr)*deltat;
-            solution.revenue = solver.getValue(revenue_expr)*deltat;
-#else
-            // Computed revenue and cost from decision variables instead of getting thei values from the related CPLEX expressions
-            solution.revenue = 0;
+        // Output u_{i}
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            DCS_DEBUG_STREAM << u[i].getName() << " = " << solver.getValue(u[i]) << std::endl;
+        }
+
+        // Output s_{j}
+        for (std::size_t j = 0; j < nsvcs; ++j)
+        {
+            DCS_DEBUG_STREAM << s[j].getName() << " = " << solver.getValue(s[j]) << " (" << detail::to_IloBool(solver.getValue(s[j])) << ")" << std::endl;
+        }
+
+        // Output revenue
+        //DCS_DEBUG_STREAM << revenue_expr.getName() << " = " << solver.getValue(revenue_expr) << std::endl;
+        DCS_DEBUG_STREAM << "revenue = " << solver.getValue(revenue_expr) << std::endl;
+
+        // Output cost
+        //DCS_DEBUG_STREAM << cost_expr.getName() << " = " << solver.getValue(cost_expr) << std::endl;
+        DCS_DEBUG_STREAM << "cost = " << solver.getValue(cost_expr) << std::endl;
+
+        DCS_DEBUG_TRACE( "- Computed values: " );
+
+        {
+            // Output computed revenue (compare it with the value of the variable 'revenue')
+            RealT comp_revenue = 0;
             for (std::size_t i = 0; i < nfns; ++i)
             {
                 for (std::size_t j = 0; j < nsvcs; ++j)
@@ -1813,12 +3223,14 @@ DCS_DEBUG_TRACE( "x[" << i << "] - Value: " << solver.getValue(x[i]) << ", Conve
 
                     for (std::size_t k = 0; k < nvmcats; ++k)
                     {
-                        solution.revenue += fp_svc_cat_revenues[svc_cat]*detail::to_IloInt(solver.getValue(y[i][j][k]));
+                        comp_revenue += fp_svc_cat_revenues[svc_cat]*detail::to_IloInt(solver.getValue(y[i][j][k]));
                     }
                 }
             }
-            solution.revenue *= deltat;
-            solution.cost = 0;
+            DCS_DEBUG_STREAM << "Computed revenue = " << comp_revenue << std::endl;
+
+            // Output computed cost (compare it with the value of the variable 'cost')
+            RealT comp_cost = 0;
             // - Add elecricity costs
             for (std::size_t i = 0; i < nfns; ++i)
             {
@@ -1828,11 +3240,11 @@ DCS_DEBUG_TRACE( "x[" << i << "] - Value: " << solver.getValue(x[i]) << ", Conve
                 auto const wcost = fp_electricity_cost;
 
                 // Add elecricity consumption cost
-                solution.cost += (detail::to_IloBool(solver.getValue(x[i]))*fn_cat_min_powers[fn_cat]+dC*solver.getValue(u[i]))*wcost;
+                comp_cost += (detail::to_IloBool(solver.getValue(x[i]))*fn_cat_min_powers[fn_cat]+dC*solver.getValue(u[i]))*wcost;
 
                 // Add switch-on/off costs
-                solution.cost += detail::to_IloBool(solver.getValue(x[i]))*(1-fn_power_state)*fp_fn_cat_awake_costs[fn_cat]/deltat
-                              +  (1-detail::to_IloBool(solver.getValue(x[i])))*fn_power_state*fp_fn_cat_asleep_costs[fn_cat]/deltat;
+                comp_cost += detail::to_IloBool(solver.getValue(x[i]))*(1-fn_power_state)*fp_fn_cat_awake_costs[fn_cat]/deltat
+                          +  (1-detail::to_IloBool(solver.getValue(x[i])))*fn_power_state*fp_fn_cat_asleep_costs[fn_cat]/deltat;
             }
             // - Add VM (re)allocation costs
             for (std::size_t i = 0; i < nfns; ++i)
@@ -1847,7 +3259,7 @@ DCS_DEBUG_TRACE( "x[" << i << "] - Value: " << solver.getValue(x[i]) << ", Conve
                             // This FN already hosted some VMs for service j
                             old_y = fn_vm_allocations[i].at(j).second;
                         }
-                        solution.cost += std::max(IloInt(0), detail::to_IloInt(solver.getValue(y[i][j][k])) - old_y)*vm_cat_alloc_costs[k]/deltat;
+                        comp_cost += std::max(IloInt(0), detail::to_IloInt(solver.getValue(y[i][j][k])) - old_y)*vm_cat_alloc_costs[k]/deltat;
                     }
                 }
             }
@@ -1856,6 +3268,19 @@ DCS_DEBUG_TRACE( "x[" << i << "] - Value: " << solver.getValue(x[i]) << ", Conve
             {
                 auto const svc_cat = svc_categories[j];
 
+                bool need_vms = true;
+                for (std::size_t k = 0; k < nvmcats && need_vms; ++k)
+                {
+                    if (svc_cat_vm_cat_min_num_vms[svc_cat][k] == 0)
+                    {
+                        need_vms = false;
+                    }
+                }
+                if (!need_vms)
+                {
+                    continue;
+                }
+
                 std::size_t left_term = 0;
 
                 for (std::size_t k = 0; k < nvmcats; ++k)
@@ -1872,79 +3297,238 @@ DCS_DEBUG_TRACE( "x[" << i << "] - Value: " << solver.getValue(x[i]) << ", Conve
                 }
 
 
-                //solution.cost += ((s[t][j] == 0) || left_term)*fp_svc_cat_penalties[svc_cat]; // Don't work
-                solution.cost += ((detail::to_IloBool(solver.getValue(s[j])) == 0) + left_term)*fp_svc_cat_penalties[svc_cat];
+                //cost_cost += ((s[t][j] == 0) || left_term)*fp_svc_cat_penalties[svc_cat]; // Don't work
+                comp_cost += ((detail::to_IloBool(solver.getValue(s[j])) == 0) + left_term)*fp_svc_cat_penalties[svc_cat];
             }
-            solution.cost *= deltat;
-#endif
-            //solution.watts = 0;
-            for (std::size_t i = 0; i < nfns; ++i)
-            {
-                //const std::size_t fn = fns[i];
+            DCS_DEBUG_STREAM << "Computed cost = " << comp_cost << std::endl;
+            DCS_DEBUG_STREAM << "Computed objective value = " << (comp_revenue-comp_cost)*deltat << std::endl;
+        }
 
-                solution.fn_power_states[i] = detail::to_IloBool(solver.getValue(x[i]));
-//                solution.fn_vm_allocations[i].resize(nvms);
-                for (std::size_t j = 0; j < nsvcs; ++j)
-                {
-                    //const std::size_t vm = vms[j];
+        DCS_DEBUG_TRACE( "]-------------------------------------------------------------------------------" );
+#else
+        DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( fn_power_states );
+        DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( fn_vm_allocations );
+        DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( fn_cat_min_powers );
+        DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( fn_cat_max_powers );
+        DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( vm_cat_alloc_costs );
+        DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( svc_cat_vm_cat_min_num_vms );
+        DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( fp_svc_cat_revenues );
+        DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( fp_svc_cat_penalties );
+        DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( fp_electricity_cost );
+        DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( fp_fn_cat_asleep_costs );
+        DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( fp_fn_cat_awake_costs );
+#endif // DCS_DEBUG
 
-                    for (std::size_t k = 0; k < nvmcats; ++k)
+        // Perform consistency checks
+
+        auto const check_tol = solver.getParam(IloCplex::Param::MIP::Tolerances::MIPGap);
+        auto const check_int_tol = solver.getParam(IloCplex::Param::MIP::Tolerances::Integrality);
+
+        // - Check 'x' variable consistency
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+DCS_DEBUG_TRACE( "x[" << i << "] - Value: " << solver.getValue(x[i]) << ", Converted: " << detail::to_IloBool(solver.getValue(x[i])) << ", tol: " << check_int_tol );
+#ifdef DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
+            DCS_ASSERT( dcs::math::float_traits<IloNum>::approximately_equal(solver.getValue(x[i]), detail::to_IloBool(solver.getValue(x[i])), check_int_tol),
+                        DCS_EXCEPTION_THROW( std::logic_error,
+                                             "Anomaly in the CPLEX 'x' variable" ) );
+#else // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
+            if (!dcs::math::float_traits<IloNum>::approximately_equal(solver.getValue(x[i]), detail::to_IloBool(solver.getValue(x[i])), check_int_tol))
+            {
+                std::ostringstream oss;
+                oss << "Anomaly in the CPLEX 'x[" << i << "]' variable - value: " << solver.getValue(x[i]) << ", converted-value: " << detail::to_IloBool(solver.getValue(x[i])) << " (tol: " << check_int_tol << ")";
+                dcs::log_warn(DCS_LOGGING_AT, oss.str());
+            }
+#endif // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
+        }
+        // - Check 'y' variable consistency
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+#ifdef DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
+                    DCS_ASSERT( dcs::math::float_traits<IloNum>::approximately_equal(solver.getValue(y[i][j][k]), detail::to_IloInt(solver.getValue(y[i][j][k])), check_int_tol),
+                                DCS_EXCEPTION_THROW( std::logic_error,
+                                                     "Anomaly in the CPLEX 'y' variable" ) );
+#else // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
+                    if (!dcs::math::float_traits<IloNum>::approximately_equal(solver.getValue(y[i][j][k]), detail::to_IloInt(solver.getValue(y[i][j][k])), check_int_tol))
                     {
-                        auto const num_vms = detail::to_IloInt(solver.getValue(y[i][j][k]));
-                        if (num_vms > 0)
-                        {
-                            solution.fn_vm_allocations[i][j] = std::make_pair(k, static_cast<std::size_t>(num_vms));
-                        }
+                        std::ostringstream oss;
+                        oss << "Anomaly in the CPLEX 'y[" << i << "][" << j << "][" << k << "]' variable - value: " << solver.getValue(y[i][j][k]) << ", converted-value: " << detail::to_IloBool(solver.getValue(y[i][j][k])) << " (tol: " << check_int_tol << ")";
+                        dcs::log_warn(DCS_LOGGING_AT, oss.str());
                     }
+#endif // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
                 }
-                //solution.fn_cpu_allocations[i] = solver.getValue(u[i]);
-                solution.fn_cpu_allocations[i] = dcs::math::roundp(solver.getValue(u[i]), std::log10(1.0/solver.getParam(IloCplex::Param::MIP::Tolerances::MIPGap)));
             }
-
-            // Consistency check: <obj value> == (<revenue> - <cost>)*deltat
+        }
+        // - Check 's' variable consistency
+        for (std::size_t j = 0; j < nsvcs; ++j)
+        {
 #ifdef DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
-            DCS_ASSERT( dcs::math::float_traits<RealT>::approximately_equal(solution.objective_value, (solution.revenue-solution.cost)*deltat, check_tol),
+            DCS_ASSERT( dcs::math::float_traits<IloNum>::approximately_equal(solver.getValue(s[j]), detail::to_IloBool(solver.getValue(s[j])), check_int_tol),
                         DCS_EXCEPTION_THROW( std::logic_error,
-                                             "Anomaly in CPLEX solution: objective value does not match with the difference of revenues and costs" ) );
+                                             "Anomaly in the CPLEX 's' variable" ) );
 #else // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
-            if (!dcs::math::float_traits<RealT>::approximately_equal(solution.objective_value, (solution.revenue-solution.cost)*deltat, check_tol))
+            if (!dcs::math::float_traits<IloNum>::approximately_equal(solver.getValue(s[j]), detail::to_IloBool(solver.getValue(s[j])), check_int_tol))
             {
                 std::ostringstream oss;
-                oss << "Anomaly in the CPLEX solution - objective value and the difference between revenue and costs do not match - objective value: " << solution.objective_value << ", difference: " << (solution.revenue-solution.cost)*deltat << " (tol: " << check_tol << ")";
+                oss << "Anomaly in the CPLEX 's[" << j << "]' variable - value: " << solver.getValue(s[j]) << ", converted-value: " << detail::to_IloBool(solver.getValue(s[j])) << " (tol: " << check_int_tol << ")";
                 dcs::log_warn(DCS_LOGGING_AT, oss.str());
             }
 #endif // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
+        }
+        // - Check objective value consistency
+#ifdef DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
+        DCS_ASSERT( dcs::math::float_traits<IloNum>::approximately_equal(solver.getObjValue(), (solver.getValue(revenue_expr)-solver.getValue(cost_expr))*deltat, check_tol),
+                    DCS_EXCEPTION_THROW( std::logic_error,
+                                         "Anomaly in th CPLEX solution: objective value does not match with the difference of revenues and costs" ) );
+#else // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
+        if (!dcs::math::float_traits<IloNum>::approximately_equal(solver.getObjValue(), (solver.getValue(revenue_expr)-solver.getValue(cost_expr))*deltat, check_tol))
+        {
+            std::ostringstream oss;
+            oss << "Anomaly in the CPLEX solution - objective value and the difference between revenue and costs do not match - objective value: " << solver.getObjValue() << ", difference: " << (solver.getValue(revenue_expr)-solver.getValue(cost_expr))*deltat << " (tol: " << check_tol << ")";
+            dcs::log_warn(DCS_LOGGING_AT, oss.str());
+        }
+#endif // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
 
-            revenue_expr.end();
-            cost_expr.end();
-            obj.end();
-            s.end();
-            u.end();
-            y.end();
-            x.end();
+        // Fill the solution object
 
-            // Close the Concert Technology app
-            env.end();
+        solution.fn_vm_allocations.resize(nfns);
+        solution.fn_cpu_allocations.resize(nfns);
+        solution.fn_power_states.resize(nfns, 0);
+        solution.profit = solution.objective_value;
+#if 1
+        solution.cost = solver.getValue(cost_expr)*deltat;
+        solution.revenue = solver.getValue(revenue_expr)*deltat;
+#else
+        // Computed revenue and cost from decision variables instead of getting thei values from the related CPLEX expressions
+        solution.revenue = 0;
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                auto const svc_cat = svc_categories[j];
+
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    solution.revenue += fp_svc_cat_revenues[svc_cat]*detail::to_IloInt(solver.getValue(y[i][j][k]));
+                }
+            }
         }
-        catch (const IloException& e)
+        solution.revenue *= deltat;
+        solution.cost = 0;
+        // - Add elecricity costs
+        for (std::size_t i = 0; i < nfns; ++i)
         {
-            std::ostringstream oss;
-            oss << "Got exception from Cplex Optimizer: " << e.getMessage();
-            DCS_EXCEPTION_THROW(std::runtime_error, oss.str());
+            auto const fn_cat = fn_categories[i];
+            auto const fn_power_state = fn_power_states[i];
+            auto const dC = fn_cat_max_powers[fn_cat]-fn_cat_min_powers[fn_cat];
+            auto const wcost = fp_electricity_cost;
+
+            // Add elecricity consumption cost
+            solution.cost += (detail::to_IloBool(solver.getValue(x[i]))*fn_cat_min_powers[fn_cat]+dC*solver.getValue(u[i]))*wcost;
+
+            // Add switch-on/off costs
+            solution.cost += detail::to_IloBool(solver.getValue(x[i]))*(1-fn_power_state)*fp_fn_cat_awake_costs[fn_cat]/deltat
+                          +  (1-detail::to_IloBool(solver.getValue(x[i])))*fn_power_state*fp_fn_cat_asleep_costs[fn_cat]/deltat;
         }
-        catch (...)
+        // - Add VM (re)allocation costs
+        for (std::size_t i = 0; i < nfns; ++i)
         {
-            DCS_EXCEPTION_THROW(std::runtime_error,
-                                "Unexpected error during the optimization");
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    IloInt old_y = 0;
+                    if (fn_vm_allocations[i].count(j) > 0 && fn_vm_allocations[i].at(j).first == k)
+                    {
+                        // This FN already hosted some VMs for service j
+                        old_y = fn_vm_allocations[i].at(j).second;
+                    }
+                    solution.cost += std::max(IloInt(0), detail::to_IloInt(solver.getValue(y[i][j][k])) - old_y)*vm_cat_alloc_costs[k]/deltat;
+                }
+            }
         }
+        // - Add service penalties
+        for (std::size_t j = 0; j < nsvcs; ++j)
+        {
+            auto const svc_cat = svc_categories[j];
 
-        return solution;
+            std::size_t left_term = 0;
+
+            for (std::size_t k = 0; k < nvmcats; ++k)
+            {
+                std::size_t ysum_term = 0;
+
+                for (std::size_t i = 0; i < nfns; ++i)
+                {
+                    ysum_term += detail::to_IloInt(solver.getValue(y[i][j][k]));
+                }
+
+                //left_term += (ysum_term > 0)*(ysum_term < svc_cat_vm_cat_min_num_vms[svc_cat][k]);
+                left_term += ((ysum_term == 0) + (ysum_term == svc_cat_vm_cat_min_num_vms[svc_cat][k])) == 0;
+            }
+
+
+            //solution.cost += ((s[t][j] == 0) || left_term)*fp_svc_cat_penalties[svc_cat]; // Don't work
+            solution.cost += ((detail::to_IloBool(solver.getValue(s[j])) == 0) + left_term)*fp_svc_cat_penalties[svc_cat];
+        }
+        solution.cost *= deltat;
+#endif
+        //solution.watts = 0;
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            //const std::size_t fn = fns[i];
+
+            solution.fn_power_states[i] = detail::to_IloBool(solver.getValue(x[i]));
+//                solution.fn_vm_allocations[i].resize(nvms);
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                //const std::size_t vm = vms[j];
+
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    auto const num_vms = detail::to_IloInt(solver.getValue(y[i][j][k]));
+                    if (num_vms > 0)
+                    {
+                        solution.fn_vm_allocations[i][j] = std::make_pair(k, static_cast<std::size_t>(num_vms));
+                    }
+                }
+            }
+            //solution.fn_cpu_allocations[i] = solver.getValue(u[i]);
+            solution.fn_cpu_allocations[i] = dcs::math::roundp(solver.getValue(u[i]), std::log10(1.0/solver.getParam(IloCplex::Param::MIP::Tolerances::MIPGap)));
+        }
+
+        // Consistency check: <obj value> == (<revenue> - <cost>)*deltat
+#ifdef DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
+        DCS_ASSERT( dcs::math::float_traits<RealT>::approximately_equal(solution.objective_value, (solution.revenue-solution.cost)*deltat, check_tol),
+                    DCS_EXCEPTION_THROW( std::logic_error,
+                                         "Anomaly in CPLEX solution: objective value does not match with the difference of revenues and costs" ) );
+#else // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
+        if (!dcs::math::float_traits<RealT>::approximately_equal(solution.objective_value, (solution.revenue-solution.cost)*deltat, check_tol))
+        {
+            std::ostringstream oss;
+            oss << "Anomaly in the CPLEX solution - objective value and the difference between revenue and costs do not match - objective value: " << solution.objective_value << ", difference: " << (solution.revenue-solution.cost)*deltat << " (tol: " << check_tol << ")";
+            dcs::log_warn(DCS_LOGGING_AT, oss.str());
+        }
+#endif // DCS_FOG_VM_ALLOC_ABORT_ON_ANOMALY
+
+        return true;
     }
 
 
 private:
     RealT rel_tol_; ///< Relative optimality tolerance used to define optimality (a solution is considered optimal if there does not exist a solution with a better objective function with respect to a relative optimality tolerance).
     RealT time_lim_; ///< Time limit (in seconds) used to set the maximum time the optimizare can spend in search for the best solution.
+    bool warm_start_; ///< Tells whether the search starts from the current VM allocation (i.e., the solution of the previous interval).
+    bool persistent_model_; ///< Tells whether the optimization model is kept alive across calls to solve (CPLEX only).
+    bool sym_break_; ///< Tells whether the symmetries among interchangeable FNs are broken by means of additional constraints.
+    std::size_t num_workers_; ///< Number of parallel workers used by the solver (0 means the solver default).
+    bool deterministic_; ///< Tells whether the parallel search must be deterministic.
+    mutable std::mutex cplex_models_mtx_; ///< Guards the pool of persistent CPLEX models, which is shared by the simulation replicas run in parallel
+    mutable std::vector<std::unique_ptr<detail::cplex_vm_allocation_model_t<RealT>>> cplex_models_; ///< Pool of persistent CPLEX models, from the least to the most recently used
 }; // optimal_vm_alllocation_solver
 
 
@@ -1956,9 +3540,13 @@ class optimal_multislot_vm_allocation_solver_t: public base_multislot_vm_allocat
 {
 public:
     explicit optimal_multislot_vm_allocation_solver_t(RealT relative_tolerance = 0,
-                                                      RealT time_limit = -1)
+                                                      RealT time_limit = -1,
+                                                      bool linear_switch_costs = false)
     : rel_tol_(relative_tolerance),
-      time_lim_(time_limit)
+      time_lim_(time_limit),
+      lin_switch_(linear_switch_costs),
+      num_workers_(0),
+      deterministic_(false)
     {
     }
 
@@ -1982,6 +3570,59 @@ public:
         return time_lim_;
     }
 
+    /**
+     * \brief Tells whether the switch-on/off costs of FNs must be modeled by
+     *  means of explicit switch variables.
+     *
+     * By default, the switch-on/off costs between consecutive time slots are
+     * modeled as products of the power-state variables of FNs, which turn the
+     * model into a quadratic one. When this option is set, the model uses
+     * on/off switch variables linked to power-state variables by linear
+     * constraints, so that the model stays a linear one.
+     * This option is only supported by the CPLEX solver.
+     */
+    void linear_switch_costs(bool value)
+    {
+        lin_switch_ = value;
+    }
+
+    bool linear_switch_costs() const
+    {
+        return lin_switch_;
+    }
+
+    /**
+     * \brief Sets the number of parallel workers used by the solver (0 means
+     *  the solver default, that is usually one per core).
+     */
+    void num_workers(std::size_t value)
+    {
+        num_workers_ = value;
+    }
+
+    std::size_t num_workers() const
+    {
+        return num_workers_;
+    }
+
+    /**
+     * \brief Tells whether the parallel search must be deterministic, that is
+     *  whether repeated runs must give the same result regardless of thread
+     *  scheduling.
+     *
+     * This option is only meaningful for the CPLEX solver (CP Optimizer only
+     * supports the number of workers).
+     */
+    void deterministic(bool value)
+    {
+        deterministic_ = value;
+    }
+
+    bool deterministic() const
+    {
+        return deterministic_;
+    }
+
 
     multislot_vm_allocation_t<RealT> solve(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
                                            const std::vector<bool>& fn_power_states, // The power status of each FN
@@ -2021,6 +3662,9 @@ public:
         DCS_DEBUG_TRACE("- Length of the time interval: " << deltat);
         DCS_DEBUG_TRACE("- Relative Tolerance: " << rel_tol_);
         DCS_DEBUG_TRACE("- Time Limit: " << time_lim_);
+        DCS_DEBUG_TRACE("- Linear Switch Costs: " << lin_switch_);
+        DCS_DEBUG_TRACE("- Number of Workers: " << num_workers_);
+        DCS_DEBUG_TRACE("- Deterministic: " << deterministic_);
 
 #if defined(DCS_FOG_VM_ALLOC_USE_CPLEX_SOLVER)
         return by_native_cplex(fn_categories,
@@ -2103,6 +3747,9 @@ public:
         DCS_DEBUG_TRACE("- Length of the time interval: " << deltat);
         DCS_DEBUG_TRACE("- Relative Tolerance: " << rel_tol_);
         DCS_DEBUG_TRACE("- Time Limit: " << time_lim_);
+        DCS_DEBUG_TRACE("- Linear Switch Costs: " << lin_switch_);
+        DCS_DEBUG_TRACE("- Number of Workers: " << num_workers_);
+        DCS_DEBUG_TRACE("- Deterministic: " << deterministic_);
 
 #if defined(DCS_FOG_VM_ALLOC_USE_CPLEX_SOLVER)
         return by_native_cplex(fn_categories,
@@ -2682,16 +4329,22 @@ private:
                 //solver.setParam(IloCplex::Param::MIP::Tolerances::MIPGap, rel_tol_);
                 solver.setParameter(IloCP::RelativeOptimalityTolerance, rel_tol_);
             }
-            // Set Time Limit to limit the execution time of the search
-            if (math::float_traits<RealT>::definitely_greater(time_lim_, 0))
+            // Set Time Limit to limit the execution time of the search (capped by the time left before the deadline of the caller, if any)
+            auto const time_lim = detail::solve_time_limit(time_lim_);
+            if (math::float_traits<RealT>::definitely_greater(time_lim, 0))
             {
                 //solver.setParam(IloCplex::Param::TimeLimit, time_lim_);
-                solver.setParameter(IloCP::TimeLimit, time_lim_);
+                solver.setParameter(IloCP::TimeLimit, time_lim);
             }
             // Set the search log verbosity to 'terse' (default is 'normal') to
             // limit the amount of data written into the log file in case the
             // search takes very long
             solver.setParameter(IloCP::LogVerbosity, IloCP::Terse);
+            // Set the number of parallel workers (default is one per core)
+            if (num_workers_ > 0)
+            {
+                solver.setParameter(IloCP::Workers, static_cast<IloInt>(num_workers_));
+            }
 
 #ifdef DCS_DEBUG
             detail::dump_cp_settings(solver);
@@ -2708,20 +4361,32 @@ private:
             //solver.setParameter(IloCP::SearchType, IloCP::MultiPoint);
             //solver.setParameter(IloCP::BranchLimit, 10000);
 
+            detail::solve_timer_t<RealT> timer;
+
             solver.propagate();
-            solution.solved = solver.solve();
+            {
+                // Let the search be aborted from another thread (e.g., by the portfolio solver)
+                detail::solve_interrupt_guard_t interrupt_guard([&solver]() { solver.abortSearch(); });
+
+                timer.start();
+                solution.solved = !detail::solve_interrupted() && solver.solve();
+                timer.stop();
+            }
             solution.optimal = false;
+            solution.solve_time = timer.solve_time();
 
             IloAlgorithm::Status status = solver.getStatus();
             switch (status)
             {
                 case IloAlgorithm::Optimal: // The algorithm found an optimal solution.
                     solution.objective_value = static_cast<RealT>(solver.getObjValue());
+                    solution.gap = static_cast<RealT>(solver.getObjGap());
                     solution.optimal = true;
                     break;
                 case IloAlgorithm::Feasible: // The algorithm found a feasible solution, though it may not necessarily be optimal.
 
                     solution.objective_value = static_cast<RealT>(solver.getObjValue());
+                    solution.gap = static_cast<RealT>(solver.getObjGap());
                     dcs::log_warn(DCS_LOGGING_AT, "Optimization problem solved but non-optimal");
                     break;
                 case IloAlgorithm::Infeasible: // The algorithm proved the model infeasible (i.e., it is not possible to find an assignment of values to variables satisfying all the constraints in the model).
@@ -2744,7 +4409,7 @@ private:
 
                     // If the problem was shown to be infeasible, find a minimal
                     // explanation for infeasibility
-                    if (solver.refineConflict())
+                    if (!detail::solve_interrupted() && solver.refineConflict())
                     {
                         dcs::log_warn(DCS_LOGGING_AT, "Conflict refinement:");
                         solver.writeConflict(DCS_LOGGING_STREAM);
@@ -3092,6 +4757,31 @@ private:
                 }
             }
 
+            // Auxiliary variables w^{on}_{t,i} \in \{0,1\} and w^{off}_{t,i} \in \{0,1\}: 1 if, at time slot t, FN i is switched on (off, respectively), 0 otherwise.
+            // These variables are only used by the linearized model.
+            IloArray<IloBoolVarArray> w_on(env, nslots);
+            IloArray<IloBoolVarArray> w_off(env, nslots);
+            if (lin_switch_)
+            {
+                for (std::size_t t = 0; t < nslots; ++t)
+                {
+                    w_on[t] = IloBoolVarArray(env, nfns);
+                    w_off[t] = IloBoolVarArray(env, nfns);
+                    for (std::size_t i = 0; i < nfns; ++i)
+                    {
+                        std::ostringstream oss;
+                        oss << "w_on[" << t << "][" << i << "]";
+                        w_on[t][i] = IloBoolVar(env, oss.str().c_str());
+                        model.add(w_on[t][i]);
+
+                        oss.str("");
+                        oss << "w_off[" << t << "][" << i << "]";
+                        w_off[t][i] = IloBoolVar(env, oss.str().c_str());
+                        model.add(w_off[t][i]);
+                    }
+                }
+            }
+
             // Constraints
 
             std::size_t cc = 0; // Constraint counter
@@ -3301,6 +4991,49 @@ private:
             }
 */
 
+            // Link the switch variables to the power states of FNs (only for the linearized model):
+            //  \forall t \in T, i \in F: x_{t,i} - x_{t-1,i} = w^{on}_{t,i} - w^{off}_{t,i}
+            //  \forall t \in T, i \in F: w^{on}_{t,i} + w^{off}_{t,i} \le 1
+            // where x_{-1,i} is the current power state of FN i.
+            if (lin_switch_)
+            {
+                ++cc;
+                for (std::size_t t = 0; t < nslots; ++t)
+                {
+                    for (std::size_t i = 0; i < nfns; ++i)
+                    {
+                        std::ostringstream oss;
+                        oss << "C" << cc << "_{" << t << "," << i << "}";
+
+                        IloConstraint cons;
+                        if (t > 0)
+                        {
+                            cons = (x[t][i] - x[t-1][i] == w_on[t][i] - w_off[t][i]);
+                        }
+                        else
+                        {
+                            cons = (x[0][i] - IloInt(fn_power_states[i]) == w_on[0][i] - w_off[0][i]);
+                        }
+                        cons.setName(oss.str().c_str());
+                        model.add(cons);
+                    }
+                }
+
+                ++cc;
+                for (std::size_t t = 0; t < nslots; ++t)
+                {
+                    for (std::size_t i = 0; i < nfns; ++i)
+                    {
+                        std::ostringstream oss;
+                        oss << "C" << cc << "_{" << t << "," << i << "}";
+
+                        IloConstraint cons(w_on[t][i] + w_off[t][i] <= 1);
+                        cons.setName(oss.str().c_str());
+                        model.add(cons);
+                    }
+                }
+            }
+
             // Constraints the value of x_{t,i} to force using a selected set of FNs:
             //   x_{t,i} = 1 if fixed_fns.count(i) > 0
             //   x_{t,i} = 0 if fixed_fns.count(i) == 0
@@ -3365,7 +5098,12 @@ private:
                         cost_expr += (x[t][i]*fn_cat_min_powers[fn_cat]+dC*u[t][i])*wcost;
 
                         // Add switch-on/off costs
-                        if (t > 0)
+                        if (lin_switch_)
+                        {
+                            cost_expr += w_on[t][i]*fp_fn_cat_awake_costs[fn_cat]/deltat
+                                      +  w_off[t][i]*fp_fn_cat_asleep_costs[fn_cat]/deltat;
+                        }
+                        else if (t > 0)
                         {
                             cost_expr += x[t][i]*(1-x[t-1][i])*fp_fn_cat_awake_costs[fn_cat]/deltat
                                       +  (1-x[t][i])*x[t-1][i]*fp_fn_cat_asleep_costs[fn_cat]/deltat;
@@ -3466,10 +5204,20 @@ private:
                 //solver.setParam(IloCplex::EpGap, relative_gap);
                 solver.setParam(IloCplex::Param::MIP::Tolerances::MIPGap, rel_tol_);
             }
-            // Set Time Limit to limit the execution time of the search
-            if (math::float_traits<RealT>::definitely_greater(time_lim_, 0))
+            // Set Time Limit to limit the execution time of the search (capped by the time left before the deadline of the caller, if any)
+            auto const time_lim = detail::solve_time_limit(time_lim_);
+            if (math::float_traits<RealT>::definitely_greater(time_lim, 0))
+            {
+                solver.setParam(IloCplex::Param::TimeLimit, time_lim);
+            }
+            // Set the number of threads and the parallel mode
+            if (num_workers_ > 0)
+            {
+                solver.setParam(IloCplex::Param::Threads, static_cast<IloInt>(num_workers_));
+            }
+            if (deterministic_)
             {
-                solver.setParam(IloCplex::Param::TimeLimit, time_lim_);
+                solver.setParam(IloCplex::Param::Parallel, IloCplex::Deterministic);
             }
 //            // Set the search log verbosity to 'terse' (default is 'normal') to
 //            // limit the amount of data written into the log file in case the
@@ -3484,19 +5232,32 @@ private:
             solver.setParam(IloCplex::Param::Emphasis::Memory, 1);
 #endif // DCS_FOG_VM_ALLOC_CPLEX_MEMORY_EMPHASIS
 
-            solution.solved = solver.solve();
+            detail::solve_timer_t<RealT> timer;
+            IloCplex::Aborter aborter = solver.use(IloCplex::Aborter(env));
+
+            {
+                // Let the search be aborted from another thread (e.g., by the portfolio solver)
+                detail::solve_interrupt_guard_t interrupt_guard([&aborter]() { aborter.abort(); });
+
+                timer.start();
+                solution.solved = solver.solve();
+                timer.stop();
+            }
             solution.optimal = false;
+            solution.solve_time = timer.solve_time();
 
             IloAlgorithm::Status status = solver.getStatus();
             switch (status)
             {
                 case IloAlgorithm::Optimal: // The algorithm found an optimal solution.
                     solution.objective_value = static_cast<RealT>(solver.getObjValue());
+                    solution.gap = static_cast<RealT>(solver.getMIPRelativeGap());
                     solution.optimal = true;
                     break;
                 case IloAlgorithm::Feasible: // The algorithm found a feasible solution, though it may not necessarily be optimal.
 
                     solution.objective_value = static_cast<RealT>(solver.getObjValue());
+                    solution.gap = static_cast<RealT>(solver.getMIPRelativeGap());
                     dcs::log_warn(DCS_LOGGING_AT, "Optimization problem solved but non-optimal");
                     break;
                 case IloAlgorithm::Infeasible: // The algorithm proved the model infeasible (i.e., it is not possible to find an assignment of values to variables satisfying all the constraints in the model).
@@ -3947,6 +5708,8 @@ private:
             revenue_expr.end();
             cost_expr.end();
             obj.end();
+            w_off.end();
+            w_on.end();
             s.end();
             u.end();
             y.end();
@@ -3989,6 +5752,9 @@ private:
 private:
     RealT rel_tol_; ///< Relative optimality tolerance used to define optimality (a solution is considered optimal if there does not exist a solution with a better objective function with respect to a relative optimality tolerance).
     RealT time_lim_; ///< Time limit (in seconds) used to set the maximum time the optimizare can spend in search for the best solution.
+    bool lin_switch_; ///< Tells whether the switch-on/off costs are modeled by means of linear constraints on switch variables.
+    std::size_t num_workers_; ///< Number of parallel workers used by the solver (0 means the solver default).
+    bool deterministic_; ///< Tells whether the parallel search must be deterministic.
 }; // optimal_multislot_vm_allocation_solver_t
 
 }} // Namespace dcs::fog
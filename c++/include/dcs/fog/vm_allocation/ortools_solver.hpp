@@ -0,0 +1,873 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fog/vm_allocation/ortools_solver.hpp
+ *
+ * \brief Solvers for the VM allocation problem based on the OR-Tools linear
+ *  solver wrapper (e.g., CBC, SCIP, HiGHS or CP-SAT).
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FOG_VM_ALLOCATION_ORTOOLS_SOLVER_HPP
+#define DCS_FOG_VM_ALLOCATION_ORTOOLS_SOLVER_HPP
+
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/fog/io.hpp>
+#include <dcs/fog/vm_allocation/commons.hpp>
+#include <dcs/logging.hpp>
+#include <dcs/math/traits/float.hpp>
+#include <limits>
+#include <map>
+#include <memory>
+#include <ortools/linear_solver/linear_solver.h>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace dcs { namespace fog {
+
+namespace detail {
+
+/**
+ * \brief Solves the multi-slot VM allocation problem by means of the OR-Tools
+ *  linear solver wrapper.
+ *
+ * The model is a linear reformulation of the one solved by the optimal
+ * solvers:
+ * - v_{t,j,k} \in \{0,1\} tells whether service j uses class-k VMs in slot t,
+ *   so that VMs of a service belong to the same class;
+ * - a_{t,j,k} \in \{0,1\} tells whether service j gets all the class-k VMs it
+ *   requires in slot t, so that the service penalty is paid when
+ *   \sum_{k} a_{t,j,k} = 0;
+ * - r_{t,i,j,k} \ge y_{t,i,j,k} - y_{t-1,i,j,k} counts the VMs (re)allocated
+ *   on FN i in slot t;
+ * - w^{on}_{t,i} \ge x_{t,i} - x_{t-1,i} and w^{off}_{t,i} \ge x_{t-1,i} - x_{t,i}
+ *   account for switch-on/off costs.
+ * .
+ * The revenue and the cost of the resulting VM allocation are then recomputed
+ * by \c eval_multislot_vm_allocation.
+ */
+template <typename RealT>
+multislot_vm_allocation_t<RealT> solve_ortools_vm_allocation(const std::string& solver_id, // The OR-Tools solver to use (e.g., "CBC", "SCIP", "HIGHS", "CP-SAT")
+                                                             RealT rel_tol, // Relative optimality tolerance (0 means the solver default)
+                                                             RealT time_lim, // Time limit in seconds (a non-positive value means no limit)
+                                                             std::size_t num_workers, // Number of search workers (0 means the solver default)
+                                                             bool deterministic, // Tells whether the parallel search must be deterministic (CP-SAT only)
+                                                             const std::string& solver_params, // Solver-specific parameters, in the format of the underlying solver (e.g., a SatParameters text proto for CP-SAT)
+                                                             const std::vector<std::set<std::size_t>>& fixed_fns, // For each time slot, the set of selected FNs to use for the VM allocation (if in a given time slot the set is empty, any FN can be used)
+                                                             const std::vector<bool>& hint_fn_power_states, // The power status of each FN in the VM allocation of the first time slot from which to start the search (if empty, no hint is given)
+                                                             const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& hint_fn_vm_allocations, // The VM allocations of the first time slot from which to start the search, by FN and service
+                                                             const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                             const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                             const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                             const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                             const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                             const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                             const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                             const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                             const std::vector<std::vector<std::vector<std::size_t>>>& slot_svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by time slot, service category and VM category
+                                                             const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service category
+                                                             const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service category
+                                                             const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                             const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                             const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                             RealT deltat, // Length of the time interval
+                                                             RealT& solve_time) // Wall-clock time (in seconds) taken by the solver
+{
+    namespace ort = operations_research;
+
+    const std::size_t nslots = slot_svc_cat_vm_cat_min_num_vms.size();
+    const std::size_t nfns = fn_categories.size();
+    const std::size_t nsvcs = svc_categories.size();
+    const std::size_t nvmcats = vm_cat_fn_cat_cpu_specs.size();
+
+    DCS_ASSERT( nfns == fn_power_states.size(),
+                DCS_EXCEPTION_THROW( std::logic_error,
+                                     "FN power states container has a wrong size" ) );
+
+    DCS_ASSERT( nfns == fn_vm_allocations.size(),
+                DCS_EXCEPTION_THROW( std::logic_error,
+                                     "FN VM allocations container has a wrong size" ) );
+
+    DCS_ASSERT( nslots == fixed_fns.size(),
+                DCS_EXCEPTION_THROW( std::logic_error,
+                                     "Fixed FNs container has a wrong size" ) );
+
+    multislot_vm_allocation_t<RealT> solution;
+
+    solve_time = std::numeric_limits<RealT>::quiet_NaN();
+
+    std::unique_ptr<ort::MPSolver> p_solver(ort::MPSolver::CreateSolver(solver_id));
+    if (!p_solver)
+    {
+        DCS_EXCEPTION_THROW(std::invalid_argument, "OR-Tools solver '" + solver_id + "' is not available");
+    }
+
+    auto const inf = ort::MPSolver::infinity();
+
+    // Decision Variables
+
+    std::vector<std::vector<ort::MPVariable*>> x(nslots, std::vector<ort::MPVariable*>(nfns)); // x_{t,i} \in \{0,1\}: 1 if FN i is to be powered on in slot t
+    std::vector<std::vector<std::vector<std::vector<ort::MPVariable*>>>> y(nslots, std::vector<std::vector<std::vector<ort::MPVariable*>>>(nfns, std::vector<std::vector<ort::MPVariable*>>(nsvcs, std::vector<ort::MPVariable*>(nvmcats)))); // y_{t,i,j,k} \in \mathbb{N}: the number of class-k VMs allocated on FN i for service j in slot t
+    std::vector<std::vector<std::vector<ort::MPVariable*>>> v(nslots, std::vector<std::vector<ort::MPVariable*>>(nsvcs, std::vector<ort::MPVariable*>(nvmcats))); // v_{t,j,k} \in \{0,1\}: 1 if service j uses class-k VMs in slot t
+    std::vector<std::vector<std::vector<ort::MPVariable*>>> a(nslots, std::vector<std::vector<ort::MPVariable*>>(nsvcs, std::vector<ort::MPVariable*>(nvmcats))); // a_{t,j,k} \in \{0,1\}: 1 if service j gets all the class-k VMs it requires in slot t
+    for (std::size_t t = 0; t < nslots; ++t)
+    {
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            double lb = 0;
+            double ub = 1;
+            if (fixed_fns[t].size() > 0)
+            {
+                lb = ub = (fixed_fns[t].count(i) > 0) ? 1 : 0;
+            }
+
+            std::ostringstream oss;
+            oss << "x[" << t << "][" << i << "]";
+            x[t][i] = p_solver->MakeIntVar(lb, ub, oss.str());
+
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                auto const svc_cat = svc_categories[j];
+
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    oss.str("");
+                    oss << "y[" << t << "][" << i << "][" << j << "][" << k << "]";
+                    y[t][i][j][k] = p_solver->MakeIntVar(0, slot_svc_cat_vm_cat_min_num_vms[t][svc_cat][k], oss.str());
+                }
+            }
+        }
+        for (std::size_t j = 0; j < nsvcs; ++j)
+        {
+            for (std::size_t k = 0; k < nvmcats; ++k)
+            {
+                std::ostringstream oss;
+                oss << "v[" << t << "][" << j << "][" << k << "]";
+                v[t][j][k] = p_solver->MakeBoolVar(oss.str());
+
+                oss.str("");
+                oss << "a[" << t << "][" << j << "][" << k << "]";
+                a[t][j][k] = p_solver->MakeBoolVar(oss.str());
+            }
+        }
+    }
+
+    // Constraints and objective
+
+    ort::MPObjective* const p_obj = p_solver->MutableObjective();
+    double obj_offset = 0;
+
+    std::size_t cc = 0; // Constraint counter
+
+    for (std::size_t t = 0; t < nslots; ++t)
+    {
+        auto const& svc_cat_vm_cat_min_num_vms = slot_svc_cat_vm_cat_min_num_vms[t];
+
+        // VMs allocated for a given service must belong to the same class
+        //  \forall j \in S: \sum_{k \in C} v_{t,j,k} \le 1
+        ++cc;
+        for (std::size_t j = 0; j < nsvcs; ++j)
+        {
+            std::ostringstream oss;
+            oss << "C" << cc << "_{" << t << "," << j << "}";
+
+            ort::MPConstraint* const p_cons = p_solver->MakeRowConstraint(-inf, 1, oss.str());
+            for (std::size_t k = 0; k < nvmcats; ++k)
+            {
+                p_cons->SetCoefficient(v[t][j][k], 1);
+            }
+        }
+
+        // Don't allocate useless VMs and only allocate VMs of the selected class
+        //  \forall j \in S, k \in C: \sum_{i \in F} y_{t,i,j,k} - N_{t,j,k} v_{t,j,k} \le 0
+        // A service gets all the VMs it requires only if they are actually allocated
+        //  \forall j \in S, k \in C: \sum_{i \in F} y_{t,i,j,k} - N_{t,j,k} a_{t,j,k} \ge 0
+        cc += 2;
+        for (std::size_t j = 0; j < nsvcs; ++j)
+        {
+            auto const svc_cat = svc_categories[j];
+
+            for (std::size_t k = 0; k < nvmcats; ++k)
+            {
+                std::ostringstream oss;
+                oss << "C" << (cc-1) << "_{" << t << "," << j << "," << k << "}";
+
+                ort::MPConstraint* const p_cons_v = p_solver->MakeRowConstraint(-inf, 0, oss.str());
+
+                oss.str("");
+                oss << "C" << cc << "_{" << t << "," << j << "," << k << "}";
+
+                ort::MPConstraint* const p_cons_a = p_solver->MakeRowConstraint(0, inf, oss.str());
+
+                for (std::size_t i = 0; i < nfns; ++i)
+                {
+                    p_cons_v->SetCoefficient(y[t][i][j][k], 1);
+                    p_cons_a->SetCoefficient(y[t][i][j][k], 1);
+                }
+                p_cons_v->SetCoefficient(v[t][j][k], -static_cast<double>(svc_cat_vm_cat_min_num_vms[svc_cat][k]));
+                p_cons_a->SetCoefficient(a[t][j][k], -static_cast<double>(svc_cat_vm_cat_min_num_vms[svc_cat][k]));
+            }
+        }
+
+        // The total allocated capacity on a powered-on FN must not exceed the max capacity
+        //  \forall i \in F: \sum_{j \in S} \sum_{k \in C} y_{t,i,j,k} C_{i,k} - x_{t,i} \le 0
+        ++cc;
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            auto const fn_cat = fn_categories[i];
+
+            std::ostringstream oss;
+            oss << "C" << cc << "_{" << t << "," << i << "}";
+
+            ort::MPConstraint* const p_cons = p_solver->MakeRowConstraint(-inf, 0, oss.str());
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    p_cons->SetCoefficient(y[t][i][j][k], vm_cat_fn_cat_cpu_specs[k][fn_cat]);
+                }
+            }
+            p_cons->SetCoefficient(x[t][i], -1);
+        }
+
+        // Switch-on/off and VM (re)allocation costs
+        //  \forall i \in F: w^{on}_{t,i} - x_{t,i} + x_{t-1,i} \ge 0, w^{off}_{t,i} + x_{t,i} - x_{t-1,i} \ge 0
+        //  \forall i \in F, j \in S, k \in C: r_{t,i,j,k} - y_{t,i,j,k} + y_{t-1,i,j,k} \ge 0
+        cc += 2;
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            auto const fn_cat = fn_categories[i];
+
+            std::ostringstream oss;
+            oss << "w_on[" << t << "][" << i << "]";
+            ort::MPVariable* const p_w_on = p_solver->MakeNumVar(0, 1, oss.str());
+
+            oss.str("");
+            oss << "w_off[" << t << "][" << i << "]";
+            ort::MPVariable* const p_w_off = p_solver->MakeNumVar(0, 1, oss.str());
+
+            oss.str("");
+            oss << "C" << (cc-1) << "_{" << t << "," << i << "}";
+
+            // Since x_{-1,i} is a constant, it is moved to the bounds
+            const double prev_x = (t > 0) ? 0 : static_cast<double>(fn_power_states[i]);
+
+            ort::MPConstraint* const p_cons_on = p_solver->MakeRowConstraint(-prev_x, inf, oss.str());
+            p_cons_on->SetCoefficient(p_w_on, 1);
+            p_cons_on->SetCoefficient(x[t][i], -1);
+
+            oss.str("");
+            oss << "C" << (cc-1) << "_{" << t << "," << i << "}^{off}";
+
+            ort::MPConstraint* const p_cons_off = p_solver->MakeRowConstraint(prev_x, inf, oss.str());
+            p_cons_off->SetCoefficient(p_w_off, 1);
+            p_cons_off->SetCoefficient(x[t][i], 1);
+
+            if (t > 0)
+            {
+                p_cons_on->SetCoefficient(x[t-1][i], 1);
+                p_cons_off->SetCoefficient(x[t-1][i], -1);
+            }
+
+            p_obj->SetCoefficient(p_w_on, -fp_fn_cat_awake_costs[fn_cat]);
+            p_obj->SetCoefficient(p_w_off, -fp_fn_cat_asleep_costs[fn_cat]);
+
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    oss.str("");
+                    oss << "r[" << t << "][" << i << "][" << j << "][" << k << "]";
+                    ort::MPVariable* const p_r = p_solver->MakeNumVar(0, inf, oss.str());
+
+                    // Since y_{-1,i,j,k} is a constant, it is moved to the bounds
+                    double prev_y = 0;
+                    if (t == 0 && fn_vm_allocations[i].count(j) > 0 && fn_vm_allocations[i].at(j).first == k)
+                    {
+                        prev_y = fn_vm_allocations[i].at(j).second;
+                    }
+
+                    oss.str("");
+                    oss << "C" << cc << "_{" << t << "," << i << "," << j << "," << k << "}";
+
+                    ort::MPConstraint* const p_cons = p_solver->MakeRowConstraint(-prev_y, inf, oss.str());
+                    p_cons->SetCoefficient(p_r, 1);
+                    p_cons->SetCoefficient(y[t][i][j][k], -1);
+                    if (t > 0)
+                    {
+                        p_cons->SetCoefficient(y[t-1][i][j][k], 1);
+                    }
+
+                    p_obj->SetCoefficient(p_r, -vm_cat_alloc_costs[k]);
+                }
+            }
+        }
+
+        // Revenues and electricity consumption costs
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            auto const fn_cat = fn_categories[i];
+            auto const dC = fn_cat_max_powers[fn_cat]-fn_cat_min_powers[fn_cat];
+
+            p_obj->SetCoefficient(x[t][i], -fn_cat_min_powers[fn_cat]*fp_electricity_cost*deltat);
+
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                auto const svc_cat = svc_categories[j];
+
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    p_obj->SetCoefficient(y[t][i][j][k], (fp_svc_cat_revenues[svc_cat]-vm_cat_fn_cat_cpu_specs[k][fn_cat]*dC*fp_electricity_cost)*deltat);
+                }
+            }
+        }
+
+        // Service penalties
+        for (std::size_t j = 0; j < nsvcs; ++j)
+        {
+            auto const svc_cat = svc_categories[j];
+            auto const& min_num_vms = svc_cat_vm_cat_min_num_vms[svc_cat];
+
+            if (std::find(min_num_vms.begin(), min_num_vms.end(), 0) != min_num_vms.end())
+            {
+                continue;
+            }
+
+            obj_offset -= fp_svc_cat_penalties[svc_cat]*deltat;
+            for (std::size_t k = 0; k < nvmcats; ++k)
+            {
+                p_obj->SetCoefficient(a[t][j][k], fp_svc_cat_penalties[svc_cat]*deltat);
+            }
+        }
+    }
+
+    p_obj->SetOffset(obj_offset);
+    p_obj->SetMaximization();
+
+    // Configure and run the solver
+
+    ort::MPSolverParameters params;
+    if (math::float_traits<RealT>::definitely_greater(rel_tol, 0))
+    {
+        params.SetDoubleParam(ort::MPSolverParameters::RELATIVE_MIP_GAP, rel_tol);
+    }
+    // Cap the time limit by the time left before the deadline of the caller, if any
+    time_lim = solve_time_limit(time_lim);
+    if (math::float_traits<RealT>::definitely_greater(time_lim, 0))
+    {
+        p_solver->set_time_limit(static_cast<std::int64_t>(time_lim*1000));
+    }
+    const bool sat_backend = p_solver->ProblemType() == ort::MPSolver::SAT_INTEGER_PROGRAMMING;
+    std::string specific_params = solver_params;
+    if (sat_backend)
+    {
+        // Through MPSolver, CP-SAT does not necessarily get its default
+        // number of search workers (one per core), so the number of workers
+        // is set in its SatParameters, unless the given parameters already
+        // set it.
+        if (solver_params.find("num_workers") == std::string::npos)
+        {
+            const std::size_t sat_num_workers = num_workers > 0 ? num_workers : std::max(std::thread::hardware_concurrency(), 1U);
+            specific_params = "num_workers:" + std::to_string(sat_num_workers) + " " + specific_params;
+        }
+    }
+    else if (num_workers > 0 && !p_solver->SetNumThreads(static_cast<int>(num_workers)).ok())
+    {
+        dcs::log_warn(DCS_LOGGING_AT, "OR-Tools solver '" + solver_id + "' does not support multiple workers");
+    }
+    if (deterministic && sat_backend)
+    {
+        // CP-SAT runs a portfolio of search workers (LNS, core-based,
+        // feasibility jump, ...) that exchange bounds and solutions in an
+        // order that depends on thread scheduling, unless the search is
+        // interleaved.
+        // Note, the other backends are driven single-threaded or are
+        // deterministic by default.
+        specific_params = "interleave_search:true " + specific_params;
+    }
+    if (!specific_params.empty() && !p_solver->SetSolverSpecificParametersAsString(specific_params))
+    {
+        DCS_EXCEPTION_THROW(std::invalid_argument,
+                            "Invalid parameters '" + specific_params + "' for OR-Tools solver '" + solver_id + "'");
+    }
+#ifndef DCS_DEBUG
+    p_solver->SuppressOutput();
+#else // DCS_DEBUG
+    p_solver->EnableOutput();
+#endif // DCS_DEBUG
+
+    // Start the search from the given VM allocation of the first time slot
+    if (!hint_fn_power_states.empty())
+    {
+        std::vector<bool> start_fn_power_states;
+        std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>> start_fn_vm_allocations;
+        make_vm_allocation_start(hint_fn_power_states, hint_fn_vm_allocations, fixed_fns.front(), svc_categories, slot_svc_cat_vm_cat_min_num_vms.front(), start_fn_power_states, start_fn_vm_allocations);
+
+        std::vector<std::pair<const ort::MPVariable*,double>> hint;
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            hint.emplace_back(x[0][i], start_fn_power_states[i] ? 1 : 0);
+
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    std::size_t start_y = 0;
+                    if (start_fn_vm_allocations[i].count(j) > 0 && start_fn_vm_allocations[i].at(j).first == k)
+                    {
+                        start_y = start_fn_vm_allocations[i].at(j).second;
+                    }
+                    hint.emplace_back(y[0][i][j][k], start_y);
+                }
+            }
+        }
+        p_solver->SetHint(hint);
+    }
+
+    auto const start_time = std::chrono::steady_clock::now();
+    auto status = ort::MPSolver::NOT_SOLVED;
+    {
+        // Let the search be aborted from another thread (e.g., by the portfolio solver)
+        detail::solve_interrupt_guard_t interrupt_guard([&p_solver]() { p_solver->InterruptSolve(); });
+
+        if (!detail::solve_interrupted())
+        {
+            status = p_solver->Solve(params);
+        }
+    }
+    solve_time = std::chrono::duration_cast<std::chrono::duration<RealT>>(std::chrono::steady_clock::now()-start_time).count();
+
+    DCS_DEBUG_TRACE("- Solve time: " << solve_time);
+
+    switch (status)
+    {
+        case ort::MPSolver::OPTIMAL:
+            solution.solved = solution.optimal = true;
+            break;
+        case ort::MPSolver::FEASIBLE:
+            solution.solved = true;
+            dcs::log_warn(DCS_LOGGING_AT, "Optimization problem solved but non-optimal");
+            break;
+        default:
+        {
+            std::ostringstream oss;
+            oss << "Optimization was stopped with status = " << status;
+            dcs::log_warn(DCS_LOGGING_AT, oss.str());
+
+            return solution;
+        }
+    }
+
+    DCS_DEBUG_TRACE( "- Objective value: " << p_obj->Value() << ", best bound: " << p_obj->BestBound() );
+
+    // Relative gap, computed as in CPLEX
+    solution.gap = static_cast<RealT>(std::abs(p_obj->BestBound()-p_obj->Value())/(1e-10+std::abs(p_obj->Value())));
+    solution.solve_time = solve_time;
+
+    solution.fn_power_states.resize(nslots);
+    solution.fn_vm_allocations.resize(nslots);
+    solution.fn_cpu_allocations.resize(nslots);
+    for (std::size_t t = 0; t < nslots; ++t)
+    {
+        solution.fn_power_states[t].resize(nfns, false);
+        solution.fn_vm_allocations[t].resize(nfns);
+        solution.fn_cpu_allocations[t].resize(nfns, 0);
+
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            auto const fn_cat = fn_categories[i];
+
+            solution.fn_power_states[t][i] = std::lround(x[t][i]->solution_value()) != 0;
+
+            for (std::size_t j = 0; j < nsvcs; ++j)
+            {
+                for (std::size_t k = 0; k < nvmcats; ++k)
+                {
+                    auto const num_vms = std::lround(y[t][i][j][k]->solution_value());
+                    if (num_vms > 0)
+                    {
+                        solution.fn_vm_allocations[t][i][j] = std::make_pair(k, static_cast<std::size_t>(num_vms));
+                        solution.fn_cpu_allocations[t][i] += num_vms*vm_cat_fn_cat_cpu_specs[k][fn_cat];
+                    }
+                }
+            }
+        }
+    }
+
+    eval_multislot_vm_allocation(fn_categories,
+                                 fn_power_states,
+                                 fn_vm_allocations,
+                                 fn_cat_min_powers,
+                                 fn_cat_max_powers,
+                                 vm_cat_alloc_costs,
+                                 svc_categories,
+                                 slot_svc_cat_vm_cat_min_num_vms,
+                                 fp_svc_cat_revenues,
+                                 fp_svc_cat_penalties,
+                                 fp_electricity_cost,
+                                 fp_fn_cat_asleep_costs,
+                                 fp_fn_cat_awake_costs,
+                                 deltat,
+                                 solution);
+
+    return solution;
+}
+
+} // Namespace detail
+
+
+/**
+ * \brief Solver for the VM allocation problem based on the OR-Tools linear
+ *  solver wrapper.
+ *
+ * The same VM allocation problem solved by \c optimal_vm_allocation_solver_t
+ * is solved by means of any of the (possibly open-source) MILP solvers
+ * available through OR-Tools, like CBC, SCIP, HiGHS or CP-SAT.
+ */
+template <typename RealT>
+class ortools_vm_allocation_solver_t: public base_vm_allocation_solver_t<RealT>
+{
+public:
+    explicit ortools_vm_allocation_solver_t(const std::string& solver_id = "CBC",
+                                            RealT relative_tolerance = 0,
+                                            RealT time_limit = -1,
+                                            std::size_t num_workers = 0,
+                                            bool deterministic = false,
+                                            const std::string& solver_params = "")
+    : solver_id_(solver_id),
+      rel_tol_(relative_tolerance),
+      time_lim_(time_limit),
+      num_workers_(num_workers),
+      deterministic_(deterministic),
+      solver_params_(solver_params)
+    {
+    }
+
+    vm_allocation_t<RealT> solve(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                 const std::vector<bool>& fn_power_states, // The power status of each FN
+                                 const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                 const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                 const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                 const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                 const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                 const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                 const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                 const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                 const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                 const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                 const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                 const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                 RealT deltat = 1 // Length of the time interval
+                            ) const
+    {
+        return this->solve_with_fixed_fns(std::set<std::size_t>(), // Any FN can be selected
+                                          fn_categories,
+                                          fn_power_states,
+                                          fn_vm_allocations,
+                                          fn_cat_min_powers,
+                                          fn_cat_max_powers,
+                                          vm_cat_fn_cat_cpu_specs,
+                                          vm_cat_alloc_costs,
+                                          svc_categories,
+                                          svc_cat_vm_cat_min_num_vms,
+                                          fp_svc_cat_revenues,
+                                          fp_svc_cat_penalties,
+                                          fp_electricity_cost,
+                                          fp_fn_cat_asleep_costs,
+                                          fp_fn_cat_awake_costs,
+                                          deltat);
+    }
+
+    vm_allocation_t<RealT> solve_with_fixed_fns(const std::set<std::size_t>& fixed_fns,
+                                                const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                                const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                                const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                                const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                RealT deltat = 1 // Length of the time interval
+                            ) const
+    {
+        return this->solve_with_fixed_fns_from(vm_allocation_t<RealT>(), // No starting point
+                                               fixed_fns,
+                                               fn_categories,
+                                               fn_power_states,
+                                               fn_vm_allocations,
+                                               fn_cat_min_powers,
+                                               fn_cat_max_powers,
+                                               vm_cat_fn_cat_cpu_specs,
+                                               vm_cat_alloc_costs,
+                                               svc_categories,
+                                               svc_cat_vm_cat_min_num_vms,
+                                               fp_svc_cat_revenues,
+                                               fp_svc_cat_penalties,
+                                               fp_electricity_cost,
+                                               fp_fn_cat_asleep_costs,
+                                               fp_fn_cat_awake_costs,
+                                               deltat);
+    }
+
+    vm_allocation_t<RealT> solve_with_fixed_fns_from(const vm_allocation_t<RealT>& start_vm_alloc, // The VM allocation from which to start the search
+                                                     const std::set<std::size_t>& fixed_fns,
+                                                     const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                     const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                     const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                     const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                     const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                     const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                     const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                     const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                     const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                                     const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                                     const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                                     const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                     const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                     const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                     RealT deltat = 1 // Length of the time interval
+                            ) const
+    {
+        DCS_DEBUG_TRACE("Finding VM allocation by using the OR-Tools solver '" << solver_id_ << "':");
+        DCS_DEBUG_TRACE("- Number of FNs: " << fn_categories.size());
+        DCS_DEBUG_TRACE("- FN Fixed: " << fixed_fns);
+        DCS_DEBUG_TRACE("- Relative Tolerance: " << rel_tol_);
+        DCS_DEBUG_TRACE("- Time Limit: " << time_lim_);
+        DCS_DEBUG_TRACE("- Number of Workers: " << num_workers_);
+        DCS_DEBUG_TRACE("- Deterministic: " << deterministic_);
+        DCS_DEBUG_TRACE("- Solver Parameters: " << solver_params_);
+        DCS_DEBUG_TRACE("- Start FN Power States: " << start_vm_alloc.fn_power_states);
+        DCS_DEBUG_TRACE("- Start FN - VM Allocations: " << start_vm_alloc.fn_vm_allocations);
+
+        // The starting point is only used as a hint if it refers to the same FNs
+        const bool use_start = start_vm_alloc.fn_power_states.size() == fn_power_states.size()
+                               && start_vm_alloc.fn_vm_allocations.size() == fn_vm_allocations.size();
+
+        RealT solve_time = 0;
+
+        auto const ms_solution = detail::solve_ortools_vm_allocation(solver_id_,
+                                                                     rel_tol_,
+                                                                     time_lim_,
+                                                                     num_workers_,
+                                                                     deterministic_,
+                                                                     solver_params_,
+                                                                     std::vector<std::set<std::size_t>>(1, fixed_fns),
+                                                                     use_start ? start_vm_alloc.fn_power_states : std::vector<bool>(),
+                                                                     use_start ? start_vm_alloc.fn_vm_allocations : std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>(),
+                                                                     fn_categories,
+                                                                     fn_power_states,
+                                                                     fn_vm_allocations,
+                                                                     fn_cat_min_powers,
+                                                                     fn_cat_max_powers,
+                                                                     vm_cat_fn_cat_cpu_specs,
+                                                                     vm_cat_alloc_costs,
+                                                                     svc_categories,
+                                                                     std::vector<std::vector<std::vector<std::size_t>>>(1, svc_cat_vm_cat_min_num_vms),
+                                                                     fp_svc_cat_revenues,
+                                                                     fp_svc_cat_penalties,
+                                                                     fp_electricity_cost,
+                                                                     fp_fn_cat_asleep_costs,
+                                                                     fp_fn_cat_awake_costs,
+                                                                     deltat,
+                                                                     solve_time);
+
+        vm_allocation_t<RealT> solution;
+
+        solution.solved = ms_solution.solved;
+        solution.optimal = ms_solution.optimal;
+        solution.solve_time = solve_time;
+        solution.gap = ms_solution.gap;
+        if (solution.solved)
+        {
+            solution.objective_value = ms_solution.objective_value;
+            solution.profit = ms_solution.profit;
+            solution.revenue = ms_solution.revenue;
+            solution.cost = ms_solution.cost;
+            solution.fn_vm_allocations = ms_solution.fn_vm_allocations.front();
+            solution.fn_power_states = ms_solution.fn_power_states.front();
+            solution.fn_cpu_allocations = ms_solution.fn_cpu_allocations.front();
+        }
+
+        return solution;
+    }
+
+
+private:
+    std::string solver_id_; ///< The OR-Tools solver to use (e.g., "CBC", "SCIP", "HIGHS" or "CP-SAT")
+    RealT rel_tol_; ///< Relative tolerance; the optimizer will stop as soon as it has found a feasible solution proved to be within (rel_tol_*100)% of optimal.
+    RealT time_lim_; ///< Time limit (in seconds) used to set the maximum time the optimizer can spend in search for the best solution.
+    std::size_t num_workers_; ///< Number of search workers (0 means the solver default).
+    bool deterministic_; ///< Tells whether the parallel search must be deterministic (CP-SAT only).
+    std::string solver_params_; ///< Solver-specific parameters, in the format of the underlying solver.
+}; // ortools_vm_allocation_solver_t
+
+
+/**
+ * \brief Solver for the multi-slot VM allocation problem based on the
+ *  OR-Tools linear solver wrapper.
+ *
+ * The same VM allocation problem solved by
+ * \c optimal_multislot_vm_allocation_solver_t is solved by means of any of the
+ * (possibly open-source) MILP solvers available through OR-Tools.
+ */
+template <typename RealT>
+class ortools_multislot_vm_allocation_solver_t: public base_multislot_vm_allocation_solver_t<RealT>
+{
+public:
+    explicit ortools_multislot_vm_allocation_solver_t(const std::string& solver_id = "CBC",
+                                                      RealT relative_tolerance = 0,
+                                                      RealT time_limit = -1,
+                                                      std::size_t num_workers = 0,
+                                                      bool deterministic = false,
+                                                      const std::string& solver_params = "")
+    : solver_id_(solver_id),
+      rel_tol_(relative_tolerance),
+      time_lim_(time_limit),
+      num_workers_(num_workers),
+      deterministic_(deterministic),
+      solver_params_(solver_params)
+    {
+    }
+
+    multislot_vm_allocation_t<RealT> solve(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                           const std::vector<bool>& fn_power_states, // The power status of each FN
+                                           const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                           const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                           const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                           const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                           const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                           const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                           const std::vector<std::vector<std::vector<std::size_t>>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by time slot, service category and VM category
+                                           const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                           const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                           const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                           const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                           const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                           RealT deltat = 1 // Length of the time interval
+                                    ) const
+    {
+        return this->solve_with_fixed_fns(std::vector<std::set<std::size_t>>(svc_cat_vm_cat_min_num_vms.size()), // Any FN can be selected
+                                          fn_categories,
+                                          fn_power_states,
+                                          fn_vm_allocations,
+                                          fn_cat_min_powers,
+                                          fn_cat_max_powers,
+                                          vm_cat_fn_cat_cpu_specs,
+                                          vm_cat_alloc_costs,
+                                          svc_categories,
+                                          svc_cat_vm_cat_min_num_vms,
+                                          fp_svc_cat_revenues,
+                                          fp_svc_cat_penalties,
+                                          fp_electricity_cost,
+                                          fp_fn_cat_asleep_costs,
+                                          fp_fn_cat_awake_costs,
+                                          deltat);
+    }
+
+    multislot_vm_allocation_t<RealT> solve_with_fixed_fns(const std::vector<std::set<std::size_t>>& fixed_fns, // For each time slot, the set of selected FNs to use for the VM allocation (if in a given time slot the set is empty, any FN can be used)
+                                                          const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                          const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                          const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                          const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                          const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                          const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                          const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                          const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                          const std::vector<std::vector<std::vector<std::size_t>>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by time slot, service category and VM category
+                                                          const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                                          const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                                          const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                          const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                          const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                          RealT deltat = 1 // Length of the time interval
+                                                    ) const
+    {
+        DCS_DEBUG_TRACE("Finding multi-slot VM allocation by using the OR-Tools solver '" << solver_id_ << "':");
+        DCS_DEBUG_TRACE("- Number of FNs: " << fn_categories.size());
+        DCS_DEBUG_TRACE("- Number of Time Slots: " << svc_cat_vm_cat_min_num_vms.size());
+        DCS_DEBUG_TRACE("- Relative Tolerance: " << rel_tol_);
+        DCS_DEBUG_TRACE("- Time Limit: " << time_lim_);
+        DCS_DEBUG_TRACE("- Number of Workers: " << num_workers_);
+        DCS_DEBUG_TRACE("- Deterministic: " << deterministic_);
+        DCS_DEBUG_TRACE("- Solver Parameters: " << solver_params_);
+
+        RealT solve_time = 0;
+
+        return detail::solve_ortools_vm_allocation(solver_id_,
+                                                   rel_tol_,
+                                                   time_lim_,
+                                                   num_workers_,
+                                                   deterministic_,
+                                                   solver_params_,
+                                                   fixed_fns,
+                                                   std::vector<bool>(), // No hint
+                                                   std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>(),
+                                                   fn_categories,
+                                                   fn_power_states,
+                                                   fn_vm_allocations,
+                                                   fn_cat_min_powers,
+                                                   fn_cat_max_powers,
+                                                   vm_cat_fn_cat_cpu_specs,
+                                                   vm_cat_alloc_costs,
+                                                   svc_categories,
+                                                   svc_cat_vm_cat_min_num_vms,
+                                                   fp_svc_cat_revenues,
+                                                   fp_svc_cat_penalties,
+                                                   fp_electricity_cost,
+                                                   fp_fn_cat_asleep_costs,
+                                                   fp_fn_cat_awake_costs,
+                                                   deltat,
+                                                   solve_time);
+    }
+
+
+private:
+    std::string solver_id_; ///< The OR-Tools solver to use (e.g., "CBC", "SCIP", "HIGHS" or "CP-SAT")
+    RealT rel_tol_; ///< Relative tolerance; the optimizer will stop as soon as it has found a feasible solution proved to be within (rel_tol_*100)% of optimal.
+    RealT time_lim_; ///< Time limit (in seconds) used to set the maximum time the optimizer can spend in search for the best solution.
+    std::size_t num_workers_; ///< Number of search workers (0 means the solver default).
+    bool deterministic_; ///< Tells whether the parallel search must be deterministic (CP-SAT only).
+    std::string solver_params_; ///< Solver-specific parameters, in the format of the underlying solver.
+}; // ortools_multislot_vm_allocation_solver_t
+
+}} // Namespace dcs::fog
+
+
+#endif // DCS_FOG_VM_ALLOCATION_ORTOOLS_SOLVER_HPP
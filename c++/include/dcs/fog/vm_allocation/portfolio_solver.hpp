@@ -0,0 +1,883 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fog/vm_allocation/portfolio_solver.hpp
+ *
+ * \brief Portfolio solvers for the (single-slot and multi-slot) VM
+ *  allocation problem, which race several solvers and keep the best VM
+ *  allocation.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FOG_VM_ALLOCATION_PORTFOLIO_SOLVER_HPP
+#define DCS_FOG_VM_ALLOCATION_PORTFOLIO_SOLVER_HPP
+
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/fog/vm_allocation/commons.hpp>
+#include <dcs/logging.hpp>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace dcs { namespace fog {
+
+namespace detail {
+
+/// State shared by the solvers that race in a portfolio
+template <typename SolutionT, typename RealT>
+struct portfolio_race_t
+{
+    portfolio_race_t()
+    : num_running(0),
+      stop(false),
+      has_best(false),
+      first_incumbent_time(std::numeric_limits<RealT>::quiet_NaN())
+    {
+    }
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::size_t num_running; ///< The number of solvers of the current stage that are still running
+    bool stop; ///< Tells if the race is over (e.g., because an optimal solution has been found)
+    bool has_best; ///< Tells if a feasible solution has been found
+    SolutionT best; ///< The best solution found so far
+    RealT first_incumbent_time; ///< The time (in seconds since the start of the race) when the first feasible solution has been found
+}; // portfolio_race_t
+
+/// The fraction of the time limit of a portfolio that is left to the solvers to return their solutions once their search has been stopped (e.g., to extract the solution and free the model)
+constexpr double portfolio_time_limit_margin = 0.05;
+
+/**
+ * \brief Runs the given solver tasks concurrently, each one on its own
+ *  thread, and waits for them.
+ *
+ * The solution returned by each task is passed to \a check, which evaluates
+ * it and tells whether it is feasible, and is then kept if it is better than
+ * the best one found so far.
+ * When the race ends before all the tasks are done, the tasks that are still
+ * running are interrupted (see \c solve_interrupter_t), their solutions are
+ * discarded and the threads are joined before returning. Solvers that cannot
+ * be interrupted (e.g., the heuristic ones) are waited for until they are
+ * done.
+ * The race is also interrupted when the solve call running it is.
+ * The race ends at the deadline given by \a time_limit or by the deadline of
+ * the calling thread (see \c solve_deadline_scope_t), whichever comes first.
+ * The solve calls of the tasks are given the time left before that deadline,
+ * less a margin (see \c portfolio_time_limit_margin), so that the solvers
+ * that honor it (see \c solve_time_limit) return in time.
+ *
+ * The race stops as soon as the best solution is optimal, either because its
+ * solver proved it or because its relative gap is within
+ * \a relative_tolerance.
+ *
+ * Returns \c true if the race has been stopped before all the tasks were
+ * done, because an optimal solution has been found, the deadline expired or
+ * the race has been interrupted.
+ */
+template <typename SolutionT, typename RealT, typename CheckT>
+bool run_portfolio_race(const std::vector<std::function<SolutionT()>>& tasks,
+                        const CheckT& check,
+                        portfolio_race_t<SolutionT,RealT>& race,
+                        std::chrono::steady_clock::time_point start_time,
+                        RealT time_limit, // The max number of seconds since the start of the race (a non-positive value means no limit)
+                        RealT relative_tolerance) // The relative gap within which the best solution is considered optimal (a non-positive value means that only proved optimal solutions stop the race)
+{
+    if (tasks.empty())
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(race.mtx);
+
+        race.num_running = tasks.size();
+    }
+
+    auto race_deadline = solve_deadline_scope_t::current();
+    if (time_limit > 0)
+    {
+        race_deadline = std::min(race_deadline, start_time+std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<RealT>(time_limit)));
+    }
+    auto task_deadline = race_deadline;
+    if (race_deadline != std::chrono::steady_clock::time_point::max())
+    {
+        task_deadline = start_time+std::chrono::duration_cast<std::chrono::steady_clock::duration>((race_deadline-start_time)*(1-portfolio_time_limit_margin));
+    }
+
+    // Each task gets its own interrupter, so that the losers can be aborted
+    // without affecting the other solve calls of their solvers
+    std::vector<std::unique_ptr<solve_interrupter_t>> interrupters;
+    std::vector<std::thread> threads;
+
+    auto const interrupt_and_join = [&interrupters, &threads]()
+                                    {
+                                        for (auto& p_interrupter : interrupters)
+                                        {
+                                            p_interrupter->interrupt();
+                                        }
+                                        for (auto& thread : threads)
+                                        {
+                                            thread.join();
+                                        }
+                                    };
+
+    try
+    {
+        for (auto const& task : tasks)
+        {
+            interrupters.emplace_back(new solve_interrupter_t());
+
+            auto const p_interrupter = interrupters.back().get();
+
+            threads.emplace_back([&task, &check, &race, p_interrupter, start_time, task_deadline, relative_tolerance]()
+                                 {
+                                     solve_interrupter_scope_t interrupter_scope(p_interrupter);
+                                     solve_deadline_scope_t deadline_scope(task_deadline);
+
+                                     try
+                                     {
+                                         auto solution = task();
+
+                                         if (check(solution))
+                                         {
+                                             std::lock_guard<std::mutex> lock(race.mtx);
+
+                                             if (!race.stop)
+                                             {
+                                                 if (std::isnan(race.first_incumbent_time))
+                                                 {
+                                                     race.first_incumbent_time = std::chrono::duration_cast<std::chrono::duration<RealT>>(std::chrono::steady_clock::now()-start_time).count();
+                                                 }
+                                                 if (!race.has_best
+                                                     || solution.objective_value > race.best.objective_value
+                                                     || (solution.optimal && solution.objective_value >= race.best.objective_value)) // Prefer the solution that comes with an optimality proof
+                                                 {
+                                                     race.best = solution;
+                                                     race.has_best = true;
+                                                 }
+                                                 if (solution.optimal
+                                                     || (relative_tolerance > 0 && race.best.gap <= relative_tolerance)) // False if the solver gives no bound (i.e., the gap is NaN)
+                                                 {
+                                                     race.best.optimal = true;
+                                                     race.stop = true;
+                                                 }
+                                             }
+                                         }
+                                     }
+                                     catch (const std::exception& e)
+                                     {
+                                         std::ostringstream oss;
+                                         oss << "VM allocation solver of the portfolio failed: " << e.what();
+                                         dcs::log_warn(DCS_LOGGING_AT, oss.str());
+                                     }
+                                     catch (...)
+                                     {
+                                         dcs::log_warn(DCS_LOGGING_AT, "VM allocation solver of the portfolio failed");
+                                     }
+
+                                     std::lock_guard<std::mutex> lock(race.mtx);
+                                     if (race.num_running > 0)
+                                     {
+                                         --race.num_running;
+                                     }
+                                     race.cv.notify_all();
+                                 });
+        }
+    }
+    catch (...)
+    {
+        // Could not start all the tasks
+        interrupt_and_join();
+        throw;
+    }
+
+    bool stopped = false;
+    {
+        solve_interrupt_guard_t interrupt_guard([&race]()
+                                                {
+                                                    std::lock_guard<std::mutex> lock(race.mtx);
+
+                                                    race.stop = true;
+                                                    race.cv.notify_all();
+                                                });
+
+        std::unique_lock<std::mutex> lock(race.mtx);
+
+        auto const done = [&race]() { return race.num_running == 0 || race.stop; };
+        if (race_deadline != std::chrono::steady_clock::time_point::max())
+        {
+            race.cv.wait_until(lock, race_deadline, done);
+        }
+        else
+        {
+            race.cv.wait(lock, done);
+        }
+
+        // Solutions of the tasks that are still running are discarded
+        if (!done())
+        {
+            race.stop = true;
+        }
+        stopped = race.stop;
+    }
+
+    if (stopped)
+    {
+        interrupt_and_join();
+    }
+    else
+    {
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    return stopped;
+}
+
+} // Namespace detail
+
+
+/**
+ * \brief Portfolio solver for the VM allocation problem.
+ *
+ * Since it is not known in advance which solver works best on a given
+ * problem, the problem is given to several solvers that run concurrently
+ * (each one on its own thread), and the most profitable feasible VM
+ * allocation they find is returned.
+ * Solvers are run in two stages:
+ * -# the heuristic solvers, whose best VM allocation becomes the incumbent;
+ * -# the exact solvers, which are given the incumbent as a starting point
+ *    (see \c base_vm_allocation_solver_t::solve_with_fixed_fns_from): the
+ *    optimal (CPLEX and CP Optimizer), the aggregated and the OR-Tools
+ *    solvers start their search from it (as a MIP start or a hint), while
+ *    the others ignore it.
+ * .
+ * The race ends as soon as all the solvers are done, one of them finds an
+ * optimal VM allocation (i.e., proved optimal by the solver or whose relative
+ * gap is within the relative tolerance of the portfolio) or the time limit
+ * expires, whichever comes first.
+ * VM allocations are compared by their objective value, as computed by
+ * \c detail::eval_vm_allocation, so that solvers whose objective functions
+ * differ are compared on the same ground.
+ *
+ * The solvers that are still running when the race ends are interrupted and
+ * their VM allocations are discarded (see \c detail::run_portfolio_race).
+ * Since heuristic solvers cannot be interrupted, they should be fast compared
+ * to the time limit of the portfolio.
+ */
+template <typename RealT>
+class portfolio_vm_allocation_solver_t: public base_vm_allocation_solver_t<RealT>
+{
+private:
+    typedef std::shared_ptr<base_vm_allocation_solver_t<RealT>> solver_pointer;
+
+    /// The problem data, shared by the solvers of the portfolio (referenced, not copied, since the solvers are joined before solving returns)
+    struct problem_t
+    {
+        const std::set<std::size_t>& fixed_fns;
+        const std::vector<std::size_t>& fn_categories;
+        const std::vector<bool>& fn_power_states;
+        const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations;
+        const std::vector<RealT>& fn_cat_min_powers;
+        const std::vector<RealT>& fn_cat_max_powers;
+        const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs;
+        const std::vector<RealT>& vm_cat_alloc_costs;
+        const std::vector<std::size_t>& svc_categories;
+        const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms;
+        const std::vector<RealT>& fp_svc_cat_revenues;
+        const std::vector<RealT>& fp_svc_cat_penalties;
+        RealT fp_electricity_cost;
+        const std::vector<RealT>& fp_fn_cat_asleep_costs;
+        const std::vector<RealT>& fp_fn_cat_awake_costs;
+        RealT deltat;
+    }; // problem_t
+
+    typedef detail::portfolio_race_t<vm_allocation_t<RealT>,RealT> race_type;
+
+
+
+public:
+    portfolio_vm_allocation_solver_t(const std::vector<solver_pointer>& heuristic_solvers,
+                                     const std::vector<solver_pointer>& exact_solvers,
+                                     RealT time_limit = -1,
+                                     RealT relative_tolerance = 0)
+    : heur_solvers_(heuristic_solvers),
+      exact_solvers_(exact_solvers),
+      time_lim_(time_limit),
+      rel_tol_(relative_tolerance)
+    {
+        // pre: there is at least one solver
+        DCS_ASSERT(heur_solvers_.size() > 0 || exact_solvers_.size() > 0,
+                   DCS_EXCEPTION_THROW(std::invalid_argument,
+                                       "Portfolio needs at least one VM allocation solver"));
+        for (auto const& p_solver : heur_solvers_)
+        {
+            // pre: solvers are not null
+            DCS_ASSERT(p_solver,
+                       DCS_EXCEPTION_THROW(std::invalid_argument,
+                                           "Invalid VM allocation solver"));
+        }
+        for (auto const& p_solver : exact_solvers_)
+        {
+            // pre: solvers are not null
+            DCS_ASSERT(p_solver,
+                       DCS_EXCEPTION_THROW(std::invalid_argument,
+                                           "Invalid VM allocation solver"));
+        }
+    }
+
+    void time_limit(RealT value)
+    {
+        time_lim_ = value;
+    }
+
+    RealT time_limit() const
+    {
+        return time_lim_;
+    }
+
+    void relative_tolerance(RealT value)
+    {
+        rel_tol_ = value;
+    }
+
+    RealT relative_tolerance() const
+    {
+        return rel_tol_;
+    }
+
+    vm_allocation_t<RealT> solve(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                 const std::vector<bool>& fn_power_states, // The power status of each FN
+                                 const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                 const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                 const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                 const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                 const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                 const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                 const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                 const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                 const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                 const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                 const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                 const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                 RealT deltat = 1 // Length of the time interval
+                            ) const
+    {
+        return this->solve_with_fixed_fns_from(vm_allocation_t<RealT>(), // No starting point
+                                               std::set<std::size_t>(), // Any FN can be selected
+                                               fn_categories,
+                                               fn_power_states,
+                                               fn_vm_allocations,
+                                               fn_cat_min_powers,
+                                               fn_cat_max_powers,
+                                               vm_cat_fn_cat_cpu_specs,
+                                               vm_cat_alloc_costs,
+                                               svc_categories,
+                                               svc_cat_vm_cat_min_num_vms,
+                                               fp_svc_cat_revenues,
+                                               fp_svc_cat_penalties,
+                                               fp_electricity_cost,
+                                               fp_fn_cat_asleep_costs,
+                                               fp_fn_cat_awake_costs,
+                                               deltat);
+    }
+
+    vm_allocation_t<RealT> solve_with_fixed_fns(const std::set<std::size_t>& fixed_fns,
+                                                const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                                const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                                const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                                const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                RealT deltat = 1 // Length of the time interval
+                            ) const
+    {
+        return this->solve_with_fixed_fns_from(vm_allocation_t<RealT>(), // No starting point
+                                               fixed_fns,
+                                               fn_categories,
+                                               fn_power_states,
+                                               fn_vm_allocations,
+                                               fn_cat_min_powers,
+                                               fn_cat_max_powers,
+                                               vm_cat_fn_cat_cpu_specs,
+                                               vm_cat_alloc_costs,
+                                               svc_categories,
+                                               svc_cat_vm_cat_min_num_vms,
+                                               fp_svc_cat_revenues,
+                                               fp_svc_cat_penalties,
+                                               fp_electricity_cost,
+                                               fp_fn_cat_asleep_costs,
+                                               fp_fn_cat_awake_costs,
+                                               deltat);
+    }
+
+    vm_allocation_t<RealT> solve_with_fixed_fns_from(const vm_allocation_t<RealT>& start_vm_alloc, // The VM allocation from which to start the search
+                                                     const std::set<std::size_t>& fixed_fns,
+                                                     const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                     const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                     const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                     const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                     const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                     const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                     const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                     const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                     const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by service category and VM category
+                                                     const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                                     const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                                     const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                     const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                     const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                     RealT deltat = 1 // Length of the time interval
+                            ) const
+    {
+        DCS_DEBUG_TRACE("Finding VM allocation by a portfolio of solvers:");
+        DCS_DEBUG_TRACE("- Number of FNs: " << fn_categories.size());
+        DCS_DEBUG_TRACE("- FN Fixed: " << fixed_fns);
+        DCS_DEBUG_TRACE("- Number of Services: " << svc_categories.size());
+        DCS_DEBUG_TRACE("- Number of Heuristic Solvers: " << heur_solvers_.size());
+        DCS_DEBUG_TRACE("- Number of Exact Solvers: " << exact_solvers_.size());
+        DCS_DEBUG_TRACE("- Time Limit: " << time_lim_);
+        DCS_DEBUG_TRACE("- Relative Tolerance: " << rel_tol_);
+
+        auto const start_time = std::chrono::steady_clock::now();
+
+        const problem_t problem = {fixed_fns,
+                                  fn_categories,
+                                  fn_power_states,
+                                  fn_vm_allocations,
+                                  fn_cat_min_powers,
+                                  fn_cat_max_powers,
+                                  vm_cat_fn_cat_cpu_specs,
+                                  vm_cat_alloc_costs,
+                                  svc_categories,
+                                  svc_cat_vm_cat_min_num_vms,
+                                  fp_svc_cat_revenues,
+                                  fp_svc_cat_penalties,
+                                  fp_electricity_cost,
+                                  fp_fn_cat_asleep_costs,
+                                  fp_fn_cat_awake_costs,
+                                  deltat};
+
+        race_type race;
+
+        // Stage 1: heuristic solvers
+        bool stopped = detail::run_portfolio_race(make_tasks(heur_solvers_, start_vm_alloc, problem), make_check(problem), race, start_time, time_lim_, rel_tol_);
+
+        // Stage 2: exact solvers, starting from the best heuristic VM allocation
+        if (!stopped && exact_solvers_.size() > 0)
+        {
+            vm_allocation_t<RealT> start;
+            {
+                std::lock_guard<std::mutex> lock(race.mtx);
+
+                start = race.has_best ? race.best : start_vm_alloc;
+            }
+
+            detail::run_portfolio_race(make_tasks(exact_solvers_, start, problem), make_check(problem), race, start_time, time_lim_, rel_tol_);
+        }
+
+        vm_allocation_t<RealT> solution;
+        {
+            std::lock_guard<std::mutex> lock(race.mtx);
+
+            if (race.has_best)
+            {
+                solution = race.best;
+            }
+            solution.first_incumbent_time = race.first_incumbent_time;
+        }
+        solution.solve_time = std::chrono::duration_cast<std::chrono::duration<RealT>>(std::chrono::steady_clock::now()-start_time).count();
+
+        DCS_DEBUG_TRACE("- Solve time: " << solution.solve_time << ", time to first incumbent: " << solution.first_incumbent_time);
+        DCS_DEBUG_TRACE("- Objective value: " << solution.objective_value << " (optimal: " << solution.optimal << ", gap: " << solution.gap << ")");
+
+        return solution;
+    }
+
+
+private:
+    /// Makes a task for each of the given solvers, which solves the problem from the given VM allocation
+    static std::vector<std::function<vm_allocation_t<RealT>()>> make_tasks(const std::vector<solver_pointer>& solvers,
+                                                                           const vm_allocation_t<RealT>& start_vm_alloc,
+                                                                           const problem_t& problem)
+    {
+        std::vector<std::function<vm_allocation_t<RealT>()>> tasks;
+
+        for (auto const& p_solver : solvers)
+        {
+            tasks.push_back([p_solver, start_vm_alloc, &problem]()
+                            {
+                                return p_solver->solve_with_fixed_fns_from(start_vm_alloc,
+                                                                           problem.fixed_fns,
+                                                                           problem.fn_categories,
+                                                                           problem.fn_power_states,
+                                                                           problem.fn_vm_allocations,
+                                                                           problem.fn_cat_min_powers,
+                                                                           problem.fn_cat_max_powers,
+                                                                           problem.vm_cat_fn_cat_cpu_specs,
+                                                                           problem.vm_cat_alloc_costs,
+                                                                           problem.svc_categories,
+                                                                           problem.svc_cat_vm_cat_min_num_vms,
+                                                                           problem.fp_svc_cat_revenues,
+                                                                           problem.fp_svc_cat_penalties,
+                                                                           problem.fp_electricity_cost,
+                                                                           problem.fp_fn_cat_asleep_costs,
+                                                                           problem.fp_fn_cat_awake_costs,
+                                                                           problem.deltat);
+                            });
+        }
+
+        return tasks;
+    }
+
+    /// Makes the function that tells if a VM allocation is feasible and computes its objective value
+    static std::function<bool(vm_allocation_t<RealT>&)> make_check(const problem_t& problem)
+    {
+        return [&problem](vm_allocation_t<RealT>& solution) -> bool
+               {
+                    const std::size_t nfns = problem.fn_categories.size();
+
+                    if (!solution.solved
+                        || solution.fn_power_states.size() != nfns
+                        || solution.fn_vm_allocations.size() != nfns
+                        || solution.fn_cpu_allocations.size() != nfns
+                        || !check_vm_allocation_solution(solution))
+                    {
+                        return false;
+                    }
+
+                    detail::eval_vm_allocation(problem.fn_categories,
+                                               problem.fn_power_states,
+                                               problem.fn_vm_allocations,
+                                               problem.fn_cat_min_powers,
+                                               problem.fn_cat_max_powers,
+                                               problem.vm_cat_alloc_costs,
+                                               problem.svc_categories,
+                                               problem.svc_cat_vm_cat_min_num_vms,
+                                               problem.fp_svc_cat_revenues,
+                                               problem.fp_svc_cat_penalties,
+                                               problem.fp_electricity_cost,
+                                               problem.fp_fn_cat_asleep_costs,
+                                               problem.fp_fn_cat_awake_costs,
+                                               problem.deltat,
+                                               solution);
+
+                    return true;
+               };
+    }
+
+
+    std::vector<solver_pointer> heur_solvers_; ///< The heuristic solvers, run first
+    std::vector<solver_pointer> exact_solvers_; ///< The exact solvers, run from the best heuristic VM allocation
+    RealT time_lim_; ///< The max number of seconds to wait for the solvers (a non-positive value means no limit)
+    RealT rel_tol_; ///< The relative gap within which a VM allocation is considered optimal and stops the race (a non-positive value means that only proved optimal VM allocations do)
+}; // portfolio_vm_allocation_solver_t
+
+
+/**
+ * \brief Portfolio solver for the multi-slot VM allocation problem.
+ *
+ * The multi-slot counterpart of \c portfolio_vm_allocation_solver_t: all the
+ * solvers race in a single stage (multi-slot solvers cannot be given a
+ * starting point), and the most profitable feasible multi-slot VM allocation
+ * they find within the time limit is returned.
+ * Multi-slot VM allocations are compared by their objective value, as
+ * computed by \c detail::eval_multislot_vm_allocation.
+ */
+template <typename RealT>
+class portfolio_multislot_vm_allocation_solver_t: public base_multislot_vm_allocation_solver_t<RealT>
+{
+private:
+    typedef std::shared_ptr<base_multislot_vm_allocation_solver_t<RealT>> solver_pointer;
+
+    /// The problem data, shared by the solvers of the portfolio (referenced, not copied, since the solvers are joined before solving returns)
+    struct problem_t
+    {
+        const std::vector<std::set<std::size_t>>& fixed_fns;
+        const std::vector<std::size_t>& fn_categories;
+        const std::vector<bool>& fn_power_states;
+        const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations;
+        const std::vector<RealT>& fn_cat_min_powers;
+        const std::vector<RealT>& fn_cat_max_powers;
+        const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs;
+        const std::vector<RealT>& vm_cat_alloc_costs;
+        const std::vector<std::size_t>& svc_categories;
+        const std::vector<std::vector<std::vector<std::size_t>>>& svc_cat_vm_cat_min_num_vms;
+        const std::vector<RealT>& fp_svc_cat_revenues;
+        const std::vector<RealT>& fp_svc_cat_penalties;
+        RealT fp_electricity_cost;
+        const std::vector<RealT>& fp_fn_cat_asleep_costs;
+        const std::vector<RealT>& fp_fn_cat_awake_costs;
+        RealT deltat;
+    }; // problem_t
+
+    typedef detail::portfolio_race_t<multislot_vm_allocation_t<RealT>,RealT> race_type;
+
+
+public:
+    explicit portfolio_multislot_vm_allocation_solver_t(const std::vector<solver_pointer>& solvers,
+                                                        RealT time_limit = -1,
+                                                        RealT relative_tolerance = 0)
+    : solvers_(solvers),
+      time_lim_(time_limit),
+      rel_tol_(relative_tolerance)
+    {
+        // pre: there is at least one solver
+        DCS_ASSERT(solvers_.size() > 0,
+                   DCS_EXCEPTION_THROW(std::invalid_argument,
+                                       "Portfolio needs at least one VM allocation solver"));
+        for (auto const& p_solver : solvers_)
+        {
+            // pre: solvers are not null
+            DCS_ASSERT(p_solver,
+                       DCS_EXCEPTION_THROW(std::invalid_argument,
+                                           "Invalid VM allocation solver"));
+        }
+    }
+
+    void time_limit(RealT value)
+    {
+        time_lim_ = value;
+    }
+
+    RealT time_limit() const
+    {
+        return time_lim_;
+    }
+
+    void relative_tolerance(RealT value)
+    {
+        rel_tol_ = value;
+    }
+
+    RealT relative_tolerance() const
+    {
+        return rel_tol_;
+    }
+
+    multislot_vm_allocation_t<RealT> solve(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                           const std::vector<bool>& fn_power_states, // The power status of each FN
+                                           const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                           const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                           const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                           const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                           const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                           const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                           const std::vector<std::vector<std::vector<std::size_t>>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by time slot, service category and VM category
+                                           const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                           const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                           const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                           const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                           const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                           RealT deltat = 1 // Length of the time interval
+                                    ) const
+    {
+        return this->solve_with_fixed_fns(std::vector<std::set<std::size_t>>(svc_cat_vm_cat_min_num_vms.size()), // Any FN can be selected
+                                          fn_categories,
+                                          fn_power_states,
+                                          fn_vm_allocations,
+                                          fn_cat_min_powers,
+                                          fn_cat_max_powers,
+                                          vm_cat_fn_cat_cpu_specs,
+                                          vm_cat_alloc_costs,
+                                          svc_categories,
+                                          svc_cat_vm_cat_min_num_vms,
+                                          fp_svc_cat_revenues,
+                                          fp_svc_cat_penalties,
+                                          fp_electricity_cost,
+                                          fp_fn_cat_asleep_costs,
+                                          fp_fn_cat_awake_costs,
+                                          deltat);
+    }
+
+    multislot_vm_allocation_t<RealT> solve_with_fixed_fns(const std::vector<std::set<std::size_t>>& fixed_fns, // For each time slot, the set of selected FNs to use for the VM allocation (if in a given time slot the set is empty, any FN can be used)
+                                                          const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                          const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                          const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                          const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                          const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                          const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                          const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                          const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                          const std::vector<std::vector<std::vector<std::size_t>>>& svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by time slot, service category and VM category
+                                                          const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                                          const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                                          const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                          const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                          const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                          RealT deltat = 1 // Length of the time interval
+                                                    ) const
+    {
+        DCS_DEBUG_TRACE("Finding multi-slot VM allocation by a portfolio of solvers:");
+        DCS_DEBUG_TRACE("- Number of Time Slots: " << svc_cat_vm_cat_min_num_vms.size());
+        DCS_DEBUG_TRACE("- Number of FNs: " << fn_categories.size());
+        DCS_DEBUG_TRACE("- Number of Services: " << svc_categories.size());
+        DCS_DEBUG_TRACE("- Number of Solvers: " << solvers_.size());
+        DCS_DEBUG_TRACE("- Time Limit: " << time_lim_);
+        DCS_DEBUG_TRACE("- Relative Tolerance: " << rel_tol_);
+
+        auto const start_time = std::chrono::steady_clock::now();
+
+        const problem_t problem = {fixed_fns,
+                                  fn_categories,
+                                  fn_power_states,
+                                  fn_vm_allocations,
+                                  fn_cat_min_powers,
+                                  fn_cat_max_powers,
+                                  vm_cat_fn_cat_cpu_specs,
+                                  vm_cat_alloc_costs,
+                                  svc_categories,
+                                  svc_cat_vm_cat_min_num_vms,
+                                  fp_svc_cat_revenues,
+                                  fp_svc_cat_penalties,
+                                  fp_electricity_cost,
+                                  fp_fn_cat_asleep_costs,
+                                  fp_fn_cat_awake_costs,
+                                  deltat};
+
+        std::vector<std::function<multislot_vm_allocation_t<RealT>()>> tasks;
+        for (auto const& p_solver : solvers_)
+        {
+            tasks.push_back([p_solver, &problem]()
+                            {
+                                return p_solver->solve_with_fixed_fns(problem.fixed_fns,
+                                                                      problem.fn_categories,
+                                                                      problem.fn_power_states,
+                                                                      problem.fn_vm_allocations,
+                                                                      problem.fn_cat_min_powers,
+                                                                      problem.fn_cat_max_powers,
+                                                                      problem.vm_cat_fn_cat_cpu_specs,
+                                                                      problem.vm_cat_alloc_costs,
+                                                                      problem.svc_categories,
+                                                                      problem.svc_cat_vm_cat_min_num_vms,
+                                                                      problem.fp_svc_cat_revenues,
+                                                                      problem.fp_svc_cat_penalties,
+                                                                      problem.fp_electricity_cost,
+                                                                      problem.fp_fn_cat_asleep_costs,
+                                                                      problem.fp_fn_cat_awake_costs,
+                                                                      problem.deltat);
+                            });
+        }
+
+        auto const check = [&problem](multislot_vm_allocation_t<RealT>& solution) -> bool
+                           {
+                                const std::size_t nslots = problem.svc_cat_vm_cat_min_num_vms.size();
+                                const std::size_t nfns = problem.fn_categories.size();
+
+                                if (!solution.solved
+                                    || solution.fn_power_states.size() != nslots
+                                    || solution.fn_vm_allocations.size() != nslots
+                                    || solution.fn_cpu_allocations.size() != nslots)
+                                {
+                                    return false;
+                                }
+                                for (std::size_t t = 0; t < nslots; ++t)
+                                {
+                                    if (solution.fn_power_states[t].size() != nfns
+                                        || solution.fn_vm_allocations[t].size() != nfns
+                                        || solution.fn_cpu_allocations[t].size() != nfns)
+                                    {
+                                        return false;
+                                    }
+                                }
+                                if (!check_vm_allocation_solution(solution))
+                                {
+                                    return false;
+                                }
+
+                                detail::eval_multislot_vm_allocation(problem.fn_categories,
+                                                                     problem.fn_power_states,
+                                                                     problem.fn_vm_allocations,
+                                                                     problem.fn_cat_min_powers,
+                                                                     problem.fn_cat_max_powers,
+                                                                     problem.vm_cat_alloc_costs,
+                                                                     problem.svc_categories,
+                                                                     problem.svc_cat_vm_cat_min_num_vms,
+                                                                     problem.fp_svc_cat_revenues,
+                                                                     problem.fp_svc_cat_penalties,
+                                                                     problem.fp_electricity_cost,
+                                                                     problem.fp_fn_cat_asleep_costs,
+                                                                     problem.fp_fn_cat_awake_costs,
+                                                                     problem.deltat,
+                                                                     solution);
+
+                                return true;
+                           };
+
+        race_type race;
+
+        detail::run_portfolio_race(tasks, check, race, start_time, time_lim_, rel_tol_);
+
+        multislot_vm_allocation_t<RealT> solution;
+        {
+            std::lock_guard<std::mutex> lock(race.mtx);
+
+            if (race.has_best)
+            {
+                solution = race.best;
+            }
+        }
+        solution.solve_time = std::chrono::duration_cast<std::chrono::duration<RealT>>(std::chrono::steady_clock::now()-start_time).count();
+
+        DCS_DEBUG_TRACE("- Solve time: " << solution.solve_time);
+        DCS_DEBUG_TRACE("- Objective value: " << solution.objective_value << " (optimal: " << solution.optimal << ", gap: " << solution.gap << ")");
+
+        return solution;
+    }
+
+
+private:
+    std::vector<solver_pointer> solvers_; ///< The solvers racing in the portfolio
+    RealT time_lim_; ///< The max number of seconds to wait for the solvers (a non-positive value means no limit)
+    RealT rel_tol_; ///< The relative gap within which a multi-slot VM allocation is considered optimal and stops the race (a non-positive value means that only proved optimal VM allocations do)
+}; // portfolio_multislot_vm_allocation_solver_t
+
+}} // Namespace dcs::fog
+
+
+#endif // DCS_FOG_VM_ALLOCATION_PORTFOLIO_SOLVER_HPP
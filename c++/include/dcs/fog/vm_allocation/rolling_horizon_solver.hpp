@@ -0,0 +1,342 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fog/vm_allocation/rolling_horizon_solver.hpp
+ *
+ * \brief Rolling-horizon solver for the multi-slot VM allocation problem.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FOG_VM_ALLOCATION_ROLLING_HORIZON_SOLVER_HPP
+#define DCS_FOG_VM_ALLOCATION_ROLLING_HORIZON_SOLVER_HPP
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/fog/vm_allocation/commons.hpp>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace dcs { namespace fog {
+
+/**
+ * \brief Rolling-horizon solver for the multi-slot VM allocation problem.
+ *
+ * Rather than solving a single model spanning all the time slots, the time
+ * horizon is covered by a sequence of windows of (at most) \c window_size
+ * consecutive slots, each one solved by means of the given multi-slot
+ * solver.
+ * Consecutive windows share \c window_overlap slots: of each window only the
+ * first <tt>window_size-window_overlap</tt> slots are committed (the remaining
+ * slots only serve as a lookahead), and the next window starts from the power
+ * states and VM allocations of the last committed slot, so that the
+ * switch-on/off and VM allocation costs between windows are accounted for.
+ *
+ * The memory and time required by each solve thus depend on the window size
+ * rather than on the length of the horizon, at the price of losing the
+ * optimality of the resulting VM allocation.
+ * When the calling thread has a deadline (e.g., in a portfolio, see
+ * \c detail::solve_deadline_scope_t), it is split among the windows.
+ *
+ * The windows are chained, rather than coordinated through a Lagrangian
+ * relaxation of the switch-on/off costs that couple consecutive slots: such
+ * a relaxation would need per-FN prices, while the multi-slot solvers only
+ * take per-FN-category costs.
+ */
+template <typename RealT>
+class rolling_horizon_multislot_vm_allocation_solver_t: public base_multislot_vm_allocation_solver_t<RealT>
+{
+public:
+    rolling_horizon_multislot_vm_allocation_solver_t(const std::shared_ptr<base_multislot_vm_allocation_solver_t<RealT>>& p_solver,
+                                                     std::size_t window_size,
+                                                     std::size_t window_overlap = 0)
+    : p_solver_(p_solver),
+      win_size_(window_size),
+      win_overlap_(window_overlap)
+    {
+        // pre: solver is not null
+        DCS_ASSERT(p_solver_,
+                   DCS_EXCEPTION_THROW(std::invalid_argument,
+                                       "Invalid multi-slot VM allocation solver"));
+        // pre: window size > 0
+        DCS_ASSERT(win_size_ > 0,
+                   DCS_EXCEPTION_THROW(std::invalid_argument,
+                                       "Window size must be > 0"));
+        // pre: window overlap < window size
+        DCS_ASSERT(win_overlap_ < win_size_,
+                   DCS_EXCEPTION_THROW(std::invalid_argument,
+                                       "Window overlap must be < window size"));
+    }
+
+    std::size_t window_size() const
+    {
+        return win_size_;
+    }
+
+    std::size_t window_overlap() const
+    {
+        return win_overlap_;
+    }
+
+    multislot_vm_allocation_t<RealT> solve(const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                           const std::vector<bool>& fn_power_states, // The power status of each FN
+                                           const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                           const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                           const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                           const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                           const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                           const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                           const std::vector<std::vector<std::vector<std::size_t>>>& slot_svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by time slot, service category and VM category
+                                           const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                           const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                           const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                           const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                           const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                           RealT deltat = 1) const // Length of the time interval
+    {
+        return by_rolling_horizon(std::vector<std::set<std::size_t>>(), // Use any FN
+                                  fn_categories,
+                                  fn_power_states,
+                                  fn_vm_allocations,
+                                  fn_cat_min_powers,
+                                  fn_cat_max_powers,
+                                  vm_cat_fn_cat_cpu_specs,
+                                  vm_cat_alloc_costs,
+                                  svc_categories,
+                                  slot_svc_cat_vm_cat_min_num_vms,
+                                  fp_svc_cat_revenues,
+                                  fp_svc_cat_penalties,
+                                  fp_electricity_cost,
+                                  fp_fn_cat_asleep_costs,
+                                  fp_fn_cat_awake_costs,
+                                  deltat);
+    }
+
+    multislot_vm_allocation_t<RealT> solve_with_fixed_fns(const std::vector<std::set<std::size_t>>& fixed_fns, // For each time slot, the set of selected FNs to use for the VM allocation (if in a given time slot the set is empty, any FN can be used)
+                                                          const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
+                                                          const std::vector<bool>& fn_power_states, // The power status of each FN
+                                                          const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations, // Current VM allocations, by FN and service
+                                                          const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
+                                                          const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
+                                                          const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs, // The CPU requirement of VMs by VM category and FN category
+                                                          const std::vector<RealT>& vm_cat_alloc_costs, // The cost to allocate a VM on a FN (e.g., cost to boot a VM or to live-migrate its state), by VM category
+                                                          const std::vector<std::size_t>& svc_categories, // Service categories by service
+                                                          const std::vector<std::vector<std::vector<std::size_t>>>& slot_svc_cat_vm_cat_min_num_vms, // The min number of VMs required to achieve QoS, by time slot, service category and VM category
+                                                          const std::vector<RealT>& fp_svc_cat_revenues, // Monetary revenues by service
+                                                          const std::vector<RealT>& fp_svc_cat_penalties, // Monetary penalties by service
+                                                          const RealT fp_electricity_cost, // Electricty cost (in $/Wh) of FP
+                                                          const std::vector<RealT>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FN category
+                                                          const std::vector<RealT>& fp_fn_cat_awake_costs, // Cost to power-on a FN by FN category
+                                                          RealT deltat = 1) const // Length of the time interval
+    {
+        return by_rolling_horizon(fixed_fns,
+                                  fn_categories,
+                                  fn_power_states,
+                                  fn_vm_allocations,
+                                  fn_cat_min_powers,
+                                  fn_cat_max_powers,
+                                  vm_cat_fn_cat_cpu_specs,
+                                  vm_cat_alloc_costs,
+                                  svc_categories,
+                                  slot_svc_cat_vm_cat_min_num_vms,
+                                  fp_svc_cat_revenues,
+                                  fp_svc_cat_penalties,
+                                  fp_electricity_cost,
+                                  fp_fn_cat_asleep_costs,
+                                  fp_fn_cat_awake_costs,
+                                  deltat);
+    }
+
+
+private:
+    multislot_vm_allocation_t<RealT> by_rolling_horizon(const std::vector<std::set<std::size_t>>& fixed_fns,
+                                                        const std::vector<std::size_t>& fn_categories,
+                                                        const std::vector<bool>& fn_power_states,
+                                                        const std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>>& fn_vm_allocations,
+                                                        const std::vector<RealT>& fn_cat_min_powers,
+                                                        const std::vector<RealT>& fn_cat_max_powers,
+                                                        const std::vector<std::vector<RealT>>& vm_cat_fn_cat_cpu_specs,
+                                                        const std::vector<RealT>& vm_cat_alloc_costs,
+                                                        const std::vector<std::size_t>& svc_categories,
+                                                        const std::vector<std::vector<std::vector<std::size_t>>>& slot_svc_cat_vm_cat_min_num_vms,
+                                                        const std::vector<RealT>& fp_svc_cat_revenues,
+                                                        const std::vector<RealT>& fp_svc_cat_penalties,
+                                                        const RealT fp_electricity_cost,
+                                                        const std::vector<RealT>& fp_fn_cat_asleep_costs,
+                                                        const std::vector<RealT>& fp_fn_cat_awake_costs,
+                                                        RealT deltat) const
+    {
+        const std::size_t nslots = slot_svc_cat_vm_cat_min_num_vms.size();
+        const std::size_t step = win_size_-win_overlap_;
+
+        DCS_DEBUG_TRACE("Finding rolling-horizon multi-slot VM allocation:");
+        DCS_DEBUG_TRACE("- Number of Time Slots: " << nslots);
+        DCS_DEBUG_TRACE("- Window Size: " << win_size_);
+        DCS_DEBUG_TRACE("- Window Overlap: " << win_overlap_);
+
+        auto const start_time = std::chrono::steady_clock::now();
+
+        multislot_vm_allocation_t<RealT> solution;
+        solution.solved = true;
+        solution.optimal = nslots <= win_size_;
+
+        std::vector<bool> cur_fn_power_states = fn_power_states;
+        std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>> cur_fn_vm_allocations = fn_vm_allocations;
+
+        for (std::size_t t0 = 0; t0 < nslots; t0 += step)
+        {
+            auto const t1 = std::min(t0+win_size_, nslots);
+            // Commit the whole window if it reaches the end of the horizon
+            auto const t_commit = (t1 == nslots) ? t1 : t0+step;
+
+            DCS_DEBUG_TRACE("Solving window [" << t0 << "," << t1 << ") - committing slots [" << t0 << "," << t_commit << ")");
+
+            // If the caller has a deadline, the windows left share the time
+            // left before it evenly (the time saved by a window goes to the
+            // next ones)
+            auto win_deadline = detail::solve_deadline_scope_t::current();
+            if (win_deadline != std::chrono::steady_clock::time_point::max())
+            {
+                const std::chrono::steady_clock::rep num_win_left = (nslots-t0 <= win_size_) ? 1 : (nslots-t0-win_size_+step-1)/step+1;
+                auto const now = std::chrono::steady_clock::now();
+
+                win_deadline = now+(win_deadline-now)/num_win_left;
+            }
+            detail::solve_deadline_scope_t deadline_scope(win_deadline);
+
+            const std::vector<std::vector<std::vector<std::size_t>>> win_min_num_vms(slot_svc_cat_vm_cat_min_num_vms.begin()+t0,
+                                                                                     slot_svc_cat_vm_cat_min_num_vms.begin()+t1);
+
+            multislot_vm_allocation_t<RealT> win_solution;
+            if (fixed_fns.size() > 0)
+            {
+                const std::vector<std::set<std::size_t>> win_fixed_fns(fixed_fns.begin()+t0, fixed_fns.begin()+t1);
+
+                win_solution = p_solver_->solve_with_fixed_fns(win_fixed_fns,
+                                                               fn_categories,
+                                                               cur_fn_power_states,
+                                                               cur_fn_vm_allocations,
+                                                               fn_cat_min_powers,
+                                                               fn_cat_max_powers,
+                                                               vm_cat_fn_cat_cpu_specs,
+                                                               vm_cat_alloc_costs,
+                                                               svc_categories,
+                                                               win_min_num_vms,
+                                                               fp_svc_cat_revenues,
+                                                               fp_svc_cat_penalties,
+                                                               fp_electricity_cost,
+                                                               fp_fn_cat_asleep_costs,
+                                                               fp_fn_cat_awake_costs,
+                                                               deltat);
+            }
+            else
+            {
+                win_solution = p_solver_->solve(fn_categories,
+                                                cur_fn_power_states,
+                                                cur_fn_vm_allocations,
+                                                fn_cat_min_powers,
+                                                fn_cat_max_powers,
+                                                vm_cat_fn_cat_cpu_specs,
+                                                vm_cat_alloc_costs,
+                                                svc_categories,
+                                                win_min_num_vms,
+                                                fp_svc_cat_revenues,
+                                                fp_svc_cat_penalties,
+                                                fp_electricity_cost,
+                                                fp_fn_cat_asleep_costs,
+                                                fp_fn_cat_awake_costs,
+                                                deltat);
+            }
+
+            if (!win_solution.solved)
+            {
+                DCS_DEBUG_TRACE("Window [" << t0 << "," << t1 << ") cannot be solved");
+
+                return multislot_vm_allocation_t<RealT>();
+            }
+
+            solution.optimal = solution.optimal && win_solution.optimal;
+            if (t1 == nslots && t0 == 0)
+            {
+                // A single window covers the whole time horizon
+                solution.gap = win_solution.gap;
+            }
+
+            for (std::size_t t = 0; t < t_commit-t0; ++t)
+            {
+                solution.fn_vm_allocations.push_back(std::move(win_solution.fn_vm_allocations[t]));
+                solution.fn_power_states.push_back(std::move(win_solution.fn_power_states[t]));
+                solution.fn_cpu_allocations.push_back(std::move(win_solution.fn_cpu_allocations[t]));
+            }
+
+            // Chain the next window to the last committed slot
+            cur_fn_power_states = solution.fn_power_states.back();
+            cur_fn_vm_allocations = solution.fn_vm_allocations.back();
+
+            if (t1 == nslots)
+            {
+                break;
+            }
+        }
+
+        detail::eval_multislot_vm_allocation(fn_categories,
+                                             fn_power_states,
+                                             fn_vm_allocations,
+                                             fn_cat_min_powers,
+                                             fn_cat_max_powers,
+                                             vm_cat_alloc_costs,
+                                             svc_categories,
+                                             slot_svc_cat_vm_cat_min_num_vms,
+                                             fp_svc_cat_revenues,
+                                             fp_svc_cat_penalties,
+                                             fp_electricity_cost,
+                                             fp_fn_cat_asleep_costs,
+                                             fp_fn_cat_awake_costs,
+                                             deltat,
+                                             solution);
+
+        solution.solve_time = std::chrono::duration_cast<std::chrono::duration<RealT>>(std::chrono::steady_clock::now()-start_time).count();
+
+        DCS_DEBUG_TRACE("- Objective value: " << solution.objective_value);
+        DCS_DEBUG_TRACE("- Solve time: " << solution.solve_time);
+
+        return solution;
+    }
+
+
+private:
+    std::shared_ptr<base_multislot_vm_allocation_solver_t<RealT>> p_solver_; ///< The solver used to solve the VM allocation problem in each window
+    std::size_t win_size_; ///< The number of time slots in each window
+    std::size_t win_overlap_; ///< The number of time slots shared by two consecutive windows
+}; // rolling_horizon_multislot_vm_allocation_solver_t
+
+}} // Namespace dcs::fog
+
+
+#endif // DCS_FOG_VM_ALLOCATION_ROLLING_HORIZON_SOLVER_HPP
@@ -38,6 +38,7 @@
 #include <dcs/fog/user_mobility.hpp>
 #include <dcs/fog/scenario.hpp>
 #include <dcs/logging.hpp>
+#include <dcs/macro.hpp>
 #include <exception>
 #include <iomanip>
 #include <iostream>
@@ -68,13 +69,19 @@ void version(char const* progname);
 
 struct cli_options_t
 {
+    static const std::size_t default_optim_cache_size = 0;
+    static const std::size_t default_optim_greedy_max_passes = 10;
+    static const std::size_t default_optim_num_workers = 0;
+    static constexpr char const* default_optim_ortools_solver = "CBC";
     static constexpr double default_optim_relative_tolerance = 0;
     static constexpr double default_optim_time_limit = -1;
+    static constexpr double default_optim_time_limit_fraction = 0;
     static const unsigned long default_rng_seed = 5489U;
     static constexpr double default_sim_ci_level = 0.95;
     static constexpr double default_sim_ci_rel_precision = 0.04;
     static const std::size_t default_sim_max_num_replications = 0;
     static constexpr double default_sim_max_replication_duration = 0;
+    static const std::size_t default_sim_num_threads = 1;
     static const int default_verbosity = 0;
 
 
@@ -82,11 +89,27 @@ struct cli_options_t
     : help(false),
       optim_relative_tolerance(default_optim_relative_tolerance),
       optim_time_limit(default_optim_time_limit),
+      optim_time_limit_fraction(default_optim_time_limit_fraction),
+      optim_cache_size(default_optim_cache_size),
+      optim_deterministic(false),
+      optim_greedy_max_passes(default_optim_greedy_max_passes),
+      optim_multislot_greedy(false),
+      optim_multislot_linear_switch(false),
+      optim_multislot_window_overlap(0),
+      optim_multislot_window_size(0),
+      optim_num_workers(default_optim_num_workers),
+      optim_ortools_solver(default_optim_ortools_solver),
+      optim_persistent_model(false),
+      optim_portfolio(false),
+      optim_symmetry_breaking(false),
+      optim_warm_start(true),
       rng_seed(default_rng_seed),
       sim_ci_level(default_sim_ci_level),
       sim_ci_rel_precision(default_sim_ci_rel_precision),
       sim_max_num_replications(default_sim_max_num_replications),
       sim_max_replication_duration(default_sim_max_replication_duration),
+      sim_num_threads(default_sim_num_threads),
+      sim_request_level(false),
       test(false),
       verbosity(default_verbosity),
       version(false)
@@ -97,6 +120,21 @@ struct cli_options_t
     bool help;
     double optim_relative_tolerance; ///< The relative tolerance option to set to the optimizer
     double optim_time_limit; ///< The time limit option to set to the optimizer
+    double optim_time_limit_fraction; ///< The time limit of the anytime VM allocation, as a fraction of the VM allocation interval (0 means no anytime VM allocation)
+    std::size_t optim_cache_size; ///< The max number of VM allocations to cache (0 means no cache)
+    bool optim_deterministic; ///< Make the parallel search of the optimizer deterministic
+    std::size_t optim_greedy_max_passes; ///< The max number of local search passes of the 'greedy' VM allocation policy
+    bool optim_multislot_greedy; ///< Solve the multi-slot VM allocation problem with the greedy heuristic regardless of the VM allocation policy
+    bool optim_multislot_linear_switch; ///< Model the switch-on/off costs of the multi-slot optimization by means of linear constraints
+    std::size_t optim_multislot_window_overlap; ///< The number of time slots shared by consecutive windows of the rolling-horizon multi-slot optimization
+    std::size_t optim_multislot_window_size; ///< The number of time slots of each window of the rolling-horizon multi-slot optimization (0 means the whole horizon)
+    std::size_t optim_num_workers; ///< The number of search workers used by the optimizer (0 means the optimizer default)
+    std::string optim_ortools_params; ///< The solver-specific parameters to pass to the OR-Tools solver of the 'ortools' VM allocation policy
+    std::string optim_ortools_solver; ///< The OR-Tools solver to use for the 'ortools' VM allocation policy
+    bool optim_persistent_model; ///< Keep the optimization model alive across intervals and only update its data
+    bool optim_portfolio; ///< Race the solver of the VM allocation policy against the heuristic solvers and keep the best VM allocation
+    bool optim_symmetry_breaking; ///< Break the symmetries among interchangeable FNs by means of additional constraints
+    bool optim_warm_start; ///< Start the optimizer from the VM allocation of the previous interval
     std::string output_stats_data_file; ///< The path to the output stats data file
     std::string output_trace_data_file; ///< The path to the output trace data file
     unsigned long rng_seed; ///< The seed used for random number generation
@@ -105,6 +143,8 @@ struct cli_options_t
     double sim_ci_rel_precision; ///< Relative precision for the half-width of the confidence intervals
     std::size_t sim_max_num_replications; ///< Maximum number of replications (0 means 'unlimited')
     double sim_max_replication_duration; ///< Length of each replication (in terms of simulated time)
+    std::size_t sim_num_threads; ///< Number of threads used to run independent replications in parallel
+    bool sim_request_level; ///< Also simulate services at the level of individual requests
     bool test; ///< Show experimental settings without running any experiment
     int verbosity; ///< The verbosity level: 0 for 'minimum' and 9 for 'maximum' verbosity level
     bool version; ///< Show version information
@@ -136,6 +176,21 @@ cli_options_t parse_cli_options(int argc, char* argv[])
 
     opt.optim_relative_tolerance = cli::simple::get_option<double>(argv, argv+argc, "--optim-reltol", opt.default_optim_relative_tolerance);
     opt.optim_time_limit = cli::simple::get_option<double>(argv, argv+argc, "--optim-tilim", opt.default_optim_time_limit);
+    opt.optim_time_limit_fraction = cli::simple::get_option<double>(argv, argv+argc, "--optim-tilim-fraction", opt.default_optim_time_limit_fraction);
+    opt.optim_cache_size = cli::simple::get_option<std::size_t>(argv, argv+argc, "--optim-cache", opt.default_optim_cache_size);
+    opt.optim_deterministic = cli::simple::get_option(argv, argv+argc, "--optim-deterministic");
+    opt.optim_greedy_max_passes = cli::simple::get_option<std::size_t>(argv, argv+argc, "--optim-greedy-max-passes", opt.default_optim_greedy_max_passes);
+    opt.optim_multislot_greedy = cli::simple::get_option(argv, argv+argc, "--optim-multislot-greedy");
+    opt.optim_multislot_linear_switch = cli::simple::get_option(argv, argv+argc, "--optim-multislot-linear-switch");
+    opt.optim_multislot_window_overlap = cli::simple::get_option<std::size_t>(argv, argv+argc, "--optim-multislot-window-overlap", 0);
+    opt.optim_multislot_window_size = cli::simple::get_option<std::size_t>(argv, argv+argc, "--optim-multislot-window", 0);
+    opt.optim_num_workers = cli::simple::get_option<std::size_t>(argv, argv+argc, "--optim-num-workers", opt.default_optim_num_workers);
+    opt.optim_ortools_params = cli::simple::get_option<std::string>(argv, argv+argc, "--optim-ortools-params");
+    opt.optim_ortools_solver = cli::simple::get_option<std::string>(argv, argv+argc, "--optim-ortools-solver", opt.default_optim_ortools_solver);
+    opt.optim_persistent_model = cli::simple::get_option(argv, argv+argc, "--optim-persistent-model");
+    opt.optim_portfolio = cli::simple::get_option(argv, argv+argc, "--optim-portfolio");
+    opt.optim_symmetry_breaking = cli::simple::get_option(argv, argv+argc, "--optim-symmetry-breaking");
+    opt.optim_warm_start = !cli::simple::get_option(argv, argv+argc, "--optim-no-warm-start");
     opt.output_stats_data_file = cli::simple::get_option<std::string>(argv, argv+argc, "--out-stats-file");
     opt.output_trace_data_file = cli::simple::get_option<std::string>(argv, argv+argc, "--out-trace-file");
     opt.rng_seed = cli::simple::get_option<unsigned long>(argv, argv+argc, "--rng-seed", opt.default_rng_seed);
@@ -144,6 +199,12 @@ cli_options_t parse_cli_options(int argc, char* argv[])
     opt.sim_ci_rel_precision = cli::simple::get_option<double>(argv, argv+argc, "--sim-ci-rel-precision", opt.default_sim_ci_rel_precision);
     opt.sim_max_num_replications = cli::simple::get_option<std::size_t>(argv, argv+argc, "--sim-max-num-rep", opt.default_sim_max_num_replications);
     opt.sim_max_replication_duration = cli::simple::get_option<double>(argv, argv+argc, "--sim-max-rep-len", opt.default_sim_max_replication_duration);
+    opt.sim_num_threads = cli::simple::get_option<std::size_t>(argv, argv+argc, "--sim-num-threads", opt.default_sim_num_threads);
+    if (opt.sim_num_threads == 0)
+    {
+        opt.sim_num_threads = 1;
+    }
+    opt.sim_request_level = cli::simple::get_option(argv, argv+argc, "--sim-request-level");
     opt.test = cli::simple::get_option(argv, argv+argc, "--test");
     opt.verbosity = cli::simple::get_option<short>(argv, argv+argc, "--verbosity", opt.default_verbosity);
     if (opt.verbosity < 0)
@@ -160,6 +221,14 @@ cli_options_t parse_cli_options(int argc, char* argv[])
     {
         DCS_EXCEPTION_THROW( std::invalid_argument, "Scenario file not specified" );
     }
+    if (opt.optim_time_limit_fraction < 0)
+    {
+        DCS_EXCEPTION_THROW( std::invalid_argument, "Time limit fraction must be non-negative" );
+    }
+    if (opt.optim_multislot_window_size > 0 && opt.optim_multislot_window_overlap >= opt.optim_multislot_window_size)
+    {
+        DCS_EXCEPTION_THROW( std::invalid_argument, "Multi-slot window overlap must be less than the window size" );
+    }
 
     return opt;
 }
@@ -170,6 +239,21 @@ std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharT
     os  << "help: " << opts.help
         << ", optim-relative-tolerance: " << opts.optim_relative_tolerance
         << ", optim-time-limit: " << opts.optim_time_limit
+        << ", optim-time-limit-fraction: " << opts.optim_time_limit_fraction
+        << ", optim-cache-size: " << opts.optim_cache_size
+        << ", optim-deterministic: " << opts.optim_deterministic
+        << ", optim-greedy-max-passes: " << opts.optim_greedy_max_passes
+        << ", optim-multislot-greedy: " << opts.optim_multislot_greedy
+        << ", optim-multislot-linear-switch: " << opts.optim_multislot_linear_switch
+        << ", optim-multislot-window-overlap: " << opts.optim_multislot_window_overlap
+        << ", optim-multislot-window-size: " << opts.optim_multislot_window_size
+        << ", optim-num-workers: " << opts.optim_num_workers
+        << ", optim-ortools-params: " << opts.optim_ortools_params
+        << ", optim-ortools-solver: " << opts.optim_ortools_solver
+        << ", optim-persistent-model: " << opts.optim_persistent_model
+        << ", optim-portfolio: " << opts.optim_portfolio
+        << ", optim-symmetry-breaking: " << opts.optim_symmetry_breaking
+        << ", optim-warm-start: " << opts.optim_warm_start
         << ", output-stats-data-file: " << opts.output_stats_data_file
         << ", output-trace-data-file: " << opts.output_trace_data_file
         << ", random-generator-seed: " << opts.rng_seed
@@ -178,6 +262,8 @@ std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharT
         << ", sim-ci-relative-precision: " << opts.sim_ci_rel_precision
         << ", sim-max-num-replications: " << opts.sim_max_num_replications
         << ", sim-max-replication-duration: " << opts.sim_max_replication_duration
+        << ", sim-num-threads: " << opts.sim_num_threads
+        << ", sim-request-level: " << opts.sim_request_level
         << ", test: " << opts.test
         << ", verbosity: " << opts.verbosity
         << ", version: " << opts.version;
@@ -195,6 +281,36 @@ void usage(char const* progname)
               << "  Real number in [0,1] denoting the relative tolerance parameter in the optimizer." << std::endl
               << "--optim-tilim <num>" << std::endl
               << "  Real positive number denoting the maximum number of seconds to wait for the termination of the optimizer." << std::endl
+              << "--optim-tilim-fraction <num>" << std::endl
+              << "  Real number >= 0 denoting the maximum time to wait for each VM allocation as a fraction of the VM allocation interval of the scenario (overrides --optim-tilim). When positive, VM allocations are computed in anytime mode: the 'greedy' heuristic quickly gives a VM allocation, which the solver of the VM allocation policy then tries to improve until the time limit expires (the same holds for the multi-slot VM allocation). Use 0 to disable." << std::endl
+              << "--optim-cache <num>" << std::endl
+              << "  Integer number >= 0 denoting the max number of VM allocations to cache, so that VM allocation problems that have already been solved (e.g., in previous intervals) are not solved again. The least recently used VM allocations are evicted first. Use 0 to disable the cache." << std::endl
+              << "--optim-deterministic" << std::endl
+              << "  Make the parallel search of the optimizer deterministic, so that repeated runs with the same number of workers give the same result (CPLEX and OR-Tools CP-SAT solvers only)." << std::endl
+              << "--optim-greedy-max-passes <num>" << std::endl
+              << "  Integer number >= 0 denoting the max number of local search passes used by the 'greedy' VM allocation policy. Use 0 to disable the local search." << std::endl
+              << "--optim-multislot-greedy" << std::endl
+              << "  Solve the multi-slot VM allocation problem (e.g., the one for the global optimal allocation) with the greedy heuristic regardless of the VM allocation policy, so that CPLEX is not needed for it." << std::endl
+              << "--optim-multislot-linear-switch" << std::endl
+              << "  Model the switch-on/off costs of FNs in the multi-slot VM allocation problem by means of switch variables and linear constraints rather than products of power-state variables (CPLEX solver only)." << std::endl
+              << "--optim-multislot-window <num>" << std::endl
+              << "  Integer number >= 0 denoting the number of time slots of each window used to solve the multi-slot VM allocation problem with a rolling horizon. Use 0 to solve the whole horizon at once." << std::endl
+              << "--optim-multislot-window-overlap <num>" << std::endl
+              << "  Integer number >= 0 denoting the number of time slots shared by consecutive windows of the rolling horizon (must be less than the window size)." << std::endl
+              << "--optim-num-workers <num>" << std::endl
+              << "  Integer number >= 0 denoting the number of search workers used by the optimizer. Use 0 for the optimizer default (usually, one per core). For the OR-Tools CP-SAT solver, this sets 'num_workers' in its SatParameters (one per core when 0), unless --optim-ortools-params already sets it." << std::endl
+              << "--optim-ortools-params <string>" << std::endl
+              << "  Solver-specific parameters passed as they are to the OR-Tools solver used by the 'ortools' VM allocation policy, in the format of that solver. For CP-SAT this is a SatParameters text proto, which tunes its portfolio of search workers (e.g., 'num_workers:32 use_lns_only:true' or 'subsolvers:\"default_lns\" subsolvers:\"core\"')." << std::endl
+              << "--optim-ortools-solver <name>" << std::endl
+              << "  The OR-Tools solver used by the 'ortools' VM allocation policy (e.g., 'CBC', 'SCIP', 'HIGHS' or 'CP-SAT'). CP-SAT is only reachable as a backend of the OR-Tools linear solver wrapper (MPSolver), not through a CP-SAT model of its own: its search workers can only be tuned by --optim-num-workers and --optim-ortools-params (as SatParameters)." << std::endl
+              << "--optim-persistent-model" << std::endl
+              << "  Keep the optimization model alive across intervals and only update the data that change (CPLEX solver only). By default, the model is built anew for every VM allocation." << std::endl
+              << "--optim-portfolio" << std::endl
+              << "  Race the solver of the VM allocation policy against the 'greedy' and 'bahreini2017_match_alt' heuristics, each one on its own thread, and keep the most profitable VM allocation. Exact solvers start from the best heuristic VM allocation, and the race stops at the first optimal VM allocation or when the time limit given by --optim-tilim (or --optim-tilim-fraction) expires." << std::endl
+              << "--optim-symmetry-breaking" << std::endl
+              << "  Break the symmetries among FNs of the same category that are in the same power state and host the same VMs by means of additional ordering constraints." << std::endl
+              << "--optim-no-warm-start" << std::endl
+              << "  Do not start the optimizer from the VM allocation of the previous interval." << std::endl
               << "--out-stats-file <file>" << std::endl
               << "  The output file where writing statistics." << std::endl
               << "--out-trace-file <file>" << std::endl
@@ -211,6 +327,10 @@ void usage(char const* progname)
               << "  Real number >= 0 denoting the maximum duration of each independent replication." << std::endl
               << "--sim-max-num-rep <num>" << std::endl
               << "  Integer number >= 0 denoting the maximum number of independent replications. Use 0 for an unlimited number of replications." << std::endl
+              << "--sim-num-threads <num>" << std::endl
+              << "  Integer number >= 1 denoting the number of threads used to run independent replications in parallel." << std::endl
+              << "--sim-request-level" << std::endl
+              << "  Also simulate services at the level of individual requests, and report request delays (mean and percentiles)." << std::endl
               << "--test" << std::endl
               << "  Show the experiment settings without running any experiment." << std::endl
               << "--verbosity <num>" << std::endl
@@ -225,11 +345,37 @@ void version(char const* progname)
     std::cout << progname << " version " << DCS_FOG_VM_ALLOC_DETAIL_VERSION_STR << std::endl;
 }
 
+/// Makes the solver of the multi-slot VM allocation problem of the VM allocation policies that have no multi-slot counterpart
+template <typename RealT>
+std::shared_ptr<fog::base_multislot_vm_allocation_solver_t<RealT>> make_optimal_multislot_vm_allocation_solver(const cli_options_t& opts, RealT optim_time_limit)
+{
+#ifdef DCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER
+    auto p_solver = std::make_shared<fog::optimal_multislot_vm_allocation_solver_t<RealT>>(opts.optim_relative_tolerance, optim_time_limit, opts.optim_multislot_linear_switch);
+    p_solver->num_workers(opts.optim_num_workers);
+    p_solver->deterministic(opts.optim_deterministic);
+    return p_solver;
+#else // DCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER
+    DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( optim_time_limit );
+
+    if (!opts.optim_multislot_greedy)
+    {
+        dcs::log_warn(DCS_LOGGING_AT, "Optimal multi-slot VM allocation is not available (rebuild with DCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER): the greedy heuristic is used instead");
+    }
+    return std::make_shared<fog::greedy_multislot_vm_allocation_solver_t<RealT>>(opts.optim_greedy_max_passes);
+#endif // DCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER
+}
+
 template <typename RealT, typename RNGT>
 void run_experiment(const fog::scenario_t<RealT>& scen, const cli_options_t& opts, RNGT& rng)
 {
     fog::experiment_t<RealT> exp;
 
+    // In anytime mode, each VM allocation must be computed within a fraction of the VM allocation interval
+    const bool optim_anytime = opts.optim_time_limit_fraction > 0;
+    const RealT optim_time_limit = optim_anytime
+                                   ? static_cast<RealT>(opts.optim_time_limit_fraction*scen.fp_vm_allocation_interval)
+                                   : static_cast<RealT>(opts.optim_time_limit);
+
     // Setup experiment
     // - Load scenario
     exp.num_fog_node_categories(scen.num_fn_categories);
@@ -261,6 +407,8 @@ void run_experiment(const fog::scenario_t<RealT>& scen, const cli_options_t& opt
     // - Add options
     exp.max_num_replications(opts.sim_max_num_replications);
     exp.max_replication_duration(opts.sim_max_replication_duration);
+    exp.num_threads(opts.sim_num_threads);
+    exp.request_level_simulation(opts.sim_request_level);
     exp.confidence_interval_level(opts.sim_ci_level);
     exp.confidence_interval_relative_precision(opts.sim_ci_rel_precision);
     exp.output_stats_data_file(opts.output_stats_data_file);
@@ -268,7 +416,7 @@ void run_experiment(const fog::scenario_t<RealT>& scen, const cli_options_t& opt
     exp.verbosity_level(opts.verbosity);
     //exp.service_delay_tolerance(opts.service_delay_tolerance);
     exp.optimization_relative_tolerance(opts.optim_relative_tolerance);
-    exp.optimization_max_duration(opts.optim_time_limit);
+    exp.optimization_max_duration(optim_time_limit);
     //exp.service_arrival_rate_estimation(opts.service_arrival_rate_estimation);
     //exp.fp_penalty_policy(opts.fp_penalty_policy);
     //exp.fp_penalty_model(opts.fp_penalty_model);
@@ -380,22 +528,134 @@ void run_experiment(const fog::scenario_t<RealT>& scen, const cli_options_t& opt
     }
     //exp.user_mobility_model(std::make_shared<fog::random_waypoint_user_mobility_model_t>(300, 100, 100));
     exp.user_mobility_model(p_usr_mob_model);
+    if (scen.svc_user_mobility_model_params.count("area") > 0)
+    {
+        // One area per service, each one given as "min_x,max_x,min_y,max_y"
+        std::vector<fog::rectangular_area_t> areas;
+        for (auto const& str_val : scen.svc_user_mobility_model_params.at("area"))
+        {
+            fog::rectangular_area_t area;
+            char sep1 = 0;
+            char sep2 = 0;
+            char sep3 = 0;
+
+            std::istringstream iss(str_val);
+            iss >> area.min_x >> sep1 >> area.max_x >> sep2 >> area.min_y >> sep3 >> area.max_y;
+            if (iss.fail() || sep1 != ',' || sep2 != ',' || sep3 != ',')
+            {
+                DCS_EXCEPTION_THROW( std::invalid_argument, "Malformed user mobility area '" + str_val + "' (expected 'min_x,max_x,min_y,max_y')" );
+            }
+            areas.push_back(area);
+        }
+        exp.user_mobility_areas(areas.begin(), areas.end());
+    }
     std::shared_ptr<fog::base_vm_allocation_solver_t<RealT>> p_vm_alloc_solver;
     std::shared_ptr<fog::base_multislot_vm_allocation_solver_t<RealT>> p_multislot_vm_alloc_solver;
     switch (scen.fp_vm_allocation_policy)
     {
         case fog::optimal_vm_allocation_policy:
-            p_vm_alloc_solver = std::make_shared<fog::optimal_vm_allocation_solver_t<RealT>>(opts.optim_relative_tolerance, opts.optim_time_limit);
-            p_multislot_vm_alloc_solver = std::make_shared<fog::optimal_multislot_vm_allocation_solver_t<RealT>>(opts.optim_relative_tolerance, opts.optim_time_limit);
+#ifdef DCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER
+            {
+                auto p_optimal_vm_alloc_solver = std::make_shared<fog::optimal_vm_allocation_solver_t<RealT>>(opts.optim_relative_tolerance, optim_time_limit, opts.optim_warm_start, opts.optim_persistent_model, opts.optim_symmetry_breaking);
+                p_optimal_vm_alloc_solver->num_workers(opts.optim_num_workers);
+                p_optimal_vm_alloc_solver->deterministic(opts.optim_deterministic);
+                p_vm_alloc_solver = p_optimal_vm_alloc_solver;
+            }
+            p_multislot_vm_alloc_solver = make_optimal_multislot_vm_allocation_solver(opts, optim_time_limit);
+#else // DCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER
+            DCS_EXCEPTION_THROW( std::runtime_error, "Optimal VM allocation policy is not available (rebuild with DCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER)" );
+#endif // DCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER
             break;
         case fog::bahreini2017_match_vm_allocation_policy:
             p_vm_alloc_solver = std::make_shared<fog::bahreini2017_mcappim_vm_allocation_solver_t<RealT>>();
-            p_multislot_vm_alloc_solver = std::make_shared<fog::optimal_multislot_vm_allocation_solver_t<RealT>>(opts.optim_relative_tolerance, opts.optim_time_limit); //FIXME: multislot VM allocation uses optimal VM allocation policy
+            p_multislot_vm_alloc_solver = make_optimal_multislot_vm_allocation_solver(opts, optim_time_limit); //FIXME: multislot VM allocation uses optimal VM allocation policy
             break;
         case fog::bahreini2017_match_alt_vm_allocation_policy:
             p_vm_alloc_solver = std::make_shared<fog::bahreini2017_mcappim_alt_vm_allocation_solver_t<RealT>>();
-            p_multislot_vm_alloc_solver = std::make_shared<fog::optimal_multislot_vm_allocation_solver_t<RealT>>(opts.optim_relative_tolerance, opts.optim_time_limit); //FIXME: multislot VM allocation uses optimal VM allocation policy
+            p_multislot_vm_alloc_solver = make_optimal_multislot_vm_allocation_solver(opts, optim_time_limit); //FIXME: multislot VM allocation uses optimal VM allocation policy
+            break;
+        case fog::bahreini2017_match_flow_vm_allocation_policy:
+#ifdef DCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER
+            p_vm_alloc_solver = std::make_shared<fog::bahreini2017_mcappim_flow_vm_allocation_solver_t<RealT>>();
+            p_multislot_vm_alloc_solver = make_optimal_multislot_vm_allocation_solver(opts, optim_time_limit); //FIXME: multislot VM allocation uses optimal VM allocation policy
+#else // DCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER
+            DCS_EXCEPTION_THROW( std::runtime_error, "Min-cost flow Bahreini VM allocation policy is not available (rebuild with DCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER)" );
+#endif // DCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER
+            break;
+        case fog::aggregated_vm_allocation_policy:
+#ifdef DCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER
+            p_vm_alloc_solver = std::make_shared<fog::aggregated_vm_allocation_solver_t<RealT>>(opts.optim_relative_tolerance, optim_time_limit);
+            p_multislot_vm_alloc_solver = make_optimal_multislot_vm_allocation_solver(opts, optim_time_limit); //FIXME: multislot VM allocation uses optimal VM allocation policy
+#else // DCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER
+            DCS_EXCEPTION_THROW( std::runtime_error, "Aggregated VM allocation policy is not available (rebuild with DCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER)" );
+#endif // DCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER
             break;
+        case fog::greedy_vm_allocation_policy:
+            p_vm_alloc_solver = std::make_shared<fog::greedy_vm_allocation_solver_t<RealT>>(opts.optim_greedy_max_passes);
+            p_multislot_vm_alloc_solver = std::make_shared<fog::greedy_multislot_vm_allocation_solver_t<RealT>>(opts.optim_greedy_max_passes);
+            break;
+        case fog::ortools_vm_allocation_policy:
+#ifdef DCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER
+            p_vm_alloc_solver = std::make_shared<fog::ortools_vm_allocation_solver_t<RealT>>(opts.optim_ortools_solver, opts.optim_relative_tolerance, optim_time_limit, opts.optim_num_workers, opts.optim_deterministic, opts.optim_ortools_params);
+            p_multislot_vm_alloc_solver = std::make_shared<fog::ortools_multislot_vm_allocation_solver_t<RealT>>(opts.optim_ortools_solver, opts.optim_relative_tolerance, optim_time_limit, opts.optim_num_workers, opts.optim_deterministic, opts.optim_ortools_params);
+#else // DCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER
+            DCS_EXCEPTION_THROW( std::runtime_error, "OR-Tools VM allocation policy is not available (rebuild with DCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER)" );
+#endif // DCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER
+            break;
+    }
+    if (opts.optim_portfolio || optim_anytime)
+    {
+        std::vector<std::shared_ptr<fog::base_vm_allocation_solver_t<RealT>>> heuristic_solvers;
+        std::vector<std::shared_ptr<fog::base_vm_allocation_solver_t<RealT>>> exact_solvers;
+
+        // The greedy heuristic gives the starting VM allocation of the anytime mode
+        heuristic_solvers.push_back(std::make_shared<fog::greedy_vm_allocation_solver_t<RealT>>(opts.optim_greedy_max_passes));
+        if (opts.optim_portfolio)
+        {
+            heuristic_solvers.push_back(std::make_shared<fog::bahreini2017_mcappim_alt_vm_allocation_solver_t<RealT>>());
+        }
+        switch (scen.fp_vm_allocation_policy)
+        {
+            case fog::greedy_vm_allocation_policy:
+                // Already in the portfolio
+                break;
+            case fog::bahreini2017_match_alt_vm_allocation_policy:
+                if (!opts.optim_portfolio)
+                {
+                    heuristic_solvers.push_back(p_vm_alloc_solver);
+                }
+                break;
+            case fog::bahreini2017_match_vm_allocation_policy:
+            case fog::bahreini2017_match_flow_vm_allocation_policy:
+                heuristic_solvers.push_back(p_vm_alloc_solver);
+                break;
+            default:
+                exact_solvers.push_back(p_vm_alloc_solver);
+                break;
+        }
+        p_vm_alloc_solver = std::make_shared<fog::portfolio_vm_allocation_solver_t<RealT>>(heuristic_solvers, exact_solvers, optim_time_limit, opts.optim_relative_tolerance);
+    }
+    if (opts.optim_multislot_greedy)
+    {
+        p_multislot_vm_alloc_solver = std::make_shared<fog::greedy_multislot_vm_allocation_solver_t<RealT>>(opts.optim_greedy_max_passes);
+    }
+    if (opts.optim_multislot_window_size > 0)
+    {
+        p_multislot_vm_alloc_solver = std::make_shared<fog::rolling_horizon_multislot_vm_allocation_solver_t<RealT>>(p_multislot_vm_alloc_solver, opts.optim_multislot_window_size, opts.optim_multislot_window_overlap);
+    }
+    if (optim_anytime && !opts.optim_multislot_greedy && scen.fp_vm_allocation_policy != fog::greedy_vm_allocation_policy)
+    {
+        std::vector<std::shared_ptr<fog::base_multislot_vm_allocation_solver_t<RealT>>> multislot_solvers;
+
+        multislot_solvers.push_back(std::make_shared<fog::greedy_multislot_vm_allocation_solver_t<RealT>>(opts.optim_greedy_max_passes));
+        multislot_solvers.push_back(p_multislot_vm_alloc_solver);
+        p_multislot_vm_alloc_solver = std::make_shared<fog::portfolio_multislot_vm_allocation_solver_t<RealT>>(multislot_solvers, optim_time_limit, opts.optim_relative_tolerance);
+    }
+    std::shared_ptr<fog::caching_vm_allocation_solver_t<RealT>> p_caching_vm_alloc_solver;
+    if (opts.optim_cache_size > 0)
+    {
+        p_caching_vm_alloc_solver = std::make_shared<fog::caching_vm_allocation_solver_t<RealT>>(p_vm_alloc_solver, opts.optim_cache_size);
+        p_vm_alloc_solver = p_caching_vm_alloc_solver;
     }
     exp.vm_allocation_solver(p_vm_alloc_solver);
     exp.multislot_vm_allocation_solver(p_multislot_vm_alloc_solver);
@@ -430,6 +690,10 @@ void run_experiment(const fog::scenario_t<RealT>& scen, const cli_options_t& opt
     std::chrono::duration<double> elapsed_seconds = stop_clock-start_clock;
 
     DCS_LOGGING_STREAM << "**** ELAPSED TIME: " << elapsed_seconds.count() << "s" << std::endl;
+    if (p_caching_vm_alloc_solver)
+    {
+        DCS_LOGGING_STREAM << "**** VM ALLOCATION CACHE: hits: " << p_caching_vm_alloc_solver->num_hits() << ", misses: " << p_caching_vm_alloc_solver->num_misses() << ", hit rate: " << p_caching_vm_alloc_solver->hit_rate() << ", size: " << p_caching_vm_alloc_solver->size() << "/" << p_caching_vm_alloc_solver->max_size() << std::endl;
+    }
     DCS_LOGGING_STREAM << "**** [" << std::put_time(std::localtime(&stop_time), "%c %Z") << "]" << std::endl;
     DCS_LOGGING_STREAM << "****************************************************************" << std::endl;
 }
@@ -15,8 +15,10 @@ boost_ldflags = -L$(boost_home_)/stage/lib
 boost_ldlibs =
 
 ## [CPLEX]
+# - Comment out to build without CPLEX (the 'optimal' and 'aggregated' VM allocation policies are then not available)
 cplex_home_ = $(HOME)/sys/opt/optim/ibm/ILOG/CPLEX_Studio1271
 cplex_cflags = -I$(cplex_home_)/cplex/include -I$(cplex_home_)/cpoptimizer/include -I$(cplex_home_)/concert/include -DIL_STD
+cplex_cflags += -DDCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER
 cplex_cflags += -DDCS_FOG_VM_ALLOC_USE_NATIVE_CP_SOLVER
 cplex_ldflags = -L$(cplex_home_)/cplex/lib/x86-64_linux/static_pic -L$(cplex_home_)/cpoptimizer/lib/x86-64_linux/static_pic -L$(cplex_home_)/concert/lib/x86-64_linux/static_pic
 cplex_ldlibs = -lilocplex -lcp -lcplex -lconcert -lm -lpthread
@@ -28,6 +30,16 @@ dcs_commons_cflags = -I$(dcs_commons_home_)/inc
 dcs_commons_ldflags =
 dcs_commons_ldlibs =
 
+## [OR-tools]
+# - Uncomment to enable the OR-Tools based VM allocation solvers (which require the OR-Tools library)
+#ortools_home_ = $(thirdparty_path_)/or-tools
+#ortools_cflags = -DDCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER
+#ortools_ldflags = -L$(ortools_home_)/lib
+#ortools_ldlibs = -lortools
+ortools_cflags =
+ortools_ldflags =
+ortools_ldlibs =
+
 ## [YAML-cpp]
 yamlcpp_cflags =
 yamlcpp_ldflags =
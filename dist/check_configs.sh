@@ -0,0 +1,195 @@
+#!/bin/sh
+
+## Builds the simulator in each solver configuration, with warnings turned into
+## errors, and runs a short simulation of the smoke scenario with each VM
+## allocation solver available in that configuration.
+##
+## Configurations are the licence-free one (no CPLEX at all), and the CPLEX
+## and the CP Optimizer based optimal solvers (the latter two only if CPLEX is
+## enabled in config.mk), each one with and without the OR-Tools based solvers
+## (the latter only if OR-Tools is enabled in config.mk).
+## These configurations allocate VMs for the real workload on the FNs selected
+## for the predicted one (i.e., DCS_FOG_VMALLOC_REAL_WORKLOAD_ALLOCATE_WITH_FIXED_FNS),
+## while the '@all' and '@none' variants check the other two allocation methods.
+## Compiler and linker flags are taken from the environment (see the
+## 'check-configs' target of the Makefile, which exports them).
+
+if [ "$#" -lt "2" ]; then
+	echo "Usage: $0 <base dir> <object file>..."
+	exit 1
+fi
+
+base_dir=$1
+shift
+if [ ! -d "$base_dir" ]; then
+	echo "Wrong base directory '$base_dir'"
+	exit 1
+fi
+
+objs="$@"
+src=$base_dir/c++/src/fog_vmalloc.cpp
+scenario=$base_dir/dist/smoke_scenario.dat
+out_dir=$(mktemp -d)
+trap 'rm -rf "$out_dir"' EXIT
+
+CXX=${CXX:-c++}
+sim_opts="--sim-max-num-rep 2 --sim-max-rep-len 50 --sim-num-threads 2 --rng-seed 1 --optim-tilim 10"
+
+configs="free"
+case " $CXXFLAGS " in
+	*" -DDCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER "*)
+		configs="$configs cplex cp"
+		;;
+	*)
+		echo "CPLEX is not enabled: only the licence-free configurations are checked"
+		;;
+esac
+case " $CXXFLAGS " in
+	*" -DDCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER "*)
+		for config in $configs; do
+			configs="$configs $config+ortools"
+		done
+		;;
+esac
+for config in free cplex cp; do
+	case " $configs " in
+		*" $config "*)
+			configs="$configs $config@all $config@none"
+			;;
+	esac
+done
+
+num_failures=0
+
+## Prints the given flags but the CPLEX ones (i.e., include and library paths, and libraries)
+without_cplex() {
+	for flag in "$@"; do
+		case $flag in
+			*cplex*|*concert*|*cpoptimizer*|-lcp)
+				;;
+			*)
+				printf '%s ' "$flag"
+				;;
+		esac
+	done
+}
+
+## Runs the simulator of the given configuration with the given VM allocation policy and options
+## (the run fails if the simulator fails, reports an anomaly or CPLEX rejects a warm start)
+run() {
+	config=$1
+	policy=$2
+	shift 2
+
+	sed -e "s/^fp.vm_allocation_policy.*/fp.vm_allocation_policy = $policy/" "$scenario" > "$out_dir/scenario.dat"
+
+	log=$out_dir/$config-$policy.log
+	printf '%s' "- [$config] $policy${*:+ $*} ... "
+	if "$out_dir/fog_vmalloc-$config" --scenario "$out_dir/scenario.dat" $sim_opts "$@" > "$log" 2>&1 \
+	   && ! grep -qi -e "anomaly" -e "did not accept the warm start" "$log"; then
+		echo "OK"
+	else
+		echo "FAILED (see below)"
+		tail -n 20 "$log"
+		num_failures=$((num_failures + 1))
+	fi
+}
+
+for config in $configs; do
+	cxxflags=$CXXFLAGS
+	ldflags=$LDFLAGS
+	ldlibs=$LDLIBS
+	cfg_flags="-UDCS_FOG_VMALLOC_REAL_WORKLOAD_ALLOCATE_ALL -UDCS_FOG_VMALLOC_REAL_WORKLOAD_ALLOCATE_WITH_FIXED_FNS -UDCS_FOG_VMALLOC_REAL_WORKLOAD_ALLOCATE_NONE"
+	case $config in
+		*@all)
+			cfg_flags="$cfg_flags -DDCS_FOG_VMALLOC_REAL_WORKLOAD_ALLOCATE_ALL"
+			;;
+		*@none)
+			cfg_flags="$cfg_flags -DDCS_FOG_VMALLOC_REAL_WORKLOAD_ALLOCATE_NONE"
+			;;
+		*)
+			cfg_flags="$cfg_flags -DDCS_FOG_VMALLOC_REAL_WORKLOAD_ALLOCATE_WITH_FIXED_FNS"
+			;;
+	esac
+	case $config in
+		free*)
+			# Nothing from CPLEX must be needed, so its headers and libraries are left out
+			cxxflags=$(without_cplex $CXXFLAGS)
+			ldflags=$(without_cplex $LDFLAGS)
+			ldlibs=$(without_cplex $LDLIBS)
+			cfg_flags="$cfg_flags -UDCS_FOG_VM_ALLOC_ENABLE_CPLEX_SOLVER"
+			policies="greedy bahreini2017_match bahreini2017_match_alt"
+			;;
+		cplex*)
+			cfg_flags="$cfg_flags -UDCS_FOG_VM_ALLOC_USE_CP_SOLVER -DDCS_FOG_VM_ALLOC_USE_CPLEX_SOLVER"
+			policies="optimal aggregated greedy bahreini2017_match bahreini2017_match_alt"
+			;;
+		cp*)
+			cfg_flags="$cfg_flags -UDCS_FOG_VM_ALLOC_USE_CPLEX_SOLVER -DDCS_FOG_VM_ALLOC_USE_CP_SOLVER"
+			policies="optimal aggregated greedy bahreini2017_match bahreini2017_match_alt"
+			;;
+	esac
+	case $config in
+		*+ortools)
+			policies="$policies bahreini2017_match_flow ortools"
+			;;
+		*)
+			cfg_flags="$cfg_flags -UDCS_FOG_VM_ALLOC_ENABLE_ORTOOLS_SOLVER"
+			;;
+	esac
+
+	echo "Building configuration '$config'..."
+	if ! $CXX $cxxflags $cfg_flags -Werror $ldflags -o "$out_dir/fog_vmalloc-$config" "$src" $objs $ldlibs; then
+		echo "Configuration '$config' FAILED to build"
+		num_failures=$((num_failures + 1))
+		continue
+	fi
+
+	case $config in
+		free@*)
+			# Only check the allocation of VMs for the real workload
+			run $config greedy
+			continue
+			;;
+		*@*)
+			# Only check the allocation of VMs for the real workload, also with the warm start from the pooled model
+			run $config optimal
+			run $config optimal --optim-persistent-model
+			continue
+			;;
+	esac
+
+	for policy in $policies; do
+		run $config $policy
+	done
+
+	# Solver options that change the way the VM allocation solvers are used
+	case $config in
+		free*)
+			run $config greedy --optim-cache 16
+			run $config greedy --optim-portfolio --optim-tilim-fraction 0.5
+			run $config bahreini2017_match --optim-multislot-window 2 --optim-multislot-window-overlap 1
+			;;
+		*)
+			run $config optimal --optim-no-warm-start
+			run $config optimal --optim-persistent-model --optim-symmetry-breaking
+			run $config optimal --optim-num-workers 2 --optim-deterministic
+			run $config optimal --optim-cache 16
+			run $config optimal --optim-portfolio --optim-tilim-fraction 0.5
+			run $config optimal --optim-multislot-greedy
+			run $config optimal --optim-multislot-window 2 --optim-multislot-window-overlap 1
+			;;
+	esac
+	case $config in
+		cplex*)
+			run $config optimal --optim-multislot-linear-switch
+			;;
+	esac
+	run $config greedy --sim-request-level
+done
+
+if [ "$num_failures" -gt "0" ]; then
+	echo "$num_failures check(s) FAILED"
+	exit 1
+fi
+echo "All configurations OK"
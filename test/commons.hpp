@@ -0,0 +1,89 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/commons.hpp
+ *
+ * \brief Minimal support for the test programs.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FOG_TEST_COMMONS_HPP
+#define DCS_FOG_TEST_COMMONS_HPP
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+
+
+namespace dcs { namespace fog { namespace test {
+
+/// Returns the number of failed checks
+inline std::size_t& num_failures()
+{
+    static std::size_t n = 0;
+
+    return n;
+}
+
+/// Records the outcome of a check
+inline bool check(bool passed, const char* what, const char* file, int line)
+{
+    if (!passed)
+    {
+        ++num_failures();
+        std::cerr << file << ":" << line << ": check failed: " << what << std::endl;
+    }
+
+    return passed;
+}
+
+/// Tells if \a x and \a y are equal up to the relative tolerance \a tol
+template <typename RealT>
+bool rel_close(RealT x, RealT y, RealT tol)
+{
+    return std::abs(x-y) <= tol*std::max(std::abs(x), std::abs(y));
+}
+
+/// Prints a summary of the checks and returns the exit status of the test program
+inline int report(const char* name)
+{
+    if (num_failures() > 0)
+    {
+        std::cerr << name << ": " << num_failures() << " check(s) failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << name << ": all checks passed" << std::endl;
+    return 0;
+}
+
+}}} // Namespace dcs::fog::test
+
+
+#define DCS_FOG_TEST_CHECK(x) ::dcs::fog::test::check((x), #x, __FILE__, __LINE__)
+
+#define DCS_FOG_TEST_CHECK_EQ(x,y) ::dcs::fog::test::check((x) == (y), #x " == " #y, __FILE__, __LINE__)
+
+#define DCS_FOG_TEST_CHECK_REL_CLOSE(x,y,tol) ::dcs::fog::test::check(::dcs::fog::test::rel_close((x), (y), (tol)), #x " ~= " #y, __FILE__, __LINE__)
+
+
+#endif // DCS_FOG_TEST_COMMONS_HPP
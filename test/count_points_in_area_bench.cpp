@@ -0,0 +1,129 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/count_points_in_area_bench.cpp
+ *
+ * \brief Compares the kernels that count the points inside an area.
+ *
+ * For each number of points, the points inside the fog node area (the square
+ * centered in the simulation area whose sides are 10% of the ones of the
+ * simulation area) are counted with the scalar kernel and with each SIMD
+ * kernel supported by the CPU, and the average time per point is reported.
+ *
+ * Usage: count_points_in_area_bench
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <dcs/fog/user_mobility/commons.hpp>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace {
+
+/// Counts the points with the given kernel (repeatedly, so that at least 1e8 points are counted) and returns the average time (in ns) per point
+double count_time(dcs::fog::detail::count_points_in_area_kernel_t kernel, const std::vector<double>& x, const std::vector<double>& y, const dcs::fog::rectangular_area_t& area, std::size_t& count)
+{
+    const std::size_t num_reps = std::max(static_cast<std::size_t>(1e8/x.size()), static_cast<std::size_t>(1));
+
+    count = 0;
+
+    auto const start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < num_reps; ++r)
+    {
+        count += kernel(x.data(), y.data(), x.size(), area);
+    }
+
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now()-start).count()/(num_reps*x.size());
+}
+
+} // Namespace <unnamed>
+
+
+int main()
+{
+    std::vector<std::pair<std::string, dcs::fog::detail::count_points_in_area_kernel_t>> kernels;
+    kernels.emplace_back("Scalar", dcs::fog::detail::count_points_in_area_scalar);
+#ifdef DCS_FOG_USER_MOBILITY_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        kernels.emplace_back("AVX2", dcs::fog::detail::count_points_in_area_avx2);
+    }
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        kernels.emplace_back("AVX-512", dcs::fog::detail::count_points_in_area_avx512);
+    }
+#endif // DCS_FOG_USER_MOBILITY_X86_SIMD
+
+    const dcs::fog::rectangular_area_t area(45, 55, 45, 55);
+
+    std::size_t num_mismatches = 0;
+
+    std::cout << "Points";
+    for (auto const& kernel : kernels)
+    {
+        std::cout << "  " << kernel.first << "(ns/point)";
+    }
+    std::cout << "  Speedup" << std::endl;
+    for (std::size_t n = 10000; n <= 10000000; n *= 10)
+    {
+        std::mt19937 rng(5489);
+        std::uniform_real_distribution<double> coord_rvg(0, 100);
+        std::vector<double> x(n);
+        std::vector<double> y(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            x[i] = coord_rvg(rng);
+            y[i] = coord_rvg(rng);
+        }
+
+        std::vector<double> times;
+        std::size_t scalar_count = 0;
+        std::cout << n;
+        for (auto const& kernel : kernels)
+        {
+            std::size_t count = 0;
+            times.push_back(count_time(kernel.second, x, y, area, count));
+            std::cout << "  " << std::setprecision(4) << times.back();
+
+            if (times.size() == 1)
+            {
+                scalar_count = count;
+            }
+            else if (count != scalar_count)
+            {
+                std::cerr << "Counts differ (kernel: " << kernel.first << ", points: " << n << ")" << std::endl;
+                ++num_mismatches;
+            }
+        }
+        // Speedup of the kernel selected at run time
+        std::cout << "  " << times.front()/times.back() << std::endl;
+    }
+
+    return num_mismatches > 0 ? 1 : 0;
+}
@@ -0,0 +1,133 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/event_list_bench.cpp
+ *
+ * \brief Compares the future event lists on the classic hold model.
+ *
+ * The event list is first filled with a given number of entries; then every
+ * hold operation removes the earliest entry and inserts a new one at a random
+ * time ahead of it, so that the size of the list stays constant.
+ * The average time of a hold operation is reported for each event list, size
+ * and distribution of the time increments.
+ *
+ * Usage: event_list_bench [<number of hold operations per run>]
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <dcs/fog/event_list.hpp>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace {
+
+typedef dcs::fog::event_list_entry_t<double> entry_type;
+typedef std::function<double(std::mt19937&)> increment_type;
+
+/// Runs the hold model on the given event list with the given time increments and returns the average time (in ns) of a hold operation
+template <typename EventListT>
+double hold_time(std::size_t size, const std::vector<double>& increments, double& checksum)
+{
+    const std::size_t num_holds = increments.size()-size;
+
+    EventListT list;
+    std::uint64_t seq = 0;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        list.push(entry_type(increments[i], seq++, i));
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    for (std::size_t n = size; n < increments.size(); ++n)
+    {
+        auto const top = list.top();
+        list.pop();
+        list.push(entry_type(top.fire_time+increments[n], seq++, top.slot));
+    }
+    auto const stop = std::chrono::steady_clock::now();
+
+    checksum = list.top().fire_time;
+
+    return std::chrono::duration<double, std::nano>(stop-start).count()/num_holds;
+}
+
+} // Namespace <unnamed>
+
+
+int main(int argc, char* argv[])
+{
+    const std::size_t num_holds = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 5000000;
+
+    const std::vector<std::pair<std::string, increment_type>> distributions = {
+        {"exponential", [](std::mt19937& rng) { return std::exponential_distribution<double>(1.0)(rng); }},
+        {"uniform", [](std::mt19937& rng) { return std::uniform_real_distribution<double>(0, 2)(rng); }},
+        {"bimodal", [](std::mt19937& rng) { return std::uniform_int_distribution<int>(0, 9)(rng) == 0 ? 1e4 : 1e-3*std::uniform_real_distribution<double>()(rng); }}
+    };
+
+    std::size_t num_mismatches = 0;
+
+    std::cout << "Increments  Size  BinaryHeap(ns)  4-aryHeap(ns)  8-aryHeap(ns)  CalendarQueue(ns)" << std::endl;
+    for (auto const& distribution : distributions)
+    {
+        for (std::size_t size = 100; size <= 1000000; size *= 10)
+        {
+            // Time increments are drawn beforehand, so that only the event lists are timed
+            std::mt19937 rng(5489);
+            std::vector<double> increments(size+num_holds);
+            for (auto& x : increments)
+            {
+                x = distribution.second(rng);
+            }
+
+            double checksums[4];
+
+            auto const binary_time = hold_time<dcs::fog::binary_heap_event_list_t<double>>(size, increments, checksums[0]);
+            auto const dary4_time = hold_time<dcs::fog::dary_heap_event_list_t<double, 4>>(size, increments, checksums[1]);
+            auto const dary8_time = hold_time<dcs::fog::dary_heap_event_list_t<double, 8>>(size, increments, checksums[2]);
+            auto const calendar_time = hold_time<dcs::fog::calendar_queue_event_list_t<double>>(size, increments, checksums[3]);
+
+            std::cout << distribution.first << "  " << size
+                      << "  " << std::setprecision(4) << binary_time
+                      << "  " << dary4_time
+                      << "  " << dary8_time
+                      << "  " << calendar_time << std::endl;
+
+            // All the event lists remove entries in the same order, so they end up with the same earliest entry
+            if (checksums[1] != checksums[0] || checksums[2] != checksums[0] || checksums[3] != checksums[0])
+            {
+                std::cerr << "Event lists disagree (increment: " << distribution.first << ", size: " << size << ")" << std::endl;
+                ++num_mismatches;
+            }
+        }
+    }
+
+    return num_mismatches > 0 ? 1 : 0;
+}
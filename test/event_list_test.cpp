@@ -0,0 +1,194 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/event_list_test.cpp
+ *
+ * \brief Checks the future event lists against the priority queue they
+ *  replace.
+ *
+ * Entries must come out in the same fire time order as from the binary heap
+ * of the original simulator (a std::priority_queue ordered by fire time), and
+ * simultaneous entries in insertion order.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <dcs/fog/event_list.hpp>
+#include <functional>
+#include <queue>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include "commons.hpp"
+
+
+namespace {
+
+typedef dcs::fog::event_list_entry_t<double> entry_type;
+
+/// The event list of the original simulator: a binary heap ordered by fire time only
+struct baseline_comparator_t
+{
+    bool operator()(const entry_type& e1, const entry_type& e2) const
+    {
+        return e1.fire_time > e2.fire_time;
+    }
+};
+
+typedef std::priority_queue<entry_type, std::vector<entry_type>, baseline_comparator_t> baseline_event_list_t;
+
+
+/**
+ * Mixes insertions and removals as a simulation does (new entries never
+ * precede the last removed one), drawing the time increments from the given
+ * generator.
+ */
+template <typename EventListT>
+void test_ordering(std::function<double(std::mt19937&)> increment, std::size_t num_ops)
+{
+    EventListT list;
+    baseline_event_list_t baseline;
+    std::set<std::pair<double,std::uint64_t>> reference;
+
+    std::mt19937 rng(5489);
+    std::uniform_int_distribution<int> op_rvg(0, 9);
+    std::uint64_t seq = 0;
+    double now = 0;
+    bool ok = true;
+    for (std::size_t i = 0; i < num_ops && ok; ++i)
+    {
+        // Insertions slightly outnumber removals so that the list grows and shrinks
+        if (op_rvg(rng) < 6 || reference.empty())
+        {
+            const entry_type entry(now+increment(rng), seq++, i);
+            list.push(entry);
+            baseline.push(entry);
+            reference.emplace(entry.fire_time, entry.seq);
+        }
+        else
+        {
+            auto const top = list.top();
+            auto const baseline_top = baseline.top();
+            auto const reference_top = *reference.begin();
+
+            ok = DCS_FOG_TEST_CHECK_EQ( top.fire_time, baseline_top.fire_time )
+                 && DCS_FOG_TEST_CHECK_EQ( top.seq, reference_top.second );
+
+            now = top.fire_time;
+            list.pop();
+            baseline.pop();
+            reference.erase(reference.begin());
+        }
+
+        ok = ok && DCS_FOG_TEST_CHECK_EQ( list.size(), reference.size() );
+    }
+
+    // Drain the list
+    while (!list.empty() && ok)
+    {
+        ok = DCS_FOG_TEST_CHECK_EQ( list.top().fire_time, baseline.top().fire_time )
+             && DCS_FOG_TEST_CHECK_EQ( list.top().seq, reference.begin()->second );
+        list.pop();
+        baseline.pop();
+        reference.erase(reference.begin());
+    }
+    DCS_FOG_TEST_CHECK( reference.empty() );
+}
+
+/// Inserts entries that all have the same fire time: they must come out in insertion order
+template <typename EventListT>
+void test_ties()
+{
+    EventListT list;
+
+    for (std::uint64_t seq = 0; seq < 1000; ++seq)
+    {
+        list.push(entry_type(1.5, seq, seq));
+    }
+    for (std::uint64_t seq = 0; seq < 1000; ++seq)
+    {
+        if (!DCS_FOG_TEST_CHECK_EQ( list.top().seq, seq ))
+        {
+            break;
+        }
+        list.pop();
+    }
+    DCS_FOG_TEST_CHECK( list.empty() );
+}
+
+/// Reuses the list after clearing it, with entries far away from the previous ones
+template <typename EventListT>
+void test_clear()
+{
+    EventListT list;
+
+    for (std::uint64_t seq = 0; seq < 5000; ++seq)
+    {
+        list.push(entry_type(seq*0.01, seq, 0));
+    }
+    list.clear();
+    DCS_FOG_TEST_CHECK( list.empty() );
+
+    std::vector<double> times = {1e6, 3.0, 1e6, 0.0, 2e9};
+    for (std::size_t i = 0; i < times.size(); ++i)
+    {
+        list.push(entry_type(times[i], i, i));
+    }
+
+    // Expected order: 0.0, 3.0, 1e6 (first inserted), 1e6, 2e9
+    const std::vector<std::size_t> expected = {3, 1, 0, 2, 4};
+    for (auto slot : expected)
+    {
+        DCS_FOG_TEST_CHECK_EQ( list.top().slot, slot );
+        list.pop();
+    }
+    DCS_FOG_TEST_CHECK( list.empty() );
+}
+
+template <typename EventListT>
+void test_event_list()
+{
+    const std::size_t num_ops = 200000;
+
+    // Exponential increments
+    test_ordering<EventListT>([](std::mt19937& rng) { return std::exponential_distribution<double>(1.0)(rng); }, num_ops);
+    // Coarse increments, giving many simultaneous entries
+    test_ordering<EventListT>([](std::mt19937& rng) { return std::floor(std::exponential_distribution<double>(1.0)(rng)*4)/4; }, num_ops);
+    // Bimodal increments (a hard case for the bucket width estimate of calendar queues)
+    test_ordering<EventListT>([](std::mt19937& rng) { return std::uniform_int_distribution<int>(0, 9)(rng) == 0 ? 1e4 : 1e-3*std::uniform_real_distribution<double>()(rng); }, num_ops);
+    test_ties<EventListT>();
+    test_clear<EventListT>();
+}
+
+} // Namespace <unnamed>
+
+
+int main()
+{
+    test_event_list<dcs::fog::binary_heap_event_list_t<double>>();
+    test_event_list<dcs::fog::dary_heap_event_list_t<double>>();
+    test_event_list<dcs::fog::dary_heap_event_list_t<double, 8>>();
+    test_event_list<dcs::fog::calendar_queue_event_list_t<double>>();
+
+    return dcs::fog::test::report("event_list_test");
+}
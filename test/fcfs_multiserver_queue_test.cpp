@@ -0,0 +1,212 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/fcfs_multiserver_queue_test.cpp
+ *
+ * \brief Checks the FCFS multiserver queue used by the request-level
+ *  simulation of service delays.
+ *
+ * With Poisson arrivals and exponential service times, the simulated queue
+ * must reproduce the average response time W and the average number of
+ * requests L of the M/M/c model.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstddef>
+#include <dcs/fog/service_performance/fcfs_multiserver_queue.hpp>
+#include <dcs/fog/service_performance/mmc_service_performance_model.hpp>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+#include "commons.hpp"
+
+
+namespace {
+
+/**
+ * Simulates a M/M/c queue and checks W and L against the M/M/c model.
+ *
+ * The first requests are discarded to remove the initial transient.
+ */
+void test_mmc(double lambda, double mu, std::size_t c, std::size_t num_reqs)
+{
+    const std::size_t num_warmup_reqs = num_reqs/10;
+
+    dcs::fog::fcfs_multiserver_queue_t<double> queue;
+    queue.num_servers(c);
+
+    std::mt19937 rng(c);
+    std::exponential_distribution<double> arr_rvg(lambda);
+    std::exponential_distribution<double> svc_rvg(mu);
+
+    // Departures of requests in service, as (departure time, arrival time)
+    typedef std::pair<double,double> departure_t;
+    std::priority_queue<departure_t, std::vector<departure_t>, std::greater<departure_t>> departures;
+
+    double now = 0;
+    double next_arr = arr_rvg(rng);
+    std::size_t num_arrs = 0;
+    std::size_t num_deps = 0;
+    double sum_rt = 0;
+    std::size_t num_rt = 0;
+    double area = 0; // Integral of the number of requests in the system
+    double start_time = 0;
+    while (num_deps < num_reqs)
+    {
+        const bool is_arrival = departures.empty() || next_arr < departures.top().first;
+        const double t = is_arrival ? next_arr : departures.top().first;
+
+        if (num_deps >= num_warmup_reqs)
+        {
+            area += (t-now)*(queue.num_busy_servers()+queue.num_waiting());
+        }
+        now = t;
+
+        if (is_arrival)
+        {
+            if (queue.arrive(now))
+            {
+                departures.emplace(now+svc_rvg(rng), now);
+            }
+            ++num_arrs;
+            next_arr = now+arr_rvg(rng);
+        }
+        else
+        {
+            auto const dep = departures.top();
+            departures.pop();
+
+            ++num_deps;
+            if (num_deps > num_warmup_reqs)
+            {
+                sum_rt += now-dep.second;
+                ++num_rt;
+            }
+            else if (num_deps == num_warmup_reqs)
+            {
+                start_time = now;
+            }
+
+            double arr_time = 0;
+            if (queue.depart(arr_time))
+            {
+                departures.emplace(now+svc_rvg(rng), arr_time);
+            }
+        }
+    }
+
+    dcs::fog::mmc_service_performance_model_t<double> model;
+    auto const W = model.average_response_time(lambda, mu, c);
+    auto const L = lambda*W; // Little's law
+
+    DCS_FOG_TEST_CHECK( num_arrs >= num_deps );
+    DCS_FOG_TEST_CHECK_REL_CLOSE( sum_rt/num_rt, W, 0.03 );
+    DCS_FOG_TEST_CHECK_REL_CLOSE( area/(now-start_time), L, 0.03 );
+}
+
+/// Checks that waiting requests are served in arrival order, also when the ring buffer grows
+void test_fcfs_order()
+{
+    dcs::fog::fcfs_multiserver_queue_t<double> queue;
+    queue.num_servers(2);
+
+    DCS_FOG_TEST_CHECK( queue.arrive(0) );
+    DCS_FOG_TEST_CHECK( queue.arrive(1) );
+
+    // Interleave departures with arrivals, so that the ring buffer wraps around before growing
+    double expected = 2;
+    double arr_time = -1;
+    for (std::size_t i = 2; i < 100; ++i)
+    {
+        DCS_FOG_TEST_CHECK( !queue.arrive(i) );
+        if (i % 3 == 0)
+        {
+            DCS_FOG_TEST_CHECK( queue.depart(arr_time) );
+            DCS_FOG_TEST_CHECK_EQ( arr_time, expected );
+            expected += 1;
+        }
+    }
+    DCS_FOG_TEST_CHECK_EQ( queue.num_busy_servers(), 2u );
+    DCS_FOG_TEST_CHECK_EQ( queue.num_waiting(), 100-expected );
+
+    while (queue.depart(arr_time))
+    {
+        DCS_FOG_TEST_CHECK_EQ( arr_time, expected );
+        expected += 1;
+    }
+    DCS_FOG_TEST_CHECK_EQ( expected, 100 );
+    DCS_FOG_TEST_CHECK_EQ( queue.num_waiting(), 0u );
+    DCS_FOG_TEST_CHECK_EQ( queue.num_busy_servers(), 1u );
+}
+
+/// Checks that removing servers does not preempt requests in service, and that adding servers starts waiting requests
+void test_num_servers_change()
+{
+    dcs::fog::fcfs_multiserver_queue_t<double> queue;
+    queue.num_servers(3);
+
+    for (std::size_t i = 0; i < 6; ++i)
+    {
+        queue.arrive(i);
+    }
+    DCS_FOG_TEST_CHECK_EQ( queue.num_busy_servers(), 3u );
+    DCS_FOG_TEST_CHECK_EQ( queue.num_waiting(), 3u );
+
+    double arr_time = -1;
+    queue.num_servers(1);
+    DCS_FOG_TEST_CHECK( !queue.depart(arr_time) );
+    DCS_FOG_TEST_CHECK( !queue.depart(arr_time) );
+    DCS_FOG_TEST_CHECK( queue.depart(arr_time) );
+    DCS_FOG_TEST_CHECK_EQ( arr_time, 3 );
+    DCS_FOG_TEST_CHECK_EQ( queue.num_busy_servers(), 1u );
+
+    queue.num_servers(4);
+    std::size_t num_started = 0;
+    while (queue.start_next(arr_time))
+    {
+        ++num_started;
+    }
+    DCS_FOG_TEST_CHECK_EQ( num_started, 2u );
+    DCS_FOG_TEST_CHECK_EQ( arr_time, 5 );
+    DCS_FOG_TEST_CHECK_EQ( queue.num_busy_servers(), 3u );
+
+    queue.num_servers(1);
+    queue.arrive(6);
+    queue.arrive(7);
+    DCS_FOG_TEST_CHECK_EQ( queue.drop_waiting(), 2u );
+    DCS_FOG_TEST_CHECK_EQ( queue.num_waiting(), 0u );
+    DCS_FOG_TEST_CHECK_EQ( queue.num_busy_servers(), 3u );
+}
+
+} // Namespace <unnamed>
+
+
+int main()
+{
+    test_mmc(0.7, 1.0, 1, 1000000);
+    test_mmc(3.4, 1.0, 4, 1000000);
+    test_mmc(17.0, 1.0, 20, 1000000);
+    test_mmc(45.0, 0.5, 100, 1000000);
+    test_fcfs_order();
+    test_num_servers_change();
+
+    return dcs::fog::test::report("fcfs_multiserver_queue_test");
+}
@@ -0,0 +1,199 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/min_num_vms_bench.cpp
+ *
+ * \brief Measures the cost of sizing services at every VM allocation, as a
+ *  function of the number of service categories.
+ *
+ * At every VM allocation, the experiment computes the min number of VMs that
+ * meets the target delay of each service category, for each VM category and
+ * for both the predicted and the real arrival rates (see
+ * \c experiment_t::allocate_vms).
+ * This program replays that computation over consecutive intervals, where
+ * arrival rates drift, with the M/M/c model (galloping and bisection search)
+ * and with a linear scan of the number of VMs (as in the original model), and
+ * reports the time per VM allocation of both.
+ *
+ * Usage: min_num_vms_bench [<number of intervals>]
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <dcs/fog/service_performance/mmc_service_performance_model.hpp>
+#include <dcs/math/traits/float.hpp>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+/// Finds the min number of VMs by scanning the number of VMs one at a time, as the original M/M/c model did
+class linear_scan_model_t
+{
+public:
+    std::size_t min_num_vms(double lambda, double mu, double target_delay, double tol)
+    {
+        if (target_delay < 1/mu)
+        {
+            return std::numeric_limits<std::size_t>::max();
+        }
+        if (dcs::math::float_traits<double>::essentially_equal(lambda, 0))
+        {
+            return 0;
+        }
+
+        std::size_t c = 1;
+        while (dcs::math::float_traits<double>::essentially_greater_equal(lambda/(c*mu), 1)
+               || !dcs::math::float_traits<double>::essentially_less_equal(model_.average_response_time(lambda, mu, c), target_delay, tol))
+        {
+            ++c;
+        }
+
+        return c;
+    }
+
+
+private:
+    dcs::fog::mmc_service_performance_model_t<double> model_;
+};
+
+
+/// Service categories, with their arrival rates and their service rates by VM category
+struct workload_t
+{
+    workload_t(std::size_t nsvccats, std::uint32_t seed)
+    : rng(seed),
+      svc_cat_arrival_rates(nsvccats),
+      svc_cat_vm_cat_service_rates(nsvccats, std::vector<double>(3)),
+      svc_cat_max_delays(nsvccats)
+    {
+        std::uniform_real_distribution<double> log_lambda_rvg(std::log(1.0), std::log(2000.0));
+        std::uniform_real_distribution<double> mu_rvg(1, 10);
+
+        for (std::size_t s = 0; s < nsvccats; ++s)
+        {
+            svc_cat_arrival_rates[s] = std::exp(log_lambda_rvg(rng));
+            for (auto& mu : svc_cat_vm_cat_service_rates[s])
+            {
+                mu = mu_rvg(rng);
+            }
+            svc_cat_max_delays[s] = 1.5/(*std::min_element(svc_cat_vm_cat_service_rates[s].begin(), svc_cat_vm_cat_service_rates[s].end()));
+        }
+    }
+
+    /// Moves to the next interval, where arrival rates change by a few percent
+    void next_interval()
+    {
+        std::normal_distribution<double> drift_rvg(0, 0.05);
+
+        for (auto& lambda : svc_cat_arrival_rates)
+        {
+            lambda *= std::exp(drift_rvg(rng));
+        }
+    }
+
+    std::mt19937 rng;
+    std::vector<double> svc_cat_arrival_rates;
+    std::vector<std::vector<double>> svc_cat_vm_cat_service_rates;
+    std::vector<double> svc_cat_max_delays;
+};
+
+/// Sizes all the service categories for all the VM categories, for the predicted (here, the previous) and the real arrival rates, and returns the total number of VMs
+template <typename ModelT>
+std::size_t size_services(ModelT& model, const std::vector<double>& pred_arrival_rates, const workload_t& workload)
+{
+    const double tol = 1e-5;
+
+    std::size_t num_vms = 0;
+    for (std::size_t s = 0; s < workload.svc_cat_arrival_rates.size(); ++s)
+    {
+        for (auto const mu : workload.svc_cat_vm_cat_service_rates[s])
+        {
+            num_vms += model.min_num_vms(workload.svc_cat_arrival_rates[s], mu, workload.svc_cat_max_delays[s], tol);
+            num_vms += model.min_num_vms(pred_arrival_rates[s], mu, workload.svc_cat_max_delays[s], tol);
+        }
+    }
+
+    return num_vms;
+}
+
+/// Replays the given number of VM allocations and returns the average time (in ms) of a VM allocation and the total number of VMs
+template <typename ModelT>
+double sizing_time(std::size_t nsvccats, std::size_t nintervals, std::size_t& num_vms)
+{
+    ModelT model;
+    workload_t workload(nsvccats, 5489);
+
+    num_vms = 0;
+    double time = 0;
+    for (std::size_t t = 0; t < nintervals; ++t)
+    {
+        auto const pred_arrival_rates = workload.svc_cat_arrival_rates;
+        workload.next_interval();
+
+        auto const start = std::chrono::steady_clock::now();
+        num_vms += size_services(model, pred_arrival_rates, workload);
+        time += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-start).count();
+    }
+
+    return time/nintervals;
+}
+
+} // Namespace <unnamed>
+
+
+int main(int argc, char* argv[])
+{
+    const std::size_t nintervals = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 20;
+
+    std::size_t num_mismatches = 0;
+
+    std::cout << "SvcCats  Gallop(ms)  Linear(ms)  Speedup" << std::endl;
+    for (std::size_t nsvccats : {1, 10, 100, 1000, 5000})
+    {
+        std::size_t gallop_num_vms = 0;
+        std::size_t linear_num_vms = 0;
+
+        auto const gallop_time = sizing_time<dcs::fog::mmc_service_performance_model_t<double>>(nsvccats, nintervals, gallop_num_vms);
+        auto const linear_time = sizing_time<linear_scan_model_t>(nsvccats, nintervals, linear_num_vms);
+
+        std::cout << nsvccats
+                  << "  " << std::setprecision(4) << gallop_time
+                  << "  " << linear_time
+                  << "  " << linear_time/gallop_time << std::endl;
+
+        if (gallop_num_vms != linear_num_vms)
+        {
+            std::cerr << "Numbers of VMs differ (service categories: " << nsvccats << ")" << std::endl;
+            ++num_mismatches;
+        }
+    }
+
+    return num_mismatches > 0 ? 1 : 0;
+}
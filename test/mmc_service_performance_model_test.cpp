@@ -0,0 +1,290 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/mmc_service_performance_model_test.cpp
+ *
+ * \brief Checks the M/M/c service performance model.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <dcs/fog/service_performance/mmc_service_performance_model.hpp>
+#include <dcs/math/traits/float.hpp>
+#include <limits>
+#include <random>
+#include <vector>
+#include "commons.hpp"
+
+
+namespace {
+
+/**
+ * Average response times of a M/M/c queue for c=0,1,...,max_c, computed
+ * directly from the Erlang-C formula.
+ *
+ * The Poisson terms a^k/k! (with a=lambda/mu) are evaluated in log space
+ * and scaled by the largest one before being summed, so that they do not
+ * overflow whatever the number of servers.
+ * Unstable queues are given an infinite response time.
+ */
+std::vector<long double> direct_response_times(long double lambda, long double mu, std::size_t max_c)
+{
+    auto const a = lambda/mu;
+
+    std::vector<long double> log_terms(max_c+1);
+    for (std::size_t k = 0; k <= max_c; ++k)
+    {
+        log_terms[k] = k*std::log(a)-std::lgamma(k+1.0L);
+    }
+    auto const log_scale = *std::max_element(log_terms.begin(), log_terms.end());
+
+    std::vector<long double> delays(max_c+1, std::numeric_limits<long double>::infinity());
+    long double sum = 0; // Sum of the scaled terms for k=0,...,c-1
+    for (std::size_t c = 1; c <= max_c; ++c)
+    {
+        sum += std::exp(log_terms[c-1]-log_scale);
+        if (a >= c)
+        {
+            continue;
+        }
+
+        auto const tail = std::exp(log_terms[c]-log_scale)/(1-a/c);
+        auto const erlang_c = tail/(sum+tail);
+        delays[c] = 1/mu+erlang_c/(c*mu-lambda);
+    }
+
+    return delays;
+}
+
+/**
+ * Average response time of a M/M/c queue computed as in the original
+ * implementation of the model, that is with powers and factorials.
+ *
+ * With doubles, factorials overflow as soon as c > 170, and powers of the
+ * offered load a=lambda/mu as soon as c > 709/log(a): beyond this boundary
+ * the result is not finite.
+ */
+double closed_form_response_time(double lambda, double mu, std::size_t c)
+{
+    auto factorial = [](std::size_t n) { double f = 1; for (std::size_t k = 2; k <= n; ++k) { f *= k; } return f; };
+
+    auto const a = lambda/mu;
+    auto const rho = a/c;
+    auto pi0 = std::pow(a, c)/factorial(c)/(1-rho);
+    for (std::size_t k = 0; k < c; ++k)
+    {
+        pi0 += std::pow(a, k)/factorial(k);
+    }
+    pi0 = 1/pi0;
+    auto const pm = std::pow(a, c)/(factorial(c)*(1-rho))*pi0;
+
+    return (c*rho+(rho/(1-rho))*pm)/lambda;
+}
+
+/**
+ * Compares the cached delay tables with the direct evaluation of the
+ * Erlang-C formula for up to 10^4 servers, and with the original closed-form
+ * formula up to the number of servers where it overflows.
+ *
+ * Offered loads are chosen so that stable queues are found on both sides of
+ * the overflow boundary of the closed form, and that some are close to
+ * saturation.
+ */
+template <typename RealT>
+void test_delays_vs_direct(RealT tol)
+{
+    const std::size_t max_c = 10000;
+    const std::size_t max_closed_form_c = 200; // Factorials overflow beyond this value anyway
+
+    std::size_t num_overflows = 0; // Number of stable queues where the closed form overflows
+
+    for (auto rates : {std::make_pair(0.5, 1.0), std::make_pair(10.0, 1.0), std::make_pair(150.0, 1.0), std::make_pair(169.5, 1.0),
+                       std::make_pair(400.0, 2.5), std::make_pair(1000.0, 1.0), std::make_pair(5000.0, 1.0), std::make_pair(9990.0, 1.0)})
+    {
+        const RealT lambda = rates.first;
+        const RealT mu = rates.second;
+
+        dcs::fog::mmc_service_performance_model_t<RealT> model;
+        auto const delays = model.average_response_times(lambda, mu, max_c);
+        auto const ref_delays = direct_response_times(lambda, mu, max_c);
+
+        for (std::size_t c = 1; c <= max_c; ++c)
+        {
+            bool ok = true;
+            if (std::isinf(ref_delays[c]))
+            {
+                ok = DCS_FOG_TEST_CHECK( std::isinf(delays[c]) || lambda/(c*mu) > 1-tol );
+            }
+            else
+            {
+                ok = DCS_FOG_TEST_CHECK_REL_CLOSE( static_cast<long double>(delays[c]), ref_delays[c], static_cast<long double>(tol) );
+
+                if (ok && c <= max_closed_form_c)
+                {
+                    auto const closed_form_delay = closed_form_response_time(lambda, mu, c);
+                    if (std::isfinite(closed_form_delay))
+                    {
+                        ok = DCS_FOG_TEST_CHECK_REL_CLOSE( static_cast<double>(delays[c]), closed_form_delay, std::max(static_cast<double>(tol), 1e-10) );
+                    }
+                    else
+                    {
+                        ++num_overflows;
+                    }
+                }
+            }
+            if (!ok)
+            {
+                std::cerr << "  lambda: " << lambda << ", mu: " << mu << ", c: " << c << ", delay: " << delays[c] << ", expected: " << ref_delays[c] << std::endl;
+                break;
+            }
+        }
+    }
+
+    // Make sure the overflow boundary has been crossed
+    DCS_FOG_TEST_CHECK( num_overflows > 0 );
+}
+
+/**
+ * Checks that delays are the same whatever the order in which they are
+ * queried, that is whatever the way the cached tables of delays are
+ * extended, and after the cache is flushed.
+ */
+template <typename RealT>
+void test_delay_cache()
+{
+    const std::size_t max_c = 2000;
+
+    std::mt19937 rng(1);
+
+    dcs::fog::mmc_service_performance_model_t<RealT> cached_model;
+    for (RealT lambda : {0.3, 7.5, 120.0, 1500.0})
+    {
+        const RealT mu = 1.25;
+
+        // Reference: a whole table computed at once by a fresh model
+        dcs::fog::mmc_service_performance_model_t<RealT> fresh_model;
+        auto const delays = fresh_model.average_response_times(lambda, mu, max_c);
+        DCS_FOG_TEST_CHECK_EQ( delays.size(), max_c+1 );
+
+        // Query single delays in random order, so that the cached table grows by chunks of random size
+        std::vector<std::size_t> cs(max_c);
+        for (std::size_t c = 1; c <= max_c; ++c)
+        {
+            cs[c-1] = c;
+        }
+        std::shuffle(cs.begin(), cs.end(), rng);
+        for (auto c : cs)
+        {
+            if (lambda < c*mu)
+            {
+                DCS_FOG_TEST_CHECK_EQ( cached_model.average_response_time(lambda, mu, c), delays[c] );
+            }
+            else
+            {
+                DCS_FOG_TEST_CHECK( std::isinf(delays[c]) );
+            }
+        }
+
+        // Tables shorter than the cached one are prefixes of it
+        auto const short_delays = cached_model.average_response_times(lambda, mu, max_c/3);
+        DCS_FOG_TEST_CHECK( std::equal(short_delays.begin(), short_delays.end(), delays.begin()) );
+    }
+
+    // Fill the cache with many pairs of rates, so that it is flushed, and check that delays do not change
+    dcs::fog::mmc_service_performance_model_t<RealT> fresh_model;
+    auto const delays = fresh_model.average_response_times(7.5, 1.25, max_c);
+    for (std::size_t i = 0; i < 3000; ++i)
+    {
+        cached_model.average_response_time(1+i*0.01, 1, 10);
+    }
+    DCS_FOG_TEST_CHECK( cached_model.average_response_times(7.5, 1.25, max_c) == delays );
+
+    // No arrivals, no delay
+    DCS_FOG_TEST_CHECK_EQ( cached_model.average_response_time(0, 1, 3), 0 );
+    DCS_FOG_TEST_CHECK_EQ( cached_model.min_num_vms(0, 1, 2, 0), 0u );
+}
+
+/**
+ * Checks the number of VMs found by the galloping and bisection search
+ * against a linear scan of the number of servers (as in the original
+ * implementation of the model).
+ */
+template <typename RealT>
+void test_min_num_vms()
+{
+    const RealT tol = 1e-5;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<RealT> log_lambda_rvg(std::log(0.01), std::log(5000.0));
+    std::uniform_real_distribution<RealT> mu_rvg(0.5, 5);
+    std::uniform_real_distribution<RealT> log_slack_rvg(std::log(1e-4), std::log(2.0));
+
+    dcs::fog::mmc_service_performance_model_t<RealT> model;
+    for (std::size_t i = 0; i < 2000; ++i)
+    {
+        const RealT lambda = std::exp(log_lambda_rvg(rng));
+        const RealT mu = mu_rvg(rng);
+        RealT target_delay = (1+std::exp(log_slack_rvg(rng)))/mu;
+
+        // Sometimes use a target equal to an achievable delay, to check the boundary of the search
+        if (i % 4 == 0)
+        {
+            auto const c = static_cast<std::size_t>(lambda/mu)+1+i%7;
+            target_delay = model.average_response_time(lambda, mu, c);
+        }
+
+        // Linear scan
+        dcs::fog::mmc_service_performance_model_t<RealT> ref_model;
+        std::size_t ref_c = 1;
+        while (dcs::math::float_traits<RealT>::essentially_greater_equal(lambda/(ref_c*mu), 1)
+               || !dcs::math::float_traits<RealT>::essentially_less_equal(ref_model.average_response_times(lambda, mu, ref_c)[ref_c], target_delay, tol))
+        {
+            ++ref_c;
+        }
+
+        auto const c = model.min_num_vms(lambda, mu, target_delay, tol);
+        if (!DCS_FOG_TEST_CHECK_EQ( c, ref_c ))
+        {
+            std::cerr << "  lambda: " << lambda << ", mu: " << mu << ", target delay: " << target_delay << ", c: " << c << ", expected: " << ref_c << std::endl;
+        }
+    }
+
+    // Targets below the service time cannot be met
+    DCS_FOG_TEST_CHECK_EQ( model.min_num_vms(10, 2, 0.49, tol), std::numeric_limits<std::size_t>::max() );
+}
+
+} // Namespace <unnamed>
+
+
+int main()
+{
+    test_delay_cache<float>();
+    test_delay_cache<double>();
+    test_delay_cache<long double>();
+    test_delays_vs_direct<float>(2e-7);
+    test_delays_vs_direct<double>(1e-15);
+    test_delays_vs_direct<long double>(1e-15);
+    test_min_num_vms<float>();
+    test_min_num_vms<double>();
+
+    return dcs::fog::test::report("mmc_service_performance_model_test");
+}
@@ -0,0 +1,250 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/multislot_switch_formulation_bench.cpp
+ *
+ * \brief Compares the two formulations of the switch-on/off costs of FNs in
+ *  the optimal multi-slot VM allocation model.
+ *
+ * Each generated scenario is solved by CPLEX both with the original
+ * formulation (where switch costs are products of power-state variables) and
+ * with the linearized one (where they are charged on explicit switch
+ * variables), and the objective values and solve times are reported side by
+ * side.
+ * The two formulations have the same optimum, so the program fails if, on
+ * any scenario, the objective value of either one is not the one of its VM
+ * allocation under the quadratic objective function, or exceeds the best bound
+ * proved by the other one (i.e., if the two differ when both are optimal).
+ *
+ * Usage: multislot_switch_formulation_bench [<time limit (in seconds)>]
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <dcs/fog/vm_allocation/optimal_solver.hpp>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#ifndef DCS_FOG_VM_ALLOC_USE_CPLEX_SOLVER
+# error "The linearized switch costs are only supported by the CPLEX solver"
+#endif // DCS_FOG_VM_ALLOC_USE_CPLEX_SOLVER
+
+
+namespace {
+
+/**
+ * A random instance of the multi-slot VM allocation problem, with 3 FN
+ * categories, 3 VM categories and 4 service categories.
+ *
+ * The min number of VMs of services follows a daily-like pattern over time
+ * slots, so that FNs are needed in some time slots and not in others, and
+ * the initial power states of FNs are random, so that both switch-on and
+ * switch-off costs matter.
+ */
+struct scenario_t
+{
+    scenario_t(std::size_t nfns, std::size_t nsvcs, std::size_t nslots, std::uint32_t seed)
+    : fn_categories(nfns),
+      fn_power_states(nfns),
+      fn_vm_allocations(nfns),
+      fn_cat_min_powers({100, 80, 200}),
+      fn_cat_max_powers({200, 250, 300}),
+      vm_cat_fn_cat_cpu_specs({{0.05, 0.08, 0.03}, {0.1, 0.15, 0.07}, {0.2, 0.3, 0.15}}),
+      vm_cat_alloc_costs({0.01, 0.02, 0.03}),
+      svc_categories(nsvcs),
+      fp_svc_cat_revenues({0.5, 0.6, 0.7, 0.4}),
+      fp_svc_cat_penalties({1, 1, 2, 0.5}),
+      fp_electricity_cost(0.0004),
+      fp_fn_cat_asleep_costs({0.02, 0.02, 0.02}),
+      fp_fn_cat_awake_costs({0.05, 0.05, 0.05}),
+      deltat(1)
+    {
+        const std::vector<std::vector<std::size_t>> base_min_num_vms = {{4, 2, 1}, {3, 2, 1}, {2, 1, 1}, {5, 3, 2}};
+
+        std::mt19937 rng(seed);
+
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            fn_categories[i] = rng() % fn_cat_min_powers.size();
+            fn_power_states[i] = rng() % 2;
+        }
+        for (auto& svc_cat : svc_categories)
+        {
+            svc_cat = rng() % base_min_num_vms.size();
+        }
+
+        slot_svc_cat_vm_cat_min_num_vms.assign(nslots, base_min_num_vms);
+        for (std::size_t t = 0; t < nslots; ++t)
+        {
+            auto const load = 1+std::min(t, nslots-t)*3/nslots; // From 1 to 2 times the base load, and back
+            for (auto& vm_cat_min_num_vms : slot_svc_cat_vm_cat_min_num_vms[t])
+            {
+                for (auto& n : vm_cat_min_num_vms)
+                {
+                    n *= load;
+                }
+            }
+        }
+    }
+
+    dcs::fog::multislot_vm_allocation_t<double> solve(const dcs::fog::base_multislot_vm_allocation_solver_t<double>& solver) const
+    {
+        return solver.solve(fn_categories,
+                            fn_power_states,
+                            fn_vm_allocations,
+                            fn_cat_min_powers,
+                            fn_cat_max_powers,
+                            vm_cat_fn_cat_cpu_specs,
+                            vm_cat_alloc_costs,
+                            svc_categories,
+                            slot_svc_cat_vm_cat_min_num_vms,
+                            fp_svc_cat_revenues,
+                            fp_svc_cat_penalties,
+                            fp_electricity_cost,
+                            fp_fn_cat_asleep_costs,
+                            fp_fn_cat_awake_costs,
+                            deltat);
+    }
+
+    /// Evaluates the given VM allocation with the objective function of the multi-slot VM allocation problem (i.e., with the quadratic switch costs)
+    double eval(const dcs::fog::multislot_vm_allocation_t<double>& vm_alloc) const
+    {
+        auto sol = vm_alloc;
+        dcs::fog::detail::eval_multislot_vm_allocation(fn_categories,
+                                                       fn_power_states,
+                                                       fn_vm_allocations,
+                                                       fn_cat_min_powers,
+                                                       fn_cat_max_powers,
+                                                       vm_cat_alloc_costs,
+                                                       svc_categories,
+                                                       slot_svc_cat_vm_cat_min_num_vms,
+                                                       fp_svc_cat_revenues,
+                                                       fp_svc_cat_penalties,
+                                                       fp_electricity_cost,
+                                                       fp_fn_cat_asleep_costs,
+                                                       fp_fn_cat_awake_costs,
+                                                       deltat,
+                                                       sol);
+        return sol.objective_value;
+    }
+
+    std::vector<std::size_t> fn_categories;
+    std::vector<bool> fn_power_states;
+    std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>> fn_vm_allocations;
+    std::vector<double> fn_cat_min_powers;
+    std::vector<double> fn_cat_max_powers;
+    std::vector<std::vector<double>> vm_cat_fn_cat_cpu_specs;
+    std::vector<double> vm_cat_alloc_costs;
+    std::vector<std::size_t> svc_categories;
+    std::vector<std::vector<std::vector<std::size_t>>> slot_svc_cat_vm_cat_min_num_vms;
+    std::vector<double> fp_svc_cat_revenues;
+    std::vector<double> fp_svc_cat_penalties;
+    double fp_electricity_cost;
+    std::vector<double> fp_fn_cat_asleep_costs;
+    std::vector<double> fp_fn_cat_awake_costs;
+    double deltat;
+}; // scenario_t
+
+} // Namespace <unnamed>
+
+
+int main(int argc, char* argv[])
+{
+    const double time_limit = (argc > 1) ? std::atof(argv[1]) : 600;
+    const double rel_tol = 1e-6;
+    const std::size_t num_seeds = 3;
+
+    // Number of FNs, services and time slots
+    const std::vector<std::vector<std::size_t>> sizes = {{10, 20, 4}, {20, 40, 6}, {40, 80, 8}, {60, 150, 12}};
+
+    dcs::fog::optimal_multislot_vm_allocation_solver_t<double> quad_solver(rel_tol, time_limit, false);
+    dcs::fog::optimal_multislot_vm_allocation_solver_t<double> lin_solver(rel_tol, time_limit, true);
+    quad_solver.deterministic(true);
+    lin_solver.deterministic(true);
+
+    std::size_t num_mismatches = 0;
+    std::size_t num_runs = 0;
+    double tot_quad_time = 0;
+    double tot_lin_time = 0;
+    double sum_log_speedup = 0;
+
+    std::cout << "FNs  Svcs  Slots  Seed  Quad.Obj  Quad.Time  Quad.Opt  Lin.Obj  Lin.Time  Lin.Opt  Speedup" << std::endl;
+    for (auto const& size : sizes)
+    {
+        for (std::size_t seed = 1; seed <= num_seeds; ++seed)
+        {
+            const scenario_t scen(size[0], size[1], size[2], seed);
+
+            auto const quad_sol = scen.solve(quad_solver);
+            auto const lin_sol = scen.solve(lin_solver);
+            auto const speedup = quad_sol.solve_time/lin_sol.solve_time;
+
+            std::cout << size[0] << "  " << size[1] << "  " << size[2] << "  " << seed
+                      << "  " << std::setprecision(10) << quad_sol.objective_value << "  " << std::setprecision(4) << quad_sol.solve_time << "  " << quad_sol.optimal
+                      << "  " << std::setprecision(10) << lin_sol.objective_value << "  " << std::setprecision(4) << lin_sol.solve_time << "  " << lin_sol.optimal
+                      << "  " << speedup << std::endl;
+
+            // Both formulations must give VM allocations whose objective value is the one of the quadratic objective function.
+            // Besides, the objective value of each formulation cannot exceed the best bound proved by the other one, so they are
+            // the same when both are optimal.
+            auto const tol = 10*rel_tol*std::max(1.0, std::abs(quad_sol.objective_value));
+            auto const bound = [](const dcs::fog::multislot_vm_allocation_t<double>& sol)
+                               {
+                                   if (sol.optimal)
+                                   {
+                                       return sol.objective_value;
+                                   }
+                                   return std::isnan(sol.gap) ? std::numeric_limits<double>::infinity() : sol.objective_value+sol.gap*std::abs(sol.objective_value);
+                               };
+            bool ok = quad_sol.solved && lin_sol.solved;
+            if (ok)
+            {
+                ok = std::abs(quad_sol.objective_value-scen.eval(quad_sol)) <= tol
+                     && std::abs(lin_sol.objective_value-scen.eval(lin_sol)) <= tol
+                     && quad_sol.objective_value <= bound(lin_sol)+tol
+                     && lin_sol.objective_value <= bound(quad_sol)+tol;
+            }
+            if (!ok)
+            {
+                std::cerr << "Inconsistent VM allocations (FNs: " << size[0] << ", services: " << size[1] << ", slots: " << size[2] << ", seed: " << seed << ")" << std::endl;
+                ++num_mismatches;
+            }
+
+            tot_quad_time += quad_sol.solve_time;
+            tot_lin_time += lin_sol.solve_time;
+            sum_log_speedup += std::log(speedup);
+            ++num_runs;
+        }
+    }
+
+    std::cout << "Total solve time: " << tot_quad_time << " s (quadratic), " << tot_lin_time << " s (linearized)" << std::endl;
+    std::cout << "Geometric mean of speedups: " << std::exp(sum_log_speedup/num_runs) << std::endl;
+
+    return num_mismatches > 0 ? 1 : 0;
+}
@@ -0,0 +1,169 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/optimal_vm_allocation_test.cpp
+ *
+ * \brief Checks the CPLEX based VM allocation solvers.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <dcs/fog/vm_allocation/aggregated_solver.hpp>
+#include <dcs/fog/vm_allocation/optimal_solver.hpp>
+#include <iostream>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+#include "commons.hpp"
+
+
+namespace {
+
+/**
+ * A small random instance of the VM allocation problem, with 2 FN categories,
+ * 2 VM categories and 3 service categories, and with no VM allocated yet.
+ *
+ * CPU requirements of VMs are powers of 1/2, so that any VM allocation that
+ * fits the aggregated CPU capacity of a group of FNs also fits its FNs one by
+ * one. On these instances, the aggregated and the disaggregated models have
+ * thus the same optimal objective value.
+ */
+struct instance_t
+{
+    instance_t(std::size_t nfns, std::size_t nsvcs, std::uint32_t seed)
+    : fn_categories(nfns),
+      fn_power_states(nfns),
+      fn_vm_allocations(nfns),
+      fn_cat_min_powers({100, 80}),
+      fn_cat_max_powers({200, 250}),
+      vm_cat_fn_cat_cpu_specs({{0.125, 0.25}, {0.25, 0.5}}),
+      vm_cat_alloc_costs({0.01, 0.02}),
+      svc_categories(nsvcs),
+      svc_cat_vm_cat_min_num_vms({{4, 2}, {6, 3}, {2, 1}}),
+      fp_svc_cat_revenues({0.5, 0.6, 0.7}),
+      fp_svc_cat_penalties({1, 1, 2}),
+      fp_electricity_cost(0.0004),
+      fp_fn_cat_asleep_costs({0.02, 0.02}),
+      fp_fn_cat_awake_costs({0.05, 0.05}),
+      deltat(1)
+    {
+        std::mt19937 rng(seed);
+
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            fn_categories[i] = rng() % fn_cat_min_powers.size();
+            fn_power_states[i] = rng() % 2;
+        }
+        for (auto& svc_cat : svc_categories)
+        {
+            svc_cat = rng() % svc_cat_vm_cat_min_num_vms.size();
+        }
+    }
+
+    template <typename SolverT>
+    dcs::fog::vm_allocation_t<double> solve(const SolverT& solver) const
+    {
+        return solver.solve(fn_categories,
+                            fn_power_states,
+                            fn_vm_allocations,
+                            fn_cat_min_powers,
+                            fn_cat_max_powers,
+                            vm_cat_fn_cat_cpu_specs,
+                            vm_cat_alloc_costs,
+                            svc_categories,
+                            svc_cat_vm_cat_min_num_vms,
+                            fp_svc_cat_revenues,
+                            fp_svc_cat_penalties,
+                            fp_electricity_cost,
+                            fp_fn_cat_asleep_costs,
+                            fp_fn_cat_awake_costs,
+                            deltat);
+    }
+
+    std::vector<std::size_t> fn_categories;
+    std::vector<bool> fn_power_states;
+    std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>> fn_vm_allocations;
+    std::vector<double> fn_cat_min_powers;
+    std::vector<double> fn_cat_max_powers;
+    std::vector<std::vector<double>> vm_cat_fn_cat_cpu_specs;
+    std::vector<double> vm_cat_alloc_costs;
+    std::vector<std::size_t> svc_categories;
+    std::vector<std::vector<std::size_t>> svc_cat_vm_cat_min_num_vms;
+    std::vector<double> fp_svc_cat_revenues;
+    std::vector<double> fp_svc_cat_penalties;
+    double fp_electricity_cost;
+    std::vector<double> fp_fn_cat_asleep_costs;
+    std::vector<double> fp_fn_cat_awake_costs;
+    double deltat;
+}; // instance_t
+
+/**
+ * Checks that the aggregated model and the disaggregated one (with and
+ * without the symmetry-breaking constraints and the persistent model) find
+ * optimal VM allocations with the same objective value, on instances ranging
+ * from plenty to scarce FN capacity.
+ */
+void test_aggregated_vs_disaggregated()
+{
+    const double tol = 1e-6;
+
+    dcs::fog::optimal_vm_allocation_solver_t<double> solver;
+    dcs::fog::optimal_vm_allocation_solver_t<double> sym_solver(0, -1, true, false, true);
+    dcs::fog::optimal_vm_allocation_solver_t<double> persistent_sym_solver(0, -1, true, true, true);
+    dcs::fog::aggregated_vm_allocation_solver_t<double> agg_solver;
+
+    for (auto const& sizes : {std::make_pair(2, 3), std::make_pair(6, 8), std::make_pair(8, 20)})
+    {
+        for (std::uint32_t seed = 1; seed <= 3; ++seed)
+        {
+            const instance_t inst(sizes.first, sizes.second, seed);
+
+            auto const sol = inst.solve(solver);
+            auto const sym_sol = inst.solve(sym_solver);
+            auto const persistent_sym_sol = inst.solve(persistent_sym_solver);
+            auto const agg_sol = inst.solve(agg_solver);
+
+            if (!DCS_FOG_TEST_CHECK( sol.solved && sol.optimal )
+                || !DCS_FOG_TEST_CHECK( sym_sol.solved && sym_sol.optimal )
+                || !DCS_FOG_TEST_CHECK( persistent_sym_sol.solved && persistent_sym_sol.optimal )
+                || !DCS_FOG_TEST_CHECK( agg_sol.solved && agg_sol.optimal )
+                || !DCS_FOG_TEST_CHECK( dcs::fog::check_vm_allocation_solution(agg_sol) )
+                || !DCS_FOG_TEST_CHECK_REL_CLOSE( sym_sol.objective_value, sol.objective_value, tol )
+                || !DCS_FOG_TEST_CHECK_REL_CLOSE( persistent_sym_sol.objective_value, sol.objective_value, tol )
+                || !DCS_FOG_TEST_CHECK_REL_CLOSE( agg_sol.objective_value, sol.objective_value, tol ))
+            {
+                std::cerr << "  FNs: " << sizes.first << ", services: " << sizes.second << ", seed: " << seed << std::endl;
+            }
+        }
+    }
+}
+
+} // Namespace <unnamed>
+
+
+int main()
+{
+    test_aggregated_vs_disaggregated();
+
+    return dcs::fog::test::report("optimal_vm_allocation_test");
+}
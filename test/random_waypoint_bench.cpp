@@ -0,0 +1,132 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/random_waypoint_bench.cpp
+ *
+ * \brief Measures the time of a step of the random waypoint mobility model.
+ *
+ * For each number of nodes, the model is advanced for a given number of steps
+ * counting the users inside the fog node area only, inside a few fog node
+ * areas (counted by scanning all nodes) and inside many fog node areas
+ * (counted through the spatial index), and the average time of a step is
+ * reported for each case.
+ *
+ * Usage: random_waypoint_bench [<number of steps>]
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <dcs/fog/user_mobility.hpp>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+
+namespace {
+
+const std::size_t max_x = 1000;
+const std::size_t max_y = 1000;
+
+/// Returns the areas of a square grid of the given number of fog nodes per side, each one covering a square of 5% of the side of the simulation area
+std::vector<dcs::fog::rectangular_area_t> make_fn_areas(std::size_t num_fns_per_side)
+{
+    const double len = 0.05*max_x;
+    const double spacing = static_cast<double>(max_x)/num_fns_per_side;
+
+    std::vector<dcs::fog::rectangular_area_t> areas;
+    for (std::size_t i = 0; i < num_fns_per_side; ++i)
+    {
+        for (std::size_t j = 0; j < num_fns_per_side; ++j)
+        {
+            auto const cx = (i+0.5)*spacing;
+            auto const cy = (j+0.5)*spacing;
+            areas.emplace_back(cx-len/2, cx+len/2, cy-len/2, cy+len/2);
+        }
+    }
+
+    return areas;
+}
+
+/// Advances the given model by the given number of steps and returns the average time (in us) of a step and the total number of users counted
+template <typename StepT>
+double step_time(std::size_t num_steps, StepT step, std::size_t& num_users)
+{
+    num_users = 0;
+
+    auto const start = std::chrono::steady_clock::now();
+    for (std::size_t t = 0; t < num_steps; ++t)
+    {
+        num_users += step();
+    }
+
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now()-start).count()/num_steps;
+}
+
+} // Namespace <unnamed>
+
+
+int main(int argc, char* argv[])
+{
+    const std::size_t num_steps = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200;
+
+    auto const few_areas = make_fn_areas(2);
+    auto const many_areas = make_fn_areas(16);
+
+    std::cout << "Nodes  FNArea(us)  " << few_areas.size() << "Areas(us)  " << many_areas.size() << "Areas(us)" << std::endl;
+    for (std::size_t num_nodes : {10000, 100000, 1000000})
+    {
+        dcs::fog::random_waypoint_user_mobility_model_t fn_model(num_nodes, max_x, max_y);
+        dcs::fog::random_waypoint_user_mobility_model_t few_model(fn_model);
+        dcs::fog::random_waypoint_user_mobility_model_t many_model(fn_model);
+
+        std::size_t num_users = 0;
+
+        auto const fn_time = step_time(num_steps, [&fn_model]() { return fn_model.next(); }, num_users);
+        auto const few_time = step_time(num_steps,
+                                        [&few_model, &few_areas]()
+                                        {
+                                            std::size_t n = 0;
+                                            for (auto count : few_model.next(few_areas))
+                                            {
+                                                n += count;
+                                            }
+                                            return n;
+                                        },
+                                        num_users);
+        auto const many_time = step_time(num_steps,
+                                         [&many_model, &many_areas]()
+                                         {
+                                             std::size_t n = 0;
+                                             for (auto count : many_model.next(many_areas))
+                                             {
+                                                 n += count;
+                                             }
+                                             return n;
+                                         },
+                                         num_users);
+
+        std::cout << num_nodes
+                  << "  " << std::setprecision(4) << fn_time
+                  << "  " << few_time
+                  << "  " << many_time << std::endl;
+    }
+}
@@ -0,0 +1,230 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/simulator_bench.cpp
+ *
+ * \brief Measures the event throughput of the discrete-event simulator.
+ *
+ * The simulator runs a hold model (every fired event schedules a new one at
+ * an exponentially distributed time ahead, so the number of pending events
+ * stays constant) for several numbers of pending events.
+ * Its throughput (events per second) is reported side by side with the one of
+ * the original event handling, where each scheduled event and its state were
+ * heap-allocated and shared through \c std::shared_ptr in a binary heap.
+ *
+ * Usage: simulator_bench [<number of events per run>]
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <dcs/fog/simulator.hpp>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+struct hold_state_t
+{
+    double value;
+    std::uint32_t id;
+};
+
+
+/// Hold model run by the simulator with pooled events
+class hold_simulator_t: public dcs::fog::simulator_t<double>
+{
+public:
+    hold_simulator_t(std::size_t num_pending, std::size_t num_events)
+    : num_pending_(num_pending),
+      num_events_(num_events),
+      num_fired_(0),
+      sum_(0)
+    {
+        this->max_replication_duration(std::numeric_limits<double>::infinity());
+        this->max_num_replications(1);
+    }
+
+    double sum() const
+    {
+        return sum_;
+    }
+
+
+private:
+    void do_initialize_simulation() { }
+
+    void do_finalize_simulation() { }
+
+    void do_initialize_replication()
+    {
+        for (std::size_t i = 0; i < num_pending_; ++i)
+        {
+            this->schedule_event(delay_rvg_(rng_), 0, hold_state_t{0, static_cast<std::uint32_t>(i)});
+        }
+    }
+
+    void do_finalize_replication() { }
+
+    bool do_check_end_of_replication() const
+    {
+        return num_fired_ >= num_events_;
+    }
+
+    bool do_check_end_of_simulation() const
+    {
+        return false;
+    }
+
+    void do_process_event(const dcs::fog::event_t<double>& event)
+    {
+        auto const state = event.state<hold_state_t>();
+
+        ++num_fired_;
+        sum_ += state.value;
+        this->schedule_event(event.fire_time+delay_rvg_(rng_), event.tag, hold_state_t{state.value+1, state.id});
+    }
+
+
+private:
+    std::size_t num_pending_;
+    std::size_t num_events_;
+    std::size_t num_fired_;
+    double sum_;
+    std::mt19937 rng_{5489};
+    std::exponential_distribution<double> delay_rvg_{1.0};
+};
+
+
+/// Event state of the original simulator: a polymorphic object shared by the event
+struct shared_event_state_t
+{
+    virtual ~shared_event_state_t() { }
+};
+
+struct shared_hold_state_t: shared_event_state_t
+{
+    shared_hold_state_t(double value, std::uint32_t id)
+    : value(value),
+      id(id)
+    {
+    }
+
+    double value;
+    std::uint32_t id;
+};
+
+struct shared_event_t
+{
+    shared_event_t(double fire_time, int tag, const std::shared_ptr<shared_event_state_t>& p_state)
+    : fire_time(fire_time),
+      tag(tag),
+      p_state(p_state)
+    {
+    }
+
+    double fire_time;
+    int tag;
+    std::shared_ptr<shared_event_state_t> p_state;
+};
+
+struct shared_event_comparator_t
+{
+    bool operator()(const std::shared_ptr<shared_event_t>& e1, const std::shared_ptr<shared_event_t>& e2) const
+    {
+        return e1->fire_time > e2->fire_time;
+    }
+};
+
+/// Runs the hold model with the event handling of the original simulator and returns the same checksum as hold_simulator_t
+double run_shared_hold_model(std::size_t num_pending, std::size_t num_events)
+{
+    std::mt19937 rng(5489);
+    std::exponential_distribution<double> delay_rvg(1.0);
+    std::priority_queue<std::shared_ptr<shared_event_t>, std::vector<std::shared_ptr<shared_event_t>>, shared_event_comparator_t> queue;
+
+    for (std::size_t i = 0; i < num_pending; ++i)
+    {
+        queue.push(std::make_shared<shared_event_t>(delay_rvg(rng), 0, std::make_shared<shared_hold_state_t>(0, static_cast<std::uint32_t>(i))));
+    }
+
+    double sum = 0;
+    for (std::size_t n = 0; n < num_events; ++n)
+    {
+        auto p_event = queue.top();
+        queue.pop();
+
+        auto const& state = static_cast<const shared_hold_state_t&>(*p_event->p_state);
+        sum += state.value;
+        queue.push(std::make_shared<shared_event_t>(p_event->fire_time+delay_rvg(rng), p_event->tag, std::make_shared<shared_hold_state_t>(state.value+1, state.id)));
+    }
+
+    return sum;
+}
+
+template <typename FuncT>
+double elapsed_seconds(FuncT func)
+{
+    auto const start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+}
+
+} // Namespace <unnamed>
+
+
+int main(int argc, char* argv[])
+{
+    const std::size_t num_events = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 5000000;
+
+    std::size_t num_mismatches = 0;
+
+    std::cout << "Pending  Pooled.Events/s  Shared.Events/s  Speedup" << std::endl;
+    for (std::size_t num_pending : {10, 1000, 100000, 1000000})
+    {
+        hold_simulator_t sim(num_pending, num_events);
+        double shared_sum = 0;
+
+        auto const pooled_time = elapsed_seconds([&sim]() { sim.run(); });
+        auto const shared_time = elapsed_seconds([&]() { shared_sum = run_shared_hold_model(num_pending, num_events); });
+
+        std::cout << num_pending
+                  << "  " << std::setprecision(4) << num_events/pooled_time
+                  << "  " << num_events/shared_time
+                  << "  " << shared_time/pooled_time << std::endl;
+
+        // Ties have probability zero, so both fire the same events in the same order
+        if (sim.sum() != shared_sum)
+        {
+            std::cerr << "Fired events differ (pending events: " << num_pending << ")" << std::endl;
+            ++num_mismatches;
+        }
+    }
+
+    return num_mismatches > 0 ? 1 : 0;
+}
@@ -0,0 +1,217 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/simulator_test.cpp
+ *
+ * \brief Checks the event handling of the discrete-event simulator.
+ *
+ * Events are stored in a recycled pool with inline state. The test checks
+ * that they are fired in time order (simultaneous events in scheduling
+ * order) and that their states survive slot recycling, against a reference
+ * event list where every event owns its state.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <dcs/fog/event_list.hpp>
+#include <dcs/fog/simulator.hpp>
+#include <limits>
+#include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+#include "commons.hpp"
+
+
+namespace {
+
+struct test_state_t
+{
+    double value;
+    std::uint32_t id;
+};
+
+/// A fired event: fire time, tag and state
+typedef std::tuple<double, int, double, std::uint32_t> fired_event_t;
+
+/**
+ * Test model: each fired event schedules up to two new events, often at the
+ * same time as other pending ones (fire times are multiples of 0.5).
+ */
+class event_generator_t
+{
+public:
+    explicit event_generator_t(std::uint32_t seed)
+    : rng_(seed)
+    {
+    }
+
+    template <typename ScheduleT>
+    void initial_events(ScheduleT schedule)
+    {
+        for (std::uint32_t i = 0; i < 50; ++i)
+        {
+            schedule(next_time(0), static_cast<int>(i % 3), test_state_t{i*0.25, i});
+        }
+        next_id_ = 50;
+    }
+
+    template <typename ScheduleT>
+    void process(double now, const test_state_t& state, ScheduleT schedule)
+    {
+        if (next_id_ >= max_num_events)
+        {
+            return;
+        }
+
+        const std::size_t n = rng_() % 3;
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            schedule(next_time(now), static_cast<int>(next_id_ % 3), test_state_t{state.value+1, next_id_});
+            ++next_id_;
+        }
+    }
+
+
+private:
+    static constexpr std::uint32_t max_num_events = 20000;
+
+    double next_time(double now)
+    {
+        return now + std::floor(std::uniform_real_distribution<double>(0, 4)(rng_))/2;
+    }
+
+
+private:
+    std::mt19937 rng_;
+    std::uint32_t next_id_ = 0;
+};
+
+
+template <typename EventListT>
+class test_simulator_t: public dcs::fog::simulator_t<double, EventListT>
+{
+public:
+    explicit test_simulator_t(std::uint32_t seed)
+    : seed_(seed)
+    {
+    }
+
+    std::vector<std::vector<fired_event_t>> traces;
+
+
+private:
+    void do_initialize_simulation() { }
+
+    void do_finalize_simulation() { }
+
+    void do_initialize_replication()
+    {
+        gen_ = event_generator_t(seed_);
+        traces.emplace_back();
+        gen_.initial_events([this](double t, int tag, const test_state_t& s) { this->schedule_event(t, tag, s); });
+    }
+
+    void do_finalize_replication() { }
+
+    bool do_check_end_of_replication() const
+    {
+        return false;
+    }
+
+    bool do_check_end_of_simulation() const
+    {
+        return false;
+    }
+
+    void do_process_event(const dcs::fog::event_t<double>& event)
+    {
+        auto const state = event.state<test_state_t>();
+
+        traces.back().emplace_back(event.fire_time, event.tag, state.value, state.id);
+        gen_.process(event.fire_time, state, [this](double t, int tag, const test_state_t& s) { this->schedule_event(t, tag, s); });
+    }
+
+
+private:
+    std::uint32_t seed_;
+    event_generator_t gen_{0};
+};
+
+
+/// Runs the test model on an event list made of heap-allocated events ordered by (fire time, scheduling order)
+std::vector<fired_event_t> reference_trace(std::uint32_t seed)
+{
+    std::multimap<double, std::tuple<int, test_state_t>> events;
+    auto schedule = [&events](double t, int tag, const test_state_t& s) { events.emplace(t, std::make_tuple(tag, s)); };
+
+    event_generator_t gen(seed);
+    gen.initial_events(schedule);
+
+    std::vector<fired_event_t> trace;
+    while (!events.empty())
+    {
+        // Equal keys are kept in insertion order, so the first one is the earliest scheduled
+        auto const event = *events.begin();
+        events.erase(events.begin());
+
+        auto const& state = std::get<1>(event.second);
+        trace.emplace_back(event.first, std::get<0>(event.second), state.value, state.id);
+        gen.process(event.first, state, schedule);
+    }
+
+    return trace;
+}
+
+template <typename EventListT>
+void test_event_order(std::uint32_t seed)
+{
+    auto const ref_trace = reference_trace(seed);
+
+    test_simulator_t<EventListT> sim(seed);
+    sim.max_replication_duration(std::numeric_limits<double>::infinity());
+    sim.max_num_replications(2);
+    sim.run();
+
+    DCS_FOG_TEST_CHECK_EQ( sim.traces.size(), 2u );
+    for (auto const& trace : sim.traces)
+    {
+        // Pending events and recycled slots are reset at every replication
+        DCS_FOG_TEST_CHECK_EQ( trace.size(), ref_trace.size() );
+        DCS_FOG_TEST_CHECK( trace == ref_trace );
+    }
+}
+
+} // Namespace <unnamed>
+
+
+int main()
+{
+    for (std::uint32_t seed : {1u, 2u, 3u})
+    {
+        test_event_order<dcs::fog::binary_heap_event_list_t<double>>(seed);
+        test_event_order<dcs::fog::dary_heap_event_list_t<double>>(seed);
+        test_event_order<dcs::fog::calendar_queue_event_list_t<double>>(seed);
+    }
+
+    return dcs::fog::test::report("simulator_test");
+}
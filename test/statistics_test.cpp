@@ -0,0 +1,120 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/statistics_test.cpp
+ *
+ * \brief Checks the P-square quantile estimator against exact sample
+ *  quantiles.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <dcs/fog/statistics.hpp>
+#include <functional>
+#include <random>
+#include <vector>
+#include "commons.hpp"
+
+
+namespace {
+
+/**
+ * Compares the P-square estimates of some quantiles of a sample drawn from
+ * the given generator with the exact sample quantiles.
+ *
+ * Estimates are checked both by value and by rank, that is by the fraction
+ * of observations that do not exceed them, which must be close to the
+ * probability of the quantile whatever the scale of the distribution.
+ */
+void test_p2_quantiles(std::function<double(std::mt19937&)> rvg, std::size_t n)
+{
+    const std::vector<double> probs = {0.05, 0.25, 0.5, 0.75, 0.9, 0.95, 0.99};
+
+    std::mt19937 rng(n);
+
+    std::vector<dcs::fog::p2_quantile_estimator_t<double>> estimators;
+    for (auto p : probs)
+    {
+        estimators.emplace_back(p);
+    }
+
+    std::vector<double> sample(n);
+    for (auto& obs : sample)
+    {
+        obs = rvg(rng);
+        for (auto& estimator : estimators)
+        {
+            estimator.collect(obs);
+        }
+    }
+    std::sort(sample.begin(), sample.end());
+
+    for (std::size_t k = 0; k < probs.size(); ++k)
+    {
+        auto const p = probs[k];
+        auto const estimate = estimators[k].estimate();
+        auto const exact = sample[static_cast<std::size_t>(std::ceil(p*n))-1];
+        auto const rank = static_cast<double>(std::upper_bound(sample.begin(), sample.end(), estimate)-sample.begin())/n;
+
+        DCS_FOG_TEST_CHECK_EQ( estimators[k].size(), n );
+        DCS_FOG_TEST_CHECK_REL_CLOSE( estimate, exact, 0.01 );
+        DCS_FOG_TEST_CHECK( std::abs(rank-p) <= 0.002 );
+    }
+}
+
+/// With less than five observations the estimate is the sample quantile
+void test_p2_few_observations()
+{
+    dcs::fog::p2_quantile_estimator_t<double> median(0.5);
+    dcs::fog::p2_quantile_estimator_t<double> q90(0.9);
+
+    DCS_FOG_TEST_CHECK( std::isnan(median.estimate()) );
+
+    for (double obs : {3.0, 1.0, 2.0})
+    {
+        median.collect(obs);
+        q90.collect(obs);
+    }
+    DCS_FOG_TEST_CHECK_EQ( median.estimate(), 2 );
+    DCS_FOG_TEST_CHECK_EQ( q90.estimate(), 3 );
+
+    median.reset();
+    DCS_FOG_TEST_CHECK_EQ( median.size(), 0u );
+    median.collect(7);
+    DCS_FOG_TEST_CHECK_EQ( median.estimate(), 7 );
+}
+
+} // Namespace <unnamed>
+
+
+int main()
+{
+    const std::size_t n = 200000;
+
+    test_p2_quantiles([](std::mt19937& rng) { return std::exponential_distribution<double>(1.0)(rng); }, n);
+    test_p2_quantiles([](std::mt19937& rng) { return std::uniform_real_distribution<double>(10, 20)(rng); }, n);
+    test_p2_quantiles([](std::mt19937& rng) { return std::normal_distribution<double>(100, 5)(rng); }, n);
+    test_p2_quantiles([](std::mt19937& rng) { return std::lognormal_distribution<double>(0, 1)(rng); }, n);
+    test_p2_few_observations();
+
+    return dcs::fog::test::report("statistics_test");
+}
@@ -0,0 +1,325 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/user_mobility_test.cpp
+ *
+ * \brief Checks the user mobility models.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <dcs/fog/user_mobility.hpp>
+#include <memory>
+#include <random>
+#include <vector>
+#include "commons.hpp"
+
+
+namespace {
+
+std::size_t brute_force_count(const std::vector<double>& x, const std::vector<double>& y, std::size_t first, std::size_t n, const dcs::fog::rectangular_area_t& area)
+{
+    std::size_t count = 0;
+    for (std::size_t i = first; i < first+n; ++i)
+    {
+        if (x[i] >= area.min_x && x[i] <= area.max_x && y[i] >= area.min_y && y[i] <= area.max_y)
+        {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Generates random points in [-10,110]x[-10,110] (thus also outside the
+ * [0,100]x[0,100] simulation area), some of which lie on the lines x=k and
+ * y=k, for integer k, so that they fall on area and grid cell borders.
+ */
+void make_points(std::size_t n, std::mt19937& rng, std::vector<double>& x, std::vector<double>& y)
+{
+    std::uniform_real_distribution<double> coord_rvg(-10, 110);
+
+    x.resize(n);
+    y.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        x[i] = coord_rvg(rng);
+        y[i] = coord_rvg(rng);
+        if (i % 5 == 0)
+        {
+            x[i] = std::round(x[i]);
+        }
+        if (i % 7 == 0)
+        {
+            y[i] = std::round(y[i]);
+        }
+    }
+}
+
+/// Generates random areas, with integer corners (on which points lie) half of the times, and some degenerate areas
+std::vector<dcs::fog::rectangular_area_t> make_areas(std::size_t n, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> coord_rvg(-20, 120);
+    std::uniform_real_distribution<double> len_rvg(0, 40);
+
+    std::vector<dcs::fog::rectangular_area_t> areas;
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        auto min_x = coord_rvg(rng);
+        auto min_y = coord_rvg(rng);
+        auto max_x = min_x+len_rvg(rng);
+        auto max_y = min_y+len_rvg(rng);
+        if (k % 2 == 0)
+        {
+            min_x = std::round(min_x);
+            min_y = std::round(min_y);
+            max_x = std::round(max_x);
+            max_y = std::round(max_y);
+        }
+        areas.emplace_back(min_x, max_x, min_y, max_y);
+    }
+
+    // Areas reduced to a segment, an empty area, and an area covering everything
+    areas.emplace_back(50, 50, 0, 100);
+    areas.emplace_back(20, 80, 30, 30);
+    areas.emplace_back(60, 40, 0, 100);
+    areas.emplace_back(-1e3, 1e3, -1e3, 1e3);
+
+    return areas;
+}
+
+/**
+ * Checks the scalar and SIMD kernels (the ones supported by the CPU) that
+ * count the points in an area against a brute force count, on arrays of any
+ * length and alignment.
+ */
+void test_count_points_in_area()
+{
+    typedef dcs::fog::detail::count_points_in_area_kernel_t kernel_type;
+
+    std::vector<std::pair<const char*, kernel_type>> kernels;
+    kernels.emplace_back("scalar", dcs::fog::detail::count_points_in_area_scalar);
+    kernels.emplace_back("dispatched", dcs::fog::detail::count_points_in_area_kernel());
+#ifdef DCS_FOG_USER_MOBILITY_X86_SIMD
+    if (__builtin_cpu_supports("avx2"))
+    {
+        kernels.emplace_back("AVX2", dcs::fog::detail::count_points_in_area_avx2);
+    }
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        kernels.emplace_back("AVX-512", dcs::fog::detail::count_points_in_area_avx512);
+    }
+#endif // DCS_FOG_USER_MOBILITY_X86_SIMD
+
+    std::mt19937 rng(11);
+    std::vector<double> x;
+    std::vector<double> y;
+    make_points(5000, rng, x, y);
+    auto const areas = make_areas(50, rng);
+
+    for (auto const& kernel : kernels)
+    {
+        bool ok = true;
+        for (std::size_t n : {0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 1000, 4097})
+        {
+            for (std::size_t first : {0, 1, 3})
+            {
+                for (auto const& area : areas)
+                {
+                    if (ok && !DCS_FOG_TEST_CHECK_EQ( kernel.second(x.data()+first, y.data()+first, n, area), brute_force_count(x, y, first, n, area) ))
+                    {
+                        std::cerr << "  kernel: " << kernel.first << ", n: " << n << ", offset: " << first << std::endl;
+                        ok = false;
+                    }
+                }
+            }
+        }
+    }
+
+    // Counts over all the areas at once (in blocks of points)
+    std::vector<std::size_t> counts(areas.size());
+    dcs::fog::count_points_in_areas(x, y, areas.begin(), areas.end(), counts.begin());
+    for (std::size_t k = 0; k < areas.size(); ++k)
+    {
+        DCS_FOG_TEST_CHECK_EQ( counts[k], brute_force_count(x, y, 0, x.size(), areas[k]) );
+        DCS_FOG_TEST_CHECK_EQ( dcs::fog::count_points_in_area(x, y, areas[k]), counts[k] );
+    }
+}
+
+/// Checks the counts of the uniform-grid spatial index against a brute force count, for several grid sizes
+void test_uniform_grid_spatial_index()
+{
+    std::mt19937 rng(13);
+    auto const areas = make_areas(500, rng);
+
+    for (std::size_t n : {0, 1, 100, 20000})
+    {
+        std::vector<double> x;
+        std::vector<double> y;
+        make_points(n, rng, x, y);
+
+        for (auto const& num_cells : {std::make_pair(1, 1), std::make_pair(7, 3), std::make_pair(10, 10), std::make_pair(64, 64), std::make_pair(300, 1)})
+        {
+            dcs::fog::uniform_grid_spatial_index_t grid(100, 100, num_cells.first, num_cells.second);
+            grid.build(x, y);
+            DCS_FOG_TEST_CHECK_EQ( grid.num_points(), n );
+
+            std::vector<std::size_t> counts(areas.size());
+            grid.count(areas.begin(), areas.end(), counts.begin());
+            for (std::size_t k = 0; k < areas.size(); ++k)
+            {
+                if (!DCS_FOG_TEST_CHECK_EQ( counts[k], brute_force_count(x, y, 0, n, areas[k]) ))
+                {
+                    std::cerr << "  points: " << n << ", cells: " << num_cells.first << "x" << num_cells.second << ", area: [" << areas[k].min_x << "," << areas[k].max_x << "]x[" << areas[k].min_y << "," << areas[k].max_y << "]" << std::endl;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Rebuilding the index replaces the previous points
+    dcs::fog::uniform_grid_spatial_index_t grid(100, 100, 8, 8);
+    grid.build(std::vector<double>(10, 50), std::vector<double>(10, 50));
+    grid.build(std::vector<double>(3, 20), std::vector<double>(3, 20));
+    DCS_FOG_TEST_CHECK_EQ( grid.count(dcs::fog::rectangular_area_t(0, 100, 0, 100)), 3u );
+}
+
+/**
+ * Runs three copies of a random waypoint model in lockstep and checks that:
+ * - the number of users in the fog node area returned by next() is the same
+ *   as the one counted by next(areas), both with few areas (counted by
+ *   scanning users) and with many areas (counted through the spatial index);
+ * - users never leave the simulation area.
+ *
+ * Also checks that, in the long run, the average number of users in the fog
+ * node area is the one given by a Python port of the \c random_waypoint
+ * model of PyMobility with the same parameters (that is, about 1.6% of users without pauses and
+ * 1.3% with pauses of up to 5 steps, rather than the 1% of a uniform
+ * distribution, since users concentrate in the center).
+ */
+void test_random_waypoint(std::size_t max_wt, double expected_avg_fn_users)
+{
+    const std::size_t num_users = 2000;
+    const std::size_t max_x = 100;
+    const std::size_t max_y = 100;
+    const std::size_t num_steps = 2000;
+    const std::size_t num_warmup_steps = 200;
+
+    dcs::fog::random_waypoint_user_mobility_model_t model(num_users, max_x, max_y, 10, 100, max_wt, 1234);
+    std::unique_ptr<dcs::fog::user_mobility_model_t> scan_model(model.clone());
+    std::unique_ptr<dcs::fog::user_mobility_model_t> grid_model(model.clone());
+
+    // The fog node area is the square centered in the simulation area with sides that are 10% of the ones of the simulation area
+    const dcs::fog::rectangular_area_t fn_area(45, 55, 45, 55);
+    // Slightly enlarged, to tolerate rounding errors in positions
+    const dcs::fog::rectangular_area_t sim_area(-1e-9, max_x+1e-9, -1e-9, max_y+1e-9);
+
+    const std::vector<dcs::fog::rectangular_area_t> few_areas = {fn_area, sim_area};
+    std::vector<dcs::fog::rectangular_area_t> many_areas(50, sim_area);
+    many_areas[17] = fn_area;
+
+    std::size_t num_fn_users = 0;
+    bool ok = true;
+    for (std::size_t t = 0; t < num_steps && ok; ++t)
+    {
+        auto const n = model.next();
+        auto const scan_counts = scan_model->next(few_areas);
+        auto const grid_counts = grid_model->next(many_areas);
+
+        ok = DCS_FOG_TEST_CHECK_EQ( scan_counts[0], n )
+             && DCS_FOG_TEST_CHECK_EQ( grid_counts[17], n )
+             && DCS_FOG_TEST_CHECK_EQ( scan_counts[1], num_users )
+             && DCS_FOG_TEST_CHECK_EQ( grid_counts[0], num_users );
+
+        if (t >= num_warmup_steps)
+        {
+            num_fn_users += n;
+        }
+    }
+
+    DCS_FOG_TEST_CHECK_REL_CLOSE( static_cast<double>(num_fn_users)/(num_steps-num_warmup_steps), expected_avg_fn_users, 0.05 );
+}
+
+/**
+ * Checks that equally seeded models (and clones) generate the same sequence,
+ * that reseeding changes it, and that reseeding restarts the model, so that
+ * models reseeded with the same seeds generate the same sequence whatever
+ * their past.
+ */
+void test_random_waypoint_seed()
+{
+    dcs::fog::random_waypoint_user_mobility_model_t model1(500, 100, 100);
+    dcs::fog::random_waypoint_user_mobility_model_t model2(500, 100, 100);
+
+    std::vector<std::size_t> counts1;
+    std::vector<std::size_t> counts2;
+    for (std::size_t t = 0; t < 100; ++t)
+    {
+        counts1.push_back(model1.next());
+        counts2.push_back(model2.next());
+    }
+    DCS_FOG_TEST_CHECK( counts1 == counts2 );
+
+    std::unique_ptr<dcs::fog::user_mobility_model_t> clone(model1.clone());
+    std::seed_seq seq = {1, 2, 3};
+    model2.seed(seq);
+    counts1.clear();
+    counts2.clear();
+    std::vector<std::size_t> clone_counts;
+    for (std::size_t t = 0; t < 200; ++t)
+    {
+        counts1.push_back(model1.next());
+        counts2.push_back(model2.next());
+        clone_counts.push_back(clone->next());
+    }
+    DCS_FOG_TEST_CHECK( clone_counts == counts1 );
+    DCS_FOG_TEST_CHECK( counts2 != counts1 );
+
+    // model1 has moved 300 steps and model2 200 steps since reseeding
+    std::seed_seq seq1 = {4, 5, 6};
+    std::seed_seq seq2 = {4, 5, 6};
+    model1.seed(seq1);
+    model2.seed(seq2);
+    counts1.clear();
+    counts2.clear();
+    for (std::size_t t = 0; t < 100; ++t)
+    {
+        counts1.push_back(model1.next());
+        counts2.push_back(model2.next());
+    }
+    DCS_FOG_TEST_CHECK( counts1 == counts2 );
+}
+
+} // Namespace <unnamed>
+
+
+int main()
+{
+    test_count_points_in_area();
+    test_uniform_grid_spatial_index();
+    // Averages over 4 runs of 1100 steps of the Python model (discarding the first 100 steps of each run)
+    test_random_waypoint(0, 32.4);
+    test_random_waypoint(5, 25.2);
+    test_random_waypoint_seed();
+
+    return dcs::fog::test::report("user_mobility_test");
+}
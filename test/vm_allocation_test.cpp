@@ -0,0 +1,643 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file test/vm_allocation_test.cpp
+ *
+ * \brief Checks the heuristic VM allocation solvers.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <dcs/fog/vm_allocation/caching_solver.hpp>
+#include <dcs/fog/vm_allocation/greedy_solver.hpp>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include "commons.hpp"
+
+
+namespace {
+
+typedef std::vector<std::map<std::size_t,std::pair<std::size_t,std::size_t>>> fn_vm_allocations_t;
+
+/// A random instance of the VM allocation problem, with 3 FN categories, 3 VM categories and 4 service categories
+struct scenario_t
+{
+    scenario_t(std::size_t nfns, std::size_t nsvcs, std::uint32_t seed)
+    : fn_categories(nfns),
+      fn_power_states(nfns),
+      fn_vm_allocations(nfns),
+      fn_cat_min_powers({100, 80, 200}),
+      fn_cat_max_powers({200, 250, 300}),
+      vm_cat_fn_cat_cpu_specs({{0.05, 0.08, 0.03}, {0.1, 0.15, 0.07}, {0.2, 0.3, 0.15}}),
+      vm_cat_alloc_costs({0.01, 0.02, 0.03}),
+      svc_categories(nsvcs),
+      svc_cat_vm_cat_min_num_vms({{8, 4, 2}, {6, 3, 2}, {4, 2, 1}, {10, 5, 3}}),
+      fp_svc_cat_revenues({0.5, 0.6, 0.7, 0.4}),
+      fp_svc_cat_penalties({1, 1, 2, 0.5}),
+      fp_electricity_cost(0.0004),
+      fp_fn_cat_asleep_costs({0.02, 0.02, 0.02}),
+      fp_fn_cat_awake_costs({0.05, 0.05, 0.05}),
+      deltat(1),
+      rng(seed)
+    {
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            fn_categories[i] = rng() % fn_cat_min_powers.size();
+            fn_power_states[i] = rng() % 2;
+        }
+        for (auto& svc_cat : svc_categories)
+        {
+            svc_cat = rng() % svc_cat_vm_cat_min_num_vms.size();
+        }
+    }
+
+    template <typename SolverT>
+    dcs::fog::vm_allocation_t<double> solve(const SolverT& solver, const std::set<std::size_t>& fixed_fns = std::set<std::size_t>()) const
+    {
+        return solver.solve_with_fixed_fns(fixed_fns,
+                                           fn_categories,
+                                           fn_power_states,
+                                           fn_vm_allocations,
+                                           fn_cat_min_powers,
+                                           fn_cat_max_powers,
+                                           vm_cat_fn_cat_cpu_specs,
+                                           vm_cat_alloc_costs,
+                                           svc_categories,
+                                           svc_cat_vm_cat_min_num_vms,
+                                           fp_svc_cat_revenues,
+                                           fp_svc_cat_penalties,
+                                           fp_electricity_cost,
+                                           fp_fn_cat_asleep_costs,
+                                           fp_fn_cat_awake_costs,
+                                           deltat);
+    }
+
+    /// Evaluates the given VM allocation with the objective function of the VM allocation problem
+    double eval(const dcs::fog::vm_allocation_t<double>& vm_alloc) const
+    {
+        auto sol = vm_alloc;
+        dcs::fog::detail::eval_vm_allocation(fn_categories,
+                                             fn_power_states,
+                                             fn_vm_allocations,
+                                             fn_cat_min_powers,
+                                             fn_cat_max_powers,
+                                             vm_cat_alloc_costs,
+                                             svc_categories,
+                                             svc_cat_vm_cat_min_num_vms,
+                                             fp_svc_cat_revenues,
+                                             fp_svc_cat_penalties,
+                                             fp_electricity_cost,
+                                             fp_fn_cat_asleep_costs,
+                                             fp_fn_cat_awake_costs,
+                                             deltat,
+                                             sol);
+        return sol.objective_value;
+    }
+
+    /// Moves to the next interval: the given VM allocation becomes the current one, and some services change category
+    void next_interval(const dcs::fog::vm_allocation_t<double>& vm_alloc)
+    {
+        fn_power_states = vm_alloc.fn_power_states;
+        fn_vm_allocations = vm_alloc.fn_vm_allocations;
+        for (auto& svc_cat : svc_categories)
+        {
+            if (rng() % 5 == 0)
+            {
+                svc_cat = rng() % svc_cat_vm_cat_min_num_vms.size();
+            }
+        }
+    }
+
+    std::vector<std::size_t> fn_categories;
+    std::vector<bool> fn_power_states;
+    fn_vm_allocations_t fn_vm_allocations;
+    std::vector<double> fn_cat_min_powers;
+    std::vector<double> fn_cat_max_powers;
+    std::vector<std::vector<double>> vm_cat_fn_cat_cpu_specs;
+    std::vector<double> vm_cat_alloc_costs;
+    std::vector<std::size_t> svc_categories;
+    std::vector<std::vector<std::size_t>> svc_cat_vm_cat_min_num_vms;
+    std::vector<double> fp_svc_cat_revenues;
+    std::vector<double> fp_svc_cat_penalties;
+    double fp_electricity_cost;
+    std::vector<double> fp_fn_cat_asleep_costs;
+    std::vector<double> fp_fn_cat_awake_costs;
+    double deltat;
+    std::mt19937 rng;
+}; // scenario_t
+
+/**
+ * Checks that the given VM allocation is a feasible solution of the given
+ * problem (restricted to the FNs in \a fixed_fns, if not empty), that is:
+ * - no FN is overloaded and no VM runs on a powered-off FN;
+ * - the CPU share of each FN is the one required by its VMs;
+ * - each service is either not served at all or served by exactly the min
+ *   number of VMs of a single VM category;
+ * - only the FNs in \a fixed_fns are used.
+ * .
+ */
+bool check_feasible(const scenario_t& scen, const dcs::fog::vm_allocation_t<double>& vm_alloc, const std::set<std::size_t>& fixed_fns = std::set<std::size_t>())
+{
+    auto const nfns = scen.fn_categories.size();
+
+    bool ok = DCS_FOG_TEST_CHECK( vm_alloc.solved )
+              && DCS_FOG_TEST_CHECK_EQ( vm_alloc.fn_vm_allocations.size(), nfns )
+              && DCS_FOG_TEST_CHECK_EQ( vm_alloc.fn_power_states.size(), nfns )
+              && DCS_FOG_TEST_CHECK_EQ( vm_alloc.fn_cpu_allocations.size(), nfns )
+              && DCS_FOG_TEST_CHECK( dcs::fog::check_vm_allocation_solution(vm_alloc) );
+    if (!ok)
+    {
+        return false;
+    }
+
+    std::map<std::size_t,std::pair<std::size_t,std::size_t>> svc_vms; // <service => <VM category,number>> over all FNs
+    for (std::size_t i = 0; i < nfns && ok; ++i)
+    {
+        double share = 0;
+        for (auto const& svc_alloc : vm_alloc.fn_vm_allocations[i])
+        {
+            auto const j = svc_alloc.first;
+            auto const k = svc_alloc.second.first;
+            auto const n = svc_alloc.second.second;
+
+            share += n*scen.vm_cat_fn_cat_cpu_specs[k][scen.fn_categories[i]];
+
+            auto& vms = svc_vms[j];
+            ok = ok && DCS_FOG_TEST_CHECK( n > 0 )
+                    && DCS_FOG_TEST_CHECK( vms.second == 0 || vms.first == k );
+            vms.first = k;
+            vms.second += n;
+        }
+        ok = ok && DCS_FOG_TEST_CHECK( share <= 1+1e-9 )
+                && DCS_FOG_TEST_CHECK( std::abs(vm_alloc.fn_cpu_allocations[i]-share) <= 1e-9 )
+                && DCS_FOG_TEST_CHECK( fixed_fns.empty() || fixed_fns.count(i) > 0 || vm_alloc.fn_vm_allocations[i].empty() );
+    }
+    for (auto const& vms : svc_vms)
+    {
+        auto const svc_cat = scen.svc_categories[vms.first];
+
+        ok = ok && DCS_FOG_TEST_CHECK_EQ( vms.second.second, scen.svc_cat_vm_cat_min_num_vms[svc_cat][vms.second.first] );
+    }
+
+    return ok;
+}
+
+/**
+ * Checks that the greedy solver (with and without local search) returns
+ * feasible VM allocations, whose objective value is the one given by
+ * eval_vm_allocation, on instances ranging from plenty to scarce FN capacity,
+ * over consecutive intervals (where each VM allocation starts from the
+ * previous one) and with restricted sets of FNs.
+ */
+void test_greedy_solver()
+{
+    dcs::fog::greedy_vm_allocation_solver_t<double> solver(10);
+    dcs::fog::greedy_vm_allocation_solver_t<double> no_ls_solver(0);
+
+    for (auto const& sizes : {std::make_pair(1, 1), std::make_pair(5, 40), std::make_pair(50, 100), std::make_pair(300, 600), std::make_pair(100, 2000)})
+    {
+        scenario_t scen(sizes.first, sizes.second, sizes.first+sizes.second);
+
+        for (std::size_t t = 0; t < 3; ++t)
+        {
+            auto const sol = scen.solve(solver);
+            auto const no_ls_sol = scen.solve(no_ls_solver);
+
+            if (!check_feasible(scen, sol)
+                || !check_feasible(scen, no_ls_sol)
+                || !DCS_FOG_TEST_CHECK_REL_CLOSE( sol.objective_value, scen.eval(sol), 1e-12 )
+                || !DCS_FOG_TEST_CHECK_REL_CLOSE( no_ls_sol.objective_value, scen.eval(no_ls_sol), 1e-12 )
+                || !DCS_FOG_TEST_CHECK_EQ( sol.profit, sol.objective_value )
+                // Local search never makes things worse
+                || !DCS_FOG_TEST_CHECK( sol.objective_value >= no_ls_sol.objective_value-1e-9*std::abs(no_ls_sol.objective_value) ))
+            {
+                std::cerr << "  FNs: " << sizes.first << ", services: " << sizes.second << ", interval: " << t << std::endl;
+                break;
+            }
+
+            // solve() is the same as solve_with_fixed_fns() with no fixed FN
+            auto const free_sol = solver.solve(scen.fn_categories,
+                                               scen.fn_power_states,
+                                               scen.fn_vm_allocations,
+                                               scen.fn_cat_min_powers,
+                                               scen.fn_cat_max_powers,
+                                               scen.vm_cat_fn_cat_cpu_specs,
+                                               scen.vm_cat_alloc_costs,
+                                               scen.svc_categories,
+                                               scen.svc_cat_vm_cat_min_num_vms,
+                                               scen.fp_svc_cat_revenues,
+                                               scen.fp_svc_cat_penalties,
+                                               scen.fp_electricity_cost,
+                                               scen.fp_fn_cat_asleep_costs,
+                                               scen.fp_fn_cat_awake_costs,
+                                               scen.deltat);
+            DCS_FOG_TEST_CHECK( free_sol.fn_vm_allocations == sol.fn_vm_allocations );
+            DCS_FOG_TEST_CHECK_EQ( free_sol.objective_value, sol.objective_value );
+
+            // Only every other FN can be used
+            std::set<std::size_t> fixed_fns;
+            for (std::size_t i = 0; i < scen.fn_categories.size(); i += 2)
+            {
+                fixed_fns.insert(i);
+            }
+            auto const fixed_sol = scen.solve(solver, fixed_fns);
+            if (!check_feasible(scen, fixed_sol, fixed_fns)
+                || !DCS_FOG_TEST_CHECK_REL_CLOSE( fixed_sol.objective_value, scen.eval(fixed_sol), 1e-12 ))
+            {
+                std::cerr << "  FNs: " << sizes.first << ", services: " << sizes.second << ", interval: " << t << " (fixed FNs)" << std::endl;
+                break;
+            }
+
+            scen.next_interval(sol);
+        }
+    }
+
+    // No service, no VM
+    scenario_t scen(10, 0, 1);
+    auto const sol = scen.solve(solver);
+    DCS_FOG_TEST_CHECK( check_feasible(scen, sol) );
+    DCS_FOG_TEST_CHECK_REL_CLOSE( sol.objective_value, scen.eval(sol), 1e-12 );
+}
+
+/**
+ * Checks that the greedy multi-slot solver returns VM allocations that are
+ * feasible in every time slot, whose objective value is the one given by
+ * eval_multislot_vm_allocation, and that are not worse than solving time
+ * slots one after the other with the greedy solver.
+ *
+ * The min number of VMs of services follows a daily-like pattern, so that
+ * FNs are needed in some time slots and not in others.
+ */
+void test_greedy_multislot_solver()
+{
+    const std::size_t nslots = 8;
+
+    dcs::fog::greedy_vm_allocation_solver_t<double> solver(10);
+    dcs::fog::greedy_multislot_vm_allocation_solver_t<double> ms_solver(10);
+
+    for (auto const& sizes : {std::make_pair(5, 40), std::make_pair(50, 100), std::make_pair(200, 600)})
+    {
+        const scenario_t scen(sizes.first, sizes.second, sizes.first+sizes.second);
+
+        std::vector<std::vector<std::vector<std::size_t>>> slot_svc_cat_vm_cat_min_num_vms(nslots, scen.svc_cat_vm_cat_min_num_vms);
+        for (std::size_t t = 0; t < nslots; ++t)
+        {
+            auto const load = 1+(t < nslots/2 ? t : nslots-t); // Up to 5 times the base load
+            for (auto& vm_cat_min_num_vms : slot_svc_cat_vm_cat_min_num_vms[t])
+            {
+                for (auto& n : vm_cat_min_num_vms)
+                {
+                    n *= load;
+                }
+            }
+        }
+
+        auto const check_solution = [&](const dcs::fog::multislot_vm_allocation_t<double>& ms_sol,
+                                        const std::vector<std::set<std::size_t>>& fixed_fns) -> bool
+                                    {
+                                        bool ok = DCS_FOG_TEST_CHECK( ms_sol.solved )
+                                                  && DCS_FOG_TEST_CHECK( dcs::fog::check_vm_allocation_solution(ms_sol) )
+                                                  && DCS_FOG_TEST_CHECK_EQ( ms_sol.fn_vm_allocations.size(), nslots )
+                                                  && DCS_FOG_TEST_CHECK_EQ( ms_sol.fn_power_states.size(), nslots )
+                                                  && DCS_FOG_TEST_CHECK_EQ( ms_sol.fn_cpu_allocations.size(), nslots );
+
+                                        // Each time slot is a feasible solution of its own VM allocation problem
+                                        scenario_t slot_scen(scen);
+                                        for (std::size_t t = 0; t < nslots && ok; ++t)
+                                        {
+                                            dcs::fog::vm_allocation_t<double> slot_sol;
+                                            slot_sol.solved = true;
+                                            slot_sol.fn_vm_allocations = ms_sol.fn_vm_allocations[t];
+                                            slot_sol.fn_power_states = ms_sol.fn_power_states[t];
+                                            slot_sol.fn_cpu_allocations = ms_sol.fn_cpu_allocations[t];
+                                            slot_scen.svc_cat_vm_cat_min_num_vms = slot_svc_cat_vm_cat_min_num_vms[t];
+
+                                            ok = check_feasible(slot_scen, slot_sol, fixed_fns.empty() ? std::set<std::size_t>() : fixed_fns[t]);
+                                        }
+
+                                        auto eval_sol = ms_sol;
+                                        dcs::fog::detail::eval_multislot_vm_allocation(scen.fn_categories,
+                                                                                       scen.fn_power_states,
+                                                                                       scen.fn_vm_allocations,
+                                                                                       scen.fn_cat_min_powers,
+                                                                                       scen.fn_cat_max_powers,
+                                                                                       scen.vm_cat_alloc_costs,
+                                                                                       scen.svc_categories,
+                                                                                       slot_svc_cat_vm_cat_min_num_vms,
+                                                                                       scen.fp_svc_cat_revenues,
+                                                                                       scen.fp_svc_cat_penalties,
+                                                                                       scen.fp_electricity_cost,
+                                                                                       scen.fp_fn_cat_asleep_costs,
+                                                                                       scen.fp_fn_cat_awake_costs,
+                                                                                       scen.deltat,
+                                                                                       eval_sol);
+
+                                        return ok && DCS_FOG_TEST_CHECK_REL_CLOSE( ms_sol.objective_value, eval_sol.objective_value, 1e-12 );
+                                    };
+
+        // Any FN can be used
+        auto const ms_sol = ms_solver.solve(scen.fn_categories,
+                                            scen.fn_power_states,
+                                            scen.fn_vm_allocations,
+                                            scen.fn_cat_min_powers,
+                                            scen.fn_cat_max_powers,
+                                            scen.vm_cat_fn_cat_cpu_specs,
+                                            scen.vm_cat_alloc_costs,
+                                            scen.svc_categories,
+                                            slot_svc_cat_vm_cat_min_num_vms,
+                                            scen.fp_svc_cat_revenues,
+                                            scen.fp_svc_cat_penalties,
+                                            scen.fp_electricity_cost,
+                                            scen.fp_fn_cat_asleep_costs,
+                                            scen.fp_fn_cat_awake_costs,
+                                            scen.deltat);
+        if (!check_solution(ms_sol, std::vector<std::set<std::size_t>>()))
+        {
+            std::cerr << "  FNs: " << sizes.first << ", services: " << sizes.second << std::endl;
+            continue;
+        }
+
+        // Time slots solved one after the other, each one starting from the VM allocation of the previous one
+        scenario_t slot_scen(scen);
+        double seq_objective_value = 0;
+        for (std::size_t t = 0; t < nslots; ++t)
+        {
+            slot_scen.svc_cat_vm_cat_min_num_vms = slot_svc_cat_vm_cat_min_num_vms[t];
+            auto const slot_sol = slot_scen.solve(solver);
+            seq_objective_value += slot_sol.objective_value;
+            slot_scen.fn_power_states = slot_sol.fn_power_states;
+            slot_scen.fn_vm_allocations = slot_sol.fn_vm_allocations;
+        }
+        DCS_FOG_TEST_CHECK( ms_sol.objective_value >= seq_objective_value-1e-9*std::abs(seq_objective_value) );
+
+        // Only every other FN can be used in odd time slots
+        std::vector<std::set<std::size_t>> fixed_fns(nslots);
+        for (std::size_t t = 1; t < nslots; t += 2)
+        {
+            for (std::size_t i = 0; i < scen.fn_categories.size(); i += 2)
+            {
+                fixed_fns[t].insert(i);
+            }
+        }
+        auto const fixed_ms_sol = ms_solver.solve_with_fixed_fns(fixed_fns,
+                                                                 scen.fn_categories,
+                                                                 scen.fn_power_states,
+                                                                 scen.fn_vm_allocations,
+                                                                 scen.fn_cat_min_powers,
+                                                                 scen.fn_cat_max_powers,
+                                                                 scen.vm_cat_fn_cat_cpu_specs,
+                                                                 scen.vm_cat_alloc_costs,
+                                                                 scen.svc_categories,
+                                                                 slot_svc_cat_vm_cat_min_num_vms,
+                                                                 scen.fp_svc_cat_revenues,
+                                                                 scen.fp_svc_cat_penalties,
+                                                                 scen.fp_electricity_cost,
+                                                                 scen.fp_fn_cat_asleep_costs,
+                                                                 scen.fp_fn_cat_awake_costs,
+                                                                 scen.deltat);
+        if (!check_solution(fixed_ms_sol, fixed_fns))
+        {
+            std::cerr << "  FNs: " << sizes.first << ", services: " << sizes.second << " (fixed FNs)" << std::endl;
+        }
+    }
+}
+
+/**
+ * VM allocation solver that counts the calls to the greedy solver it
+ * decorates, and that can be told to fail.
+ */
+class counting_solver_t: public dcs::fog::base_vm_allocation_solver_t<double>
+{
+public:
+    counting_solver_t()
+    : num_solves(0),
+      fail(false)
+    {
+    }
+
+    dcs::fog::vm_allocation_t<double> solve(const std::vector<std::size_t>& fn_categories,
+                                            const std::vector<bool>& fn_power_states,
+                                            const fn_vm_allocations_t& fn_vm_allocations,
+                                            const std::vector<double>& fn_cat_min_powers,
+                                            const std::vector<double>& fn_cat_max_powers,
+                                            const std::vector<std::vector<double>>& vm_cat_fn_cat_cpu_specs,
+                                            const std::vector<double>& vm_cat_alloc_costs,
+                                            const std::vector<std::size_t>& svc_categories,
+                                            const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms,
+                                            const std::vector<double>& fp_svc_cat_revenues,
+                                            const std::vector<double>& fp_svc_cat_penalties,
+                                            const double fp_electricity_cost,
+                                            const std::vector<double>& fp_fn_cat_asleep_costs,
+                                            const std::vector<double>& fp_fn_cat_awake_costs,
+                                            double deltat) const
+    {
+        return this->solve_with_fixed_fns(std::set<std::size_t>(),
+                                          fn_categories,
+                                          fn_power_states,
+                                          fn_vm_allocations,
+                                          fn_cat_min_powers,
+                                          fn_cat_max_powers,
+                                          vm_cat_fn_cat_cpu_specs,
+                                          vm_cat_alloc_costs,
+                                          svc_categories,
+                                          svc_cat_vm_cat_min_num_vms,
+                                          fp_svc_cat_revenues,
+                                          fp_svc_cat_penalties,
+                                          fp_electricity_cost,
+                                          fp_fn_cat_asleep_costs,
+                                          fp_fn_cat_awake_costs,
+                                          deltat);
+    }
+
+    dcs::fog::vm_allocation_t<double> solve_with_fixed_fns(const std::set<std::size_t>& fixed_fns,
+                                                           const std::vector<std::size_t>& fn_categories,
+                                                           const std::vector<bool>& fn_power_states,
+                                                           const fn_vm_allocations_t& fn_vm_allocations,
+                                                           const std::vector<double>& fn_cat_min_powers,
+                                                           const std::vector<double>& fn_cat_max_powers,
+                                                           const std::vector<std::vector<double>>& vm_cat_fn_cat_cpu_specs,
+                                                           const std::vector<double>& vm_cat_alloc_costs,
+                                                           const std::vector<std::size_t>& svc_categories,
+                                                           const std::vector<std::vector<std::size_t>>& svc_cat_vm_cat_min_num_vms,
+                                                           const std::vector<double>& fp_svc_cat_revenues,
+                                                           const std::vector<double>& fp_svc_cat_penalties,
+                                                           const double fp_electricity_cost,
+                                                           const std::vector<double>& fp_fn_cat_asleep_costs,
+                                                           const std::vector<double>& fp_fn_cat_awake_costs,
+                                                           double deltat) const
+    {
+        ++num_solves;
+
+        auto solution = solver_.solve_with_fixed_fns(fixed_fns,
+                                                     fn_categories,
+                                                     fn_power_states,
+                                                     fn_vm_allocations,
+                                                     fn_cat_min_powers,
+                                                     fn_cat_max_powers,
+                                                     vm_cat_fn_cat_cpu_specs,
+                                                     vm_cat_alloc_costs,
+                                                     svc_categories,
+                                                     svc_cat_vm_cat_min_num_vms,
+                                                     fp_svc_cat_revenues,
+                                                     fp_svc_cat_penalties,
+                                                     fp_electricity_cost,
+                                                     fp_fn_cat_asleep_costs,
+                                                     fp_fn_cat_awake_costs,
+                                                     deltat);
+        solution.solved = !fail;
+
+        return solution;
+    }
+
+    mutable std::size_t num_solves; ///< The number of calls to the greedy solver
+    bool fail; ///< If true, VM allocations are returned as not solved
+
+
+private:
+    dcs::fog::greedy_vm_allocation_solver_t<double> solver_;
+}; // counting_solver_t
+
+/// Tells if two VM allocations are the same (solve times excluded)
+bool same_vm_allocation(const dcs::fog::vm_allocation_t<double>& x, const dcs::fog::vm_allocation_t<double>& y)
+{
+    return x.solved == y.solved
+        && x.objective_value == y.objective_value
+        && x.fn_vm_allocations == y.fn_vm_allocations
+        && x.fn_power_states == y.fn_power_states
+        && x.fn_cpu_allocations == y.fn_cpu_allocations;
+}
+
+/**
+ * Checks that the caching solver returns the VM allocations of the decorated
+ * solver, that it calls the decorated solver only on cache misses, and that
+ * it evicts the least recently used problem instances.
+ */
+void test_caching_solver()
+{
+    auto p_counting_solver = std::make_shared<counting_solver_t>();
+    dcs::fog::caching_vm_allocation_solver_t<double> solver(p_counting_solver, 2);
+    dcs::fog::greedy_vm_allocation_solver_t<double> ref_solver;
+
+    // Three problem instances that differ only in the min number of VMs of a service category
+    std::vector<scenario_t> scens(3, scenario_t(50, 100, 1));
+    scens[1].svc_cat_vm_cat_min_num_vms[0][0] += 1;
+    scens[2].svc_cat_vm_cat_min_num_vms[3][2] += 1;
+
+    std::vector<dcs::fog::vm_allocation_t<double>> ref_sols;
+    for (auto const& scen : scens)
+    {
+        ref_sols.push_back(scen.solve(ref_solver));
+    }
+
+    // Sequence of solved instances and whether each one is expected to be found in the cache (with room for 2 instances)
+    const std::vector<std::pair<std::size_t,bool>> accesses = {{0, false}, {0, true}, {1, false}, {0, true}, {2, false}, // Evicts 1
+                                                               {0, true}, {1, false}, // Evicts 2
+                                                               {0, true}, {2, false}, // Evicts 1
+                                                               {2, true}, {0, true}};
+    std::size_t num_hits = 0;
+    for (std::size_t a = 0; a < accesses.size(); ++a)
+    {
+        auto const s = accesses[a].first;
+        auto const hit = accesses[a].second;
+        auto const num_solves = p_counting_solver->num_solves;
+
+        auto const sol = scens[s].solve(solver);
+        num_hits += hit ? 1 : 0;
+
+        if (!DCS_FOG_TEST_CHECK( same_vm_allocation(sol, ref_sols[s]) )
+            || !DCS_FOG_TEST_CHECK_EQ( p_counting_solver->num_solves, num_solves+(hit ? 0 : 1) )
+            || !DCS_FOG_TEST_CHECK_EQ( solver.num_hits(), num_hits )
+            || !DCS_FOG_TEST_CHECK_EQ( solver.num_misses(), a+1-num_hits )
+            || !DCS_FOG_TEST_CHECK( solver.size() <= solver.max_size() ))
+        {
+            std::cerr << "  access: " << a << ", instance: " << s << std::endl;
+            break;
+        }
+    }
+    DCS_FOG_TEST_CHECK_EQ( solver.size(), 2u );
+    DCS_FOG_TEST_CHECK_EQ( solver.hit_rate(), static_cast<double>(num_hits)/accesses.size() );
+
+    // The same problem solved by solve() and from a starting point is found in the cache
+    auto num_solves = p_counting_solver->num_solves;
+    auto sol = solver.solve_with_fixed_fns_from(ref_sols[1],
+                                                std::set<std::size_t>(),
+                                                scens[0].fn_categories,
+                                                scens[0].fn_power_states,
+                                                scens[0].fn_vm_allocations,
+                                                scens[0].fn_cat_min_powers,
+                                                scens[0].fn_cat_max_powers,
+                                                scens[0].vm_cat_fn_cat_cpu_specs,
+                                                scens[0].vm_cat_alloc_costs,
+                                                scens[0].svc_categories,
+                                                scens[0].svc_cat_vm_cat_min_num_vms,
+                                                scens[0].fp_svc_cat_revenues,
+                                                scens[0].fp_svc_cat_penalties,
+                                                scens[0].fp_electricity_cost,
+                                                scens[0].fp_fn_cat_asleep_costs,
+                                                scens[0].fp_fn_cat_awake_costs,
+                                                scens[0].deltat);
+    DCS_FOG_TEST_CHECK( same_vm_allocation(sol, ref_sols[0]) );
+    DCS_FOG_TEST_CHECK_EQ( p_counting_solver->num_solves, num_solves );
+
+    // Any change of the inputs gives a different problem
+    std::set<std::size_t> fixed_fns = {0, 1, 2, 3};
+    sol = scens[0].solve(solver, fixed_fns);
+    DCS_FOG_TEST_CHECK( same_vm_allocation(sol, scens[0].solve(ref_solver, fixed_fns)) );
+    DCS_FOG_TEST_CHECK_EQ( p_counting_solver->num_solves, num_solves+1 );
+
+    scenario_t scen(scens[0]);
+    scen.fn_power_states[7] = !scen.fn_power_states[7];
+    sol = scen.solve(solver);
+    DCS_FOG_TEST_CHECK( same_vm_allocation(sol, scen.solve(ref_solver)) );
+    DCS_FOG_TEST_CHECK_EQ( p_counting_solver->num_solves, num_solves+2 );
+
+    // Unsolved problems are not cached
+    p_counting_solver->fail = true;
+    scen.fp_electricity_cost *= 2;
+    scen.solve(solver);
+    sol = scen.solve(solver);
+    DCS_FOG_TEST_CHECK( !sol.solved );
+    DCS_FOG_TEST_CHECK_EQ( p_counting_solver->num_solves, num_solves+4 );
+
+    solver.clear();
+    DCS_FOG_TEST_CHECK_EQ( solver.size(), 0u );
+    DCS_FOG_TEST_CHECK_EQ( solver.num_hits(), 0u );
+    DCS_FOG_TEST_CHECK_EQ( solver.num_misses(), 0u );
+    DCS_FOG_TEST_CHECK_EQ( solver.hit_rate(), 0 );
+}
+
+} // Namespace <unnamed>
+
+
+int main()
+{
+    test_greedy_solver();
+    test_greedy_multislot_solver();
+    test_caching_solver();
+
+    return dcs::fog::test::report("vm_allocation_test");
+}